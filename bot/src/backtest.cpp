@@ -0,0 +1,183 @@
+#include "backtest.hpp"
+#include "state.hpp"
+#include "strategy.hpp"
+#include "kraken_client.hpp"
+#include "market_data.hpp"
+#include "util.hpp"
+#include <algorithm>
+
+using json = nlohmann::json;
+
+json job_to_json(const BacktestJob& job) {
+    return json{
+        {"id", job.id},
+        {"param_set", job.param_set},
+        {"pair", job.pair},
+        {"start_ns", job.start_ns},
+        {"end_ns", job.end_ns},
+        {"params", job.params}
+    };
+}
+
+BacktestJob job_from_json(const json& j) {
+    BacktestJob job;
+    job.id = j.at("id").get<uint64_t>();
+    job.param_set = j.at("param_set").get<uint64_t>();
+    job.pair = j.at("pair").get<std::string>();
+    job.start_ns = j.at("start_ns").get<int64_t>();
+    job.end_ns = j.at("end_ns").get<int64_t>();
+    job.params = j.value("params", json::object());
+    return job;
+}
+
+json result_to_json(const BacktestResult& result) {
+    return json{
+        {"job_id", result.job_id},
+        {"param_set", result.param_set},
+        {"success", result.success},
+        {"error", result.error},
+        {"ticks", result.ticks},
+        {"buys", result.buys},
+        {"round_trips", result.round_trips},
+        {"wins", result.wins},
+        {"start_equity", result.start_equity},
+        {"end_equity", result.end_equity},
+        {"max_drawdown_pct", result.max_drawdown_pct}
+    };
+}
+
+BacktestResult result_from_json(const json& j) {
+    BacktestResult result;
+    result.job_id = j.at("job_id").get<uint64_t>();
+    result.param_set = j.at("param_set").get<uint64_t>();
+    result.success = j.value("success", false);
+    result.error = j.value("error", "");
+    result.ticks = j.value("ticks", uint64_t{0});
+    result.buys = j.value("buys", 0);
+    result.round_trips = j.value("round_trips", 0);
+    result.wins = j.value("wins", 0);
+    result.start_equity = j.value("start_equity", 0.0);
+    result.end_equity = j.value("end_equity", 0.0);
+    result.max_drawdown_pct = j.value("max_drawdown_pct", 0.0);
+    return result;
+}
+
+BacktestResult run_backtest(const Config& base, const TickStoreReader& ticks, const BacktestJob& job) {
+    BacktestResult result;
+    result.job_id = job.id;
+    result.param_set = job.param_set;
+
+    Config config = base;
+    try {
+        config.apply(job.params);
+    } catch (const json::exception& e) {
+        result.error = "Bad params: " + std::string(e.what());
+        return result;
+    }
+    config.pair = job.pair;
+    config.dry_run = true;
+    config.scanner_enabled = false;
+    config.failover_enabled = false;
+    // Tick files hold quotes only: nothing feeds the L2 book, the trade tape
+    // or the paper engine's prints, so their filters would block every
+    // entry. Base settings are dropped; a sweep that asks for them fails.
+    for (const char* key : {"book_signals_enabled", "tape_enabled", "vpin_enabled", "paper_engine_enabled"}) {
+        if (job.params.value(key, false)) {
+            result.error = std::string(key) + " needs market data that tick files do not record";
+            return result;
+        }
+    }
+    if (config.indicator_source == "tape") {
+        result.error = "indicator_source \"tape\" needs trade prints that tick files do not record";
+        return result;
+    }
+    config.book_signals_enabled = false;
+    config.tape_enabled = false;
+    config.vpin_enabled = false;
+    config.paper_engine_enabled = false;
+    config.state_file.clear();
+    // Simulated trades reach a ledger only when the sweep asks for one
+    if (!job.params.contains("ledger_file")) {
+        config.ledger_file.clear();
+    }
+    if (!config.validate()) {
+        result.error = "Config validation failed for params " + job.params.dump();
+        return result;
+    }
+
+    // Segments are read one at a time, so a long range costs no more
+    // memory than a short one
+    TickCursor cursor(ticks, job.start_ns, job.end_ns);
+    const StoredTick* first;
+    const StoredTick* last;
+    if (!cursor.next(first, last)) {
+        result.error = "No ticks in range";
+        return result;
+    }
+
+    TradingState state = TradingState::default_state();
+    KrakenClient client(config.kraken_api_base, 0);
+    MarketDataCache market_data(client);
+    Strategy strategy(config, state, client, market_data);
+
+    util::set_sim_time_ns(first->exchange_ns);
+    state.trades_date_yyyy_mm_dd = util::today_yyyy_mm_dd();
+    strategy.init_simulation(config.sim_initial_cad);
+    result.start_equity = config.sim_initial_cad;
+
+    const int64_t step_ns = config.poll_interval_seconds * 1'000'000'000;
+    int64_t next_eval_ns = 0;
+    double peak_equity = result.start_equity;
+    double entry_equity = 0.0;
+    double mark_price = first->last_price;
+
+    do {
+        for (const StoredTick* tick = first; tick != last; ++tick) {
+            result.ticks++;
+            mark_price = tick->last_price;
+            if (tick->exchange_ns < next_eval_ns) {
+                continue;
+            }
+            next_eval_ns = tick->exchange_ns + step_ns;
+            util::set_sim_time_ns(tick->exchange_ns);
+
+            MarketSnapshot snap;
+            snap.pair = job.pair;
+            snap.last_price = tick->last_price;
+            snap.bid_price = tick->bid_price;
+            snap.ask_price = tick->ask_price;
+            snap.timestamp = tick->exchange_ns / 1'000'000'000;
+            snap.receive_ns = tick->exchange_ns;
+            snap.exchange_ns = tick->exchange_ns;
+            market_data.publish(snap);
+
+            double equity_before = state.sim_cad_balance + state.sim_btc_balance * tick->last_price;
+            TradeContext ctx = strategy.evaluate();
+            if (ctx.decision == Decision::BUY || ctx.decision == Decision::SELL) {
+                TradingMode mode_before = state.mode;
+                if (strategy.execute(ctx)) {
+                    if (ctx.decision == Decision::BUY) {
+                        result.buys++;
+                        entry_equity = equity_before;
+                    } else if (mode_before == TradingMode::LONG && state.mode == TradingMode::FLAT) {
+                        result.round_trips++;
+                        if (state.sim_cad_balance > entry_equity) {
+                            result.wins++;
+                        }
+                    }
+                }
+            }
+
+            double equity = state.sim_cad_balance + state.sim_btc_balance * tick->last_price;
+            peak_equity = std::max(peak_equity, equity);
+            if (peak_equity > 0.0) {
+                result.max_drawdown_pct = std::max(result.max_drawdown_pct, (peak_equity - equity) / peak_equity);
+            }
+        }
+    } while (cursor.next(first, last));
+    util::clear_sim_time();
+
+    result.end_equity = state.sim_cad_balance + state.sim_btc_balance * mark_price;
+    result.success = true;
+    return result;
+}
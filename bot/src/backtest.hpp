@@ -0,0 +1,44 @@
+#ifndef BACKTEST_HPP
+#define BACKTEST_HPP
+
+#include "config.hpp"
+#include "tick_store.hpp"
+#include <nlohmann/json.hpp>
+#include <string>
+#include <cstdint>
+
+// One sweep cell: config overrides replayed over [start_ns, end_ns)
+struct BacktestJob {
+    uint64_t id = 0;
+    uint64_t param_set = 0;      // Jobs with the same overrides share this
+    std::string pair;
+    int64_t start_ns = 0;
+    int64_t end_ns = 0;
+    nlohmann::json params = nlohmann::json::object();
+};
+
+struct BacktestResult {
+    uint64_t job_id = 0;
+    uint64_t param_set = 0;
+    bool success = false;
+    std::string error;
+    uint64_t ticks = 0;
+    int buys = 0;
+    int round_trips = 0;         // Entries fully closed
+    int wins = 0;
+    double start_equity = 0.0;
+    double end_equity = 0.0;     // Open positions marked at the last price
+    double max_drawdown_pct = 0.0;
+};
+
+nlohmann::json job_to_json(const BacktestJob& job);
+BacktestJob job_from_json(const nlohmann::json& j);
+nlohmann::json result_to_json(const BacktestResult& result);
+BacktestResult result_from_json(const nlohmann::json& j);
+
+// Replay one job through the live Strategy in dry-run mode on a simulated
+// clock. Evaluations are spaced by poll_interval_seconds of tick time, as in
+// the live loop.
+BacktestResult run_backtest(const Config& base, const TickStoreReader& ticks, const BacktestJob& job);
+
+#endif // BACKTEST_HPP
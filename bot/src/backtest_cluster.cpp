@@ -0,0 +1,522 @@
+#include "backtest_cluster.hpp"
+#include "logger.hpp"
+#include "util.hpp"
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <netdb.h>
+#include <poll.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <thread>
+#include <cstring>
+#include <cerrno>
+#include <cmath>
+
+using json = nlohmann::json;
+
+namespace {
+
+// Newline-delimited JSON over a connected socket
+class LineSocket {
+public:
+    explicit LineSocket(int fd) : fd_(fd) {
+        int one = 1;
+        setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+    ~LineSocket() { close(fd_); }
+
+    LineSocket(const LineSocket&) = delete;
+    LineSocket& operator=(const LineSocket&) = delete;
+
+    int fd() const { return fd_; }
+
+    bool send(const json& message) {
+        std::string line = message.dump() + "\n";
+        size_t sent = 0;
+        while (sent < line.size()) {
+            ssize_t n = ::send(fd_, line.data() + sent, line.size() - sent, MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                return false;
+            }
+            sent += static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    // One recv(); appends complete messages. False on EOF or error.
+    bool receive(std::vector<json>& messages) {
+        char buf[4096];
+        ssize_t n = recv(fd_, buf, sizeof(buf), 0);
+        if (n < 0 && errno == EINTR) {
+            return true;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        buffer_.append(buf, static_cast<size_t>(n));
+
+        size_t newline;
+        while ((newline = buffer_.find('\n')) != std::string::npos) {
+            std::string line = buffer_.substr(0, newline);
+            buffer_.erase(0, newline + 1);
+            try {
+                messages.push_back(json::parse(line));
+            } catch (const json::parse_error& e) {
+                LOG_WARNING("Dropping malformed message: " + std::string(e.what()));
+            }
+        }
+        return true;
+    }
+
+private:
+    int fd_;
+    std::string buffer_;
+};
+
+int listen_on(uint16_t port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+    if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || listen(fd, 64) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int connect_to(const std::string& host, uint16_t port) {
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* res = nullptr;
+    if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &res) != 0) {
+        return -1;
+    }
+    int fd = -1;
+    for (addrinfo* ai = res; ai != nullptr; ai = ai->ai_next) {
+        fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (fd < 0) {
+            continue;
+        }
+        if (connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) {
+            break;
+        }
+        close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(res);
+    return fd;
+}
+
+// Accepts "YYYY-MM-DDTHH:MM:SS" (UTC) or epoch seconds
+int64_t parse_time_ns(const json& value) {
+    if (value.is_number()) {
+        return value.get<int64_t>() * 1'000'000'000;
+    }
+    std::tm tm_time = {};
+    std::istringstream iss(value.get<std::string>());
+    iss >> std::get_time(&tm_time, "%Y-%m-%dT%H:%M:%S");
+    if (iss.fail()) {
+        throw std::runtime_error("Bad time: " + value.get<std::string>());
+    }
+    return static_cast<int64_t>(timegm(&tm_time)) * 1'000'000'000;
+}
+
+// A job that times out this many times is recorded as failed
+constexpr int kMaxJobTimeouts = 3;
+
+struct Worker {
+    std::unique_ptr<LineSocket> socket;
+    std::string name;
+    std::optional<uint64_t> job;
+    std::chrono::steady_clock::time_point deadline;
+};
+
+struct LeaderboardRow {
+    uint64_t param_set = 0;
+    json params;
+    double growth = 1.0;          // Product of per-shard end/start equity
+    int buys = 0;
+    int round_trips = 0;
+    int wins = 0;
+    double max_drawdown_pct = 0.0;
+    uint64_t ticks = 0;
+    size_t shards = 0;
+    std::string error;
+};
+
+void write_leaderboard(const SweepSpec& spec, const std::vector<BacktestJob>& jobs,
+                       const std::map<uint64_t, BacktestResult>& results) {
+    std::map<uint64_t, LeaderboardRow> rows;
+    for (const auto& job : jobs) {
+        LeaderboardRow& row = rows[job.param_set];
+        row.param_set = job.param_set;
+        row.params = job.params;
+
+        const BacktestResult& r = results.at(job.id);
+        row.shards++;
+        if (!r.success) {
+            // Empty shards do not disqualify a parameter set
+            if (r.error != "No ticks in range") {
+                row.error = r.error;
+            }
+            continue;
+        }
+        if (r.start_equity > 0.0) {
+            row.growth *= r.end_equity / r.start_equity;
+        }
+        row.buys += r.buys;
+        row.round_trips += r.round_trips;
+        row.wins += r.wins;
+        row.max_drawdown_pct = std::max(row.max_drawdown_pct, r.max_drawdown_pct);
+        row.ticks += r.ticks;
+    }
+
+    std::vector<LeaderboardRow> ranked;
+    for (auto& [id, row] : rows) {
+        ranked.push_back(row);
+    }
+    std::sort(ranked.begin(), ranked.end(), [](const LeaderboardRow& a, const LeaderboardRow& b) {
+        if (a.error.empty() != b.error.empty()) {
+            return a.error.empty();
+        }
+        return a.growth > b.growth;
+    });
+
+    json out = json::array();
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2) << "Leaderboard (" << ranked.size() << " parameter sets):";
+    for (size_t i = 0; i < ranked.size(); i++) {
+        const LeaderboardRow& row = ranked[i];
+        double return_pct = (row.growth - 1.0) * 100.0;
+        double win_rate = row.round_trips > 0 ? 100.0 * row.wins / row.round_trips : 0.0;
+        out.push_back({
+            {"rank", i + 1},
+            {"params", row.params},
+            {"return_pct", return_pct},
+            {"round_trips", row.round_trips},
+            {"buys", row.buys},
+            {"win_rate_pct", win_rate},
+            {"max_drawdown_pct", row.max_drawdown_pct * 100.0},
+            {"ticks", row.ticks},
+            {"shards", row.shards},
+            {"error", row.error}
+        });
+        if (static_cast<int>(i) < spec.top_n) {
+            oss << "\n  #" << (i + 1) << " return=" << return_pct << "%"
+                << " trades=" << row.round_trips << " win=" << win_rate << "%"
+                << " dd=" << (row.max_drawdown_pct * 100.0) << "%"
+                << " " << row.params.dump() << (row.error.empty() ? "" : " ERROR: " + row.error);
+        }
+    }
+    LOG_INFO(oss.str());
+
+    std::ofstream file(spec.leaderboard_file);
+    if (!file.is_open()) {
+        LOG_ERROR("Failed to write leaderboard: " + spec.leaderboard_file);
+        return;
+    }
+    file << out.dump(2) << std::endl;
+    LOG_INFO("Leaderboard written to " + spec.leaderboard_file);
+}
+
+} // namespace
+
+SweepSpec SweepSpec::load(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open sweep file: " + path);
+    }
+    json j;
+    try {
+        file >> j;
+    } catch (const json::parse_error& e) {
+        throw std::runtime_error("Failed to parse sweep JSON: " + std::string(e.what()));
+    }
+
+    SweepSpec spec;
+    if (j.contains("port")) spec.port = j["port"].get<uint16_t>();
+    if (j.contains("pair")) spec.pair = j["pair"].get<std::string>();
+    spec.start_ns = parse_time_ns(j.at("start"));
+    spec.end_ns = parse_time_ns(j.at("end"));
+    if (j.contains("shard_hours")) spec.shard_ns = static_cast<int64_t>(j["shard_hours"].get<double>() * 3600.0 * 1e9);
+    if (j.contains("grid")) spec.grid = j["grid"];
+    if (j.contains("top_n")) spec.top_n = j["top_n"].get<int>();
+    if (j.contains("job_timeout_seconds")) spec.job_timeout_seconds = j["job_timeout_seconds"].get<int64_t>();
+    if (j.contains("leaderboard_file")) spec.leaderboard_file = j["leaderboard_file"].get<std::string>();
+
+    if (spec.end_ns <= spec.start_ns || spec.shard_ns <= 0) {
+        throw std::runtime_error("Sweep needs start < end and shard_hours > 0");
+    }
+    if (!spec.grid.is_object()) {
+        throw std::runtime_error("Sweep grid must be an object of value lists");
+    }
+    return spec;
+}
+
+std::vector<BacktestJob> expand_sweep(const SweepSpec& spec) {
+    // Cartesian product of the grid
+    std::vector<json> param_sets = {json::object()};
+    for (const auto& [name, values] : spec.grid.items()) {
+        std::vector<json> next;
+        for (const auto& base : param_sets) {
+            for (const auto& value : (values.is_array() ? values : json::array({values}))) {
+                json params = base;
+                params[name] = value;
+                next.push_back(params);
+            }
+        }
+        param_sets = std::move(next);
+    }
+
+    std::vector<BacktestJob> jobs;
+    for (size_t p = 0; p < param_sets.size(); p++) {
+        for (int64_t start = spec.start_ns; start < spec.end_ns; start += spec.shard_ns) {
+            BacktestJob job;
+            job.id = jobs.size();
+            job.param_set = p;
+            job.pair = spec.pair;
+            job.start_ns = start;
+            job.end_ns = std::min(start + spec.shard_ns, spec.end_ns);
+            job.params = param_sets[p];
+            jobs.push_back(job);
+        }
+    }
+    return jobs;
+}
+
+bool run_coordinator(const SweepSpec& spec) {
+    std::vector<BacktestJob> jobs = expand_sweep(spec);
+    LOG_INFO("Sweep: " + std::to_string(jobs.size()) + " jobs, listening on port " + std::to_string(spec.port));
+
+    int listen_fd = listen_on(spec.port);
+    if (listen_fd < 0) {
+        LOG_ERROR("Failed to listen on port " + std::to_string(spec.port) + ": " + std::string(std::strerror(errno)));
+        return false;
+    }
+
+    std::deque<uint64_t> pending;
+    for (const auto& job : jobs) {
+        pending.push_back(job.id);
+    }
+    std::map<uint64_t, BacktestResult> results;
+    std::map<uint64_t, int> timeouts;
+    std::vector<std::unique_ptr<Worker>> workers;
+    const auto job_timeout = std::chrono::seconds(spec.job_timeout_seconds);
+    size_t last_reported = 0;
+
+    auto requeue = [&](Worker& worker, const std::string& why) {
+        if (worker.job && results.count(*worker.job) == 0) {
+            LOG_WARNING("Worker " + worker.name + " " + why + ", re-queueing job " + std::to_string(*worker.job));
+            pending.push_front(*worker.job);
+        } else {
+            LOG_WARNING("Worker " + worker.name + " " + why);
+        }
+        worker.job.reset();
+    };
+
+    // The worker keeps running the job and stays connected; its result is
+    // still taken if it arrives first. Another worker gets a copy until the
+    // job has timed out kMaxJobTimeouts times, then it is recorded as failed.
+    auto time_out = [&](Worker& worker, std::chrono::steady_clock::time_point now) {
+        uint64_t id = *worker.job;
+        worker.deadline = now + job_timeout;
+        if (results.count(id) != 0) {
+            return;
+        }
+        int count = ++timeouts[id];
+        if (count >= kMaxJobTimeouts) {
+            LOG_ERROR("Job " + std::to_string(id) + " timed out " + std::to_string(count) + " times, giving up");
+            BacktestResult failed;
+            failed.job_id = id;
+            failed.param_set = jobs[id].param_set;
+            failed.error = "Timed out " + std::to_string(count) + " times";
+            results.emplace(id, failed);
+            return;
+        }
+        LOG_WARNING("Worker " + worker.name + " timed out on job " + std::to_string(id) + ", re-queueing a copy");
+        if (std::find(pending.begin(), pending.end(), id) == pending.end()) {
+            pending.push_front(id);
+        }
+    };
+
+    while (results.size() < jobs.size()) {
+        std::vector<pollfd> fds;
+        fds.push_back({listen_fd, POLLIN, 0});
+        for (const auto& worker : workers) {
+            fds.push_back({worker->socket->fd(), POLLIN, 0});
+        }
+        if (poll(fds.data(), fds.size(), 200) < 0 && errno != EINTR) {
+            LOG_ERROR("poll failed: " + std::string(std::strerror(errno)));
+            break;
+        }
+
+        if (fds[0].revents & POLLIN) {
+            int fd = accept(listen_fd, nullptr, nullptr);
+            if (fd >= 0) {
+                auto worker = std::make_unique<Worker>();
+                worker->socket = std::make_unique<LineSocket>(fd);
+                worker->name = "fd" + std::to_string(fd);
+                workers.push_back(std::move(worker));
+            }
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < workers.size(); i++) {
+            Worker& worker = *workers[i];
+            bool alive = true;
+            if (i + 1 < fds.size() && (fds[i + 1].revents & (POLLIN | POLLHUP | POLLERR))) {
+                std::vector<json> messages;
+                alive = worker.socket->receive(messages);
+                for (const auto& message : messages) {
+                    std::string type = message.value("type", "");
+                    if (type == "hello") {
+                        worker.name = message.value("name", worker.name);
+                        LOG_INFO("Worker " + worker.name + " connected");
+                    } else if (type == "result") {
+                        BacktestResult result;
+                        try {
+                            result = result_from_json(message.at("result"));
+                        } catch (const json::exception& e) {
+                            LOG_WARNING("Dropping malformed result: " + std::string(e.what()));
+                            requeue(worker, "sent a malformed result");
+                            continue;
+                        }
+                        if (result.job_id < jobs.size()) {
+                            // A re-queued job can finish twice; keep the first
+                            results.emplace(result.job_id, result);
+                        }
+                        worker.job.reset();
+                    }
+                }
+                if (!alive) {
+                    requeue(worker, "disconnected");
+                }
+            }
+            if (alive && worker.job && now > worker.deadline) {
+                time_out(worker, now);
+            }
+            if (!alive) {
+                workers.erase(workers.begin() + static_cast<std::ptrdiff_t>(i));
+                fds.erase(fds.begin() + static_cast<std::ptrdiff_t>(i + 1));
+                i--;
+                continue;
+            }
+
+            // Skip jobs finished by another worker after a re-queue
+            while (!worker.job && !pending.empty()) {
+                uint64_t id = pending.front();
+                pending.pop_front();
+                if (results.count(id) != 0) {
+                    continue;
+                }
+                if (worker.socket->send({{"type", "job"}, {"job", job_to_json(jobs[id])}})) {
+                    worker.job = id;
+                    worker.deadline = now + job_timeout;
+                } else {
+                    pending.push_front(id);
+                    break;
+                }
+            }
+        }
+
+        // Every 10% of the sweep
+        if ((results.size() * 10) / jobs.size() != (last_reported * 10) / jobs.size()) {
+            LOG_INFO("Progress: " + std::to_string(results.size()) + "/" + std::to_string(jobs.size()) +
+                     " jobs, " + std::to_string(workers.size()) + " workers");
+            last_reported = results.size();
+        }
+    }
+
+    for (auto& worker : workers) {
+        worker->socket->send({{"type", "done"}});
+    }
+    workers.clear();
+    close(listen_fd);
+
+    if (results.size() < jobs.size()) {
+        return false;
+    }
+    write_leaderboard(spec, jobs, results);
+    return true;
+}
+
+bool run_worker(const std::string& host, uint16_t port, const Config& base, const std::string& name) {
+    int fd = -1;
+    for (int attempt = 0; attempt < 30 && fd < 0; attempt++) {
+        fd = connect_to(host, port);
+        if (fd < 0) {
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+        }
+    }
+    if (fd < 0) {
+        LOG_ERROR("Failed to connect to coordinator " + host + ":" + std::to_string(port));
+        return false;
+    }
+    LineSocket socket(fd);
+    if (!socket.send({{"type", "hello"}, {"name", name}})) {
+        return false;
+    }
+    LOG_INFO("Connected to coordinator " + host + ":" + std::to_string(port) + " as " + name);
+
+    // One segment index per pair for the life of the worker
+    std::map<std::string, std::unique_ptr<TickStoreReader>> stores;
+    size_t completed = 0;
+
+    for (;;) {
+        std::vector<json> messages;
+        if (!socket.receive(messages)) {
+            LOG_WARNING("Coordinator closed the connection");
+            return false;
+        }
+        for (const auto& message : messages) {
+            std::string type = message.value("type", "");
+            if (type == "done") {
+                LOG_INFO("Sweep finished, " + std::to_string(completed) + " jobs run here");
+                return true;
+            }
+            if (type != "job") {
+                continue;
+            }
+
+            BacktestJob job = job_from_json(message.at("job"));
+            auto& store = stores[job.pair];
+            if (!store) {
+                store = std::make_unique<TickStoreReader>(base.tick_store_dir, job.pair);
+            }
+
+            BacktestResult result;
+            if (store->is_open()) {
+                result = run_backtest(base, *store, job);
+            } else {
+                result.job_id = job.id;
+                result.param_set = job.param_set;
+                result.error = "No tick store for " + job.pair;
+            }
+            if (!socket.send({{"type", "result"}, {"result", result_to_json(result)}})) {
+                return false;
+            }
+            completed++;
+        }
+    }
+}
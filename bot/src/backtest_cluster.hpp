@@ -0,0 +1,38 @@
+#ifndef BACKTEST_CLUSTER_HPP
+#define BACKTEST_CLUSTER_HPP
+
+#include "backtest.hpp"
+#include <nlohmann/json.hpp>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// Parameter sweep: every combination of grid values, replayed over
+// [start, end) split into shard_hours slices
+struct SweepSpec {
+    uint16_t port = 7700;
+    std::string pair = "XXBTZCAD";
+    int64_t start_ns = 0;
+    int64_t end_ns = 0;
+    int64_t shard_ns = 24LL * 3600 * 1'000'000'000;
+    nlohmann::json grid = nlohmann::json::object();   // name -> [values]
+    int top_n = 10;
+    int64_t job_timeout_seconds = 600;
+    std::string leaderboard_file = "leaderboard.json";
+
+    static SweepSpec load(const std::string& path);
+};
+
+std::vector<BacktestJob> expand_sweep(const SweepSpec& spec);
+
+// Hands jobs to workers one at a time over TCP (newline-delimited JSON),
+// re-queues the job of any worker that disconnects or exceeds
+// job_timeout_seconds (failing it after repeated timeouts), and writes the
+// merged leaderboard when every job has a result.
+bool run_coordinator(const SweepSpec& spec);
+
+// Connects to host:port and runs jobs against the tick store in
+// tick_store_dir until the coordinator says it is done
+bool run_worker(const std::string& host, uint16_t port, const Config& base, const std::string& name);
+
+#endif // BACKTEST_CLUSTER_HPP
@@ -0,0 +1,78 @@
+#include "config.hpp"
+#include "logger.hpp"
+#include "backtest_cluster.hpp"
+#include "indicator_kernels.hpp"
+
+#include <iostream>
+#include <unistd.h>
+
+// Distributed parameter sweeps over recorded ticks.
+//
+//   backtest coordinator <sweep.json> [config.json]
+//   backtest worker <host:port> [config.json]
+//
+// Workers replay jobs against their local copy of tick_store_dir; the
+// coordinator merges results into a ranked leaderboard.
+
+static void usage() {
+    std::cerr << "Usage:\n"
+              << "  backtest coordinator <sweep.json> [config.json]\n"
+              << "  backtest worker <host:port> [config.json]" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        usage();
+        return 1;
+    }
+    std::string mode = argv[1];
+    std::string config_file = argc > 3 ? argv[3] : "config.json";
+    
+    Config config;
+    try {
+        config = Config::load(config_file);
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to load config: " << e.what() << std::endl;
+        return 1;
+    }
+    
+    kernels::set_isa(config.indicator_isa);
+    
+    if (mode == "coordinator") {
+        Logger::instance().init(config.log_dir, "backtest_coordinator.log");
+        SweepSpec spec;
+        try {
+            spec = SweepSpec::load(argv[2]);
+        } catch (const std::exception& e) {
+            LOG_ERROR(e.what());
+            return 1;
+        }
+        return run_coordinator(spec) ? 0 : 1;
+    }
+    
+    if (mode == "worker") {
+        std::string endpoint = argv[2];
+        size_t colon = endpoint.rfind(':');
+        if (colon == std::string::npos) {
+            usage();
+            return 1;
+        }
+        std::string name = std::to_string(getpid());
+        Logger::instance().init(config.log_dir, "backtest_worker_" + name + ".log");
+        if (config.tick_store_dir.empty()) {
+            LOG_ERROR("Config: tick_store_dir is required for backtest workers");
+            return 1;
+        }
+        // Strategy logging per simulated trade would dominate the run time
+        Logger::instance().set_level(Logger::Level::WARNING);
+        char host[256] = {};
+        gethostname(host, sizeof(host) - 1);
+        bool ok = run_worker(endpoint.substr(0, colon),
+                             static_cast<uint16_t>(std::stoi(endpoint.substr(colon + 1))),
+                             config, std::string(host) + ":" + name);
+        return ok ? 0 : 1;
+    }
+    
+    usage();
+    return 1;
+}
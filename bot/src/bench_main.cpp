@@ -0,0 +1,541 @@
+#include "config.hpp"
+#include "logger.hpp"
+#include "state.hpp"
+#include "kraken_client.hpp"
+#include "market_data.hpp"
+#include "strategy.hpp"
+#include "indicator_kernels.hpp"
+#include "tick_store.hpp"
+#include "tick_archive.hpp"
+#include "backtest.hpp"
+#include "http_recording.hpp"
+#include "replay_workload.hpp"
+#include "tick_arena.hpp"
+#include "l3_book.hpp"
+#include "util.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+// Fixed, seeded workload over the bot's hot paths, used to train and to
+// measure profile-guided builds.
+//
+//   trading_bench [config.json] [--ticks N] [--backtest-ticks N]
+//                 [--recording session.http] [--l3-events N]
+//                 [--archive-ticks N] [--seed S]
+//
+// Phases:
+//   parse      public responses replayed through KrakenClient (the recording
+//              if given, else a synthetic session)
+//   tick       one live tick per iteration: refresh, evaluate, log, execute
+//              and persist state, on a simulated clock
+//   indicators batch kernels over one long price series
+//   backtest   run_backtest over synthetic recorded ticks
+//   l3         order-by-order book replay: adds, modifies and deletes
+//              around a drifting mid, plus queue-position lookups
+//   archive    cold-tier encode and decode of polled ticks, with prices on
+//              a 0.1 grid (fixed point) and off it (XOR)
+//
+// Nothing touches the network; logs and state go to a scratch directory
+// that is removed afterwards.
+
+static double percentile(std::vector<double> values, double q) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    size_t k = std::min(values.size() - 1, static_cast<size_t>(q * static_cast<double>(values.size())));
+    std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(k), values.end());
+    return values[k];
+}
+
+static double elapsed_ns(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Latencies in ns per operation plus an optional throughput figure
+static void print_row(const std::string& name, const std::vector<double>& ns, double rate, const char* unit) {
+    double total = 0.0;
+    for (double v : ns) {
+        total += v;
+    }
+    double mean = ns.empty() ? 0.0 : total / static_cast<double>(ns.size());
+    std::printf("%-24s %10zu %10.2f %10.2f %10.2f %12.1f %s\n", name.c_str(), ns.size(), mean / 1e3,
+                percentile(ns, 0.50) / 1e3, percentile(ns, 0.99) / 1e3, rate, unit);
+}
+
+// Settings every run forces: dry run, no side channels, no real network
+static const nlohmann::json kBenchOverrides = {
+    {"dry_run", true},
+    {"scanner_enabled", false},
+    {"failover_enabled", false},
+    {"paper_engine_enabled", false},
+    {"market_data_source", "rest"},
+    {"tick_store_dir", ""},
+    {"ledger_file", ""},
+    {"fault_schedule_file", ""},
+    {"http_record_file", ""},
+    {"http_replay_file", ""},
+    {"kraken_api_base", "http://replay"},
+    {"poll_interval_seconds", 1}
+};
+
+// Without a config file: short windows and no cooldown so the random walk
+// trades often and every branch of the strategy runs
+static const nlohmann::json kDefaultStrategy = {
+    {"trend_window_short", 5},
+    {"trend_window_long", 20},
+    {"atr_window", 14},
+    {"min_atr_pct", 0.0},
+    {"require_trend_up", false},
+    {"cooldown_seconds", 0},
+    {"max_trades_per_day", 1000000},
+    {"rebuy_reset_pct", 0.0},
+    {"max_spread_pct", 0.01},
+    {"stale_price_seconds", 5}
+};
+
+static void bench_parse(const std::vector<HttpRecord>& records, const std::string& quote) {
+    KrakenClient client("http://replay", 0);
+    EndpointPolicy policy;
+    policy.max_retries = 0;
+    policy.failure_threshold = INT_MAX;
+    client.set_endpoint_policy(policy);
+    client.set_transport(std::make_unique<ReplayTransport>(records, 0.0, true));
+
+    std::map<std::string, std::vector<double>> latencies;
+    std::map<std::string, uint64_t> bytes;
+    for (const HttpRecord& r : records) {
+        if (r.response.cancelled) {
+            continue;
+        }
+        auto start = std::chrono::steady_clock::now();
+        if (!replay_public_call(client, r, quote)) {
+            continue;
+        }
+        std::string name = "parse " + record_path(r.target).substr(record_path(r.target).rfind('/') + 1);
+        latencies[name].push_back(elapsed_ns(start));
+        bytes[name] += r.response.body.size();
+    }
+    for (auto& [name, ns] : latencies) {
+        double total = 0.0;
+        for (double v : ns) {
+            total += v;
+        }
+        print_row(name, ns, static_cast<double>(bytes[name]) / (total / 1e9) / 1e6, "MB/s");
+    }
+}
+
+static void bench_ticks(const Config& config, size_t ticks, uint64_t seed, const std::string& state_path) {
+    std::vector<HttpRecord> session = synthetic_http_session(config.pair, ticks, seed, 90000.0, 1, 1);
+    std::vector<HttpRecord> tickers;
+    for (HttpRecord& r : session) {
+        if (record_path(r.target) == "/0/public/Ticker") {
+            tickers.push_back(std::move(r));
+        }
+    }
+
+    KrakenClient client(config.kraken_api_base, 0);
+    EndpointPolicy policy = config.endpoint_policy();
+    policy.max_retries = 0;
+    policy.failure_threshold = INT_MAX;
+    client.set_endpoint_policy(policy);
+    const int64_t first_ns = tickers.front().start_ns;
+    client.set_transport(std::make_unique<ReplayTransport>(std::move(tickers), 0.0));
+
+    TradingState state = TradingState::default_state();
+    MarketDataCache market_data(client);
+    market_data.track(config.pair);
+    Strategy strategy(config, state, client, market_data);
+    util::set_sim_time_ns(first_ns);
+    state.trades_date_yyyy_mm_dd = util::today_yyyy_mm_dd();
+    strategy.init_simulation(config.sim_initial_cad);
+
+    // Same arena setup as the trading loop; tick_arena_bytes 0 measures
+    // the heap-only path
+    std::unique_ptr<TickArena> arena;
+    if (config.tick_arena_bytes > 0) {
+        arena = std::make_unique<TickArena>(static_cast<size_t>(config.tick_arena_bytes));
+    }
+    
+    std::vector<double> latencies;
+    latencies.reserve(ticks);
+    double arena_bytes = 0.0;
+    int trades = 0;
+    for (size_t i = 0; i < ticks; i++) {
+        util::set_sim_time_ns(first_ns + static_cast<int64_t>(i) * config.poll_interval_seconds * 1'000'000'000);
+        auto start = std::chrono::steady_clock::now();
+        {
+            std::optional<TickArena::Scope> tick_scope;
+            if (arena) {
+                tick_scope.emplace(*arena);
+            }
+            market_data.refresh();
+            TradeContext ctx = strategy.evaluate();
+            ctx.log();
+            if ((ctx.decision == Decision::BUY || ctx.decision == Decision::SELL) && strategy.execute(ctx)) {
+                trades++;
+            }
+            state.save(state_path);
+        }
+        latencies.push_back(elapsed_ns(start));
+        if (arena) {
+            arena_bytes += static_cast<double>(arena->stats().last_tick_bytes);
+        }
+    }
+    util::clear_sim_time();
+
+    double total = 0.0;
+    for (double v : latencies) {
+        total += v;
+    }
+    print_row("tick (" + std::to_string(trades) + " trades)", latencies,
+              static_cast<double>(ticks) / (total / 1e9), "ticks/s");
+    if (arena) {
+        const TickArenaStats& a = arena->stats();
+        std::printf("%-24s %10llu %10.0f bytes/tick mean, %zu high water of %zu, %llu overflowed\n", "tick arena",
+                    static_cast<unsigned long long>(a.ticks), arena_bytes / static_cast<double>(ticks),
+                    a.high_water_bytes, a.capacity, static_cast<unsigned long long>(a.overflow_ticks));
+    }
+}
+
+static void bench_indicators(size_t n, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::normal_distribution<double> step(0.0, 0.001);
+    std::vector<double> price(n);
+    double p = 90000.0;
+    for (double& v : price) {
+        p *= 1.0 + step(rng);
+        v = p;
+    }
+
+    std::vector<double> tr(n), atr(n), fast(n), slow(n), lo(n), hi(n);
+    std::vector<int8_t> cross(n);
+    std::vector<double> latencies;
+    for (int pass = 0; pass < 5; pass++) {
+        auto start = std::chrono::steady_clock::now();
+        kernels::true_range(price.data(), n, tr.data());
+        kernels::rolling_sum(tr.data(), n, 14, atr.data());
+        kernels::ema(price.data(), n, 2.0 / 13.0, fast.data());
+        kernels::ema(price.data(), n, 2.0 / 27.0, slow.data());
+        kernels::rolling_min(price.data(), n, 50, lo.data());
+        kernels::rolling_max(price.data(), n, 50, hi.data());
+        kernels::crossovers(fast.data(), slow.data(), n, cross.data());
+        latencies.push_back(elapsed_ns(start));
+    }
+    double best = *std::min_element(latencies.begin(), latencies.end());
+    print_row("indicators (" + kernels::isa_name(kernels::active_isa()) + ")", latencies,
+              static_cast<double>(n) / (best / 1e9) / 1e6, "M points/s");
+}
+
+static void bench_backtest(const Config& config, size_t ticks, uint64_t seed, const std::string& dir) {
+    std::mt19937_64 rng(seed);
+    std::normal_distribution<double> step(0.0, 0.0015);
+    const int64_t start_ns = 1749945600LL * 1'000'000'000;
+    {
+        TickStoreWriter writer(dir, config.pair);
+        double p = 90000.0;
+        for (size_t i = 0; i < ticks; i++) {
+            p *= 1.0 + step(rng);
+            StoredTick tick{};
+            tick.exchange_ns = start_ns + static_cast<int64_t>(i) * 1'000'000'000;
+            tick.receive_ns = tick.exchange_ns;
+            tick.last_price = p;
+            tick.bid_price = p * 0.9998;
+            tick.ask_price = p * 1.0002;
+            writer.append(tick);
+        }
+    }
+
+    TickStoreReader reader(dir, config.pair);
+    BacktestJob job;
+    job.pair = config.pair;
+    job.start_ns = start_ns;
+    job.end_ns = start_ns + static_cast<int64_t>(ticks) * 1'000'000'000;
+
+    std::vector<double> latencies;
+    BacktestResult result;
+    for (int pass = 0; pass < 3; pass++) {
+        auto start = std::chrono::steady_clock::now();
+        result = run_backtest(config, reader, job);
+        latencies.push_back(elapsed_ns(start));
+    }
+    if (!result.success) {
+        std::cerr << "trading_bench: backtest failed: " << result.error << std::endl;
+        return;
+    }
+    double best = *std::min_element(latencies.begin(), latencies.end());
+    print_row("backtest (" + std::to_string(result.round_trips) + " round trips)", latencies,
+              static_cast<double>(result.ticks) / (best / 1e9) / 1e6, "M ticks/s");
+}
+
+struct L3Event {
+    enum class Kind : uint8_t { Add, Modify, Delete } kind;
+    bool bid;
+    uint64_t id;
+    double price;
+    double volume;
+};
+
+// Synthetic order-level stream on a 0.1 tick grid with most activity within
+// 50 ticks of the touch; adds and deletes balance around 5000 resting orders
+static std::vector<L3Event> synthetic_l3_events(size_t n, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> u(0.0, 1.0);
+    std::geometric_distribution<int> depth(0.08);
+    std::vector<L3Event> events;
+    events.reserve(n);
+    std::vector<uint64_t> live;
+    std::vector<double> live_price;
+    uint64_t next_id = 1;
+    double mid = 900000.0;
+    while (events.size() < n) {
+        if (u(rng) < 0.01) {
+            mid += u(rng) < 0.5 ? -1.0 : 1.0;
+        }
+        double r = u(rng);
+        double add_share = live.size() < 5000 ? 0.45 : 0.35;
+        if (r < add_share) {
+            bool bid = u(rng) < 0.5;
+            double ticks = 1.0 + depth(rng);
+            double price = (bid ? mid - ticks : mid + ticks) / 10.0;
+            live.push_back(next_id);
+            live_price.push_back(price);
+            events.push_back({L3Event::Kind::Add, bid, next_id++, price, 0.001 + u(rng) * u(rng) * 2.0});
+        } else {
+            if (live.empty()) {
+                continue;
+            }
+            size_t k = static_cast<size_t>(u(rng) * static_cast<double>(live.size()));
+            if (r < add_share + 0.2) {
+                // A fifth of amendments move the order a tick
+                if (u(rng) < 0.2) {
+                    live_price[k] += u(rng) < 0.5 ? -0.1 : 0.1;
+                }
+                events.push_back({L3Event::Kind::Modify, false, live[k], live_price[k], 0.001 + u(rng)});
+            } else {
+                events.push_back({L3Event::Kind::Delete, false, live[k], 0.0, 0.0});
+                live[k] = live.back();
+                live_price[k] = live_price.back();
+                live.pop_back();
+                live_price.pop_back();
+            }
+        }
+    }
+    return events;
+}
+
+static void bench_l3(size_t n, uint64_t seed) {
+    std::vector<L3Event> events = synthetic_l3_events(n, seed);
+    std::vector<double> latencies;
+    L3Book book(1.5, 8192);
+    double ahead = 0.0;
+    for (int pass = 0; pass < 5; pass++) {
+        book.clear();
+        auto start = std::chrono::steady_clock::now();
+        for (const L3Event& e : events) {
+            switch (e.kind) {
+            case L3Event::Kind::Add:
+                book.add(e.id, e.bid, e.price, e.volume);
+                break;
+            case L3Event::Kind::Modify:
+                book.modify(e.id, e.price, e.volume);
+                break;
+            case L3Event::Kind::Delete:
+                book.remove(e.id);
+                break;
+            }
+        }
+        latencies.push_back(elapsed_ns(start));
+        book.take_large_cancels();
+    }
+    double best = *std::min_element(latencies.begin(), latencies.end());
+    print_row("l3 replay (" + std::to_string(book.order_count()) + " orders)", latencies,
+              static_cast<double>(n) / (best / 1e9) / 1e6, "M events/s");
+
+    // Queue position of every order still resting, as a resting order of
+    // our own would be looked up each tick
+    std::vector<uint64_t> resting;
+    for (const L3Event& e : events) {
+        if (e.kind == L3Event::Kind::Add && book.queue_position(e.id).found) {
+            resting.push_back(e.id);
+        }
+    }
+    std::vector<double> lookups;
+    for (int pass = 0; pass < 5; pass++) {
+        auto start = std::chrono::steady_clock::now();
+        for (uint64_t id : resting) {
+            ahead += book.queue_position(id).volume_ahead;
+        }
+        lookups.push_back(elapsed_ns(start));
+    }
+    best = *std::min_element(lookups.begin(), lookups.end());
+    char label[64];
+    std::snprintf(label, sizeof(label), "l3 queue (%.2f ahead)",
+                  resting.empty() ? 0.0 : ahead / static_cast<double>(5 * resting.size()));
+    print_row(label, lookups, static_cast<double>(resting.size()) / (best / 1e9) / 1e6, "M lookups/s");
+}
+
+static void bench_archive(size_t n, uint64_t seed, const std::string& dir) {
+    std::mt19937_64 rng(seed);
+    std::normal_distribution<double> step(0.0, 0.0005);
+    std::normal_distribution<double> jitter_ms(0.0, 30.0);
+    std::vector<StoredTick> ticks(n);
+    int64_t ns = 1749945600LL * 1'000'000'000;
+    double p = 90000.0;
+    for (StoredTick& tick : ticks) {
+        // One poll a second with scheduling jitter; the quote arrives
+        // 40-100 ms after its exchange time
+        ns += 1'000'000'000 + static_cast<int64_t>(jitter_ms(rng) * 1e6);
+        p *= 1.0 + step(rng);
+        double last = std::round(p * 10.0) / 10.0;
+        tick.exchange_ns = ns;
+        tick.receive_ns = ns + 40'000'000 + static_cast<int64_t>(rng() % 60'000'000);
+        tick.last_price = last;
+        tick.bid_price = std::round(last * 10.0 - static_cast<double>(rng() % 3)) / 10.0;
+        tick.ask_price = std::round(last * 10.0 + static_cast<double>(1 + rng() % 3)) / 10.0;
+    }
+
+    for (bool fixed : {true, false}) {
+        if (!fixed) {
+            // Prices no decimal grid captures, as from a computed mid
+            for (StoredTick& tick : ticks) {
+                tick.bid_price = tick.last_price * 0.99987;
+                tick.ask_price = tick.last_price * 1.00013;
+            }
+        }
+        const std::string path = (std::filesystem::path(dir) / (fixed ? "bench.1.cold" : "bench.2.cold")).string();
+        std::string error;
+        ColdSegmentInfo info;
+        std::vector<double> encode;
+        for (int pass = 0; pass < 3; pass++) {
+            auto start = std::chrono::steady_clock::now();
+            if (!write_cold_segment(path, "BENCH", ticks.data(), ticks.data() + ticks.size(), &info, &error)) {
+                std::cerr << "trading_bench: archive encode failed: " << error << std::endl;
+                return;
+            }
+            encode.push_back(elapsed_ns(start));
+        }
+        std::vector<double> decode;
+        std::vector<StoredTick> out;
+        out.reserve(n);
+        for (int pass = 0; pass < 5; pass++) {
+            out.clear();
+            auto start = std::chrono::steady_clock::now();
+            if (!read_cold_segment(path, out, nullptr, &error)) {
+                std::cerr << "trading_bench: archive decode failed: " << error << std::endl;
+                return;
+            }
+            decode.push_back(elapsed_ns(start));
+        }
+        if (out.size() != n || std::memcmp(out.data(), ticks.data(), n * sizeof(StoredTick)) != 0) {
+            std::cerr << "trading_bench: archive round trip differs" << std::endl;
+            return;
+        }
+        const double raw_bytes = static_cast<double>(n * sizeof(StoredTick));
+        char label[64];
+        std::snprintf(label, sizeof(label), "archive %s enc (%.1fx)", fixed ? "fixed" : "xor",
+                      raw_bytes / static_cast<double>(info.bytes));
+        double best = *std::min_element(encode.begin(), encode.end());
+        print_row(label, encode, static_cast<double>(n) / (best / 1e9) / 1e6, "M ticks/s");
+        std::snprintf(label, sizeof(label), "archive %s decode", fixed ? "fixed" : "xor");
+        best = *std::min_element(decode.begin(), decode.end());
+        print_row(label, decode, raw_bytes / (best / 1e9) / 1e9, "GB/s decoded");
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::string config_file;
+    std::string recording;
+    size_t ticks = 20000;
+    size_t backtest_ticks = 500000;
+    size_t l3_events = 2000000;
+    size_t archive_ticks = 2000000;
+    uint64_t seed = 42;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--ticks" && i + 1 < argc) {
+            ticks = std::stoul(argv[++i]);
+        } else if (arg == "--backtest-ticks" && i + 1 < argc) {
+            backtest_ticks = std::stoul(argv[++i]);
+        } else if (arg == "--recording" && i + 1 < argc) {
+            recording = argv[++i];
+        } else if (arg == "--archive-ticks" && i + 1 < argc) {
+            archive_ticks = std::stoul(argv[++i]);
+        } else if (arg == "--l3-events" && i + 1 < argc) {
+            l3_events = std::stoul(argv[++i]);
+        } else if (arg == "--seed" && i + 1 < argc) {
+            seed = std::stoull(argv[++i]);
+        } else if (arg.rfind("--", 0) == 0) {
+            std::cerr << "Usage: trading_bench [config.json] [--ticks N] [--backtest-ticks N] "
+                         "[--recording session.http] [--l3-events N] [--archive-ticks N] [--seed S]" << std::endl;
+            return 1;
+        } else {
+            config_file = arg;
+        }
+    }
+    if (ticks == 0) {
+        std::cerr << "trading_bench: --ticks must be positive" << std::endl;
+        return 1;
+    }
+
+    const std::filesystem::path scratch = std::filesystem::temp_directory_path() /
+                                          ("trading_bench." + std::to_string(getpid()));
+    Config config;
+    std::vector<HttpRecord> records;
+    try {
+        if (config_file.empty()) {
+            config.apply(kDefaultStrategy);
+        } else {
+            config = Config::load(config_file);
+        }
+        config.apply(kBenchOverrides);
+        config.state_file = (scratch / "state.json").string();
+        config.log_dir = (scratch / "logs").string();
+        if (!recording.empty()) {
+            records = read_http_records(recording);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "trading_bench: " << e.what() << std::endl;
+        return 1;
+    }
+    if (!config.validate()) {
+        std::cerr << "trading_bench: invalid config" << std::endl;
+        return 1;
+    }
+    if (records.empty()) {
+        records = synthetic_http_session(config.pair, ticks / 4, seed);
+    }
+
+    std::filesystem::create_directories(scratch / "ticks");
+    Logger::instance().init(config.log_dir, "bench.log");
+    Logger::instance().set_console(false);
+
+    std::printf("%-24s %10s %10s %10s %10s %12s\n", "phase", "ops", "mean us", "p50 us", "p99 us", "rate");
+    bench_parse(records, config.scanner_quote);
+    bench_ticks(config, ticks, seed, config.state_file);
+    bench_indicators(1 << 20, seed);
+    bench_backtest(config, backtest_ticks, seed, (scratch / "ticks").string());
+    if (l3_events > 0) {
+        bench_l3(l3_events, seed);
+    }
+    if (archive_ticks > 0) {
+        bench_archive(archive_ticks, seed, scratch.string());
+    }
+
+    std::error_code ec;
+    std::filesystem::remove_all(scratch, ec);
+    return 0;
+}
@@ -0,0 +1,200 @@
+#include "circuit_breaker.hpp"
+#include "logger.hpp"
+#include "util.hpp"
+#include <algorithm>
+
+static constexpr size_t kLatencySamples = 256;
+static constexpr size_t kMinHedgeSamples = 20;
+static constexpr double kMaxRetryTokens = 10.0;
+
+std::string endpoint_class_to_string(EndpointClass cls) {
+    switch (cls) {
+        case EndpointClass::MARKET_DATA: return "market_data";
+        case EndpointClass::REFERENCE:   return "reference";
+        case EndpointClass::PRIVATE:     return "private";
+        default:                         return "unknown";
+    }
+}
+
+EndpointClass classify_endpoint(const std::string& url) {
+    if (url.find("/0/private/") != std::string::npos) {
+        return EndpointClass::PRIVATE;
+    }
+    for (const char* method : {"/0/public/Ticker", "/0/public/Depth", "/0/public/Trades", "/0/public/Spread",
+                               "/0/public/OHLC"}) {
+        if (url.find(method) != std::string::npos) {
+            return EndpointClass::MARKET_DATA;
+        }
+    }
+    return EndpointClass::REFERENCE;
+}
+
+std::string breaker_state_to_string(BreakerState state) {
+    switch (state) {
+        case BreakerState::CLOSED:    return "closed";
+        case BreakerState::OPEN:      return "open";
+        case BreakerState::HALF_OPEN: return "half-open";
+        default:                      return "unknown";
+    }
+}
+
+CircuitBreaker::CircuitBreaker(EndpointClass cls, const EndpointPolicy& policy)
+    : cls_(cls)
+    , policy_(policy)
+    , last_refill_(Clock::now())
+    , tokens_(kMaxRetryTokens / 2) {
+    metrics_.name = endpoint_class_to_string(cls);
+    latencies_.reserve(kLatencySamples);
+}
+
+void CircuitBreaker::set_policy(const EndpointPolicy& policy) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    policy_ = policy;
+}
+
+void CircuitBreaker::open(Clock::time_point now) {
+    current_open_ms_ = current_open_ms_ == 0 ? policy_.open_ms
+                                             : std::min(current_open_ms_ * 2, policy_.max_open_ms);
+    state_ = BreakerState::OPEN;
+    open_until_ = now + std::chrono::milliseconds(current_open_ms_);
+    probe_in_flight_ = false;
+    metrics_.trips++;
+    LOG_WARNING("Circuit breaker " + metrics_.name + " open for " + std::to_string(current_open_ms_) +
+                "ms after " + std::to_string(consecutive_failures_) + " consecutive failures");
+}
+
+bool CircuitBreaker::allow() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto now = Clock::now();
+
+    if (state_ == BreakerState::OPEN) {
+        if (now < open_until_) {
+            metrics_.short_circuited++;
+            return false;
+        }
+        state_ = BreakerState::HALF_OPEN;
+        LOG_INFO("Circuit breaker " + metrics_.name + " half-open, probing");
+    }
+    if (state_ == BreakerState::HALF_OPEN) {
+        if (probe_in_flight_) {
+            metrics_.short_circuited++;
+            return false;
+        }
+        probe_in_flight_ = true;
+    }
+
+    // Each admitted request earns a fraction of a retry
+    refill(now);
+    tokens_ = std::min(kMaxRetryTokens, tokens_ + policy_.retry_budget_ratio);
+    return true;
+}
+
+void CircuitBreaker::record_success(double latency_ms) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    metrics_.requests++;
+    metrics_.successes++;
+
+    if (state_ != BreakerState::CLOSED) {
+        LOG_INFO("Circuit breaker " + metrics_.name + " closed");
+    }
+    state_ = BreakerState::CLOSED;
+    probe_in_flight_ = false;
+    consecutive_failures_ = 0;
+    current_open_ms_ = 0;
+    current_backoff_ms_ = 0;
+    next_allowed_ = Clock::time_point{};
+
+    if (latencies_.size() < kLatencySamples) {
+        latencies_.push_back(latency_ms);
+    } else {
+        latencies_[latency_next_] = latency_ms;
+    }
+    latency_next_ = (latency_next_ + 1) % kLatencySamples;
+}
+
+void CircuitBreaker::record_failure() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto now = Clock::now();
+    metrics_.requests++;
+    metrics_.failures++;
+    consecutive_failures_++;
+
+    // Exponential backoff with 0-50% jitter, for this class only
+    current_backoff_ms_ = current_backoff_ms_ == 0 ? policy_.initial_backoff_ms
+                                                   : std::min(current_backoff_ms_ * 2, policy_.max_backoff_ms);
+    int64_t backoff = current_backoff_ms_ + util::random_jitter_ms(current_backoff_ms_ / 2);
+    next_allowed_ = now + std::chrono::milliseconds(backoff);
+    LOG_WARNING("Backoff " + metrics_.name + ": " + std::to_string(backoff) + "ms (consecutive failures: " +
+                std::to_string(consecutive_failures_) + ")");
+
+    if (state_ == BreakerState::HALF_OPEN ||
+        (state_ == BreakerState::CLOSED && consecutive_failures_ >= policy_.failure_threshold)) {
+        open(now);
+    }
+}
+
+void CircuitBreaker::refill(Clock::time_point now) {
+    double elapsed = std::chrono::duration<double>(now - last_refill_).count();
+    last_refill_ = now;
+    tokens_ = std::min(kMaxRetryTokens, tokens_ + elapsed * policy_.retry_budget_min_per_sec);
+}
+
+bool CircuitBreaker::try_spend_retry() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    refill(Clock::now());
+    if (tokens_ < 1.0) {
+        return false;
+    }
+    tokens_ -= 1.0;
+    return true;
+}
+
+void CircuitBreaker::count_retry() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    metrics_.retries++;
+}
+
+void CircuitBreaker::count_hedge(bool won) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    metrics_.hedges++;
+    if (won) {
+        metrics_.hedge_wins++;
+    }
+}
+
+int64_t CircuitBreaker::wait_ms() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(next_allowed_ - Clock::now()).count();
+    return std::max<int64_t>(0, remaining);
+}
+
+double CircuitBreaker::latency_quantile(double q) const {
+    if (latencies_.empty()) {
+        return 0.0;
+    }
+    std::vector<double> sorted = latencies_;
+    size_t k = std::min(sorted.size() - 1, static_cast<size_t>(q * static_cast<double>(sorted.size())));
+    std::nth_element(sorted.begin(), sorted.begin() + static_cast<std::ptrdiff_t>(k), sorted.end());
+    return sorted[k];
+}
+
+int64_t CircuitBreaker::hedge_delay_ms() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!policy_.hedge || cls_ != EndpointClass::MARKET_DATA || latencies_.size() < kMinHedgeSamples) {
+        return 0;
+    }
+    // Hedge the slowest ~5% of requests
+    return std::max(policy_.hedge_min_delay_ms, static_cast<int64_t>(latency_quantile(0.95)));
+}
+
+EndpointMetrics CircuitBreaker::metrics() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    EndpointMetrics m = metrics_;
+    m.state = state_;
+    m.latency_p50_ms = latency_quantile(0.50);
+    m.latency_p99_ms = latency_quantile(0.99);
+    m.backoff_ms = std::max<int64_t>(0, std::chrono::duration_cast<std::chrono::milliseconds>(
+                                            next_allowed_ - Clock::now()).count());
+    m.retry_tokens = tokens_;
+    return m;
+}
@@ -0,0 +1,118 @@
+#ifndef CIRCUIT_BREAKER_HPP
+#define CIRCUIT_BREAKER_HPP
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <chrono>
+#include <cstdint>
+
+// Kraken endpoints grouped by how they fail and whether they are safe to repeat
+enum class EndpointClass {
+    MARKET_DATA,   // Public Ticker/Depth/Trades: idempotent, latency-sensitive
+    REFERENCE,     // Public AssetPairs/Time: idempotent, rare
+    PRIVATE        // Signed POSTs: never retried or hedged (orders are not idempotent)
+};
+
+constexpr size_t kEndpointClassCount = 3;
+
+std::string endpoint_class_to_string(EndpointClass cls);
+
+// Classify by URL path (/0/public/<method> or /0/private/<method>)
+EndpointClass classify_endpoint(const std::string& url);
+
+enum class BreakerState {
+    CLOSED,
+    OPEN,
+    HALF_OPEN
+};
+
+std::string breaker_state_to_string(BreakerState state);
+
+struct EndpointPolicy {
+    int max_retries = 2;                 // Per request, idempotent classes only
+    int64_t initial_backoff_ms = 1000;
+    int64_t max_backoff_ms = 30000;
+    int failure_threshold = 5;           // Consecutive failures that open the breaker
+    int64_t open_ms = 5000;              // First cool-down; doubles on each failed probe
+    int64_t max_open_ms = 60000;
+    double retry_budget_ratio = 0.2;     // Retry/hedge tokens earned per request
+    double retry_budget_min_per_sec = 0.5; // Tokens that trickle in regardless
+    bool hedge = false;                  // Hedge slow requests (market data only)
+    int64_t hedge_min_delay_ms = 250;
+};
+
+struct EndpointMetrics {
+    std::string name;
+    BreakerState state = BreakerState::CLOSED;
+    uint64_t requests = 0;               // Attempts sent, including retries and hedges
+    uint64_t successes = 0;
+    uint64_t failures = 0;
+    uint64_t retries = 0;
+    uint64_t hedges = 0;
+    uint64_t hedge_wins = 0;             // Hedge answered first
+    uint64_t short_circuited = 0;        // Rejected while open
+    uint64_t trips = 0;                  // CLOSED/HALF_OPEN -> OPEN transitions
+    double latency_p50_ms = 0.0;
+    double latency_p99_ms = 0.0;
+    int64_t backoff_ms = 0;              // Current wait before the next attempt
+    double retry_tokens = 0.0;
+};
+
+// Per-endpoint-class breaker, backoff and retry budget. Failures of one class
+// only delay and short-circuit requests of that class.
+class CircuitBreaker {
+public:
+    CircuitBreaker(EndpointClass cls, const EndpointPolicy& policy);
+
+    void set_policy(const EndpointPolicy& policy);
+    const EndpointPolicy& policy() const { return policy_; }
+
+    // False while open; after the cool-down lets one probe through (half-open)
+    bool allow();
+
+    void record_success(double latency_ms);
+    void record_failure();
+
+    // Spend one retry/hedge token; false when the budget is exhausted
+    bool try_spend_retry();
+    void count_retry();
+    void count_hedge(bool won);
+
+    // Milliseconds until this class may send again (backoff after failures)
+    int64_t wait_ms() const;
+
+    // Hedge once the primary has been outstanding this long; 0 = no hedging
+    // yet (too few latency samples)
+    int64_t hedge_delay_ms() const;
+
+    EndpointMetrics metrics() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void open(Clock::time_point now);
+    void refill(Clock::time_point now);
+    double latency_quantile(double q) const;
+
+    EndpointClass cls_;
+    EndpointPolicy policy_;
+
+    mutable std::mutex mutex_;
+    BreakerState state_ = BreakerState::CLOSED;
+    int consecutive_failures_ = 0;
+    int64_t current_open_ms_ = 0;
+    int64_t current_backoff_ms_ = 0;
+    bool probe_in_flight_ = false;
+    Clock::time_point open_until_{};
+    Clock::time_point next_allowed_{};
+    Clock::time_point last_refill_;
+    double tokens_ = 0.0;
+
+    std::vector<double> latencies_;      // Ring of recent successful latencies
+    size_t latency_next_ = 0;
+
+    EndpointMetrics metrics_;
+};
+
+#endif // CIRCUIT_BREAKER_HPP
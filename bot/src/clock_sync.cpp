@@ -0,0 +1,133 @@
+#include "clock_sync.hpp"
+#include "logger.hpp"
+#include <algorithm>
+#include <limits>
+#include <sstream>
+#include <iomanip>
+
+// Uncertainty required before an estimate can anchor the drift baseline
+static constexpr int64_t kDriftReferenceNs = 50'000'000;
+// Minimum baseline before drift is reported
+static constexpr int64_t kDriftBaselineNs = 60'000'000'000;
+
+ClockSync::ClockSync(size_t window)
+    : window_(std::max<size_t>(window, 2)) {
+}
+
+void ClockSync::add_sample(const ClockSample& sample) {
+    if (sample.recv_ns < sample.send_ns || sample.server_ns <= 0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // Offset interval implied by this sample alone
+    int64_t lower = sample.server_ns - sample.recv_ns;
+    int64_t upper = sample.server_ns + sample.server_resolution_ns - sample.send_ns;
+
+    if (synced_ && (lower > upper_ns_ || upper < lower_ns_)) {
+        LOG_WARNING("Clock sync: sample disagrees with window, restarting estimate");
+        samples_.clear();
+        reference_local_ns_ = 0;
+        drift_ppm_ = 0.0;
+    }
+
+    samples_.push_back(sample);
+    while (samples_.size() > window_) {
+        samples_.pop_front();
+    }
+    last_rtt_ns_ = sample.recv_ns - sample.send_ns;
+    recompute();
+}
+
+void ClockSync::recompute() {
+    int64_t lower = std::numeric_limits<int64_t>::min();
+    int64_t upper = std::numeric_limits<int64_t>::max();
+    int64_t min_rtt = std::numeric_limits<int64_t>::max();
+
+    for (const auto& s : samples_) {
+        lower = std::max(lower, s.server_ns - s.recv_ns);
+        upper = std::min(upper, s.server_ns + s.server_resolution_ns - s.send_ns);
+        min_rtt = std::min(min_rtt, s.recv_ns - s.send_ns);
+    }
+
+    if (lower > upper) {
+        // Window became inconsistent through drift; keep only the newest sample
+        ClockSample newest = samples_.back();
+        samples_.clear();
+        samples_.push_back(newest);
+        lower = newest.server_ns - newest.recv_ns;
+        upper = newest.server_ns + newest.server_resolution_ns - newest.send_ns;
+        min_rtt = newest.recv_ns - newest.send_ns;
+        reference_local_ns_ = 0;
+    }
+
+    lower_ns_ = lower;
+    upper_ns_ = upper;
+    min_rtt_ns_ = min_rtt;
+    synced_ = true;
+
+    // Drift: how far the offset estimate moved since the first reference,
+    // taken once the interval is narrow enough to be meaningful
+    const int64_t offset = lower + (upper - lower) / 2;
+    const int64_t now_local = samples_.back().recv_ns;
+    if (reference_local_ns_ == 0 && (upper - lower) / 2 <= kDriftReferenceNs) {
+        reference_local_ns_ = now_local;
+        reference_offset_ns_ = offset;
+    }
+    if (reference_local_ns_ != 0 && now_local - reference_local_ns_ >= kDriftBaselineNs) {
+        drift_ppm_ = static_cast<double>(offset - reference_offset_ns_) /
+                     static_cast<double>(now_local - reference_local_ns_) * 1e6;
+    }
+}
+
+bool ClockSync::synced() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return synced_;
+}
+
+int64_t ClockSync::offset_ns() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return synced_ ? lower_ns_ + (upper_ns_ - lower_ns_) / 2 : 0;
+}
+
+int64_t ClockSync::uncertainty_ns() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return synced_ ? (upper_ns_ - lower_ns_) / 2 : 0;
+}
+
+int64_t ClockSync::rtt_ns() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return synced_ ? min_rtt_ns_ : 0;
+}
+
+int64_t ClockSync::last_rtt_ns() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return last_rtt_ns_;
+}
+
+double ClockSync::drift_ppm() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return drift_ppm_;
+}
+
+size_t ClockSync::sample_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return samples_.size();
+}
+
+int64_t ClockSync::to_exchange_ns(int64_t local_ns) const {
+    return local_ns + offset_ns();
+}
+
+void ClockSync::log_status() const {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(3);
+    oss << "Clock sync | samples=" << sample_count()
+        << " | offset=" << (static_cast<double>(offset_ns()) / 1e6) << "ms"
+        << " | +/-" << (static_cast<double>(uncertainty_ns()) / 1e6) << "ms"
+        << " | min_rtt=" << (static_cast<double>(rtt_ns()) / 1e6) << "ms"
+        << " | last_rtt=" << (static_cast<double>(last_rtt_ns()) / 1e6) << "ms"
+        << " | drift=" << drift_ppm() << "ppm";
+    LOG_INFO(oss.str());
+}
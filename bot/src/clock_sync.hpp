@@ -0,0 +1,61 @@
+#ifndef CLOCK_SYNC_HPP
+#define CLOCK_SYNC_HPP
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+
+// One request/response exchange with a server timestamp
+struct ClockSample {
+    int64_t send_ns = 0;          // Local epoch ns when the request left
+    int64_t recv_ns = 0;          // Local epoch ns when the first response byte arrived
+    int64_t server_ns = 0;        // Server timestamp, truncated to server_resolution_ns
+    int64_t server_resolution_ns = 0;
+};
+
+// Estimates the offset between the local clock and Kraken's clock.
+//
+// Each sample bounds the offset: the server stamped its reply somewhere in
+// [send, recv] local time, and the true server time lies in
+// [server, server + resolution). Intersecting those intervals over a sliding
+// window narrows the estimate well below the one-second resolution of
+// /0/public/Time. An empty intersection means one of the clocks stepped, so
+// the window restarts from the newest sample. Drift is the change of the
+// offset estimate per unit of local time since the first narrow estimate.
+class ClockSync {
+public:
+    explicit ClockSync(size_t window = 32);
+
+    void add_sample(const ClockSample& sample);
+
+    bool synced() const;
+    int64_t offset_ns() const;          // exchange - local
+    int64_t uncertainty_ns() const;     // Half-width of the offset interval
+    int64_t rtt_ns() const;             // Minimum RTT in the window
+    int64_t last_rtt_ns() const;
+    double drift_ppm() const;
+    size_t sample_count() const;
+
+    // Map a local epoch timestamp onto the exchange clock
+    int64_t to_exchange_ns(int64_t local_ns) const;
+
+    // Log offset, uncertainty, RTT and drift
+    void log_status() const;
+
+private:
+    void recompute();
+
+    size_t window_;
+    mutable std::mutex mutex_;
+    std::deque<ClockSample> samples_;
+    int64_t lower_ns_ = 0;
+    int64_t upper_ns_ = 0;
+    int64_t min_rtt_ns_ = 0;
+    int64_t last_rtt_ns_ = 0;
+    int64_t reference_local_ns_ = 0;
+    int64_t reference_offset_ns_ = 0;
+    double drift_ppm_ = 0.0;
+    bool synced_ = false;
+};
+
+#endif // CLOCK_SYNC_HPP
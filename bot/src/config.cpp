@@ -1,6 +1,7 @@
 #include "config.hpp"
 #include "logger.hpp"
 #include <nlohmann/json.hpp>
+#include <algorithm>
 #include <fstream>
 #include <sstream>
 #include <stdexcept>
@@ -22,55 +23,161 @@ Config Config::load(const std::string& path) {
         throw std::runtime_error("Failed to parse config JSON: " + std::string(e.what()));
     }
     
+    cfg.apply(j);
+    
+    return cfg;
+}
+
+void Config::apply(const json& j) {
     // Trading pair
-    if (j.contains("pair")) cfg.pair = j["pair"].get<std::string>();
+    if (j.contains("pair")) pair = j["pair"].get<std::string>();
     
     // Strategy parameters
-    if (j.contains("take_profit_pct")) cfg.take_profit_pct = j["take_profit_pct"].get<double>();
-    if (j.contains("stop_loss_pct")) cfg.stop_loss_pct = j["stop_loss_pct"].get<double>();
-    if (j.contains("rebuy_reset_pct")) cfg.rebuy_reset_pct = j["rebuy_reset_pct"].get<double>();
-    if (j.contains("trend_window_short")) cfg.trend_window_short = j["trend_window_short"].get<int>();
-    if (j.contains("trend_window_long")) cfg.trend_window_long = j["trend_window_long"].get<int>();
-    if (j.contains("require_trend_up")) cfg.require_trend_up = j["require_trend_up"].get<bool>();
-    if (j.contains("atr_window")) cfg.atr_window = j["atr_window"].get<int>();
-    if (j.contains("min_atr_pct")) cfg.min_atr_pct = j["min_atr_pct"].get<double>();
-    if (j.contains("max_spread_pct")) cfg.max_spread_pct = j["max_spread_pct"].get<double>();
+    if (j.contains("take_profit_pct")) take_profit_pct = j["take_profit_pct"].get<double>();
+    if (j.contains("stop_loss_pct")) stop_loss_pct = j["stop_loss_pct"].get<double>();
+    if (j.contains("rebuy_reset_pct")) rebuy_reset_pct = j["rebuy_reset_pct"].get<double>();
+    if (j.contains("trend_window_short")) trend_window_short = j["trend_window_short"].get<int>();
+    if (j.contains("trend_window_long")) trend_window_long = j["trend_window_long"].get<int>();
+    if (j.contains("require_trend_up")) require_trend_up = j["require_trend_up"].get<bool>();
+    if (j.contains("atr_window")) atr_window = j["atr_window"].get<int>();
+    if (j.contains("min_atr_pct")) min_atr_pct = j["min_atr_pct"].get<double>();
+    if (j.contains("max_spread_pct")) max_spread_pct = j["max_spread_pct"].get<double>();
+    if (j.contains("book_signals_enabled")) book_signals_enabled = j["book_signals_enabled"].get<bool>();
+    if (j.contains("book_depth")) book_depth = j["book_depth"].get<int>();
+    if (j.contains("book_signal_levels")) book_signal_levels = j["book_signal_levels"].get<int>();
+    if (j.contains("min_book_imbalance")) min_book_imbalance = j["min_book_imbalance"].get<double>();
+    if (j.contains("require_microprice_above_mid")) require_microprice_above_mid = j["require_microprice_above_mid"].get<bool>();
+    if (j.contains("tape_enabled")) tape_enabled = j["tape_enabled"].get<bool>();
+    if (j.contains("tape_bar_seconds")) tape_bar_seconds = j["tape_bar_seconds"].get<int64_t>();
+    if (j.contains("tape_vwap_bars")) tape_vwap_bars = j["tape_vwap_bars"].get<int>();
+    if (j.contains("tape_max_pages")) tape_max_pages = j["tape_max_pages"].get<int>();
+    if (j.contains("indicator_source")) indicator_source = j["indicator_source"].get<std::string>();
+    if (j.contains("vpin_enabled")) vpin_enabled = j["vpin_enabled"].get<bool>();
+    if (j.contains("vpin_bucket_volume")) vpin_bucket_volume = j["vpin_bucket_volume"].get<double>();
+    if (j.contains("vpin_buckets")) vpin_buckets = j["vpin_buckets"].get<int>();
+    if (j.contains("max_vpin")) max_vpin = j["max_vpin"].get<double>();
+    if (j.contains("min_flow_imbalance")) min_flow_imbalance = j["min_flow_imbalance"].get<double>();
+    
+    if (j.contains("indicator_isa")) indicator_isa = j["indicator_isa"].get<std::string>();
+    if (j.contains("bus_log_interval_seconds")) bus_log_interval_seconds = j["bus_log_interval_seconds"].get<int>();
+    
+    // Multi-pair scanner
+    if (j.contains("scanner_enabled")) scanner_enabled = j["scanner_enabled"].get<bool>();
+    if (j.contains("scanner_quote")) scanner_quote = j["scanner_quote"].get<std::string>();
+    if (j.contains("scanner_pairs")) scanner_pairs = j["scanner_pairs"].get<std::vector<std::string>>();
+    if (j.contains("scanner_max_pairs")) scanner_max_pairs = j["scanner_max_pairs"].get<int>();
+    if (j.contains("scanner_top_n")) scanner_top_n = j["scanner_top_n"].get<int>();
     
     // Position sizing
-    if (j.contains("risk_per_trade_pct")) cfg.risk_per_trade_pct = j["risk_per_trade_pct"].get<double>();
-    if (j.contains("max_position_pct")) cfg.max_position_pct = j["max_position_pct"].get<double>();
-    if (j.contains("min_cad_required_pct")) cfg.min_cad_required_pct = j["min_cad_required_pct"].get<double>();
-    if (j.contains("partial_tp_pct")) cfg.partial_tp_pct = j["partial_tp_pct"].get<double>();
-    if (j.contains("partial_tp_sell_pct")) cfg.partial_tp_sell_pct = j["partial_tp_sell_pct"].get<double>();
-    if (j.contains("trailing_stop_pct")) cfg.trailing_stop_pct = j["trailing_stop_pct"].get<double>();
-    if (j.contains("max_hold_seconds")) cfg.max_hold_seconds = j["max_hold_seconds"].get<int64_t>();
-    if (j.contains("use_dynamic_tp_sl")) cfg.use_dynamic_tp_sl = j["use_dynamic_tp_sl"].get<bool>();
-    if (j.contains("tp_atr_mult")) cfg.tp_atr_mult = j["tp_atr_mult"].get<double>();
-    if (j.contains("sl_atr_mult")) cfg.sl_atr_mult = j["sl_atr_mult"].get<double>();
+    if (j.contains("risk_per_trade_pct")) risk_per_trade_pct = j["risk_per_trade_pct"].get<double>();
+    if (j.contains("max_position_pct")) max_position_pct = j["max_position_pct"].get<double>();
+    if (j.contains("min_cad_required_pct")) min_cad_required_pct = j["min_cad_required_pct"].get<double>();
+    if (j.contains("partial_tp_pct")) partial_tp_pct = j["partial_tp_pct"].get<double>();
+    if (j.contains("partial_tp_sell_pct")) partial_tp_sell_pct = j["partial_tp_sell_pct"].get<double>();
+    if (j.contains("trailing_stop_pct")) trailing_stop_pct = j["trailing_stop_pct"].get<double>();
+    if (j.contains("max_hold_seconds")) max_hold_seconds = j["max_hold_seconds"].get<int64_t>();
+    if (j.contains("use_dynamic_tp_sl")) use_dynamic_tp_sl = j["use_dynamic_tp_sl"].get<bool>();
+    if (j.contains("tp_atr_mult")) tp_atr_mult = j["tp_atr_mult"].get<double>();
+    if (j.contains("sl_atr_mult")) sl_atr_mult = j["sl_atr_mult"].get<double>();
     
     // Timing
-    if (j.contains("poll_interval_seconds")) cfg.poll_interval_seconds = j["poll_interval_seconds"].get<int64_t>();
-    if (j.contains("cooldown_seconds")) cfg.cooldown_seconds = j["cooldown_seconds"].get<int64_t>();
-    if (j.contains("max_trades_per_day")) cfg.max_trades_per_day = j["max_trades_per_day"].get<int>();
+    if (j.contains("poll_interval_seconds")) poll_interval_seconds = j["poll_interval_seconds"].get<int64_t>();
+    if (j.contains("cooldown_seconds")) cooldown_seconds = j["cooldown_seconds"].get<int64_t>();
+    if (j.contains("max_trades_per_day")) max_trades_per_day = j["max_trades_per_day"].get<int>();
     
     // Execution mode
-    if (j.contains("dry_run")) cfg.dry_run = j["dry_run"].get<bool>();
-    if (j.contains("sim_fee_pct_roundtrip")) cfg.sim_fee_pct_roundtrip = j["sim_fee_pct_roundtrip"].get<double>();
-    if (j.contains("sim_initial_cad")) cfg.sim_initial_cad = j["sim_initial_cad"].get<double>();
+    if (j.contains("dry_run")) dry_run = j["dry_run"].get<bool>();
+    if (j.contains("sim_fee_pct_roundtrip")) sim_fee_pct_roundtrip = j["sim_fee_pct_roundtrip"].get<double>();
+    if (j.contains("sim_initial_cad")) sim_initial_cad = j["sim_initial_cad"].get<double>();
+    
+    // Paper matching engine
+    if (j.contains("paper_engine_enabled")) paper_engine_enabled = j["paper_engine_enabled"].get<bool>();
+    if (j.contains("paper_entry_order")) paper_entry_order = j["paper_entry_order"].get<std::string>();
+    if (j.contains("paper_limit_timeout_seconds")) paper_limit_timeout_seconds = j["paper_limit_timeout_seconds"].get<int64_t>();
+    if (j.contains("paper_stop_orders")) paper_stop_orders = j["paper_stop_orders"].get<bool>();
+    if (j.contains("paper_maker_fee_pct")) paper_maker_fee_pct = j["paper_maker_fee_pct"].get<double>();
+    if (j.contains("paper_taker_fee_pct")) paper_taker_fee_pct = j["paper_taker_fee_pct"].get<double>();
+    if (j.contains("paper_book_depth")) paper_book_depth = j["paper_book_depth"].get<int>();
     
     // API configuration
-    if (j.contains("kraken_api_base")) cfg.kraken_api_base = j["kraken_api_base"].get<std::string>();
-    if (j.contains("rate_limit_min_delay_ms")) cfg.rate_limit_min_delay_ms = j["rate_limit_min_delay_ms"].get<int64_t>();
-    if (j.contains("max_consecutive_failures")) cfg.max_consecutive_failures = j["max_consecutive_failures"].get<int>();
-    if (j.contains("stale_price_seconds")) cfg.stale_price_seconds = j["stale_price_seconds"].get<int64_t>();
+    if (j.contains("kraken_api_base")) kraken_api_base = j["kraken_api_base"].get<std::string>();
+    if (j.contains("rate_limit_min_delay_ms")) rate_limit_min_delay_ms = j["rate_limit_min_delay_ms"].get<int64_t>();
+    if (j.contains("rate_limit_burst")) rate_limit_burst = j["rate_limit_burst"].get<int>();
+    if (j.contains("max_consecutive_failures")) max_consecutive_failures = j["max_consecutive_failures"].get<int>();
+    if (j.contains("http_max_retries")) http_max_retries = j["http_max_retries"].get<int>();
+    if (j.contains("backoff_initial_ms")) backoff_initial_ms = j["backoff_initial_ms"].get<int64_t>();
+    if (j.contains("backoff_max_ms")) backoff_max_ms = j["backoff_max_ms"].get<int64_t>();
+    if (j.contains("breaker_failure_threshold")) breaker_failure_threshold = j["breaker_failure_threshold"].get<int>();
+    if (j.contains("breaker_open_ms")) breaker_open_ms = j["breaker_open_ms"].get<int64_t>();
+    if (j.contains("retry_budget_ratio")) retry_budget_ratio = j["retry_budget_ratio"].get<double>();
+    if (j.contains("hedge_enabled")) hedge_enabled = j["hedge_enabled"].get<bool>();
+    if (j.contains("hedge_min_delay_ms")) hedge_min_delay_ms = j["hedge_min_delay_ms"].get<int64_t>();
+    if (j.contains("http2_enabled")) http2_enabled = j["http2_enabled"].get<bool>();
+    if (j.contains("http_timeout_ms")) http_timeout_ms = j["http_timeout_ms"].get<int64_t>();
+    if (j.contains("http_prewarm")) http_prewarm = j["http_prewarm"].get<bool>();
+    if (j.contains("http_keepalive_seconds")) http_keepalive_seconds = j["http_keepalive_seconds"].get<int64_t>();
+    if (j.contains("dns_refresh_seconds")) dns_refresh_seconds = j["dns_refresh_seconds"].get<int64_t>();
+    if (j.contains("tcp_sndbuf_bytes")) tcp_sndbuf_bytes = j["tcp_sndbuf_bytes"].get<int64_t>();
+    if (j.contains("tcp_rcvbuf_bytes")) tcp_rcvbuf_bytes = j["tcp_rcvbuf_bytes"].get<int64_t>();
+    if (j.contains("stale_price_seconds")) stale_price_seconds = j["stale_price_seconds"].get<int64_t>();
+    if (j.contains("clock_sync_interval_seconds")) clock_sync_interval_seconds = j["clock_sync_interval_seconds"].get<int64_t>();
+    if (j.contains("startup_backfill")) startup_backfill = j["startup_backfill"].get<bool>();
+    if (j.contains("tick_arena_bytes")) tick_arena_bytes = j["tick_arena_bytes"].get<int64_t>();
+    if (j.contains("fault_schedule_file")) fault_schedule_file = j["fault_schedule_file"].get<std::string>();
+    if (j.contains("http_record_file")) http_record_file = j["http_record_file"].get<std::string>();
+    if (j.contains("http_replay_file")) http_replay_file = j["http_replay_file"].get<std::string>();
+    if (j.contains("http_replay_speed")) http_replay_speed = j["http_replay_speed"].get<double>();
     
-    // File paths
-    if (j.contains("state_file")) cfg.state_file = j["state_file"].get<std::string>();
-    if (j.contains("kill_switch_file")) cfg.kill_switch_file = j["kill_switch_file"].get<std::string>();
-    if (j.contains("log_dir")) cfg.log_dir = j["log_dir"].get<std::string>();
-    if (j.contains("ui_dir")) cfg.ui_dir = j["ui_dir"].get<std::string>();
+    // Market data source
+    if (j.contains("market_data_source")) market_data_source = j["market_data_source"].get<std::string>();
+    if (j.contains("shm_name")) shm_name = j["shm_name"].get<std::string>();
+    if (j.contains("shm_capacity")) shm_capacity = j["shm_capacity"].get<int64_t>();
+    if (j.contains("gateway_pairs")) gateway_pairs = j["gateway_pairs"].get<std::vector<std::string>>();
+    if (j.contains("gateway_bar_seconds")) gateway_bar_seconds = j["gateway_bar_seconds"].get<int64_t>();
     
-    return cfg;
+    // Tick store
+    if (j.contains("tick_store_dir")) tick_store_dir = j["tick_store_dir"].get<std::string>();
+    if (j.contains("tick_segment_seconds")) tick_segment_seconds = j["tick_segment_seconds"].get<int64_t>();
+    if (j.contains("tick_compact_enabled")) tick_compact_enabled = j["tick_compact_enabled"].get<bool>();
+    if (j.contains("tick_compact_interval_seconds")) tick_compact_interval_seconds = j["tick_compact_interval_seconds"].get<int>();
+    
+    // Failover
+    if (j.contains("failover_enabled")) failover_enabled = j["failover_enabled"].get<bool>();
+    if (j.contains("failover_lease_file")) failover_lease_file = j["failover_lease_file"].get<std::string>();
+    if (j.contains("state_journal_file")) state_journal_file = j["state_journal_file"].get<std::string>();
+    if (j.contains("failover_poll_ms")) failover_poll_ms = j["failover_poll_ms"].get<int64_t>();
+    
+    // File paths
+    if (j.contains("state_file")) state_file = j["state_file"].get<std::string>();
+    if (j.contains("ledger_file")) ledger_file = j["ledger_file"].get<std::string>();
+    if (j.contains("kill_switch_file")) kill_switch_file = j["kill_switch_file"].get<std::string>();
+    if (j.contains("log_dir")) log_dir = j["log_dir"].get<std::string>();
+    if (j.contains("ui_dir")) ui_dir = j["ui_dir"].get<std::string>();
+}
+
+EndpointPolicy Config::endpoint_policy() const {
+    EndpointPolicy policy;
+    policy.max_retries = http_max_retries;
+    policy.initial_backoff_ms = backoff_initial_ms;
+    policy.max_backoff_ms = backoff_max_ms;
+    policy.failure_threshold = breaker_failure_threshold;
+    policy.open_ms = breaker_open_ms;
+    policy.max_open_ms = std::max(breaker_open_ms, backoff_max_ms);
+    policy.retry_budget_ratio = retry_budget_ratio;
+    // A hedge would take a second recorded response for the same call
+    policy.hedge = hedge_enabled && http_replay_file.empty();
+    policy.hedge_min_delay_ms = hedge_min_delay_ms;
+    return policy;
+}
+
+CurlOptions Config::curl_options() const {
+    CurlOptions options;
+    options.http2 = http2_enabled;
+    options.keepalive_idle_seconds = std::max<int64_t>(http_keepalive_seconds, 10);
+    options.sndbuf_bytes = tcp_sndbuf_bytes;
+    options.rcvbuf_bytes = tcp_rcvbuf_bytes;
+    options.dns_refresh_seconds = dns_refresh_seconds;
+    return options;
 }
 
 bool Config::validate() const {
@@ -116,6 +223,158 @@ bool Config::validate() const {
         LOG_ERROR("Config: max_spread_pct must be in [0, 0.1], got " + std::to_string(max_spread_pct));
         valid = false;
     }
+
+    if (book_signal_levels < 1 || book_signal_levels > 100) {
+        LOG_ERROR("Config: book_signal_levels must be between 1 and 100, got " + std::to_string(book_signal_levels));
+        valid = false;
+    }
+
+    if (book_depth < book_signal_levels || book_depth > 500) {
+        LOG_ERROR("Config: book_depth must be between book_signal_levels and 500, got " + std::to_string(book_depth));
+        valid = false;
+    }
+
+    if (min_book_imbalance < -1.0 || min_book_imbalance > 1.0) {
+        LOG_ERROR("Config: min_book_imbalance must be in [-1, 1], got " + std::to_string(min_book_imbalance));
+        valid = false;
+    }
+
+    if (tape_bar_seconds < 1 || tape_bar_seconds > 86400) {
+        LOG_ERROR("Config: tape_bar_seconds must be between 1 and 86400, got " + std::to_string(tape_bar_seconds));
+        valid = false;
+    }
+
+    if (tape_vwap_bars < 1 || tape_vwap_bars > 10000) {
+        LOG_ERROR("Config: tape_vwap_bars must be between 1 and 10000, got " + std::to_string(tape_vwap_bars));
+        valid = false;
+    }
+
+    if (tape_max_pages < 1 || tape_max_pages > 100) {
+        LOG_ERROR("Config: tape_max_pages must be between 1 and 100, got " + std::to_string(tape_max_pages));
+        valid = false;
+    }
+
+    if (indicator_source != "poll" && indicator_source != "tape") {
+        LOG_ERROR("Config: indicator_source must be \"poll\" or \"tape\", got " + indicator_source);
+        valid = false;
+    }
+
+    if (indicator_source == "tape" && !tape_enabled) {
+        LOG_ERROR("Config: indicator_source \"tape\" requires tape_enabled");
+        valid = false;
+    }
+
+    if (vpin_enabled && !tape_enabled) {
+        LOG_ERROR("Config: vpin_enabled requires tape_enabled");
+        valid = false;
+    }
+
+    if (vpin_bucket_volume <= 0.0) {
+        LOG_ERROR("Config: vpin_bucket_volume must be positive, got " + std::to_string(vpin_bucket_volume));
+        valid = false;
+    }
+
+    if (vpin_buckets < 1 || vpin_buckets > 10000) {
+        LOG_ERROR("Config: vpin_buckets must be between 1 and 10000, got " + std::to_string(vpin_buckets));
+        valid = false;
+    }
+
+    if (max_vpin < 0.0 || max_vpin > 1.0) {
+        LOG_ERROR("Config: max_vpin must be in [0, 1], got " + std::to_string(max_vpin));
+        valid = false;
+    }
+
+    if (min_flow_imbalance < -1.0 || min_flow_imbalance > 1.0) {
+        LOG_ERROR("Config: min_flow_imbalance must be in [-1, 1], got " + std::to_string(min_flow_imbalance));
+        valid = false;
+    }
+
+    if (tape_enabled && scanner_enabled) {
+        LOG_ERROR("Config: tape_enabled follows pair only and cannot be combined with scanner_enabled");
+        valid = false;
+    }
+
+    if (book_signals_enabled && scanner_enabled) {
+        LOG_ERROR("Config: book_signals_enabled follows pair only and cannot be combined with scanner_enabled");
+        valid = false;
+    }
+
+    if (book_signals_enabled && market_data_source != "rest") {
+        LOG_ERROR("Config: book_signals_enabled needs market_data_source \"rest\" (the gateway publishes top of book only)");
+        valid = false;
+    }
+    
+    if (scanner_enabled && !dry_run) {
+        LOG_ERROR("Config: scanner_enabled requires dry_run (live balances are only reconciled for XBT/CAD)");
+        valid = false;
+    }
+
+    if (!fault_schedule_file.empty() && !dry_run) {
+        LOG_ERROR("Config: fault_schedule_file requires dry_run");
+        valid = false;
+    }
+    
+    if (!http_replay_file.empty() && !dry_run) {
+        LOG_ERROR("Config: http_replay_file requires dry_run");
+        valid = false;
+    }
+    
+    if (!http_replay_file.empty() && !http_record_file.empty() && http_replay_file == http_record_file) {
+        LOG_ERROR("Config: http_record_file must differ from http_replay_file");
+        valid = false;
+    }
+    
+    if (http_replay_speed < 0.0) {
+        LOG_ERROR("Config: http_replay_speed must be >= 0, got " + std::to_string(http_replay_speed));
+        valid = false;
+    }
+
+    if (paper_engine_enabled && !dry_run) {
+        LOG_ERROR("Config: paper_engine_enabled requires dry_run");
+        valid = false;
+    }
+
+    if (paper_entry_order != "market" && paper_entry_order != "limit") {
+        LOG_ERROR("Config: paper_entry_order must be market or limit, got " + paper_entry_order);
+        valid = false;
+    }
+
+    if (paper_limit_timeout_seconds < 1) {
+        LOG_ERROR("Config: paper_limit_timeout_seconds must be >= 1");
+        valid = false;
+    }
+
+    if (paper_maker_fee_pct < 0 || paper_maker_fee_pct > 0.01 ||
+        paper_taker_fee_pct < 0 || paper_taker_fee_pct > 0.01) {
+        LOG_ERROR("Config: paper_maker_fee_pct and paper_taker_fee_pct must be in [0, 0.01]");
+        valid = false;
+    }
+
+    if (paper_book_depth < 1 || paper_book_depth > 500) {
+        LOG_ERROR("Config: paper_book_depth must be in [1, 500], got " + std::to_string(paper_book_depth));
+        valid = false;
+    }
+
+    if (indicator_isa != "auto" && indicator_isa != "scalar" && indicator_isa != "avx2" && indicator_isa != "avx512") {
+        LOG_ERROR("Config: indicator_isa must be auto, scalar, avx2 or avx512, got " + indicator_isa);
+        valid = false;
+    }
+
+    if (bus_log_interval_seconds < 0 || bus_log_interval_seconds > 86400) {
+        LOG_ERROR("Config: bus_log_interval_seconds must be between 0 and 86400, got " +
+                  std::to_string(bus_log_interval_seconds));
+        valid = false;
+    }
+
+    if (scanner_enabled && scanner_pairs.empty() && scanner_quote.empty()) {
+        LOG_ERROR("Config: scanner_quote cannot be empty when scanner_pairs is not set");
+        valid = false;
+    }
+
+    if (scanner_max_pairs < 1 || scanner_top_n < 1) {
+        LOG_ERROR("Config: scanner_max_pairs and scanner_top_n must be >= 1");
+        valid = false;
+    }
     
     if (risk_per_trade_pct <= 0 || risk_per_trade_pct > 0.10) {
         LOG_ERROR("Config: risk_per_trade_pct must be in (0, 0.10], got " + std::to_string(risk_per_trade_pct));
@@ -177,16 +436,125 @@ bool Config::validate() const {
         valid = false;
     }
     
+    // Kraken's private counter tolerates bursts of about 15 on the lowest tier
+    if (rate_limit_burst < 1 || rate_limit_burst > 15) {
+        LOG_ERROR("Config: rate_limit_burst must be between 1 and 15, got " + std::to_string(rate_limit_burst));
+        valid = false;
+    }
+    
     if (max_consecutive_failures < 1) {
         LOG_ERROR("Config: max_consecutive_failures must be >= 1, got " + std::to_string(max_consecutive_failures));
         valid = false;
     }
+
+    if (http_max_retries < 0 || http_max_retries > 10) {
+        LOG_ERROR("Config: http_max_retries must be in [0, 10], got " + std::to_string(http_max_retries));
+        valid = false;
+    }
+
+    if (backoff_initial_ms < 1 || backoff_max_ms < backoff_initial_ms) {
+        LOG_ERROR("Config: backoff_initial_ms must be >= 1 and <= backoff_max_ms");
+        valid = false;
+    }
+
+    if (breaker_failure_threshold < 1 || breaker_open_ms < 1) {
+        LOG_ERROR("Config: breaker_failure_threshold and breaker_open_ms must be >= 1");
+        valid = false;
+    }
+
+    if (retry_budget_ratio < 0 || retry_budget_ratio > 1.0) {
+        LOG_ERROR("Config: retry_budget_ratio must be in [0, 1.0], got " + std::to_string(retry_budget_ratio));
+        valid = false;
+    }
+
+    if (hedge_min_delay_ms < 1) {
+        LOG_ERROR("Config: hedge_min_delay_ms must be >= 1, got " + std::to_string(hedge_min_delay_ms));
+        valid = false;
+    }
+    
+    if (http_timeout_ms < 1000 || http_timeout_ms > 120000) {
+        LOG_ERROR("Config: http_timeout_ms must be in [1000, 120000], got " + std::to_string(http_timeout_ms));
+        valid = false;
+    }
+    
+    if (http_keepalive_seconds < 0) {
+        LOG_ERROR("Config: http_keepalive_seconds must be >= 0, got " + std::to_string(http_keepalive_seconds));
+        valid = false;
+    }
+    
+    if (dns_refresh_seconds < 10) {
+        LOG_ERROR("Config: dns_refresh_seconds must be >= 10, got " + std::to_string(dns_refresh_seconds));
+        valid = false;
+    }
+    
+    if (tcp_sndbuf_bytes < 0 || tcp_rcvbuf_bytes < 0) {
+        LOG_ERROR("Config: tcp_sndbuf_bytes and tcp_rcvbuf_bytes must be >= 0 (0 = OS default)");
+        valid = false;
+    }
+    
+    if (tick_arena_bytes != 0 && (tick_arena_bytes < 4096 || tick_arena_bytes > (64 << 20))) {
+        LOG_ERROR("Config: tick_arena_bytes must be 0 (disabled) or between 4096 and 64 MiB, got " +
+                  std::to_string(tick_arena_bytes));
+        valid = false;
+    }
     
     if (stale_price_seconds < 5) {
         LOG_ERROR("Config: stale_price_seconds must be >= 5, got " + std::to_string(stale_price_seconds));
         valid = false;
     }
 
+    if (clock_sync_interval_seconds < 0) {
+        LOG_ERROR("Config: clock_sync_interval_seconds must be >= 0, got " + std::to_string(clock_sync_interval_seconds));
+        valid = false;
+    }
+
+    if (market_data_source != "rest" && market_data_source != "shm") {
+        LOG_ERROR("Config: market_data_source must be \"rest\" or \"shm\", got " + market_data_source);
+        valid = false;
+    }
+
+    if (shm_name.size() < 2 || shm_name[0] != '/' || shm_name.find('/', 1) != std::string::npos) {
+        LOG_ERROR("Config: shm_name must look like \"/name\", got " + shm_name);
+        valid = false;
+    }
+
+    if (shm_capacity < 64 || (shm_capacity & (shm_capacity - 1)) != 0) {
+        LOG_ERROR("Config: shm_capacity must be a power of two >= 64, got " + std::to_string(shm_capacity));
+        valid = false;
+    }
+
+    if (gateway_bar_seconds < 1) {
+        LOG_ERROR("Config: gateway_bar_seconds must be >= 1, got " + std::to_string(gateway_bar_seconds));
+        valid = false;
+    }
+
+    if (tick_segment_seconds != 0 && (tick_segment_seconds < 60 || tick_segment_seconds > 31 * 86400)) {
+        LOG_ERROR("Config: tick_segment_seconds must be 0 or between 60 and 2678400, got " +
+                  std::to_string(tick_segment_seconds));
+        valid = false;
+    }
+
+    if (tick_compact_enabled && (tick_store_dir.empty() || tick_segment_seconds == 0)) {
+        LOG_ERROR("Config: tick_compact_enabled needs tick_store_dir and a non-zero tick_segment_seconds");
+        valid = false;
+    }
+
+    if (tick_compact_interval_seconds < 10 || tick_compact_interval_seconds > 86400) {
+        LOG_ERROR("Config: tick_compact_interval_seconds must be between 10 and 86400, got " +
+                  std::to_string(tick_compact_interval_seconds));
+        valid = false;
+    }
+
+    if (failover_enabled && (failover_lease_file.empty() || state_journal_file.empty())) {
+        LOG_ERROR("Config: failover_lease_file and state_journal_file cannot be empty when failover is enabled");
+        valid = false;
+    }
+
+    if (failover_poll_ms < 10 || failover_poll_ms > 1000) {
+        LOG_ERROR("Config: failover_poll_ms must be in [10, 1000], got " + std::to_string(failover_poll_ms));
+        valid = false;
+    }
+
     if (ui_dir.empty()) {
         LOG_ERROR("Config: ui_dir cannot be empty");
         valid = false;
@@ -208,6 +576,28 @@ void Config::log_config() const {
         << "\n  atr_window: " << atr_window
         << "\n  min_atr_pct: " << (min_atr_pct * 100) << "%"
         << "\n  max_spread_pct: " << (max_spread_pct * 100) << "%"
+        << "\n  book_signals_enabled: " << (book_signals_enabled ? "true" : "false")
+        << "\n  book_depth: " << book_depth
+        << "\n  book_signal_levels: " << book_signal_levels
+        << "\n  min_book_imbalance: " << min_book_imbalance
+        << "\n  require_microprice_above_mid: " << (require_microprice_above_mid ? "true" : "false")
+        << "\n  tape_enabled: " << (tape_enabled ? "true" : "false")
+        << "\n  tape_bar_seconds: " << tape_bar_seconds
+        << "\n  tape_vwap_bars: " << tape_vwap_bars
+        << "\n  tape_max_pages: " << tape_max_pages
+        << "\n  indicator_source: " << indicator_source
+        << "\n  vpin_enabled: " << (vpin_enabled ? "true" : "false")
+        << "\n  vpin_bucket_volume: " << vpin_bucket_volume
+        << "\n  vpin_buckets: " << vpin_buckets
+        << "\n  max_vpin: " << max_vpin
+        << "\n  min_flow_imbalance: " << min_flow_imbalance
+        << "\n  indicator_isa: " << indicator_isa
+        << "\n  bus_log_interval_seconds: " << bus_log_interval_seconds
+        << "\n  scanner_enabled: " << (scanner_enabled ? "true" : "false")
+        << "\n  scanner_quote: " << scanner_quote
+        << "\n  scanner_pairs: " << (scanner_pairs.empty() ? std::string("(discover)") : std::to_string(scanner_pairs.size()))
+        << "\n  scanner_max_pairs: " << scanner_max_pairs
+        << "\n  scanner_top_n: " << scanner_top_n
         << "\n  risk_per_trade_pct: " << (risk_per_trade_pct * 100) << "%"
         << "\n  max_position_pct: " << (max_position_pct * 100) << "%"
         << "\n  min_cad_required_pct: " << (min_cad_required_pct * 100) << "%"
@@ -224,10 +614,54 @@ void Config::log_config() const {
         << "\n  dry_run: " << (dry_run ? "true" : "false")
         << "\n  sim_fee_pct_roundtrip: " << (sim_fee_pct_roundtrip * 100) << "%"
         << "\n  sim_initial_cad: " << sim_initial_cad
+        << "\n  paper_engine_enabled: " << (paper_engine_enabled ? "true" : "false")
+        << "\n  paper_entry_order: " << paper_entry_order
+        << "\n  paper_limit_timeout_seconds: " << paper_limit_timeout_seconds
+        << "\n  paper_stop_orders: " << (paper_stop_orders ? "true" : "false")
+        << "\n  paper_maker_fee_pct: " << (paper_maker_fee_pct * 100) << "%"
+        << "\n  paper_taker_fee_pct: " << (paper_taker_fee_pct * 100) << "%"
+        << "\n  paper_book_depth: " << paper_book_depth
         << "\n  kraken_api_base: " << kraken_api_base
         << "\n  rate_limit_min_delay_ms: " << rate_limit_min_delay_ms
+        << "\n  rate_limit_burst: " << rate_limit_burst
         << "\n  max_consecutive_failures: " << max_consecutive_failures
+        << "\n  http_max_retries: " << http_max_retries
+        << "\n  backoff_initial_ms: " << backoff_initial_ms
+        << "\n  backoff_max_ms: " << backoff_max_ms
+        << "\n  breaker_failure_threshold: " << breaker_failure_threshold
+        << "\n  breaker_open_ms: " << breaker_open_ms
+        << "\n  retry_budget_ratio: " << retry_budget_ratio
+        << "\n  hedge_enabled: " << (hedge_enabled ? "true" : "false")
+        << "\n  hedge_min_delay_ms: " << hedge_min_delay_ms
+        << "\n  http2_enabled: " << (http2_enabled ? "true" : "false")
+        << "\n  http_timeout_ms: " << http_timeout_ms
+        << "\n  http_prewarm: " << (http_prewarm ? "true" : "false")
+        << "\n  http_keepalive_seconds: " << http_keepalive_seconds
+        << "\n  dns_refresh_seconds: " << dns_refresh_seconds
+        << "\n  tcp_sndbuf_bytes: " << tcp_sndbuf_bytes
+        << "\n  tcp_rcvbuf_bytes: " << tcp_rcvbuf_bytes
         << "\n  stale_price_seconds: " << stale_price_seconds
+        << "\n  clock_sync_interval_seconds: " << clock_sync_interval_seconds
+        << "\n  startup_backfill: " << (startup_backfill ? "true" : "false")
+        << "\n  tick_arena_bytes: " << tick_arena_bytes
+        << "\n  fault_schedule_file: " << (fault_schedule_file.empty() ? std::string("(disabled)") : fault_schedule_file)
+        << "\n  http_record_file: " << (http_record_file.empty() ? std::string("(disabled)") : http_record_file)
+        << "\n  http_replay_file: " << (http_replay_file.empty() ? std::string("(disabled)") : http_replay_file)
+        << "\n  http_replay_speed: " << http_replay_speed
+        << "\n  market_data_source: " << market_data_source
+        << "\n  shm_name: " << shm_name
+        << "\n  shm_capacity: " << shm_capacity
+        << "\n  gateway_pairs: " << (gateway_pairs.empty() ? pair : std::to_string(gateway_pairs.size()))
+        << "\n  gateway_bar_seconds: " << gateway_bar_seconds
+        << "\n  tick_store_dir: " << (tick_store_dir.empty() ? std::string("(disabled)") : tick_store_dir)
+        << "\n  tick_segment_seconds: " << tick_segment_seconds
+        << "\n  tick_compact_enabled: " << (tick_compact_enabled ? "true" : "false")
+        << "\n  tick_compact_interval_seconds: " << tick_compact_interval_seconds
+        << "\n  failover_enabled: " << (failover_enabled ? "true" : "false")
+        << "\n  failover_lease_file: " << failover_lease_file
+        << "\n  state_journal_file: " << state_journal_file
+        << "\n  failover_poll_ms: " << failover_poll_ms
+        << "\n  ledger_file: " << (ledger_file.empty() ? std::string("(disabled)") : ledger_file)
         << "\n  ui_dir: " << ui_dir;
     
     LOG_INFO(oss.str());
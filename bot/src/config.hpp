@@ -3,6 +3,10 @@
 
 #include <string>
 #include <cstdint>
+#include <vector>
+#include <nlohmann/json_fwd.hpp>
+#include "circuit_breaker.hpp"
+#include "http_transport.hpp"
 
 struct Config {
     // Trading pair (Kraken API format: XXBT=BTC, ZCAD=CAD)
@@ -21,6 +25,45 @@ struct Config {
     double min_atr_pct = 0.003;           // 0.3% minimum volatility
     double max_spread_pct = 0.002;        // 0.2% max bid-ask spread for entries
     
+    // L2 book signals for pair (REST Depth each tick); the entry filter
+    // below only applies while they are enabled
+    bool book_signals_enabled = false;
+    int book_depth = 25;                  // Levels fetched per side
+    int book_signal_levels = 10;          // Top levels the imbalance and slopes cover
+    double min_book_imbalance = -1.0;     // Entry needs imbalance >= this; -1 accepts any
+    bool require_microprice_above_mid = false;
+    
+    // Trade tape for pair (/0/public/Trades since-cursor each tick)
+    bool tape_enabled = false;
+    int64_t tape_bar_seconds = 60;        // Volume bar interval (exchange clock)
+    int tape_vwap_bars = 30;              // Rolling VWAP / volume window in bars
+    int tape_max_pages = 5;               // Trades pages per tick before deferring the rest
+    // "poll": SMA/ATR sample the last price every poll; "tape": one sample
+    // per closed tape bar, with high/low true range
+    std::string indicator_source = "poll";
+    
+    // Order-flow toxicity over the tape's signed prints; entries are blocked
+    // while the flow is one-sided (needs tape_enabled)
+    bool vpin_enabled = false;
+    double vpin_bucket_volume = 1.0;      // Base-asset volume per bucket
+    int vpin_buckets = 50;                // Buckets in the VPIN window
+    double max_vpin = 1.0;                // Entry needs VPIN <= this; 1 accepts any
+    double min_flow_imbalance = -1.0;     // Entry needs signed imbalance >= this; -1 accepts any
+    
+    // Batch indicator kernels: "auto" picks AVX-512/AVX2/scalar at runtime
+    std::string indicator_isa = "auto";
+    
+    // Log one conflated bar per pair from the market data bus every
+    // interval, on its own thread; 0 disables
+    int bus_log_interval_seconds = 60;
+    
+    // Multi-pair scanner (dry-run only: balances are reconciled for XBT/CAD)
+    bool scanner_enabled = false;
+    std::string scanner_quote = "ZCAD";   // Scan every online pair quoted in this asset
+    std::vector<std::string> scanner_pairs; // Explicit universe; overrides discovery when set
+    int scanner_max_pairs = 500;
+    int scanner_top_n = 5;                // Candidates reported in logs and UI
+    
     // Position sizing
     double risk_per_trade_pct = 0.01;     // 1% of equity risked per trade
     double max_position_pct = 0.90;       // Max 90% of equity in a position
@@ -45,14 +88,81 @@ struct Config {
     double sim_fee_pct_roundtrip = 0.004; // 0.4% simulated round-trip fee
     double sim_initial_cad = 1000.0;      // Initial simulated equity
     
+    // Paper matching engine (dry-run only): orders rest in a local engine
+    // and fill against Kraken's book and trade prints instead of at last price
+    bool paper_engine_enabled = false;
+    std::string paper_entry_order = "market";   // "market" or "limit" (post-only at the bid)
+    int64_t paper_limit_timeout_seconds = 60;   // Cancel unfilled limit entries after this
+    bool paper_stop_orders = true;              // Rest a stop-loss sell while long
+    double paper_maker_fee_pct = 0.0025;
+    double paper_taker_fee_pct = 0.0040;
+    int paper_book_depth = 25;                  // Levels fetched per side
+    
     // API configuration
     std::string kraken_api_base = "https://api.kraken.com";
     int64_t rate_limit_min_delay_ms = 500;
+    int rate_limit_burst = 6;             // Requests allowed back to back (the startup fan-out)
     int max_consecutive_failures = 10;
+    
+    // Per-endpoint-class resilience (market data, reference, private)
+    int http_max_retries = 2;             // Idempotent public calls only
+    int64_t backoff_initial_ms = 1000;
+    int64_t backoff_max_ms = 30000;
+    int breaker_failure_threshold = 5;    // Consecutive failures that open a class
+    int64_t breaker_open_ms = 5000;       // First cool-down before a half-open probe
+    double retry_budget_ratio = 0.2;      // Retries + hedges per request, at most
+    bool hedge_enabled = false;           // Hedge slow market data requests
+    int64_t hedge_min_delay_ms = 250;
+    bool http2_enabled = true;            // Multiplex REST calls over HTTP/2 where offered
+    int64_t http_timeout_ms = 30000;      // Per request (per stream under HTTP/2)
+    bool http_prewarm = true;             // Pin DNS and open a connection at startup
+    int64_t http_keepalive_seconds = 30;  // Keep-warm request after this much idle; 0 disables
+    int64_t dns_refresh_seconds = 300;    // Re-resolve pinned hosts after this
+    int64_t tcp_sndbuf_bytes = 0;         // 0 keeps the OS default
+    int64_t tcp_rcvbuf_bytes = 0;
     int64_t stale_price_seconds = 30;
+    int64_t clock_sync_interval_seconds = 300;  // Re-probe /0/public/Time; 0 disables
+    bool startup_backfill = true;         // Seed indicator windows from OHLC bars at startup
+    int64_t tick_arena_bytes = 262144;    // Per-tick arena buffer for transient allocations; 0 disables
+    
+    // Seeded latency/failure schedule applied to every request (dry-run
+    // only); empty disables
+    std::string fault_schedule_file;
+    
+    // Record every HTTP exchange to this file (empty disables), or serve a
+    // recorded session instead of the network (dry-run only); replay speed 1
+    // reproduces recorded latencies, 0 answers immediately
+    std::string http_record_file;
+    std::string http_replay_file;
+    double http_replay_speed = 1.0;
+
+    // Market data source: "rest" polls Kraken directly, "shm" reads the
+    // ring published by market_gateway
+    std::string market_data_source = "rest";
+    std::string shm_name = "/kraken_md";
+    int64_t shm_capacity = 4096;          // Ring slots, power of two
+    std::vector<std::string> gateway_pairs; // Pairs market_gateway publishes (default: pair)
+    int64_t gateway_bar_seconds = 60;
+    
+    // Recorded ticks for backtests (<dir>/<pair>.ticks); empty disables
+    // recording
+    std::string tick_store_dir;
+    int64_t tick_segment_seconds = 86400; // Close the hot file per aligned interval; 0 never
+    // Compress closed segments into the cold tier in the background
+    bool tick_compact_enabled = false;
+    int tick_compact_interval_seconds = 300;
+    
+    // Active/passive failover: the instance holding failover_lease_file
+    // trades; the other tails state_journal_file and takes over when the
+    // lease is released
+    bool failover_enabled = false;
+    std::string failover_lease_file = "bot.lease";
+    std::string state_journal_file = "state.journal";
+    int64_t failover_poll_ms = 100;
     
     // File paths (relative to working directory)
     std::string state_file = "state.json";
+    std::string ledger_file = "trades.jsonl";   // Realized trades; empty disables
     std::string kill_switch_file = "KILL_SWITCH";
     std::string log_dir = "logs";
     std::string ui_dir = "ui";
@@ -60,6 +170,15 @@ struct Config {
     // Load from JSON file
     static Config load(const std::string& path);
     
+    // Override the fields present in j (also used for backtest sweeps)
+    void apply(const nlohmann::json& j);
+    
+    // Breaker/retry/hedge policy for KrakenClient
+    EndpointPolicy endpoint_policy() const;
+    
+    // Protocol, socket and DNS pinning options for CurlTransport
+    CurlOptions curl_options() const;
+    
     // Validate configuration
     bool validate() const;
     
@@ -0,0 +1,193 @@
+#include "fault_injection.hpp"
+#include "logger.hpp"
+#include <nlohmann/json.hpp>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+#include <algorithm>
+#include <cmath>
+
+using json = nlohmann::json;
+
+FaultSchedule FaultSchedule::from_json(const json& j) {
+    FaultSchedule schedule;
+    schedule.seed = j.value("seed", uint64_t{1});
+    schedule.repeat = j.value("repeat", false);
+
+    if (!j.contains("phases") || !j["phases"].is_array() || j["phases"].empty()) {
+        throw std::runtime_error("Fault schedule needs a non-empty phases array");
+    }
+    for (const auto& p : j["phases"]) {
+        FaultPhase phase;
+        phase.name = p.value("name", "phase " + std::to_string(schedule.phases.size() + 1));
+        phase.duration_seconds = p.value("duration_seconds", 0.0);
+        phase.latency = p.value("latency", "none");
+        phase.latency_ms = p.value("latency_ms", 0.0);
+        phase.latency_max_ms = p.value("latency_max_ms", phase.latency_ms);
+        phase.latency_sigma = p.value("latency_sigma", 0.5);
+        phase.timeout_rate = p.value("timeout_rate", 0.0);
+        phase.timeout_ms = p.value("timeout_ms", int64_t{0});
+        phase.http_error_rate = p.value("http_error_rate", 0.0);
+        phase.http_error_status = p.value("http_error_status", 503L);
+        phase.rate_limit_rate = p.value("rate_limit_rate", 0.0);
+        phase.truncate_rate = p.value("truncate_rate", 0.0);
+
+        if (phase.latency != "none" && phase.latency != "fixed" &&
+            phase.latency != "uniform" && phase.latency != "lognormal") {
+            throw std::runtime_error("Unknown latency distribution '" + phase.latency + "' in " + phase.name);
+        }
+        if (phase.duration_seconds < 0.0 || phase.latency_ms < 0.0 || phase.latency_max_ms < phase.latency_ms) {
+            throw std::runtime_error("Invalid duration or latency range in " + phase.name);
+        }
+        for (double rate : {phase.timeout_rate, phase.http_error_rate, phase.rate_limit_rate, phase.truncate_rate}) {
+            if (rate < 0.0 || rate > 1.0) {
+                throw std::runtime_error("Fault rates must be in [0, 1] in " + phase.name);
+            }
+        }
+        schedule.phases.push_back(phase);
+    }
+    return schedule;
+}
+
+FaultSchedule FaultSchedule::load(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open fault schedule: " + path);
+    }
+    return from_json(json::parse(file));
+}
+
+double FaultSchedule::total_seconds() const {
+    double total = 0.0;
+    for (const auto& phase : phases) {
+        total += phase.duration_seconds;
+    }
+    return total;
+}
+
+FaultInjectingTransport::FaultInjectingTransport(std::unique_ptr<HttpTransport> inner, FaultSchedule schedule)
+    : inner_(std::move(inner))
+    , schedule_(std::move(schedule))
+    , start_(std::chrono::steady_clock::now())
+    , rng_(schedule_.seed) {
+    LOG_WARNING("Fault injection active: " + std::to_string(schedule_.phases.size()) + " phases, seed " +
+                std::to_string(schedule_.seed));
+}
+
+const FaultPhase* FaultInjectingTransport::phase_at(double elapsed) const {
+    double cycle = schedule_.total_seconds();
+    if (schedule_.repeat && cycle > 0.0) {
+        elapsed = std::fmod(elapsed, cycle);
+    }
+    for (const auto& phase : schedule_.phases) {
+        if (phase.duration_seconds <= 0.0 || elapsed < phase.duration_seconds) {
+            return &phase;
+        }
+        elapsed -= phase.duration_seconds;
+    }
+    return &schedule_.phases.back();
+}
+
+std::string FaultInjectingTransport::current_phase() const {
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+    return phase_at(elapsed)->name;
+}
+
+// Sleep in short steps so a cancelled hedge stops waiting; false if cancelled
+static bool sleep_unless_cancelled(const HttpRequest& request, double ms) {
+    auto until = std::chrono::steady_clock::now() + std::chrono::microseconds(static_cast<int64_t>(ms * 1000.0));
+    while (std::chrono::steady_clock::now() < until) {
+        if (request.cancel && request.cancel->load(std::memory_order_acquire)) {
+            return false;
+        }
+        auto step = std::min<std::chrono::steady_clock::duration>(until - std::chrono::steady_clock::now(),
+                                                                  std::chrono::milliseconds(5));
+        std::this_thread::sleep_for(step);
+    }
+    return true;
+}
+
+HttpResponse FaultInjectingTransport::perform(const HttpRequest& request) {
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+    const FaultPhase& phase = *phase_at(elapsed);
+
+    // Draw everything up front so the sequence does not depend on which
+    // faults fired
+    double delay_ms = 0.0;
+    double u_timeout, u_error, u_limit, u_truncate, u_cut;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+        std::normal_distribution<double> normal(0.0, 1.0);
+        double u_latency = unit(rng_);
+        double z_latency = normal(rng_);
+        u_timeout = unit(rng_);
+        u_error = unit(rng_);
+        u_limit = unit(rng_);
+        u_truncate = unit(rng_);
+        u_cut = unit(rng_);
+
+        if (phase.latency == "fixed") {
+            delay_ms = phase.latency_ms;
+        } else if (phase.latency == "uniform") {
+            delay_ms = phase.latency_ms + u_latency * (phase.latency_max_ms - phase.latency_ms);
+        } else if (phase.latency == "lognormal") {
+            delay_ms = phase.latency_ms * std::exp(phase.latency_sigma * z_latency);
+        }
+
+        stats_.requests++;
+        if (delay_ms > 0.0) {
+            stats_.delayed++;
+            stats_.injected_latency_ms += delay_ms;
+        }
+        if (u_timeout < phase.timeout_rate) {
+            stats_.timeouts++;
+        } else if (u_error < phase.http_error_rate) {
+            stats_.http_errors++;
+        } else if (u_limit < phase.rate_limit_rate) {
+            stats_.rate_limited++;
+        } else if (u_truncate < phase.truncate_rate) {
+            stats_.truncated++;
+        }
+    }
+
+    HttpResponse response;
+    if (delay_ms > 0.0 && !sleep_unless_cancelled(request, delay_ms)) {
+        response.error = "Callback aborted";
+        response.cancelled = true;
+        return response;
+    }
+
+    if (u_timeout < phase.timeout_rate) {
+        int64_t hang_ms = phase.timeout_ms > 0 ? phase.timeout_ms : request.timeout_ms;
+        if (!sleep_unless_cancelled(request, static_cast<double>(hang_ms))) {
+            response.error = "Callback aborted";
+            response.cancelled = true;
+            return response;
+        }
+        response.error = "Timeout was reached (injected)";
+        return response;
+    }
+    if (u_error < phase.http_error_rate) {
+        response.ok = true;
+        response.status = phase.http_error_status;
+        return response;
+    }
+    if (u_limit < phase.rate_limit_rate) {
+        response.ok = true;
+        response.status = 200;
+        response.body = R"({"error":["EAPI:Rate limit exceeded"]})";
+        return response;
+    }
+
+    response = inner_->perform(request);
+    if (u_truncate < phase.truncate_rate && response.ok && !response.body.empty()) {
+        response.body.resize(static_cast<size_t>(u_cut * static_cast<double>(response.body.size())));
+    }
+    return response;
+}
+
+FaultStats FaultInjectingTransport::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
@@ -0,0 +1,79 @@
+#ifndef FAULT_INJECTION_HPP
+#define FAULT_INJECTION_HPP
+
+#include "http_transport.hpp"
+#include <nlohmann/json_fwd.hpp>
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <chrono>
+#include <cstdint>
+
+// Faults for one stretch of time. Rates are per-request probabilities,
+// checked in the order timeout, HTTP error, rate limit, truncation.
+struct FaultPhase {
+    std::string name;
+    double duration_seconds = 0.0;      // 0 = lasts until the end
+    std::string latency = "none";       // none, fixed, uniform or lognormal
+    double latency_ms = 0.0;            // fixed value, uniform min or lognormal median
+    double latency_max_ms = 0.0;        // uniform max
+    double latency_sigma = 0.5;         // lognormal shape
+    double timeout_rate = 0.0;          // Hang for timeout_ms, then fail
+    int64_t timeout_ms = 0;             // 0 = the request's own timeout
+    double http_error_rate = 0.0;
+    long http_error_status = 503;
+    double rate_limit_rate = 0.0;       // 200 with EAPI:Rate limit exceeded
+    double truncate_rate = 0.0;         // Real response cut short
+};
+
+struct FaultSchedule {
+    uint64_t seed = 1;
+    bool repeat = false;                // Cycle the phases instead of holding the last
+    std::vector<FaultPhase> phases;
+
+    static FaultSchedule from_json(const nlohmann::json& j);
+    static FaultSchedule load(const std::string& path);
+
+    // Sum of finite phase durations
+    double total_seconds() const;
+};
+
+struct FaultStats {
+    uint64_t requests = 0;
+    uint64_t delayed = 0;
+    uint64_t timeouts = 0;
+    uint64_t http_errors = 0;
+    uint64_t rate_limited = 0;
+    uint64_t truncated = 0;
+    double injected_latency_ms = 0.0;
+};
+
+// Decorator that perturbs requests according to a seeded schedule. The
+// random draws depend only on the seed and the request count, so a rerun
+// with the same schedule sees the same fault sequence.
+class FaultInjectingTransport : public HttpTransport {
+public:
+    FaultInjectingTransport(std::unique_ptr<HttpTransport> inner, FaultSchedule schedule);
+
+    HttpResponse perform(const HttpRequest& request) override;
+    HttpTransportStats transport_stats() const override { return inner_->transport_stats(); }
+    bool pin_host(const std::string& url) override { return inner_->pin_host(url); }
+
+    FaultStats stats() const;
+    std::string current_phase() const;
+
+private:
+    const FaultPhase* phase_at(double elapsed_seconds) const;
+
+    std::unique_ptr<HttpTransport> inner_;
+    FaultSchedule schedule_;
+    std::chrono::steady_clock::time_point start_;
+
+    mutable std::mutex mutex_;
+    std::mt19937_64 rng_;
+    FaultStats stats_;
+};
+
+#endif // FAULT_INJECTION_HPP
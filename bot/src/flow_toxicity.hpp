@@ -0,0 +1,66 @@
+#ifndef FLOW_TOXICITY_HPP
+#define FLOW_TOXICITY_HPP
+
+#include "kraken_client.hpp"
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// Signs trades by aggressor: the side Kraken reports, or the tick rule when
+// the print has none (up-tick buy, down-tick sell, a zero tick repeats the
+// previous sign)
+class TradeSignClassifier {
+public:
+    // +1 buy, -1 sell, 0 while the tick rule has no previous move to go on
+    int classify(const TradePrint& print);
+
+    uint64_t tick_rule_prints() const { return tick_rule_prints_; }
+
+private:
+    double last_price_ = 0.0;
+    int last_sign_ = 0;
+    uint64_t tick_rule_prints_ = 0;
+};
+
+struct FlowSignals {
+    bool valid = false;           // Every bucket in the window has filled
+    int buckets = 0;              // Filled buckets in the window
+    double vpin = 0.0;            // Mean |buy - sell| / bucket volume over
+                                  // the window, 0 (balanced) .. 1 (one-sided)
+    double imbalance = 0.0;       // Mean (buy - sell) / bucket volume over the
+                                  // window, -1 (all sells) .. 1 (all buys)
+    double bucket_fill = 0.0;     // Share of the open bucket filled so far
+    uint64_t buckets_closed = 0;
+};
+
+// Volume-synchronised order-flow imbalance and VPIN (Easley, Lopez de Prado
+// and O'Hara). Signed volume fills fixed-size buckets; each full bucket's
+// imbalance goes into a ring of the last window_buckets buckets and its
+// running sums. Memory is fixed at construction and a trade costs O(1),
+// plus one ring write per bucket it completes.
+class FlowToxicity {
+public:
+    FlowToxicity(double bucket_volume, int window_buckets);
+
+    // sign as returned by TradeSignClassifier; 0 splits the volume evenly
+    void add(double volume, int sign);
+
+    FlowSignals signals() const;
+
+private:
+    void close_bucket();
+
+    double bucket_volume_;
+    std::vector<double> abs_ring_;      // |buy - sell| per closed bucket
+    std::vector<double> signed_ring_;   // buy - sell per closed bucket
+    size_t head_ = 0;
+    size_t count_ = 0;
+    double abs_sum_ = 0.0;
+    double signed_sum_ = 0.0;
+
+    double buy_ = 0.0;                  // Open bucket
+    double sell_ = 0.0;
+    uint64_t buckets_closed_ = 0;
+};
+
+#endif // FLOW_TOXICITY_HPP
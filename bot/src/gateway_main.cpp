@@ -0,0 +1,231 @@
+#include "config.hpp"
+#include "logger.hpp"
+#include "kraken_client.hpp"
+#include "http_recording.hpp"
+#include "market_data.hpp"
+#include "shm_ring.hpp"
+#include "tick_store.hpp"
+#include "tick_archive.hpp"
+#include "util.hpp"
+
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <csignal>
+#include <atomic>
+#include <algorithm>
+#include <unordered_map>
+#include <memory>
+
+// Polls Kraken once for every subscribed pair and publishes ticks, top-of-book
+// and closed bars into a shared-memory ring that any number of bot processes
+// read without touching the network.
+
+static std::atomic<bool> g_running{true};
+
+void signal_handler(int signal) {
+    LOG_INFO("Received signal " + std::to_string(signal) + ", initiating shutdown...");
+    g_running = false;
+}
+
+// Bar being built for one pair
+struct BarBuilder {
+    int64_t start_ns = 0;
+    double open = 0.0;
+    double high = 0.0;
+    double low = 0.0;
+    double close = 0.0;
+};
+
+static void publish_tick(ShmRingWriter& ring, const MarketSnapshot& snap) {
+    ShmRecord record{};
+    record.type = ShmRecordType::TICK;
+    record.set_pair(snap.pair);
+    record.exchange_ns = snap.exchange_ns;
+    record.receive_ns = snap.receive_ns;
+    record.tick.last_price = snap.last_price;
+    record.tick.bid_price = snap.bid_price;
+    record.tick.ask_price = snap.ask_price;
+    record.tick.volume_24h = snap.volume_24h;
+    ring.publish(record);
+}
+
+// The ticker only carries the best level on each side
+static void publish_book(ShmRingWriter& ring, const MarketSnapshot& snap) {
+    ShmRecord record{};
+    record.type = ShmRecordType::BOOK;
+    record.set_pair(snap.pair);
+    record.exchange_ns = snap.exchange_ns;
+    record.receive_ns = snap.receive_ns;
+    record.book.bid_price[0] = snap.bid_price;
+    record.book.bid_volume[0] = snap.bid_volume;
+    record.book.ask_price[0] = snap.ask_price;
+    record.book.ask_volume[0] = snap.ask_volume;
+    record.book.bid_levels = snap.bid_price > 0.0 ? 1 : 0;
+    record.book.ask_levels = snap.ask_price > 0.0 ? 1 : 0;
+    ring.publish(record);
+}
+
+static void publish_bar(ShmRingWriter& ring, const std::string& pair, const BarBuilder& bar,
+                        int64_t interval_ns, int64_t receive_ns) {
+    ShmRecord record{};
+    record.type = ShmRecordType::BAR;
+    record.set_pair(pair);
+    record.receive_ns = receive_ns;
+    record.bar.open = bar.open;
+    record.bar.high = bar.high;
+    record.bar.low = bar.low;
+    record.bar.close = bar.close;
+    record.bar.volume = 0.0;  // Ticker quotes carry no per-interval volume
+    record.bar.start_ns = bar.start_ns;
+    record.bar.interval_ns = interval_ns;
+    ring.publish(record);
+}
+
+// Fold a quote into the pair's bar; publishes the previous bar once a quote
+// lands in a later interval
+static void update_bar(ShmRingWriter& ring, BarBuilder& bar, const MarketSnapshot& snap, int64_t interval_ns) {
+    const int64_t start_ns = snap.receive_ns - snap.receive_ns % interval_ns;
+    if (bar.start_ns != start_ns) {
+        if (bar.start_ns != 0) {
+            publish_bar(ring, snap.pair, bar, interval_ns, snap.receive_ns);
+        }
+        bar.start_ns = start_ns;
+        bar.open = snap.last_price;
+        bar.high = snap.last_price;
+        bar.low = snap.last_price;
+    }
+    bar.high = std::max(bar.high, snap.last_price);
+    bar.low = std::min(bar.low, snap.last_price);
+    bar.close = snap.last_price;
+}
+
+int main(int argc, char* argv[]) {
+    std::signal(SIGINT, signal_handler);
+    std::signal(SIGTERM, signal_handler);
+    
+    std::string config_file = "config.json";
+    if (argc > 1) {
+        config_file = argv[1];
+    }
+    
+    Config config;
+    try {
+        config = Config::load(config_file);
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to load config: " << e.what() << std::endl;
+        return 1;
+    }
+    
+    Logger::instance().init(config.log_dir, "gateway.log");
+    
+    LOG_INFO("========================================");
+    LOG_INFO("Kraken Market Data Gateway Starting");
+    LOG_INFO("========================================");
+    
+    if (!config.validate()) {
+        LOG_ERROR("Configuration validation failed");
+        return 1;
+    }
+    
+    std::vector<std::string> pairs = config.gateway_pairs;
+    if (pairs.empty()) {
+        pairs.push_back(config.pair);
+    }
+    LOG_INFO("Publishing " + std::to_string(pairs.size()) + " pairs to " + config.shm_name +
+             " every " + std::to_string(config.poll_interval_seconds) + "s");
+    
+    // Public endpoints only; no credentials needed
+    KrakenClient client(config.kraken_api_base, config.rate_limit_min_delay_ms);
+    client.set_endpoint_policy(config.endpoint_policy());
+    client.set_request_timeout_ms(config.http_timeout_ms);
+    client.set_rate_limit_burst(config.rate_limit_burst);
+    std::unique_ptr<HttpTransport> transport = std::make_unique<CurlTransport>(config.curl_options());
+    if (!config.http_record_file.empty()) {
+        transport = std::make_unique<RecordingTransport>(std::move(transport), config.http_record_file);
+    }
+    client.set_transport(std::move(transport));
+    if (config.http_prewarm) {
+        client.warm_up();
+    }
+    if (!client.sync_clock(3)) {
+        LOG_WARNING("Clock sync failed, exchange timestamps fall back to the local clock");
+    }
+    auto last_clock_sync = std::chrono::steady_clock::now();
+    
+    MarketDataCache market_data(client);
+    market_data.track(pairs);
+    
+    ShmRingWriter ring(config.shm_name, static_cast<uint64_t>(config.shm_capacity));
+    if (!ring.is_open()) {
+        LOG_ERROR("Failed to create market data ring " + config.shm_name);
+        return 1;
+    }
+    
+    std::unique_ptr<TickRecorder> recorder;
+    if (!config.tick_store_dir.empty()) {
+        recorder = std::make_unique<TickRecorder>(config.tick_store_dir, config.tick_segment_seconds);
+    }
+    std::unique_ptr<TickCompactor> compactor;
+    if (config.tick_compact_enabled) {
+        compactor = std::make_unique<TickCompactor>(config.tick_store_dir);
+        compactor->start(config.tick_compact_interval_seconds);
+    }
+    
+    const int64_t bar_interval_ns = config.gateway_bar_seconds * 1'000'000'000;
+    std::unordered_map<std::string, BarBuilder> bars;
+    
+    while (g_running) {
+        if (client.get_consecutive_failures() >= config.max_consecutive_failures) {
+            LOG_ERROR("Too many consecutive API failures (" +
+                      std::to_string(client.get_consecutive_failures()) +
+                      "), halting gateway");
+            break;
+        }
+        
+        if (config.clock_sync_interval_seconds > 0 &&
+            std::chrono::steady_clock::now() - last_clock_sync >=
+                std::chrono::seconds(config.clock_sync_interval_seconds)) {
+            client.sync_clock(1);
+            last_clock_sync = std::chrono::steady_clock::now();
+        }
+        
+        if (market_data.refresh()) {
+            std::shared_ptr<const SnapshotTable> table = market_data.snapshot();
+            if (recorder) {
+                recorder->record(*table);
+            }
+            size_t published = 0;
+            for (const auto& snap : table->snapshots()) {
+                // Rows that missed this refresh were already published
+                if (snap.version != table->version() || snap.last_price <= 0.0) {
+                    continue;
+                }
+                publish_tick(ring, snap);
+                publish_book(ring, snap);
+                update_bar(ring, bars[snap.pair], snap, bar_interval_ns);
+                published++;
+            }
+            LOG_DEBUG("Published " + std::to_string(published) + " quotes, ring sequence " +
+                      std::to_string(ring.published()));
+        } else {
+            LOG_WARNING("Market data refresh failed, nothing published this tick");
+        }
+        
+        // Heartbeat every second so readers can tell a slow poll from a dead gateway
+        for (int64_t i = 0; i < config.poll_interval_seconds && g_running; i++) {
+            ring.heartbeat();
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+            client.keep_warm(config.http_keepalive_seconds);
+        }
+    }
+    
+    if (compactor) {
+        compactor->stop();
+        CompactionStats c = compactor->totals();
+        LOG_INFO("Tick compactor: " + std::to_string(c.segments) + " segments, " + std::to_string(c.hot_bytes) +
+                 " -> " + std::to_string(c.cold_bytes) + " bytes, " + std::to_string(c.failures) + " failed");
+    }
+    LOG_INFO("Gateway stopped cleanly (" + std::to_string(ring.published()) + " records published)");
+    return 0;
+}
@@ -0,0 +1,301 @@
+#include "http_recording.hpp"
+#include "logger.hpp"
+#include "util.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <cerrno>
+#include <filesystem>
+#include <stdexcept>
+#include <thread>
+
+static constexpr char kHttpMagic[8] = {'K', 'R', 'K', 'N', 'H', 'T', 'P', '1'};
+static constexpr uint32_t kHttpVersion = 1;
+
+struct HttpFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t record_header_size;
+    char reserved[48];
+};
+static_assert(sizeof(HttpFileHeader) == 64, "http recording header must stay 64 bytes");
+
+enum : uint8_t {
+    kFlagOk = 1,
+    kFlagCancelled = 2
+};
+
+// Fixed part of each record; the url, request body, response body and error
+// follow in that order
+struct HttpRecordHeader {
+    uint32_t payload_size;
+    uint8_t method;            // 0 = GET, 1 = POST
+    uint8_t flags;
+    uint16_t reserved;
+    int32_t status;
+    uint32_t target_len;
+    uint32_t request_len;
+    uint32_t response_len;
+    uint32_t error_len;
+    uint32_t reserved2;
+    int64_t start_ns;
+    int64_t send_ns;
+    int64_t recv_ns;
+    int64_t done_ns;
+};
+static_assert(sizeof(HttpRecordHeader) == 64, "http record header layout changed");
+
+std::string url_target(const std::string& url) {
+    size_t scheme = url.find("://");
+    if (scheme == std::string::npos) {
+        return url;
+    }
+    size_t path = url.find('/', scheme + 3);
+    return path == std::string::npos ? "/" : url.substr(path);
+}
+
+// Path without the query
+static std::string target_path(const std::string& target) {
+    return target.substr(0, target.find('?'));
+}
+
+HttpRecordWriter::HttpRecordWriter(const std::string& path)
+    : path_(path) {
+    std::filesystem::path parent = std::filesystem::path(path).parent_path();
+    if (!parent.empty()) {
+        std::error_code ec;
+        std::filesystem::create_directories(parent, ec);
+    }
+
+    file_ = std::fopen(path_.c_str(), "ab");
+    if (file_ == nullptr) {
+        LOG_ERROR("Failed to open HTTP recording " + path_ + ": " + std::string(std::strerror(errno)));
+        return;
+    }
+
+    // Appending to an existing recording continues it
+    std::fseek(file_, 0, SEEK_END);
+    if (std::ftell(file_) == 0) {
+        HttpFileHeader header{};
+        std::memcpy(header.magic, kHttpMagic, sizeof(kHttpMagic));
+        header.version = kHttpVersion;
+        header.record_header_size = sizeof(HttpRecordHeader);
+        std::fwrite(&header, sizeof(header), 1, file_);
+        std::fflush(file_);
+    }
+    LOG_INFO("Recording HTTP exchanges to " + path_);
+}
+
+HttpRecordWriter::~HttpRecordWriter() {
+    if (file_ != nullptr) {
+        std::fclose(file_);
+    }
+}
+
+bool HttpRecordWriter::append(const HttpRecord& record) {
+    if (file_ == nullptr) {
+        return false;
+    }
+
+    HttpRecordHeader header{};
+    header.method = record.method == "POST" ? 1 : 0;
+    header.flags = static_cast<uint8_t>((record.response.ok ? kFlagOk : 0) |
+                                        (record.response.cancelled ? kFlagCancelled : 0));
+    header.status = static_cast<int32_t>(record.response.status);
+    header.target_len = static_cast<uint32_t>(record.target.size());
+    header.request_len = static_cast<uint32_t>(record.request_body.size());
+    header.response_len = static_cast<uint32_t>(record.response.body.size());
+    header.error_len = static_cast<uint32_t>(record.response.error.size());
+    header.payload_size = header.target_len + header.request_len + header.response_len + header.error_len;
+    header.start_ns = record.start_ns;
+    header.send_ns = record.response.timing.send_ns;
+    header.recv_ns = record.response.timing.recv_ns;
+    header.done_ns = record.done_ns;
+
+    bool ok = std::fwrite(&header, sizeof(header), 1, file_) == 1 &&
+              std::fwrite(record.target.data(), 1, record.target.size(), file_) == record.target.size() &&
+              std::fwrite(record.request_body.data(), 1, record.request_body.size(), file_) == record.request_body.size() &&
+              std::fwrite(record.response.body.data(), 1, record.response.body.size(), file_) == record.response.body.size() &&
+              std::fwrite(record.response.error.data(), 1, record.response.error.size(), file_) == record.response.error.size();
+    std::fflush(file_);
+    if (ok) {
+        written_++;
+    }
+    return ok;
+}
+
+std::vector<HttpRecord> read_http_records(const std::string& path) {
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        throw std::runtime_error("Cannot open HTTP recording " + path + ": " + std::strerror(errno));
+    }
+
+    HttpFileHeader header{};
+    if (std::fread(&header, sizeof(header), 1, file) != 1 ||
+        std::memcmp(header.magic, kHttpMagic, sizeof(kHttpMagic)) != 0 ||
+        header.version != kHttpVersion || header.record_header_size != sizeof(HttpRecordHeader)) {
+        std::fclose(file);
+        throw std::runtime_error(path + " is not an HTTP recording");
+    }
+
+    std::vector<HttpRecord> records;
+    std::string payload;
+    HttpRecordHeader rh{};
+    while (std::fread(&rh, sizeof(rh), 1, file) == 1) {
+        payload.resize(rh.payload_size);
+        if (rh.payload_size != static_cast<uint64_t>(rh.target_len) + rh.request_len + rh.response_len + rh.error_len ||
+            std::fread(payload.data(), 1, payload.size(), file) != payload.size()) {
+            LOG_WARNING("HTTP recording " + path + " ends with a torn record, ignoring it");
+            break;
+        }
+
+        HttpRecord r;
+        size_t pos = 0;
+        r.method = rh.method == 1 ? "POST" : "GET";
+        r.target = payload.substr(pos, rh.target_len);
+        pos += rh.target_len;
+        r.request_body = payload.substr(pos, rh.request_len);
+        pos += rh.request_len;
+        r.response.body = payload.substr(pos, rh.response_len);
+        pos += rh.response_len;
+        r.response.error = payload.substr(pos, rh.error_len);
+        r.response.ok = (rh.flags & kFlagOk) != 0;
+        r.response.cancelled = (rh.flags & kFlagCancelled) != 0;
+        r.response.status = rh.status;
+        r.response.timing.send_ns = rh.send_ns;
+        r.response.timing.recv_ns = rh.recv_ns;
+        r.start_ns = rh.start_ns;
+        r.done_ns = rh.done_ns;
+        records.push_back(std::move(r));
+    }
+    std::fclose(file);
+    return records;
+}
+
+RecordingTransport::RecordingTransport(std::unique_ptr<HttpTransport> inner, const std::string& path)
+    : inner_(std::move(inner))
+    , writer_(path) {
+}
+
+HttpResponse RecordingTransport::perform(const HttpRequest& request) {
+    HttpRecord record;
+    record.start_ns = util::now_epoch_ns();
+    HttpResponse response = inner_->perform(request);
+    record.done_ns = util::now_epoch_ns();
+
+    record.method = request.method;
+    record.target = url_target(request.url);
+    record.request_body = request.body;
+    record.response = response;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    writer_.append(record);
+    return response;
+}
+
+ReplayTransport::ReplayTransport(std::vector<HttpRecord> records, double speed, bool loop)
+    : speed_(speed)
+    , loop_(loop) {
+    // A cancelled hedge never reached the caller; its twin's record did
+    for (HttpRecord& r : records) {
+        if (!r.response.cancelled) {
+            records_.push_back(std::move(r));
+        }
+    }
+    served_.assign(records_.size(), true);
+    remaining_ = 0;
+}
+
+std::unique_ptr<ReplayTransport> ReplayTransport::load(const std::string& path, double speed, bool loop) {
+    auto replay = std::make_unique<ReplayTransport>(read_http_records(path), speed, loop);
+    LOG_INFO("Replaying " + std::to_string(replay->size()) + " HTTP exchanges from " + path);
+    return replay;
+}
+
+ReplayStats ReplayTransport::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+const HttpRecord* ReplayTransport::take_from(std::deque<size_t>& queue) {
+    while (!queue.empty()) {
+        size_t idx = queue.front();
+        queue.pop_front();
+        if (!served_[idx]) {
+            served_[idx] = true;
+            remaining_--;
+            return &records_[idx];
+        }
+    }
+    return nullptr;
+}
+
+const HttpRecord* ReplayTransport::take(const std::string& method, const std::string& target) {
+    // Index lazily so the first pass and every loop start from the same state
+    if (remaining_ == 0 && (stats_.served == 0 || loop_) && !records_.empty()) {
+        if (stats_.served > 0) {
+            stats_.loops++;
+        }
+        by_target_.clear();
+        by_path_.clear();
+        for (size_t i = 0; i < records_.size(); i++) {
+            by_target_[records_[i].method + " " + records_[i].target].push_back(i);
+            by_path_[records_[i].method + " " + target_path(records_[i].target)].push_back(i);
+        }
+        served_.assign(records_.size(), false);
+        remaining_ = records_.size();
+    }
+
+    if (const HttpRecord* r = take_from(by_target_[method + " " + target])) {
+        return r;
+    }
+    return take_from(by_path_[method + " " + target_path(target)]);
+}
+
+HttpResponse ReplayTransport::perform(const HttpRequest& request) {
+    const std::string target = url_target(request.url);
+    const int64_t start_ns = util::now_epoch_ns();
+
+    const HttpRecord* record = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        record = take(request.method, target);
+        if (record == nullptr) {
+            stats_.misses++;
+        } else {
+            stats_.served++;
+        }
+    }
+
+    HttpResponse response;
+    if (record == nullptr) {
+        response.error = "No recorded response for " + request.method + " " + target;
+        return response;
+    }
+
+    response = record->response;
+    const double scale = speed_ > 0.0 ? 1.0 / speed_ : 0.0;
+    const int64_t send_after = static_cast<int64_t>(static_cast<double>(record->response.timing.send_ns - record->start_ns) * scale);
+    const int64_t recv_after = static_cast<int64_t>(static_cast<double>(record->response.timing.recv_ns - record->start_ns) * scale);
+    const int64_t done_after = static_cast<int64_t>(static_cast<double>(record->done_ns - record->start_ns) * scale);
+
+    if (done_after > 0) {
+        auto until = std::chrono::steady_clock::now() + std::chrono::nanoseconds(done_after);
+        while (std::chrono::steady_clock::now() < until) {
+            if (request.cancel && request.cancel->load(std::memory_order_acquire)) {
+                HttpResponse cancelled;
+                cancelled.error = "Callback aborted";
+                cancelled.cancelled = true;
+                return cancelled;
+            }
+            std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(
+                until - std::chrono::steady_clock::now(), std::chrono::milliseconds(5)));
+        }
+    }
+
+    if (record->response.timing.recv_ns != 0) {
+        response.timing.send_ns = start_ns + std::max<int64_t>(0, send_after);
+        response.timing.recv_ns = start_ns + std::max<int64_t>(0, recv_after);
+    }
+    return response;
+}
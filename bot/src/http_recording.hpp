@@ -0,0 +1,111 @@
+#ifndef HTTP_RECORDING_HPP
+#define HTTP_RECORDING_HPP
+
+#include "http_transport.hpp"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <cstdio>
+#include <cstdint>
+
+// One request/response exchange. The target is the URL's path and query
+// with the scheme and host stripped, so a session recorded against one API
+// base replays against any other. Request headers (API-Key, API-Sign) are
+// never recorded.
+struct HttpRecord {
+    std::string method;
+    std::string target;
+    std::string request_body;
+    HttpResponse response;
+    int64_t start_ns = 0;      // Wall clock when the request was issued
+    int64_t done_ns = 0;       // Wall clock when the response was complete
+};
+
+// "/0/public/Ticker?pair=X" from "https://api.kraken.com/0/public/Ticker?pair=X"
+std::string url_target(const std::string& url);
+
+// Appends exchanges to a recording: a fixed header followed by
+// length-prefixed binary records, flushed one at a time so a crash loses at
+// most the exchange in flight
+class HttpRecordWriter {
+public:
+    explicit HttpRecordWriter(const std::string& path);
+    ~HttpRecordWriter();
+
+    HttpRecordWriter(const HttpRecordWriter&) = delete;
+    HttpRecordWriter& operator=(const HttpRecordWriter&) = delete;
+
+    bool is_open() const { return file_ != nullptr; }
+    bool append(const HttpRecord& record);
+    uint64_t written() const { return written_; }
+
+private:
+    std::string path_;
+    FILE* file_ = nullptr;
+    uint64_t written_ = 0;
+};
+
+// Every whole record in a recording, in order; a torn final record is
+// dropped. Throws std::runtime_error if the file cannot be read.
+std::vector<HttpRecord> read_http_records(const std::string& path);
+
+// Passes requests through to the inner transport and records each exchange
+class RecordingTransport : public HttpTransport {
+public:
+    RecordingTransport(std::unique_ptr<HttpTransport> inner, const std::string& path);
+
+    HttpResponse perform(const HttpRequest& request) override;
+    HttpTransportStats transport_stats() const override { return inner_->transport_stats(); }
+    bool pin_host(const std::string& url) override { return inner_->pin_host(url); }
+
+private:
+    std::unique_ptr<HttpTransport> inner_;
+    std::mutex mutex_;
+    HttpRecordWriter writer_;
+};
+
+struct ReplayStats {
+    uint64_t served = 0;
+    uint64_t misses = 0;       // Requests with no recorded response left
+    uint64_t loops = 0;        // Times a looping replay started over
+};
+
+// Serves recorded responses without touching the network. A request takes
+// the oldest unserved record with the same method and target, falling back
+// to the same path with any query (cursors like Trades' since= can differ
+// once a replayed session diverges). speed 1 reproduces recorded latencies,
+// 2 halves them, 0 answers immediately. Timings are shifted to the present;
+// the replayed Time responses then carry the recording's age in the clock
+// offset, so quote ages come out as they were recorded.
+class ReplayTransport : public HttpTransport {
+public:
+    ReplayTransport(std::vector<HttpRecord> records, double speed, bool loop = false);
+
+    // Throws std::runtime_error if the recording cannot be read
+    static std::unique_ptr<ReplayTransport> load(const std::string& path, double speed, bool loop = false);
+
+    HttpResponse perform(const HttpRequest& request) override;
+
+    size_t size() const { return records_.size(); }
+    ReplayStats stats() const;
+
+private:
+    const HttpRecord* take(const std::string& method, const std::string& target);
+    const HttpRecord* take_from(std::deque<size_t>& queue);
+
+    std::vector<HttpRecord> records_;
+    double speed_;
+    bool loop_;
+
+    mutable std::mutex mutex_;
+    std::vector<bool> served_;
+    std::unordered_map<std::string, std::deque<size_t>> by_target_;
+    std::unordered_map<std::string, std::deque<size_t>> by_path_;
+    size_t remaining_ = 0;
+    ReplayStats stats_;
+};
+
+#endif // HTTP_RECORDING_HPP
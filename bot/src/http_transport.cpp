@@ -0,0 +1,434 @@
+#include "http_transport.hpp"
+#include "logger.hpp"
+#include "util.hpp"
+#include <curl/curl.h>
+#include <sys/socket.h>
+#include <netdb.h>
+#include <arpa/inet.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <condition_variable>
+#include <thread>
+#include <mutex>
+
+// Curl write callback
+static size_t write_callback(void* contents, size_t size, size_t nmemb, std::string* userp) {
+    size_t total_size = size * nmemb;
+    userp->append(static_cast<char*>(contents), total_size);
+    return total_size;
+}
+
+// Progress callback: a non-zero return aborts the transfer
+static int cancel_callback(void* clientp, curl_off_t, curl_off_t, curl_off_t, curl_off_t) {
+    const auto* cancel = static_cast<const std::atomic<bool>*>(clientp);
+    return cancel->load(std::memory_order_acquire) ? 1 : 0;
+}
+
+// Idle handles kept beyond this are closed
+static constexpr size_t kMaxIdleHandles = 4;
+
+// Header lines linked per request; more are ignored
+static constexpr size_t kMaxHeaderLines = 16;
+
+// Latency samples kept per cold/warm group
+static constexpr size_t kLatencyWindow = 256;
+
+// Applies the configured socket buffer sizes to each new connection
+static int sockopt_callback(void* clientp, curl_socket_t fd, curlsocktype purpose) {
+    if (purpose != CURLSOCKTYPE_IPCXN) {
+        return CURL_SOCKOPT_OK;
+    }
+    const auto* options = static_cast<const CurlOptions*>(clientp);
+    if (options->sndbuf_bytes > 0) {
+        int size = static_cast<int>(options->sndbuf_bytes);
+        setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &size, sizeof(size));
+    }
+    if (options->rcvbuf_bytes > 0) {
+        int size = static_cast<int>(options->rcvbuf_bytes);
+        setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+    }
+    return CURL_SOCKOPT_OK;
+}
+
+static double quantile(const std::deque<double>& samples, double q) {
+    if (samples.empty()) {
+        return 0.0;
+    }
+    std::vector<double> sorted(samples.begin(), samples.end());
+    std::sort(sorted.begin(), sorted.end());
+    size_t idx = static_cast<size_t>(std::ceil(q * static_cast<double>(sorted.size()))) - 1;
+    return sorted[std::min(idx, sorted.size() - 1)];
+}
+
+static void push_sample(std::deque<double>& samples, double ms) {
+    samples.push_back(ms);
+    if (samples.size() > kLatencyWindow) {
+        samples.pop_front();
+    }
+}
+
+static void global_init() {
+    // curl_easy_init would do this lazily, but not thread-safely (hedged
+    // requests run on their own threads)
+    static std::once_flag curl_init;
+    std::call_once(curl_init, [] { curl_global_init(CURL_GLOBAL_DEFAULT); });
+}
+
+// One request waiting on the multiplexing thread
+struct Transfer {
+    CURLcode result = CURLE_OK;
+    bool done = false;
+};
+
+struct CurlTransport::Multi {
+    CURLM* handle = nullptr;
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<CURL*> submitted;
+    bool stop = false;
+
+    void run();
+};
+
+void CurlTransport::Multi::run() {
+    for (;;) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (stop) {
+                return;
+            }
+            for (CURL* easy : submitted) {
+                curl_multi_add_handle(handle, easy);
+            }
+            submitted.clear();
+        }
+        
+        int running = 0;
+        curl_multi_perform(handle, &running);
+        
+        int queued = 0;
+        while (CURLMsg* msg = curl_multi_info_read(handle, &queued)) {
+            if (msg->msg != CURLMSG_DONE) {
+                continue;
+            }
+            CURL* easy = msg->easy_handle;
+            CURLcode result = msg->data.result;
+            Transfer* transfer = nullptr;
+            curl_easy_getinfo(easy, CURLINFO_PRIVATE, &transfer);
+            curl_multi_remove_handle(handle, easy);
+            
+            std::lock_guard<std::mutex> lock(mutex);
+            transfer->result = result;
+            transfer->done = true;
+            cv.notify_all();
+        }
+        
+        // Woken early by curl_multi_wakeup when a request is submitted
+        curl_multi_poll(handle, nullptr, 0, 1000, nullptr);
+    }
+}
+
+CurlTransport::CurlTransport(CurlOptions options)
+    : options_(options)
+    , http2_(options.http2) {
+    global_init();
+    if (http2_ && !(curl_version_info(CURLVERSION_NOW)->features & CURL_VERSION_HTTP2)) {
+        LOG_WARNING("libcurl was built without HTTP/2, using HTTP/1.1");
+        http2_ = false;
+    }
+    stats_.http2 = http2_;
+    if (!http2_) {
+        return;
+    }
+    
+    multi_ = std::make_unique<Multi>();
+    multi_->handle = curl_multi_init();
+    curl_multi_setopt(multi_->handle, CURLMOPT_PIPELINING, static_cast<long>(CURLPIPE_MULTIPLEX));
+    multi_->worker = std::thread([multi = multi_.get()] { multi->run(); });
+}
+
+CurlTransport::~CurlTransport() {
+    if (multi_) {
+        {
+            std::lock_guard<std::mutex> lock(multi_->mutex);
+            multi_->stop = true;
+        }
+        curl_multi_wakeup(multi_->handle);
+        multi_->worker.join();
+    }
+    for (void* handle : idle_) {
+        curl_easy_cleanup(static_cast<CURL*>(handle));
+    }
+    if (multi_) {
+        curl_multi_cleanup(multi_->handle);
+    }
+}
+
+int CurlTransport::run_multiplexed(void* handle) {
+    CURL* easy = static_cast<CURL*>(handle);
+    Transfer transfer;
+    curl_easy_setopt(easy, CURLOPT_PRIVATE, &transfer);
+    
+    std::unique_lock<std::mutex> lock(multi_->mutex);
+    multi_->submitted.push_back(easy);
+    curl_multi_wakeup(multi_->handle);
+    multi_->cv.wait(lock, [&] { return transfer.done; });
+    return transfer.result;
+}
+
+HttpTransportStats CurlTransport::transport_stats() const {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    HttpTransportStats out = stats_;
+    out.cold_p50_ms = quantile(cold_ms_, 0.50);
+    out.cold_p99_ms = quantile(cold_ms_, 0.99);
+    out.warm_p50_ms = quantile(warm_ms_, 0.50);
+    out.warm_p99_ms = quantile(warm_ms_, 0.99);
+    if (stats_.cold_requests > 0) {
+        double n = static_cast<double>(stats_.cold_requests);
+        out.cold_dns_ms = cold_dns_total_ms_ / n;
+        out.cold_connect_ms = cold_connect_total_ms_ / n;
+        out.cold_tls_ms = cold_tls_total_ms_ / n;
+    }
+    return out;
+}
+
+bool CurlTransport::pin_host(const std::string& url) {
+    size_t scheme_end = url.find("://");
+    if (scheme_end == std::string::npos) {
+        return false;
+    }
+    size_t host_start = scheme_end + 3;
+    size_t host_end = url.find_first_of(":/", host_start);
+    std::string host = url.substr(host_start, host_end == std::string::npos ? std::string::npos : host_end - host_start);
+    std::string port = url.compare(0, scheme_end, "https") == 0 ? "443" : "80";
+    if (host_end != std::string::npos && url[host_end] == ':') {
+        size_t port_end = url.find('/', host_end);
+        port = url.substr(host_end + 1, port_end == std::string::npos ? std::string::npos : port_end - host_end - 1);
+    }
+    
+    // Address literals need no lookup
+    unsigned char buf[sizeof(struct in6_addr)];
+    if (host.empty() || inet_pton(AF_INET, host.c_str(), buf) == 1 || inet_pton(AF_INET6, host.c_str(), buf) == 1) {
+        return true;
+    }
+    
+    const std::string key = host + ":" + port;
+    auto now = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(pin_mutex_);
+        auto it = pins_.find(key);
+        if (it != pins_.end() && now - it->second.resolved < std::chrono::seconds(options_.dns_refresh_seconds)) {
+            return true;
+        }
+    }
+    
+    struct addrinfo hints {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    struct addrinfo* found = nullptr;
+    int rc = getaddrinfo(host.c_str(), port.c_str(), &hints, &found);
+    if (rc != 0) {
+        // An existing pin stays in use until a lookup succeeds
+        LOG_WARNING("DNS pre-resolution of " + host + " failed: " + std::string(gai_strerror(rc)));
+        return false;
+    }
+    
+    std::vector<std::string> addrs;
+    for (struct addrinfo* ai = found; ai != nullptr; ai = ai->ai_next) {
+        char text[INET6_ADDRSTRLEN] = {};
+        const void* addr = ai->ai_family == AF_INET
+            ? static_cast<const void*>(&reinterpret_cast<struct sockaddr_in*>(ai->ai_addr)->sin_addr)
+            : static_cast<const void*>(&reinterpret_cast<struct sockaddr_in6*>(ai->ai_addr)->sin6_addr);
+        if (inet_ntop(ai->ai_family, addr, text, sizeof(text)) == nullptr) {
+            continue;
+        }
+        std::string a = ai->ai_family == AF_INET6 ? "[" + std::string(text) + "]" : std::string(text);
+        if (std::find(addrs.begin(), addrs.end(), a) == addrs.end()) {
+            addrs.push_back(a);
+        }
+    }
+    freeaddrinfo(found);
+    if (addrs.empty()) {
+        return false;
+    }
+    
+    std::string list;
+    for (const std::string& a : addrs) {
+        list += (list.empty() ? "" : ",") + a;
+    }
+    
+    std::lock_guard<std::mutex> lock(pin_mutex_);
+    bool changed = pins_.find(key) == pins_.end() || pins_[key].entry != key + ":" + list;
+    pins_[key] = Pin{key + ":" + list, now};
+    if (changed) {
+        LOG_INFO("Pinned " + key + " -> " + list);
+    }
+    {
+        std::lock_guard<std::mutex> stats_lock(stats_mutex_);
+        stats_.pinned_hosts = pins_.size();
+    }
+    return true;
+}
+
+void* CurlTransport::acquire() {
+    {
+        std::lock_guard<std::mutex> lock(pool_mutex_);
+        if (!idle_.empty()) {
+            void* handle = idle_.back();
+            idle_.pop_back();
+            // Clears options but keeps the handle's live connections
+            curl_easy_reset(static_cast<CURL*>(handle));
+            return handle;
+        }
+    }
+    return curl_easy_init();
+}
+
+void CurlTransport::release(void* handle, bool reusable) {
+    if (reusable) {
+        std::lock_guard<std::mutex> lock(pool_mutex_);
+        if (idle_.size() < kMaxIdleHandles) {
+            idle_.push_back(handle);
+            return;
+        }
+    }
+    curl_easy_cleanup(static_cast<CURL*>(handle));
+}
+
+HttpResponse CurlTransport::perform(const HttpRequest& request) {
+    HttpResponse response;
+    
+    CURL* curl = static_cast<CURL*>(acquire());
+    if (!curl) {
+        response.error = "Failed to initialize curl";
+        return response;
+    }
+    
+    // Link the request's own header lines instead of copying them into a
+    // curl_slist; curl only reads the list during the transfer
+    std::array<curl_slist, kMaxHeaderLines> header_nodes;
+    const size_t header_count = std::min(request.header_lines.size(), kMaxHeaderLines);
+    for (size_t i = 0; i < header_count; i++) {
+        header_nodes[i].data = const_cast<char*>(request.header_lines[i].c_str());
+        header_nodes[i].next = i + 1 < header_count ? &header_nodes[i + 1] : nullptr;
+    }
+    
+    curl_easy_setopt(curl, CURLOPT_URL, request.url.c_str());
+    if (request.method == "POST") {
+        // curl sends application/x-www-form-urlencoded for POSTFIELDS
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, static_cast<long>(request.body.size()));
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, request.body.c_str());
+    }
+    if (header_count > 0) {
+        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, header_nodes.data());
+    }
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response.body);
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, static_cast<long>(request.timeout_ms));
+    curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, 10L);
+    curl_easy_setopt(curl, CURLOPT_USERAGENT, "KrakenTradingBot/1.0");
+    curl_easy_setopt(curl, CURLOPT_TCP_NODELAY, 1L);
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPIDLE, static_cast<long>(options_.keepalive_idle_seconds));
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPINTVL, static_cast<long>(options_.keepalive_idle_seconds));
+    if (options_.sndbuf_bytes > 0 || options_.rcvbuf_bytes > 0) {
+        curl_easy_setopt(curl, CURLOPT_SOCKOPTFUNCTION, sockopt_callback);
+        curl_easy_setopt(curl, CURLOPT_SOCKOPTDATA, &options_);
+    }
+    
+    struct curl_slist* resolve_list = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(pin_mutex_);
+        for (const auto& [key, pin] : pins_) {
+            resolve_list = curl_slist_append(resolve_list, pin.entry.c_str());
+        }
+    }
+    if (resolve_list != nullptr) {
+        curl_easy_setopt(curl, CURLOPT_RESOLVE, resolve_list);
+    }
+    if (http2_) {
+        // h2 via ALPN on https, HTTP/1.1 otherwise; wait for an existing
+        // connection to confirm multiplexing rather than opening another
+        curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, static_cast<long>(CURL_HTTP_VERSION_2TLS));
+        curl_easy_setopt(curl, CURLOPT_PIPEWAIT, 1L);
+    }
+    if (request.cancel) {
+        curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
+        curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, cancel_callback);
+        curl_easy_setopt(curl, CURLOPT_XFERINFODATA, const_cast<std::atomic<bool>*>(request.cancel.get()));
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        stats_.requests++;
+        stats_.active++;
+        stats_.peak_active = std::max(stats_.peak_active, stats_.active);
+    }
+    
+    int64_t start_ns = util::now_epoch_ns();
+    CURLcode res = http2_ ? static_cast<CURLcode>(run_multiplexed(curl)) : curl_easy_perform(curl);
+    curl_slist_free_all(resolve_list);
+    
+    long connects = 0;
+    long http_version = 0;
+    curl_off_t lookup_us = 0;
+    curl_off_t connect_us = 0;
+    curl_off_t tls_us = 0;
+    curl_off_t total_us = 0;
+    curl_easy_getinfo(curl, CURLINFO_NUM_CONNECTS, &connects);
+    curl_easy_getinfo(curl, CURLINFO_HTTP_VERSION, &http_version);
+    curl_easy_getinfo(curl, CURLINFO_NAMELOOKUP_TIME_T, &lookup_us);
+    curl_easy_getinfo(curl, CURLINFO_CONNECT_TIME_T, &connect_us);
+    curl_easy_getinfo(curl, CURLINFO_APPCONNECT_TIME_T, &tls_us);
+    curl_easy_getinfo(curl, CURLINFO_TOTAL_TIME_T, &total_us);
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        stats_.active--;
+        stats_.connections += static_cast<uint64_t>(connects);
+        if (res == CURLE_OK) {
+            (http_version == CURL_HTTP_VERSION_2_0 ? stats_.h2_streams : stats_.h1_requests)++;
+            double total_ms = static_cast<double>(total_us) / 1000.0;
+            if (connects > 0) {
+                stats_.cold_requests++;
+                push_sample(cold_ms_, total_ms);
+                // Each phase time is cumulative from the start of the request
+                cold_dns_total_ms_ += static_cast<double>(lookup_us) / 1000.0;
+                cold_connect_total_ms_ += static_cast<double>(std::max<curl_off_t>(0, connect_us - lookup_us)) / 1000.0;
+                cold_tls_total_ms_ += static_cast<double>(std::max<curl_off_t>(0, tls_us - connect_us)) / 1000.0;
+            } else {
+                stats_.warm_requests++;
+                push_sample(warm_ms_, total_ms);
+            }
+        } else if (res == CURLE_OPERATION_TIMEDOUT) {
+            stats_.timeouts++;
+        } else if (res == CURLE_ABORTED_BY_CALLBACK) {
+            stats_.cancelled++;
+        } else {
+            stats_.errors++;
+        }
+    }
+    
+    if (res != CURLE_OK) {
+        response.error = curl_easy_strerror(res);
+        response.cancelled = res == CURLE_ABORTED_BY_CALLBACK;
+        // Without multiplexing the handle's connection may be half-used;
+        // start the next request afresh (the multi handle cleans up its own)
+        release(curl, http2_);
+        return response;
+    }
+    
+    // Request fully sent at pretransfer, first byte back at starttransfer
+    curl_off_t pretransfer_us = 0;
+    curl_off_t starttransfer_us = 0;
+    curl_easy_getinfo(curl, CURLINFO_PRETRANSFER_TIME_T, &pretransfer_us);
+    curl_easy_getinfo(curl, CURLINFO_STARTTRANSFER_TIME_T, &starttransfer_us);
+    response.timing.send_ns = start_ns + static_cast<int64_t>(pretransfer_us) * 1000;
+    response.timing.recv_ns = start_ns + static_cast<int64_t>(starttransfer_us) * 1000;
+    
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &response.status);
+    release(curl, true);
+    response.ok = true;
+    return response;
+}
@@ -0,0 +1,141 @@
+#ifndef HTTP_TRANSPORT_HPP
+#define HTTP_TRANSPORT_HPP
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <chrono>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <cstdint>
+
+// Wall-clock bounds of the request on the wire, excluding connection setup
+struct HttpTiming {
+    int64_t send_ns = 0;
+    int64_t recv_ns = 0;
+};
+
+struct HttpRequest {
+    std::string method = "GET";   // GET or POST
+    std::string url;
+    std::string body;             // POST form data
+    std::vector<std::string> header_lines;  // Preformatted "Name: value"
+    int64_t timeout_ms = 30000;
+    // Abandon the request once this is set (its hedged twin answered first)
+    std::shared_ptr<const std::atomic<bool>> cancel;
+};
+
+struct HttpResponse {
+    bool ok = false;              // A response arrived (any status)
+    long status = 0;
+    std::string body;
+    std::string error;            // Transport error when !ok
+    bool cancelled = false;       // Aborted through HttpRequest::cancel
+    HttpTiming timing;
+};
+
+// Counters kept by the real transport (decorators forward them)
+struct HttpTransportStats {
+    bool http2 = false;               // Multiplexing requested and supported
+    uint64_t requests = 0;
+    uint64_t h2_streams = 0;          // Requests that ran as HTTP/2 streams
+    uint64_t h1_requests = 0;         // Requests that fell back to HTTP/1.x
+    uint64_t connections = 0;         // New connections opened
+    uint64_t timeouts = 0;            // Stream (transfer) timeouts
+    uint64_t cancelled = 0;
+    uint64_t errors = 0;              // Other transport errors
+    uint64_t active = 0;              // Streams in flight now
+    uint64_t peak_active = 0;
+
+    // Cold requests opened a connection (and paid DNS/TCP/TLS); warm ones
+    // reused a live one. Latencies are whole requests over recent samples.
+    uint64_t cold_requests = 0;
+    uint64_t warm_requests = 0;
+    double cold_p50_ms = 0.0;
+    double cold_p99_ms = 0.0;
+    double warm_p50_ms = 0.0;
+    double warm_p99_ms = 0.0;
+    double cold_dns_ms = 0.0;         // Mean setup phases of cold requests
+    double cold_connect_ms = 0.0;
+    double cold_tls_ms = 0.0;
+    uint64_t pinned_hosts = 0;
+};
+
+struct CurlOptions {
+    bool http2 = true;
+    int64_t keepalive_idle_seconds = 30;   // TCP keepalive idle and probe interval
+    int64_t sndbuf_bytes = 0;              // SO_SNDBUF; 0 keeps the OS default
+    int64_t rcvbuf_bytes = 0;              // SO_RCVBUF; 0 keeps the OS default
+    int64_t dns_refresh_seconds = 300;     // Re-resolve a pinned host after this
+};
+
+// One HTTP exchange. KrakenClient owns a transport so tests and soak runs
+// can put a decorator (fault injection) between it and the network.
+class HttpTransport {
+public:
+    virtual ~HttpTransport() = default;
+    virtual HttpResponse perform(const HttpRequest& request) = 0;
+    virtual HttpTransportStats transport_stats() const { return {}; }
+
+    // Resolve the URL's host now and pin its addresses for later requests;
+    // a pin older than the refresh interval is re-resolved. False on failure.
+    virtual bool pin_host(const std::string& url) { (void)url; return false; }
+};
+
+// libcurl transport. With http2 every request is handed to one curl multi
+// handle driven by a background thread: HTTPS hosts that negotiate h2 over
+// ALPN carry all concurrent requests as streams of a single connection, and
+// anything else (plain http, servers without h2) falls back to HTTP/1.1 with
+// one connection per outstanding request. Each stream keeps its own timeout
+// and can be cancelled without disturbing the others. Without http2 requests
+// run on the calling thread over pooled keep-alive handles.
+// Sockets get TCP_NODELAY, keepalive probes and optional buffer sizes, and
+// pinned hosts skip DNS entirely.
+class CurlTransport : public HttpTransport {
+public:
+    explicit CurlTransport(CurlOptions options = {});
+    ~CurlTransport() override;
+
+    CurlTransport(const CurlTransport&) = delete;
+    CurlTransport& operator=(const CurlTransport&) = delete;
+
+    HttpResponse perform(const HttpRequest& request) override;
+    HttpTransportStats transport_stats() const override;
+    bool pin_host(const std::string& url) override;
+
+    const CurlOptions& options() const { return options_; }
+
+private:
+    struct Multi;
+
+    struct Pin {
+        std::string entry;            // CURLOPT_RESOLVE "host:port:addr,addr"
+        std::chrono::steady_clock::time_point resolved;
+    };
+
+    void* acquire();
+    void release(void* handle, bool reusable);
+    int run_multiplexed(void* handle);
+
+    CurlOptions options_;
+    bool http2_;
+    std::unique_ptr<Multi> multi_;
+
+    std::mutex pin_mutex_;
+    std::unordered_map<std::string, Pin> pins_;
+
+    std::mutex pool_mutex_;
+    std::vector<void*> idle_;
+
+    mutable std::mutex stats_mutex_;
+    HttpTransportStats stats_;
+    std::deque<double> cold_ms_;
+    std::deque<double> warm_ms_;
+    double cold_dns_total_ms_ = 0.0;
+    double cold_connect_total_ms_ = 0.0;
+    double cold_tls_total_ms_ = 0.0;
+};
+
+#endif // HTTP_TRANSPORT_HPP
@@ -0,0 +1,510 @@
+#include "indicator_kernels.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+namespace kernels {
+
+namespace {
+
+// ---------------------------------------------------------------------------
+// Scalar reference implementations
+
+void scalar_add_rows(double* acc, const double* row, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        acc[i] += row[i];
+    }
+}
+
+void scalar_abs_change(double* out, const double* cur, const double* prev, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = prev[i] > 0.0 ? std::abs(cur[i] - prev[i]) : 0.0;
+    }
+}
+
+void scalar_divide(double* out, const double* in, double divisor, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = in[i] / divisor;
+    }
+}
+
+void scalar_ema_step(double* ema, const double* x, double alpha, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        ema[i] = ema[i] > 0.0 ? ema[i] + alpha * (x[i] - ema[i]) : x[i];
+    }
+}
+
+// Outputs [from, to) of a rolling sum
+void scalar_rolling_sum(const double* x, size_t from, size_t to, size_t window, double* out) {
+    for (size_t i = from; i < to; i++) {
+        size_t start = i + 1 >= window ? i + 1 - window : 0;
+        double sum = 0.0;
+        for (size_t k = start; k <= i; k++) {
+            sum += x[k];
+        }
+        out[i] = sum;
+    }
+}
+
+void scalar_true_range(const double* price, size_t from, size_t to, double* out) {
+    for (size_t i = std::max<size_t>(from, 1); i < to; i++) {
+        out[i] = std::abs(price[i] - price[i - 1]);
+    }
+    if (from == 0 && to > 0) {
+        out[0] = 0.0;
+    }
+}
+
+template <bool IsMax>
+void scalar_rolling_extreme(const double* x, size_t from, size_t to, size_t window, double* out) {
+    for (size_t i = from; i < to; i++) {
+        size_t start = i + 1 >= window ? i + 1 - window : 0;
+        double m = x[start];
+        for (size_t k = start + 1; k <= i; k++) {
+            m = IsMax ? std::max(m, x[k]) : std::min(m, x[k]);
+        }
+        out[i] = m;
+    }
+}
+
+void scalar_crossovers(const double* fast, const double* slow, size_t from, size_t to, int8_t* out) {
+    for (size_t i = std::max<size_t>(from, 1); i < to; i++) {
+        bool prev_above = fast[i - 1] > slow[i - 1];
+        bool above = fast[i] > slow[i];
+        out[i] = (!prev_above && above) ? 1 : (prev_above && !above) ? -1 : 0;
+    }
+    if (from == 0 && to > 0) {
+        out[0] = 0;
+    }
+}
+
+void scalar_rolling_sum_all(const double* x, size_t n, size_t window, double* out) {
+    scalar_rolling_sum(x, 0, n, window, out);
+}
+
+void scalar_true_range_all(const double* price, size_t n, double* out) {
+    scalar_true_range(price, 0, n, out);
+}
+
+void scalar_rolling_min_all(const double* x, size_t n, size_t window, double* out) {
+    scalar_rolling_extreme<false>(x, 0, n, window, out);
+}
+
+void scalar_rolling_max_all(const double* x, size_t n, size_t window, double* out) {
+    scalar_rolling_extreme<true>(x, 0, n, window, out);
+}
+
+void scalar_crossovers_all(const double* fast, const double* slow, size_t n, int8_t* out) {
+    scalar_crossovers(fast, slow, 0, n, out);
+}
+
+#ifdef KERNELS_X86
+
+// ---------------------------------------------------------------------------
+// AVX2: 4 lanes
+
+#define KERNELS_AVX2 __attribute__((target("avx2")))
+
+KERNELS_AVX2 void avx2_add_rows(double* acc, const double* row, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm256_storeu_pd(acc + i, _mm256_add_pd(_mm256_loadu_pd(acc + i), _mm256_loadu_pd(row + i)));
+    }
+    scalar_add_rows(acc + i, row + i, n - i);
+}
+
+KERNELS_AVX2 void avx2_abs_change(double* out, const double* cur, const double* prev, size_t n) {
+    const __m256d sign = _mm256_set1_pd(-0.0);
+    const __m256d zero = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d p = _mm256_loadu_pd(prev + i);
+        __m256d diff = _mm256_andnot_pd(sign, _mm256_sub_pd(_mm256_loadu_pd(cur + i), p));
+        __m256d valid = _mm256_cmp_pd(p, zero, _CMP_GT_OQ);
+        _mm256_storeu_pd(out + i, _mm256_and_pd(diff, valid));
+    }
+    scalar_abs_change(out + i, cur + i, prev + i, n - i);
+}
+
+KERNELS_AVX2 void avx2_divide(double* out, const double* in, double divisor, size_t n) {
+    const __m256d d = _mm256_set1_pd(divisor);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm256_storeu_pd(out + i, _mm256_div_pd(_mm256_loadu_pd(in + i), d));
+    }
+    scalar_divide(out + i, in + i, divisor, n - i);
+}
+
+KERNELS_AVX2 void avx2_ema_step(double* ema, const double* x, double alpha, size_t n) {
+    const __m256d a = _mm256_set1_pd(alpha);
+    const __m256d zero = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d e = _mm256_loadu_pd(ema + i);
+        __m256d v = _mm256_loadu_pd(x + i);
+        __m256d next = _mm256_add_pd(e, _mm256_mul_pd(a, _mm256_sub_pd(v, e)));
+        __m256d seeded = _mm256_cmp_pd(e, zero, _CMP_GT_OQ);
+        _mm256_storeu_pd(ema + i, _mm256_blendv_pd(v, next, seeded));
+    }
+    scalar_ema_step(ema + i, x + i, alpha, n - i);
+}
+
+KERNELS_AVX2 void avx2_rolling_sum(const double* x, size_t n, size_t window, double* out) {
+    // Warm-up prefix (partial windows) stays scalar
+    size_t i = std::min(n, window > 0 ? window - 1 : 0);
+    scalar_rolling_sum(x, 0, i, window, out);
+    for (; i + 4 <= n; i += 4) {
+        const double* base = x + i + 1 - window;
+        __m256d sum = _mm256_setzero_pd();
+        for (size_t k = 0; k < window; k++) {
+            sum = _mm256_add_pd(sum, _mm256_loadu_pd(base + k));
+        }
+        _mm256_storeu_pd(out + i, sum);
+    }
+    scalar_rolling_sum(x, i, n, window, out);
+}
+
+KERNELS_AVX2 void avx2_true_range(const double* price, size_t n, double* out) {
+    const __m256d sign = _mm256_set1_pd(-0.0);
+    scalar_true_range(price, 0, std::min<size_t>(n, 1), out);
+    size_t i = 1;
+    for (; i + 4 <= n; i += 4) {
+        __m256d diff = _mm256_sub_pd(_mm256_loadu_pd(price + i), _mm256_loadu_pd(price + i - 1));
+        _mm256_storeu_pd(out + i, _mm256_andnot_pd(sign, diff));
+    }
+    scalar_true_range(price, i, n, out);
+}
+
+// min/max operand order matches std::min(m, v) / std::max(m, v) for ties
+template <bool IsMax>
+KERNELS_AVX2 void avx2_rolling_extreme(const double* x, size_t n, size_t window, double* out) {
+    size_t i = std::min(n, window > 0 ? window - 1 : 0);
+    scalar_rolling_extreme<IsMax>(x, 0, i, window, out);
+    for (; i + 4 <= n; i += 4) {
+        const double* base = x + i + 1 - window;
+        __m256d m = _mm256_loadu_pd(base);
+        for (size_t k = 1; k < window; k++) {
+            __m256d v = _mm256_loadu_pd(base + k);
+            m = IsMax ? _mm256_max_pd(v, m) : _mm256_min_pd(v, m);
+        }
+        _mm256_storeu_pd(out + i, m);
+    }
+    scalar_rolling_extreme<IsMax>(x, i, n, window, out);
+}
+
+KERNELS_AVX2 void avx2_rolling_min(const double* x, size_t n, size_t window, double* out) {
+    avx2_rolling_extreme<false>(x, n, window, out);
+}
+
+KERNELS_AVX2 void avx2_rolling_max(const double* x, size_t n, size_t window, double* out) {
+    avx2_rolling_extreme<true>(x, n, window, out);
+}
+
+KERNELS_AVX2 void avx2_crossovers(const double* fast, const double* slow, size_t n, int8_t* out) {
+    scalar_crossovers(fast, slow, 0, std::min<size_t>(n, 1), out);
+    size_t i = 1;
+    for (; i + 4 <= n; i += 4) {
+        int above = _mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(fast + i), _mm256_loadu_pd(slow + i), _CMP_GT_OQ));
+        int prev = _mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(fast + i - 1), _mm256_loadu_pd(slow + i - 1), _CMP_GT_OQ));
+        int up = above & ~prev;
+        int down = prev & ~above;
+        for (int lane = 0; lane < 4; lane++) {
+            out[i + lane] = static_cast<int8_t>(((up >> lane) & 1) - ((down >> lane) & 1));
+        }
+    }
+    scalar_crossovers(fast, slow, i, n, out);
+}
+
+// ---------------------------------------------------------------------------
+// AVX-512: 8 lanes (built with -ffp-contract=off so mul+add is not fused)
+
+#define KERNELS_AVX512 __attribute__((target("avx512f")))
+
+KERNELS_AVX512 void avx512_add_rows(double* acc, const double* row, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm512_storeu_pd(acc + i, _mm512_add_pd(_mm512_loadu_pd(acc + i), _mm512_loadu_pd(row + i)));
+    }
+    scalar_add_rows(acc + i, row + i, n - i);
+}
+
+KERNELS_AVX512 void avx512_abs_change(double* out, const double* cur, const double* prev, size_t n) {
+    const __m512d zero = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512d p = _mm512_loadu_pd(prev + i);
+        __m512d diff = _mm512_abs_pd(_mm512_sub_pd(_mm512_loadu_pd(cur + i), p));
+        __mmask8 valid = _mm512_cmp_pd_mask(p, zero, _CMP_GT_OQ);
+        _mm512_storeu_pd(out + i, _mm512_maskz_mov_pd(valid, diff));
+    }
+    scalar_abs_change(out + i, cur + i, prev + i, n - i);
+}
+
+KERNELS_AVX512 void avx512_divide(double* out, const double* in, double divisor, size_t n) {
+    const __m512d d = _mm512_set1_pd(divisor);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm512_storeu_pd(out + i, _mm512_div_pd(_mm512_loadu_pd(in + i), d));
+    }
+    scalar_divide(out + i, in + i, divisor, n - i);
+}
+
+KERNELS_AVX512 void avx512_ema_step(double* ema, const double* x, double alpha, size_t n) {
+    const __m512d a = _mm512_set1_pd(alpha);
+    const __m512d zero = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512d e = _mm512_loadu_pd(ema + i);
+        __m512d v = _mm512_loadu_pd(x + i);
+        __m512d next = _mm512_add_pd(e, _mm512_mul_pd(a, _mm512_sub_pd(v, e)));
+        __mmask8 seeded = _mm512_cmp_pd_mask(e, zero, _CMP_GT_OQ);
+        _mm512_storeu_pd(ema + i, _mm512_mask_blend_pd(seeded, v, next));
+    }
+    scalar_ema_step(ema + i, x + i, alpha, n - i);
+}
+
+KERNELS_AVX512 void avx512_rolling_sum(const double* x, size_t n, size_t window, double* out) {
+    size_t i = std::min(n, window > 0 ? window - 1 : 0);
+    scalar_rolling_sum(x, 0, i, window, out);
+    for (; i + 8 <= n; i += 8) {
+        const double* base = x + i + 1 - window;
+        __m512d sum = _mm512_setzero_pd();
+        for (size_t k = 0; k < window; k++) {
+            sum = _mm512_add_pd(sum, _mm512_loadu_pd(base + k));
+        }
+        _mm512_storeu_pd(out + i, sum);
+    }
+    scalar_rolling_sum(x, i, n, window, out);
+}
+
+KERNELS_AVX512 void avx512_true_range(const double* price, size_t n, double* out) {
+    scalar_true_range(price, 0, std::min<size_t>(n, 1), out);
+    size_t i = 1;
+    for (; i + 8 <= n; i += 8) {
+        __m512d diff = _mm512_sub_pd(_mm512_loadu_pd(price + i), _mm512_loadu_pd(price + i - 1));
+        _mm512_storeu_pd(out + i, _mm512_abs_pd(diff));
+    }
+    scalar_true_range(price, i, n, out);
+}
+
+// GCC 12 warns about the _mm512_undefined_pd() pass-through inside
+// _mm512_min_pd/_mm512_max_pd
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+template <bool IsMax>
+KERNELS_AVX512 void avx512_rolling_extreme(const double* x, size_t n, size_t window, double* out) {
+    size_t i = std::min(n, window > 0 ? window - 1 : 0);
+    scalar_rolling_extreme<IsMax>(x, 0, i, window, out);
+    for (; i + 8 <= n; i += 8) {
+        const double* base = x + i + 1 - window;
+        __m512d m = _mm512_loadu_pd(base);
+        for (size_t k = 1; k < window; k++) {
+            __m512d v = _mm512_loadu_pd(base + k);
+            m = IsMax ? _mm512_max_pd(v, m) : _mm512_min_pd(v, m);
+        }
+        _mm512_storeu_pd(out + i, m);
+    }
+    scalar_rolling_extreme<IsMax>(x, i, n, window, out);
+}
+
+#pragma GCC diagnostic pop
+
+KERNELS_AVX512 void avx512_rolling_min(const double* x, size_t n, size_t window, double* out) {
+    avx512_rolling_extreme<false>(x, n, window, out);
+}
+
+KERNELS_AVX512 void avx512_rolling_max(const double* x, size_t n, size_t window, double* out) {
+    avx512_rolling_extreme<true>(x, n, window, out);
+}
+
+KERNELS_AVX512 void avx512_crossovers(const double* fast, const double* slow, size_t n, int8_t* out) {
+    scalar_crossovers(fast, slow, 0, std::min<size_t>(n, 1), out);
+    size_t i = 1;
+    for (; i + 8 <= n; i += 8) {
+        unsigned above = _mm512_cmp_pd_mask(_mm512_loadu_pd(fast + i), _mm512_loadu_pd(slow + i), _CMP_GT_OQ);
+        unsigned prev = _mm512_cmp_pd_mask(_mm512_loadu_pd(fast + i - 1), _mm512_loadu_pd(slow + i - 1), _CMP_GT_OQ);
+        unsigned up = above & ~prev;
+        unsigned down = prev & ~above;
+        for (unsigned lane = 0; lane < 8; lane++) {
+            out[i + lane] = static_cast<int8_t>(static_cast<int>((up >> lane) & 1u) - static_cast<int>((down >> lane) & 1u));
+        }
+    }
+    scalar_crossovers(fast, slow, i, n, out);
+}
+
+#endif // KERNELS_X86
+
+// ---------------------------------------------------------------------------
+// Dispatch
+
+struct KernelTable {
+    void (*add_rows)(double*, const double*, size_t);
+    void (*abs_change)(double*, const double*, const double*, size_t);
+    void (*divide)(double*, const double*, double, size_t);
+    void (*ema_step)(double*, const double*, double, size_t);
+    void (*rolling_sum)(const double*, size_t, size_t, double*);
+    void (*true_range)(const double*, size_t, double*);
+    void (*rolling_min)(const double*, size_t, size_t, double*);
+    void (*rolling_max)(const double*, size_t, size_t, double*);
+    void (*crossovers)(const double*, const double*, size_t, int8_t*);
+};
+
+constexpr KernelTable kScalarTable = {
+    scalar_add_rows, scalar_abs_change, scalar_divide, scalar_ema_step,
+    scalar_rolling_sum_all, scalar_true_range_all, scalar_rolling_min_all,
+    scalar_rolling_max_all, scalar_crossovers_all
+};
+
+#ifdef KERNELS_X86
+constexpr KernelTable kAvx2Table = {
+    avx2_add_rows, avx2_abs_change, avx2_divide, avx2_ema_step,
+    avx2_rolling_sum, avx2_true_range, avx2_rolling_min,
+    avx2_rolling_max, avx2_crossovers
+};
+
+constexpr KernelTable kAvx512Table = {
+    avx512_add_rows, avx512_abs_change, avx512_divide, avx512_ema_step,
+    avx512_rolling_sum, avx512_true_range, avx512_rolling_min,
+    avx512_rolling_max, avx512_crossovers
+};
+#endif
+
+bool cpu_supports(Isa isa) {
+#ifdef KERNELS_X86
+    switch (isa) {
+        case Isa::AVX512: return __builtin_cpu_supports("avx512f");
+        case Isa::AVX2: return __builtin_cpu_supports("avx2");
+        case Isa::SCALAR: return true;
+    }
+    return false;
+#else
+    return isa == Isa::SCALAR;
+#endif
+}
+
+Isa detect_isa() {
+    if (cpu_supports(Isa::AVX512)) return Isa::AVX512;
+    if (cpu_supports(Isa::AVX2)) return Isa::AVX2;
+    return Isa::SCALAR;
+}
+
+const KernelTable* table_for(Isa isa) {
+#ifdef KERNELS_X86
+    switch (isa) {
+        case Isa::AVX512: return &kAvx512Table;
+        case Isa::AVX2: return &kAvx2Table;
+        case Isa::SCALAR: break;
+    }
+#else
+    (void)isa;
+#endif
+    return &kScalarTable;
+}
+
+std::atomic<Isa> g_isa{detect_isa()};
+std::atomic<const KernelTable*> g_table{table_for(g_isa.load())};
+
+const KernelTable& table() {
+    return *g_table.load(std::memory_order_relaxed);
+}
+
+} // namespace
+
+Isa active_isa() {
+    return g_isa.load(std::memory_order_relaxed);
+}
+
+std::string isa_name(Isa isa) {
+    switch (isa) {
+        case Isa::SCALAR: return "scalar";
+        case Isa::AVX2: return "avx2";
+        case Isa::AVX512: return "avx512";
+    }
+    return "unknown";
+}
+
+bool set_isa(const std::string& name) {
+    Isa isa;
+    if (name == "auto") {
+        isa = detect_isa();
+    } else if (name == "scalar") {
+        isa = Isa::SCALAR;
+    } else if (name == "avx2") {
+        isa = Isa::AVX2;
+    } else if (name == "avx512") {
+        isa = Isa::AVX512;
+    } else {
+        return false;
+    }
+    if (!cpu_supports(isa)) {
+        return false;
+    }
+    g_isa.store(isa, std::memory_order_relaxed);
+    g_table.store(table_for(isa), std::memory_order_relaxed);
+    return true;
+}
+
+void add_rows(double* acc, const double* row, size_t n) {
+    table().add_rows(acc, row, n);
+}
+
+void abs_change(double* out, const double* cur, const double* prev, size_t n) {
+    table().abs_change(out, cur, prev, n);
+}
+
+void divide(double* out, const double* in, double divisor, size_t n) {
+    table().divide(out, in, divisor, n);
+}
+
+void ema_step(double* ema, const double* x, double alpha, size_t n) {
+    table().ema_step(ema, x, alpha, n);
+}
+
+void rolling_sum(const double* x, size_t n, size_t window, double* out) {
+    if (window == 0) {
+        std::fill(out, out + n, 0.0);
+        return;
+    }
+    table().rolling_sum(x, n, window, out);
+}
+
+void true_range(const double* price, size_t n, double* out) {
+    table().true_range(price, n, out);
+}
+
+void ema(const double* x, size_t n, double alpha, double* out) {
+    if (n == 0) {
+        return;
+    }
+    out[0] = x[0];
+    for (size_t i = 1; i < n; i++) {
+        out[i] = out[i - 1] + alpha * (x[i] - out[i - 1]);
+    }
+}
+
+void rolling_min(const double* x, size_t n, size_t window, double* out) {
+    if (window == 0) {
+        std::fill(out, out + n, 0.0);
+        return;
+    }
+    table().rolling_min(x, n, window, out);
+}
+
+void rolling_max(const double* x, size_t n, size_t window, double* out) {
+    if (window == 0) {
+        std::fill(out, out + n, 0.0);
+        return;
+    }
+    table().rolling_max(x, n, window, out);
+}
+
+void crossovers(const double* fast, const double* slow, size_t n, int8_t* out) {
+    table().crossovers(fast, slow, n, out);
+}
+
+} // namespace kernels
@@ -0,0 +1,65 @@
+#ifndef INDICATOR_KERNELS_HPP
+#define INDICATOR_KERNELS_HPP
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+// Batch indicator kernels with AVX-512 / AVX2 / scalar implementations picked
+// at runtime. Every vector kernel keeps one output per lane and performs the
+// same additions in the same order as the scalar loop, so results are
+// bit-identical to the streaming indicators (sums run oldest first, means are
+// a single division, no FMA contraction).
+namespace kernels {
+
+enum class Isa {
+    SCALAR,
+    AVX2,
+    AVX512
+};
+
+// Best ISA the CPU and OS support, or the one forced by set_isa()
+Isa active_isa();
+std::string isa_name(Isa isa);
+
+// Force an implementation ("auto", "scalar", "avx2", "avx512"); false if the
+// name is unknown or the CPU lacks it
+bool set_isa(const std::string& name);
+
+// Across series (struct-of-arrays, one lane per pair)
+
+// acc[i] += row[i]
+void add_rows(double* acc, const double* row, size_t n);
+
+// out[i] = |cur[i] - prev[i]|, or 0 where prev[i] <= 0
+void abs_change(double* out, const double* cur, const double* prev, size_t n);
+
+// out[i] = in[i] / divisor
+void divide(double* out, const double* in, double divisor, size_t n);
+
+// ema[i] += alpha * (x[i] - ema[i]); lanes with ema[i] <= 0 are seeded with x[i]
+void ema_step(double* ema, const double* x, double alpha, size_t n);
+
+// Along one contiguous series
+
+// out[i] = x[i-w+1] + ... + x[i], added oldest first; the first w-1 outputs
+// sum the available prefix (as the streaming ATR does while warming up)
+void rolling_sum(const double* x, size_t n, size_t window, double* out);
+
+// Close-to-close true range: out[0] = 0, out[i] = |p[i] - p[i-1]|
+void true_range(const double* price, size_t n, double* out);
+
+// out[0] = x[0], out[i] = out[i-1] + alpha * (x[i] - out[i-1]). The recurrence
+// is inherently serial; batch many series with ema_step instead.
+void ema(const double* x, size_t n, double alpha, double* out);
+
+// Min / max over the trailing window (prefix while warming up)
+void rolling_min(const double* x, size_t n, size_t window, double* out);
+void rolling_max(const double* x, size_t n, size_t window, double* out);
+
+// +1 where fast crosses above slow, -1 where it crosses below, else 0
+void crossovers(const double* fast, const double* slow, size_t n, int8_t* out);
+
+} // namespace kernels
+
+#endif // INDICATOR_KERNELS_HPP
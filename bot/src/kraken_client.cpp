@@ -1,26 +1,71 @@
 #include "kraken_client.hpp"
 #include "logger.hpp"
 #include "util.hpp"
-#include <curl/curl.h>
-#include <nlohmann/json.hpp>
+#include "request_template.hpp"
+#include "tick_arena.hpp"
 #include <sstream>
 #include <thread>
+#include <condition_variable>
+#include <atomic>
+#include <string_view>
+#include <algorithm>
+#include <charconv>
 #include <cstdlib>
+#include <cmath>
 
-using json = nlohmann::json;
+// Parsed responses only live inside the call that parsed them, so their
+// nodes come from the tick arena when called from the trading loop
+using json = TickJson;
 
-// Curl write callback
-static size_t write_callback(void* contents, size_t size, size_t nmemb, std::string* userp) {
-    size_t total_size = size * nmemb;
-    userp->append(static_cast<char*>(contents), total_size);
-    return total_size;
-}
+// Shared between a request and its hedge; whichever succeeds first wins and
+// cancels the other
+struct KrakenClient::HedgeState {
+    HttpRequest request;
+    CircuitBreaker* breaker = nullptr;
+    std::chrono::steady_clock::time_point deadline;
+    int64_t wait_ms = 0;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool launched = false;
+    bool finished[2] = {false, false};
+    int winner = -1;
+    HttpResponse response;             // The hedge's, once it wins
+    std::shared_ptr<std::atomic<bool>> cancel[2] = {std::make_shared<std::atomic<bool>>(false),
+                                                    std::make_shared<std::atomic<bool>>(false)};
+};
 
 KrakenClient::KrakenClient(const std::string& api_base, int64_t min_delay_ms)
     : api_base_(api_base)
     , min_delay_ms_(min_delay_ms)
     , last_request_time_(std::chrono::steady_clock::now() - std::chrono::milliseconds(min_delay_ms))
-    , current_backoff_ms_(0) {
+    , refill_time_(std::chrono::steady_clock::now())
+    , transport_(std::make_shared<CurlTransport>()) {
+    EndpointPolicy policy;
+    for (EndpointClass cls : {EndpointClass::MARKET_DATA, EndpointClass::REFERENCE, EndpointClass::PRIVATE}) {
+        breakers_.push_back(std::make_unique<CircuitBreaker>(cls, policy));
+    }
+}
+
+KrakenClient::~KrakenClient() {
+    {
+        std::lock_guard<std::mutex> lock(hedge_mutex_);
+        hedge_stopping_ = true;
+    }
+    hedge_cv_.notify_all();
+    if (hedge_timer_.joinable()) {
+        hedge_timer_.join();
+    }
+    // Whichever hedges are still out lost to their twin already or have
+    // nobody waiting for them; drop their transfers
+    for (HedgeThread& hedge : hedge_threads_) {
+        hedge.state->cancel[1]->store(true, std::memory_order_release);
+        hedge.thread.join();
+    }
+}
+
+void KrakenClient::set_transport(std::unique_ptr<HttpTransport> transport) {
+    transport_ = std::move(transport);
 }
 
 bool KrakenClient::init() {
@@ -44,172 +89,600 @@ bool KrakenClient::init() {
         return false;
     }
     
+    // Private requests are signed from per-endpoint templates built once here
+    std::string decoded_secret = util::base64_decode(api_secret_);
+    if (decoded_secret.empty()) {
+        LOG_ERROR("KRAKEN_API_SECRET is not valid base64");
+        initialized_ = false;
+        return false;
+    }
+    auto hmac = std::make_shared<HmacSha512>(decoded_secret);
+    balance_request_ = std::make_unique<PrivateRequestTemplate>(api_base_, "/0/private/Balance", api_key_, hmac);
+    add_order_request_ = std::make_unique<PrivateRequestTemplate>(api_base_, "/0/private/AddOrder", api_key_, hmac);
+    query_orders_request_ = std::make_unique<PrivateRequestTemplate>(api_base_, "/0/private/QueryOrders", api_key_, hmac);
+    trade_volume_request_ = std::make_unique<PrivateRequestTemplate>(api_base_, "/0/private/TradeVolume", api_key_, hmac);
+    
     initialized_ = true;
     LOG_INFO("Kraken client initialized with API credentials");
     return true;
 }
 
-void KrakenClient::enforce_rate_limit() {
+void KrakenClient::set_rate_limit_burst(int burst) {
     std::lock_guard<std::mutex> lock(request_mutex_);
+    rate_limit_burst_ = std::max(1, burst);
+    tokens_ = rate_limit_burst_;
+    refill_time_ = std::chrono::steady_clock::now();
+}
+
+void KrakenClient::refill_tokens(std::chrono::steady_clock::time_point now) {
+    if (min_delay_ms_ <= 0) {
+        tokens_ = rate_limit_burst_;
+        return;
+    }
+    double earned = std::chrono::duration<double, std::milli>(now - refill_time_).count() /
+                    static_cast<double>(min_delay_ms_);
+    tokens_ = std::min(static_cast<double>(rate_limit_burst_), tokens_ + earned);
+    refill_time_ = now;
+}
+
+void KrakenClient::enforce_rate_limit(EndpointClass cls) {
+    int64_t class_wait_ms = breaker(cls).wait_ms();
+    
+    // Take a token even when none is left: the debt is this caller's wait,
+    // and later callers queue behind it. The sleep happens outside the lock
+    // so concurrent callers within the burst are not serialized.
+    int64_t sleep_ms = 0;
+    {
+        std::lock_guard<std::mutex> lock(request_mutex_);
+        auto now = std::chrono::steady_clock::now();
+        refill_tokens(now);
+        tokens_ -= 1.0;
+        if (tokens_ < 0.0) {
+            sleep_ms = static_cast<int64_t>(std::ceil(-tokens_ * static_cast<double>(min_delay_ms_)));
+        }
+        sleep_ms = std::max(sleep_ms, class_wait_ms);
+        last_request_time_ = now + std::chrono::milliseconds(sleep_ms);
+    }
     
-    auto now = std::chrono::steady_clock::now();
-    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - last_request_time_).count();
-    
-    int64_t total_delay = min_delay_ms_ + current_backoff_ms_;
-    
-    if (elapsed < total_delay) {
-        int64_t sleep_ms = total_delay - elapsed;
+    if (sleep_ms > 0) {
         LOG_DEBUG("Rate limiting: sleeping " + std::to_string(sleep_ms) + "ms");
         std::this_thread::sleep_for(std::chrono::milliseconds(sleep_ms));
     }
-    
-    last_request_time_ = std::chrono::steady_clock::now();
 }
 
-void KrakenClient::apply_backoff() {
-    consecutive_failures_++;
-    
-    if (current_backoff_ms_ == 0) {
-        current_backoff_ms_ = initial_backoff_ms_;
-    } else {
-        current_backoff_ms_ = std::min(current_backoff_ms_ * 2, max_backoff_ms_);
-    }
-    
-    // Add jitter (10-50% of backoff)
-    int64_t jitter = util::random_jitter_ms(current_backoff_ms_ / 2);
-    current_backoff_ms_ += jitter;
-    
-    LOG_WARNING("Applying backoff: " + std::to_string(current_backoff_ms_) + 
-                "ms (consecutive failures: " + std::to_string(consecutive_failures_) + ")");
+void KrakenClient::record_failure() {
+    int failures = ++consecutive_failures_;
+    LOG_WARNING("Request failed (consecutive failures: " + std::to_string(failures) + ")");
 }
 
 void KrakenClient::set_backoff_params(int max_retries, int64_t initial_backoff_ms, int64_t max_backoff_ms) {
-    max_retries_ = max_retries;
-    initial_backoff_ms_ = initial_backoff_ms;
-    max_backoff_ms_ = max_backoff_ms;
+    for (auto& b : breakers_) {
+        EndpointPolicy policy = b->policy();
+        policy.max_retries = max_retries;
+        policy.initial_backoff_ms = initial_backoff_ms;
+        policy.max_backoff_ms = max_backoff_ms;
+        b->set_policy(policy);
+    }
 }
 
-std::string KrakenClient::http_get(const std::string& url) {
-    enforce_rate_limit();
-    
-    CURL* curl = curl_easy_init();
-    if (!curl) {
-        LOG_ERROR("Failed to initialize curl");
-        apply_backoff();
-        return "";
+void KrakenClient::set_endpoint_policy(const EndpointPolicy& policy) {
+    for (auto& b : breakers_) {
+        b->set_policy(policy);
+    }
+}
+
+std::vector<EndpointMetrics> KrakenClient::endpoint_metrics() const {
+    std::vector<EndpointMetrics> out;
+    for (const auto& b : breakers_) {
+        out.push_back(b->metrics());
+    }
+    return out;
+}
+
+std::string KrakenClient::http_get(const std::string& url, HttpTiming* timing) {
+    HttpRequest request;
+    request.url = url;
+    request.timeout_ms = request_timeout_ms_;
+    return perform(request, timing);
+}
+
+uint64_t KrakenClient::next_nonce() {
+    // Kraken rejects a nonce that does not increase; two calls in the same
+    // millisecond would otherwise collide
+    uint64_t nonce = std::max(static_cast<uint64_t>(util::now_epoch_ms()), last_nonce_ + 1);
+    last_nonce_ = nonce;
+    return nonce;
+}
+
+std::string KrakenClient::post_private(PrivateRequestTemplate& tmpl, std::string_view params) {
+    HttpRequest& request = tmpl.build(next_nonce(), params);
+    request.timeout_ms = request_timeout_ms_;
+    return perform(request, nullptr);
+}
+
+// Kraken reports overload inside a 200 response; the error array comes
+// first, so only the head of the body is searched
+static bool is_overload_error(const std::string& body) {
+    std::string_view head(body.data(), std::min<size_t>(body.size(), 256));
+    return head.find("EAPI:Rate limit") != std::string_view::npos ||
+           head.find("EService:") != std::string_view::npos;
+}
+
+// Cheap truncation check: a complete response is a JSON object
+static bool is_complete(const std::string& body) {
+    size_t last = body.find_last_not_of(" \t\r\n");
+    return last != std::string::npos && body[last] == '}';
+}
+
+int64_t KrakenClient::next_slot_ms() {
+    std::lock_guard<std::mutex> lock(request_mutex_);
+    refill_tokens(std::chrono::steady_clock::now());
+    if (tokens_ >= 1.0) {
+        return 0;
+    }
+    return static_cast<int64_t>(std::ceil((1.0 - tokens_) * static_cast<double>(min_delay_ms_)));
+}
+
+bool KrakenClient::try_take_slot() {
+    std::lock_guard<std::mutex> lock(request_mutex_);
+    auto now = std::chrono::steady_clock::now();
+    refill_tokens(now);
+    if (tokens_ < 1.0) {
+        return false;
+    }
+    tokens_ -= 1.0;
+    last_request_time_ = now;
+    return true;
+}
+
+HttpResponse KrakenClient::send(const HttpRequest& request, CircuitBreaker& breaker) {
+    int64_t hedge_after_ms = breaker.hedge_delay_ms();
+    if (hedge_after_ms <= 0 || request.method != "GET") {
+        return transport_->perform(request);
     }
     
-    std::string response;
-    
-    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 30L);
-    curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, 10L);
-    curl_easy_setopt(curl, CURLOPT_USERAGENT, "KrakenTradingBot/1.0");
-    
-    CURLcode res = curl_easy_perform(curl);
-    
-    if (res != CURLE_OK) {
-        LOG_ERROR("curl_easy_perform() failed: " + std::string(curl_easy_strerror(res)));
-        curl_easy_cleanup(curl);
-        apply_backoff();
-        return "";
+    // The hedge is a real request and needs its own rate-limit slot, so it
+    // is due at the later of the p95 delay and the next free slot. Without
+    // HTTP/2 it gets a pooled connection of its own; with it, it is one more
+    // stream on the same connection, so it only helps when the server, not
+    // the connection, is slow.
+    auto state = std::make_shared<HedgeState>();
+    state->request = request;
+    state->breaker = &breaker;
+    state->wait_ms = std::max(hedge_after_ms, next_slot_ms());
+    state->deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(state->wait_ms);
+    HttpRequest primary = request;
+    primary.cancel = state->cancel[0];
+    schedule_hedge(state);
+    
+    HttpResponse response = transport_->perform(primary);
+    
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->finished[0] = true;
+    if (state->winner < 0 && response.ok && response.status == 200) {
+        state->winner = 0;
+        // The loser's stream is dropped, not left to finish
+        state->cancel[1]->store(true, std::memory_order_release);
+    }
+    if (!state->launched) {
+        return response;
+    }
+    // A failed primary still leaves the hedge a chance
+    state->cv.wait(lock, [&] { return state->winner >= 0 || state->finished[1]; });
+    breaker.count_hedge(state->winner == 1);
+    return state->winner == 1 ? std::move(state->response) : response;
+}
+
+void KrakenClient::schedule_hedge(std::shared_ptr<HedgeState> state) {
+    std::lock_guard<std::mutex> lock(hedge_mutex_);
+    if (!hedge_timer_.joinable()) {
+        hedge_timer_ = std::thread([this] { hedge_loop(); });
+    }
+    hedge_pending_.push_back(std::move(state));
+    hedge_cv_.notify_one();
+}
+
+void KrakenClient::hedge_loop() {
+    std::unique_lock<std::mutex> lock(hedge_mutex_);
+    while (!hedge_stopping_) {
+        // Join hedges that have finished
+        for (size_t i = 0; i < hedge_threads_.size();) {
+            bool done;
+            {
+                std::lock_guard<std::mutex> guard(hedge_threads_[i].state->mutex);
+                done = hedge_threads_[i].state->finished[1];
+            }
+            if (done) {
+                hedge_threads_[i].thread.join();
+                hedge_threads_[i] = std::move(hedge_threads_.back());
+                hedge_threads_.pop_back();
+            } else {
+                i++;
+            }
+        }
+        
+        if (hedge_pending_.empty()) {
+            hedge_cv_.wait(lock);
+            continue;
+        }
+        auto earliest = std::min_element(hedge_pending_.begin(), hedge_pending_.end(),
+                                         [](const auto& a, const auto& b) { return a->deadline < b->deadline; });
+        if ((*earliest)->deadline > std::chrono::steady_clock::now()) {
+            hedge_cv_.wait_until(lock, (*earliest)->deadline);
+            continue;
+        }
+        std::shared_ptr<HedgeState> state = std::move(*earliest);
+        *earliest = std::move(hedge_pending_.back());
+        hedge_pending_.pop_back();
+        launch_hedge(state);
+    }
+}
+
+void KrakenClient::launch_hedge(const std::shared_ptr<HedgeState>& state) {
+    std::lock_guard<std::mutex> guard(state->mutex);
+    // Most primaries answer before their deadline; nothing to do for those
+    if (state->finished[0] || !state->breaker->try_spend_retry() || !try_take_slot()) {
+        return;
+    }
+    LOG_DEBUG("Hedging " + state->request.url + " after " + std::to_string(state->wait_ms) + "ms");
+    state->launched = true;
+    HttpRequest hedge = state->request;
+    hedge.cancel = state->cancel[1];
+    hedge_threads_.push_back(HedgeThread{
+        std::thread([state, transport = transport_, hedge = std::move(hedge)]() {
+            HttpResponse r = transport->perform(hedge);
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->finished[1] = true;
+            if (state->winner < 0 && r.ok && r.status == 200) {
+                state->winner = 1;
+                state->response = std::move(r);
+                state->cancel[0]->store(true, std::memory_order_release);
+            }
+            state->cv.notify_all();
+        }),
+        state});
+}
+
+std::string KrakenClient::perform(const HttpRequest& request, HttpTiming* timing) {
+    const EndpointClass cls = classify_endpoint(request.url);
+    CircuitBreaker& b = breaker(cls);
+    // Signed POSTs carry a nonce and may place orders: never repeat them
+    const bool idempotent = cls != EndpointClass::PRIVATE && request.method == "GET";
+    
+    for (int attempt = 0;; attempt++) {
+        if (!b.allow()) {
+            LOG_ERROR("Circuit breaker " + endpoint_class_to_string(cls) + " open, failing fast");
+            record_failure();
+            return "";
+        }
+        enforce_rate_limit(cls);
+        
+        auto start = std::chrono::steady_clock::now();
+        HttpResponse response = send(request, b);
+        double latency_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        
+        bool transport_ok = response.ok && response.status == 200;
+        if (transport_ok && !is_overload_error(response.body) && is_complete(response.body)) {
+            b.record_success(latency_ms);
+            if (timing != nullptr) {
+                *timing = response.timing;
+            }
+            // Reset backoff on success
+            consecutive_failures_ = 0;
+            return std::move(response.body);
+        }
+        
+        b.record_failure();
+        if (!response.ok) {
+            LOG_ERROR("HTTP request failed: " + response.error);
+        } else if (response.status != 200) {
+            LOG_ERROR("HTTP error: " + std::to_string(response.status));
+        }
+        
+        if (idempotent && attempt < b.policy().max_retries && b.try_spend_retry()) {
+            b.count_retry();
+            LOG_WARNING("Retrying " + endpoint_class_to_string(cls) + " request (attempt " +
+                        std::to_string(attempt + 2) + ")");
+            continue;
+        }
+        
+        if (!transport_ok) {
+            record_failure();
+            return "";
+        }
+        // Let the caller report the Kraken error or parse failure
+        if (timing != nullptr) {
+            *timing = response.timing;
+        }
+        return std::move(response.body);
+    }
+}
+
+// Parse a single Ticker result entry ("c" = last trade, "b" = bid, "a" = ask, "v" = volume)
+static bool parse_ticker_entry(const json& entry, const HttpTiming& timing, const ClockSync& clock,
+                               TickerResult& result) {
+    if (!entry.contains("c") || !entry["c"].is_array() || entry["c"].empty()) {
+        return false;
+    }
+    result.last_price = std::stod(entry["c"][0].get<std::string>());
+    // "b"/"a" are [price, whole lot volume, lot volume]
+    if (entry.contains("b") && entry["b"].is_array() && !entry["b"].empty()) {
+        result.bid_price = std::stod(entry["b"][0].get<std::string>());
+        if (entry["b"].size() > 2) {
+            result.bid_volume = std::stod(entry["b"][2].get<std::string>());
+        }
     }
+    if (entry.contains("a") && entry["a"].is_array() && !entry["a"].empty()) {
+        result.ask_price = std::stod(entry["a"][0].get<std::string>());
+        if (entry["a"].size() > 2) {
+            result.ask_volume = std::stod(entry["a"][2].get<std::string>());
+        }
+    }
+    if (entry.contains("v") && entry["v"].is_array() && entry["v"].size() > 1) {
+        result.volume_24h = std::stod(entry["v"][1].get<std::string>());
+    }
+    // The quote was served somewhere between send and first byte; take the
+    // midpoint on the exchange clock
+    result.timestamp = timing.recv_ns / 1'000'000'000;
+    result.receive_ns = timing.recv_ns;
+    result.exchange_ns = clock.to_exchange_ns(timing.send_ns + (timing.recv_ns - timing.send_ns) / 2);
+    result.success = true;
+    return true;
+}
+
+TickerResult KrakenClient::get_ticker(const std::string& pair) {
+    TickerResult result;
     
-    long http_code = 0;
-    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
-    curl_easy_cleanup(curl);
+    std::string url = api_base_ + "/0/public/Ticker?pair=" + pair;
+    LOG_DEBUG("Fetching ticker: " + url);
     
-    if (http_code != 200) {
-        LOG_ERROR("HTTP error: " + std::to_string(http_code));
-        apply_backoff();
-        return "";
+    HttpTiming timing;
+    std::string response = http_get(url, &timing);
+    if (response.empty()) {
+        result.error = "Empty response from Kraken";
+        return result;
     }
     
-    // Reset backoff on success
-    consecutive_failures_ = 0;
-    current_backoff_ms_ = 0;
+    try {
+        json j = json::parse(response);
+        
+        if (j.contains("error") && j["error"].is_array() && !j["error"].empty()) {
+            result.error = "";
+            for (const auto& err : j["error"]) {
+                result.error += err.get<std::string>() + "; ";
+            }
+            LOG_ERROR("Kraken ticker error: " + result.error);
+            record_failure();
+            return result;
+        }
+        
+        if (!j.contains("result") || j["result"].empty()) {
+            result.error = "No result in ticker response";
+            record_failure();
+            return result;
+        }
+        
+        // Get the first (and should be only) result
+        auto& res = j["result"];
+        for (auto it = res.begin(); it != res.end(); ++it) {
+            if (parse_ticker_entry(it.value(), timing, clock_, result)) {
+                LOG_DEBUG("Ticker " + pair + ": " + std::to_string(result.last_price));
+                return result;
+            }
+        }
+        
+        result.error = "Could not parse last price from ticker response";
+        record_failure();
+        
+    } catch (const json::exception& e) {
+        result.error = "JSON parse error: " + std::string(e.what());
+        LOG_ERROR(result.error);
+        record_failure();
+    } catch (const std::exception& e) {
+        result.error = "Parse error: " + std::string(e.what());
+        LOG_ERROR(result.error);
+        record_failure();
+    }
     
-    return response;
+    return result;
 }
 
-std::string KrakenClient::http_post(const std::string& url, const std::string& postdata,
-                                     const std::map<std::string, std::string>& headers) {
-    enforce_rate_limit();
+MultiTickerResult KrakenClient::get_tickers(const std::vector<std::string>& pairs) {
+    MultiTickerResult result;
     
-    CURL* curl = curl_easy_init();
-    if (!curl) {
-        LOG_ERROR("Failed to initialize curl");
-        apply_backoff();
-        return "";
+    if (pairs.empty()) {
+        result.error = "No pairs requested";
+        return result;
     }
     
-    std::string response;
+    std::string url = api_base_ + "/0/public/Ticker?pair=";
+    for (size_t i = 0; i < pairs.size(); i++) {
+        if (i > 0) url += ",";
+        url += pairs[i];
+    }
+    LOG_DEBUG("Fetching " + std::to_string(pairs.size()) + " tickers");
     
-    struct curl_slist* header_list = nullptr;
-    for (const auto& [key, value] : headers) {
-        std::string header = key + ": " + value;
-        header_list = curl_slist_append(header_list, header.c_str());
+    HttpTiming timing;
+    std::string response = http_get(url, &timing);
+    if (response.empty()) {
+        result.error = "Empty response from Kraken";
+        return result;
     }
-    header_list = curl_slist_append(header_list, "Content-Type: application/x-www-form-urlencoded");
     
-    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, postdata.c_str());
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, header_list);
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 30L);
-    curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, 10L);
-    curl_easy_setopt(curl, CURLOPT_USERAGENT, "KrakenTradingBot/1.0");
+    try {
+        json j = json::parse(response);
+        
+        if (j.contains("error") && j["error"].is_array() && !j["error"].empty()) {
+            for (const auto& err : j["error"]) {
+                result.error += err.get<std::string>() + "; ";
+            }
+            LOG_ERROR("Kraken ticker error: " + result.error);
+            record_failure();
+            return result;
+        }
+        
+        if (!j.contains("result") || !j["result"].is_object()) {
+            result.error = "No result in ticker response";
+            record_failure();
+            return result;
+        }
+        
+        for (auto it = j["result"].begin(); it != j["result"].end(); ++it) {
+            TickerResult ticker;
+            if (parse_ticker_entry(it.value(), timing, clock_, ticker)) {
+                result.tickers.emplace(it.key(), ticker);
+            }
+        }
+        
+        if (result.tickers.empty()) {
+            result.error = "Could not parse any ticker from response";
+            record_failure();
+            return result;
+        }
+        
+        result.success = true;
+        
+    } catch (const json::exception& e) {
+        result.error = "JSON parse error: " + std::string(e.what());
+        LOG_ERROR(result.error);
+        record_failure();
+    } catch (const std::exception& e) {
+        result.error = "Parse error: " + std::string(e.what());
+        LOG_ERROR(result.error);
+        record_failure();
+    }
     
-    CURLcode res = curl_easy_perform(curl);
+    return result;
+}
+
+AssetPairsResult KrakenClient::get_asset_pairs(const std::string& quote) {
+    AssetPairsResult result;
     
-    curl_slist_free_all(header_list);
+    std::string url = api_base_ + "/0/public/AssetPairs";
+    LOG_DEBUG("Fetching asset pairs for quote " + quote);
     
-    if (res != CURLE_OK) {
-        LOG_ERROR("curl_easy_perform() failed: " + std::string(curl_easy_strerror(res)));
-        curl_easy_cleanup(curl);
-        apply_backoff();
-        return "";
+    std::string response = http_get(url);
+    if (response.empty()) {
+        result.error = "Empty response from Kraken";
+        return result;
     }
     
-    long http_code = 0;
-    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
-    curl_easy_cleanup(curl);
-    
-    if (http_code != 200) {
-        LOG_ERROR("HTTP error: " + std::to_string(http_code));
-        apply_backoff();
-        return "";
+    try {
+        json j = json::parse(response);
+        
+        if (j.contains("error") && j["error"].is_array() && !j["error"].empty()) {
+            for (const auto& err : j["error"]) {
+                result.error += err.get<std::string>() + "; ";
+            }
+            LOG_ERROR("Kraken asset pairs error: " + result.error);
+            record_failure();
+            return result;
+        }
+        
+        if (!j.contains("result") || !j["result"].is_object()) {
+            result.error = "No result in asset pairs response";
+            record_failure();
+            return result;
+        }
+        
+        for (auto it = j["result"].begin(); it != j["result"].end(); ++it) {
+            const auto& info = it.value();
+            // Skip dark pool books (".d" suffix) and pairs that are not fully online
+            if (it.key().find('.') != std::string::npos) continue;
+            if (info.value("quote", "") != quote) continue;
+            if (info.value("status", "online") != "online") continue;
+            result.pairs.push_back(it.key());
+        }
+        
+        result.success = true;
+        LOG_INFO("Found " + std::to_string(result.pairs.size()) + " online pairs quoted in " + quote);
+        
+    } catch (const json::exception& e) {
+        result.error = "JSON parse error: " + std::string(e.what());
+        LOG_ERROR(result.error);
+        record_failure();
     }
     
-    // Reset backoff on success
-    consecutive_failures_ = 0;
-    current_backoff_ms_ = 0;
-    
-    return response;
+    return result;
+}
+
+// Parse one side of a Depth response: [["price", "volume", timestamp], ...]
+static std::vector<BookLevel> parse_book_side(const json& side) {
+    std::vector<BookLevel> levels;
+    if (!side.is_array()) {
+        return levels;
+    }
+    levels.reserve(side.size());
+    for (const auto& entry : side) {
+        if (!entry.is_array() || entry.size() < 2) continue;
+        BookLevel level;
+        level.price = std::stod(entry[0].get<std::string>());
+        level.volume = std::stod(entry[1].get<std::string>());
+        levels.push_back(level);
+    }
+    return levels;
 }
 
-std::string KrakenClient::generate_signature(const std::string& uri_path, const std::string& nonce,
-                                              const std::string& postdata) {
-    // Kraken signature: 
-    // HMAC-SHA512 of (URI path + SHA256(nonce + POST data)) using base64-decoded secret
+DepthResult KrakenClient::get_depth(const std::string& pair, int count) {
+    DepthResult result;
     
-    std::string sha256_input = nonce + postdata;
-    std::string sha256_hash = util::sha256_raw(sha256_input);
+    std::string url = api_base_ + "/0/public/Depth?pair=" + pair + "&count=" + std::to_string(count);
+    LOG_DEBUG("Fetching depth for " + pair);
     
-    std::string hmac_input = uri_path + sha256_hash;
-    std::string decoded_secret = util::base64_decode(api_secret_);
+    HttpTiming timing;
+    std::string response = http_get(url, &timing);
+    if (response.empty()) {
+        result.error = "Empty response from Kraken";
+        return result;
+    }
+    
+    try {
+        json j = json::parse(response);
+        
+        if (j.contains("error") && j["error"].is_array() && !j["error"].empty()) {
+            for (const auto& err : j["error"]) {
+                result.error += err.get<std::string>() + "; ";
+            }
+            LOG_ERROR("Kraken depth error: " + result.error);
+            record_failure();
+            return result;
+        }
+        
+        if (!j.contains("result") || !j["result"].is_object() || j["result"].empty()) {
+            result.error = "No result in depth response";
+            record_failure();
+            return result;
+        }
+        
+        // Kraken may key the result by its canonical name, so take the first entry
+        const auto& book = j["result"].begin().value();
+        result.bids = parse_book_side(book.value("bids", json::array()));
+        result.asks = parse_book_side(book.value("asks", json::array()));
+        result.receive_ns = timing.recv_ns;
+        result.exchange_ns = clock_.to_exchange_ns(timing.send_ns + (timing.recv_ns - timing.send_ns) / 2);
+        result.success = true;
+        
+    } catch (const json::exception& e) {
+        result.error = "JSON parse error: " + std::string(e.what());
+        LOG_ERROR(result.error);
+        record_failure();
+    } catch (const std::exception& e) {
+        result.error = "Parse error: " + std::string(e.what());
+        LOG_ERROR(result.error);
+        record_failure();
+    }
     
-    return util::hmac_sha512_raw(decoded_secret, hmac_input);
+    return result;
 }
 
-TickerResult KrakenClient::get_ticker(const std::string& pair) {
-    TickerResult result;
+TradesResult KrakenClient::get_recent_trades(const std::string& pair, const std::string& since) {
+    TradesResult result;
     
-    std::string url = api_base_ + "/0/public/Ticker?pair=" + pair;
-    LOG_DEBUG("Fetching ticker: " + url);
+    std::string url = api_base_ + "/0/public/Trades?pair=" + pair;
+    if (!since.empty()) {
+        url += "&since=" + since;
+    }
+    LOG_DEBUG("Fetching trades for " + pair);
     
     std::string response = http_get(url);
     if (response.empty()) {
@@ -221,79 +694,226 @@ TickerResult KrakenClient::get_ticker(const std::string& pair) {
         json j = json::parse(response);
         
         if (j.contains("error") && j["error"].is_array() && !j["error"].empty()) {
-            result.error = "";
             for (const auto& err : j["error"]) {
                 result.error += err.get<std::string>() + "; ";
             }
-            LOG_ERROR("Kraken ticker error: " + result.error);
-            apply_backoff();
+            LOG_ERROR("Kraken trades error: " + result.error);
+            record_failure();
             return result;
         }
         
-        if (!j.contains("result") || j["result"].empty()) {
-            result.error = "No result in ticker response";
-            apply_backoff();
+        if (!j.contains("result") || !j["result"].is_object()) {
+            result.error = "No result in trades response";
+            record_failure();
             return result;
         }
         
-        // Get the first (and should be only) result
-        auto& res = j["result"];
-        for (auto it = res.begin(); it != res.end(); ++it) {
-            // "c" is the last trade closed array [price, lot volume]
-            if (it.value().contains("c") && it.value()["c"].is_array() && !it.value()["c"].empty()) {
-                result.last_price = std::stod(it.value()["c"][0].get<std::string>());
-                if (it.value().contains("b") && it.value()["b"].is_array() && !it.value()["b"].empty()) {
-                    result.bid_price = std::stod(it.value()["b"][0].get<std::string>());
+        // [price, volume, time, "b"/"s", "m"/"l", misc, trade_id] per print,
+        // plus a "last" cursor next to the pair key
+        for (auto it = j["result"].begin(); it != j["result"].end(); ++it) {
+            if (it.key() == "last") {
+                result.last = it.value().is_string() ? it.value().get<std::string>()
+                                                     : std::to_string(it.value().get<int64_t>());
+                continue;
+            }
+            if (!it.value().is_array()) continue;
+            for (const auto& entry : it.value()) {
+                if (!entry.is_array() || entry.size() < 4) continue;
+                TradePrint print;
+                print.price = std::stod(entry[0].get<std::string>());
+                print.volume = std::stod(entry[1].get<std::string>());
+                print.time_ns = static_cast<int64_t>(entry[2].get<double>() * 1e9);
+                if (entry[3].is_string()) {
+                    const std::string side = entry[3].get<std::string>();
+                    print.has_side = side == "b" || side == "s";
+                    print.buy_aggressor = side == "b";
                 }
-                if (it.value().contains("a") && it.value()["a"].is_array() && !it.value()["a"].empty()) {
-                    result.ask_price = std::stod(it.value()["a"][0].get<std::string>());
+                if (entry.size() > 6 && entry[6].is_number_integer()) {
+                    print.trade_id = entry[6].get<uint64_t>();
                 }
-                result.timestamp = util::now_epoch_seconds();
-                result.success = true;
-                LOG_DEBUG("Ticker " + pair + ": " + std::to_string(result.last_price));
-                return result;
+                result.trades.push_back(print);
             }
         }
         
-        result.error = "Could not parse last price from ticker response";
-        apply_backoff();
+        result.success = true;
         
     } catch (const json::exception& e) {
         result.error = "JSON parse error: " + std::string(e.what());
         LOG_ERROR(result.error);
-        apply_backoff();
+        record_failure();
     } catch (const std::exception& e) {
         result.error = "Parse error: " + std::string(e.what());
         LOG_ERROR(result.error);
-        apply_backoff();
+        record_failure();
     }
     
     return result;
 }
 
-BalanceResult KrakenClient::get_balance() {
-    BalanceResult result;
+OhlcResult KrakenClient::get_ohlc(const std::string& pair, int interval_minutes) {
+    OhlcResult result;
     
-    if (!initialized_) {
-        result.error = "API credentials not initialized";
+    std::string url = api_base_ + "/0/public/OHLC?pair=" + pair + "&interval=" + std::to_string(interval_minutes);
+    LOG_DEBUG("Fetching " + std::to_string(interval_minutes) + "m OHLC for " + pair);
+    
+    std::string response = http_get(url);
+    if (response.empty()) {
+        result.error = "Empty response from Kraken";
         return result;
     }
     
-    std::string uri_path = "/0/private/Balance";
-    std::string url = api_base_ + uri_path;
+    try {
+        json j = json::parse(response);
+        
+        if (j.contains("error") && j["error"].is_array() && !j["error"].empty()) {
+            for (const auto& err : j["error"]) {
+                result.error += err.get<std::string>() + "; ";
+            }
+            LOG_ERROR("Kraken OHLC error: " + result.error);
+            record_failure();
+            return result;
+        }
+        
+        if (!j.contains("result") || !j["result"].is_object()) {
+            result.error = "No result in OHLC response";
+            record_failure();
+            return result;
+        }
+        
+        // [time, open, high, low, close, vwap, volume, count] per bar, plus a
+        // "last" cursor next to the pair key
+        for (auto it = j["result"].begin(); it != j["result"].end(); ++it) {
+            if (it.key() == "last" || !it.value().is_array()) continue;
+            for (const auto& entry : it.value()) {
+                if (!entry.is_array() || entry.size() < 7) continue;
+                OhlcBar bar;
+                bar.time = entry[0].get<int64_t>();
+                bar.open = std::stod(entry[1].get<std::string>());
+                bar.high = std::stod(entry[2].get<std::string>());
+                bar.low = std::stod(entry[3].get<std::string>());
+                bar.close = std::stod(entry[4].get<std::string>());
+                bar.volume = std::stod(entry[6].get<std::string>());
+                result.bars.push_back(bar);
+            }
+        }
+        // The newest bar is still forming
+        if (!result.bars.empty()) {
+            result.bars.pop_back();
+        }
+        
+        result.success = true;
+        
+    } catch (const json::exception& e) {
+        result.error = "JSON parse error: " + std::string(e.what());
+        LOG_ERROR(result.error);
+        record_failure();
+    } catch (const std::exception& e) {
+        result.error = "Parse error: " + std::string(e.what());
+        LOG_ERROR(result.error);
+        record_failure();
+    }
     
-    std::string nonce = util::generate_nonce();
-    std::string postdata = "nonce=" + nonce;
+    return result;
+}
+
+ServerTimeResult KrakenClient::get_server_time() {
+    ServerTimeResult result;
+    
+    std::string url = api_base_ + "/0/public/Time";
+    
+    HttpTiming timing;
+    std::string response = http_get(url, &timing);
+    if (response.empty()) {
+        result.error = "Empty response from Kraken";
+        return result;
+    }
     
-    std::string signature = generate_signature(uri_path, nonce, postdata);
+    try {
+        json j = json::parse(response);
+        
+        if (j.contains("error") && j["error"].is_array() && !j["error"].empty()) {
+            for (const auto& err : j["error"]) {
+                result.error += err.get<std::string>() + "; ";
+            }
+            LOG_ERROR("Kraken time error: " + result.error);
+            record_failure();
+            return result;
+        }
+        
+        if (!j.contains("result") || !j["result"].contains("unixtime")) {
+            result.error = "No unixtime in time response";
+            record_failure();
+            return result;
+        }
+        
+        result.unixtime = j["result"]["unixtime"].get<int64_t>();
+        result.sample.send_ns = timing.send_ns;
+        result.sample.recv_ns = timing.recv_ns;
+        result.sample.server_ns = result.unixtime * 1'000'000'000;
+        result.sample.server_resolution_ns = 1'000'000'000;  // unixtime is truncated to seconds
+        result.success = true;
+        
+        clock_.add_sample(result.sample);
+        
+    } catch (const json::exception& e) {
+        result.error = "JSON parse error: " + std::string(e.what());
+        LOG_ERROR(result.error);
+        record_failure();
+    }
     
-    std::map<std::string, std::string> headers;
-    headers["API-Key"] = api_key_;
-    headers["API-Sign"] = signature;
+    return result;
+}
+
+bool KrakenClient::warm_up() {
+    pin_host();
+    ServerTimeResult t = get_server_time();
+    if (!t.success) {
+        LOG_WARNING("Connection warm-up failed: " + t.error);
+    }
+    return t.success;
+}
+
+void KrakenClient::keep_warm(int64_t idle_seconds) {
+    if (idle_seconds <= 0) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(request_mutex_);
+        if (std::chrono::steady_clock::now() - last_request_time_ < std::chrono::seconds(idle_seconds)) {
+            return;
+        }
+    }
+    LOG_DEBUG("Connection idle for " + std::to_string(idle_seconds) + "s, sending keep-warm request");
+    warm_up();
+}
+
+bool KrakenClient::sync_clock(int probes) {
+    int ok = 0;
+    for (int i = 0; i < probes; i++) {
+        ServerTimeResult t = get_server_time();
+        if (t.success) {
+            ok++;
+        } else {
+            LOG_WARNING("Clock sync probe failed: " + t.error);
+        }
+    }
+    if (ok > 0) {
+        clock_.log_status();
+    }
+    return ok > 0;
+}
+
+BalanceResult KrakenClient::get_balance() {
+    BalanceResult result;
+    
+    if (!initialized_) {
+        result.error = "API credentials not initialized";
+        return result;
+    }
     
     LOG_DEBUG("Fetching balance...");
     
-    std::string response = http_post(url, postdata, headers);
+    std::string response = post_private(*balance_request_, {});
     if (response.empty()) {
         result.error = "Empty response from Kraken";
         return result;
@@ -308,13 +928,13 @@ BalanceResult KrakenClient::get_balance() {
                 result.error += err.get<std::string>() + "; ";
             }
             LOG_ERROR("Kraken balance error: " + result.error);
-            apply_backoff();
+            record_failure();
             return result;
         }
         
         if (!j.contains("result")) {
             result.error = "No result in balance response";
-            apply_backoff();
+            record_failure();
             return result;
         }
         
@@ -341,49 +961,110 @@ BalanceResult KrakenClient::get_balance() {
     } catch (const json::exception& e) {
         result.error = "JSON parse error: " + std::string(e.what());
         LOG_ERROR(result.error);
-        apply_backoff();
+        record_failure();
     } catch (const std::exception& e) {
         result.error = "Parse error: " + std::string(e.what());
         LOG_ERROR(result.error);
-        apply_backoff();
+        record_failure();
     }
     
     return result;
 }
 
-OrderResult KrakenClient::place_market_order(const std::string& pair, const std::string& side, double volume) {
-    OrderResult result;
+FeeTierResult KrakenClient::get_trade_volume(const std::string& pair) {
+    FeeTierResult result;
     
     if (!initialized_) {
         result.error = "API credentials not initialized";
         return result;
     }
     
-    std::string uri_path = "/0/private/AddOrder";
-    std::string url = api_base_ + uri_path;
-    
-    std::string nonce = util::generate_nonce();
+    LOG_DEBUG("Fetching fee tier for " + pair);
     
-    // Format volume to 8 decimal places for BTC
-    std::ostringstream vol_ss;
-    vol_ss << std::fixed << std::setprecision(8) << volume;
-    std::string volume_str = vol_ss.str();
-    
-    std::string postdata = "nonce=" + nonce +
-                          "&ordertype=market" +
-                          "&type=" + side +
-                          "&volume=" + volume_str +
-                          "&pair=" + pair;
+    params_.assign("pair=");
+    params_.append(pair);
+    std::string response = post_private(*trade_volume_request_, params_);
+    if (response.empty()) {
+        result.error = "Empty response from Kraken";
+        return result;
+    }
     
-    std::string signature = generate_signature(uri_path, nonce, postdata);
+    try {
+        json j = json::parse(response);
+        
+        if (j.contains("error") && j["error"].is_array() && !j["error"].empty()) {
+            for (const auto& err : j["error"]) {
+                result.error += err.get<std::string>() + "; ";
+            }
+            LOG_ERROR("Kraken trade volume error: " + result.error);
+            record_failure();
+            return result;
+        }
+        
+        if (!j.contains("result") || !j["result"].is_object()) {
+            result.error = "No result in trade volume response";
+            record_failure();
+            return result;
+        }
+        
+        // Fees are quoted in percent and keyed by the canonical pair name;
+        // pairs without a separate maker schedule charge the taker fee
+        const auto& res = j["result"];
+        result.volume_30d = std::stod(res.value("volume", "0"));
+        if (!res.contains("fees") || !res["fees"].is_object() || res["fees"].empty()) {
+            result.error = "No fee schedule for " + pair;
+            record_failure();
+            return result;
+        }
+        result.taker_fee_pct = std::stod(res["fees"].begin().value().value("fee", "0")) / 100.0;
+        result.maker_fee_pct = result.taker_fee_pct;
+        if (res.contains("fees_maker") && res["fees_maker"].is_object() && !res["fees_maker"].empty()) {
+            result.maker_fee_pct = std::stod(res["fees_maker"].begin().value().value("fee", "0")) / 100.0;
+        }
+        
+        result.success = true;
+        LOG_INFO("Fee tier: taker=" + std::to_string(result.taker_fee_pct * 100.0) + "%, maker=" +
+                 std::to_string(result.maker_fee_pct * 100.0) + "%, 30d volume=" +
+                 std::to_string(result.volume_30d));
+        
+    } catch (const json::exception& e) {
+        result.error = "JSON parse error: " + std::string(e.what());
+        LOG_ERROR(result.error);
+        record_failure();
+    } catch (const std::exception& e) {
+        result.error = "Parse error: " + std::string(e.what());
+        LOG_ERROR(result.error);
+        record_failure();
+    }
     
-    std::map<std::string, std::string> headers;
-    headers["API-Key"] = api_key_;
-    headers["API-Sign"] = signature;
+    return result;
+}
+
+OrderResult KrakenClient::place_market_order(const std::string& pair, const std::string& side, double volume) {
+    OrderResult result;
     
-    LOG_INFO("Placing market " + side + " order: " + volume_str + " " + pair);
+    if (!initialized_) {
+        result.error = "API credentials not initialized";
+        return result;
+    }
     
-    std::string response = http_post(url, postdata, headers);
+    // Format volume to 8 decimal places for BTC
+    char volume_buf[32];
+    auto [volume_end, ec] = std::to_chars(volume_buf, volume_buf + sizeof(volume_buf), volume,
+                                          std::chars_format::fixed, 8);
+    (void)ec;
+    const std::string_view volume_str(volume_buf, static_cast<size_t>(volume_end - volume_buf));
+    
+    params_.assign("ordertype=market&type=");
+    params_.append(side);
+    params_.append("&volume=");
+    params_.append(volume_str);
+    params_.append("&pair=");
+    params_.append(pair);
+    
+    LOG_INFO("Placing market " + side + " order: " + std::string(volume_str) + " " + pair);
+    
+    std::string response = post_private(*add_order_request_, params_);
     if (response.empty()) {
         result.error = "Empty response from Kraken";
         return result;
@@ -398,13 +1079,13 @@ OrderResult KrakenClient::place_market_order(const std::string& pair, const std:
                 result.error += err.get<std::string>() + "; ";
             }
             LOG_ERROR("Kraken order error: " + result.error);
-            apply_backoff();
+            record_failure();
             return result;
         }
         
         if (!j.contains("result")) {
             result.error = "No result in order response";
-            apply_backoff();
+            record_failure();
             return result;
         }
         
@@ -427,11 +1108,11 @@ OrderResult KrakenClient::place_market_order(const std::string& pair, const std:
     } catch (const json::exception& e) {
         result.error = "JSON parse error: " + std::string(e.what());
         LOG_ERROR(result.error);
-        apply_backoff();
+        record_failure();
     } catch (const std::exception& e) {
         result.error = "Parse error: " + std::string(e.what());
         LOG_ERROR(result.error);
-        apply_backoff();
+        record_failure();
     }
     
     return result;
@@ -445,21 +1126,13 @@ OrderResult KrakenClient::query_order(const std::string& txid) {
         return result;
     }
     
-    std::string uri_path = "/0/private/QueryOrders";
-    std::string url = api_base_ + uri_path;
-    
-    std::string nonce = util::generate_nonce();
-    std::string postdata = "nonce=" + nonce + "&txid=" + txid + "&trades=true";
-    
-    std::string signature = generate_signature(uri_path, nonce, postdata);
-    
-    std::map<std::string, std::string> headers;
-    headers["API-Key"] = api_key_;
-    headers["API-Sign"] = signature;
+    params_.assign("txid=");
+    params_.append(txid);
+    params_.append("&trades=true");
     
     LOG_DEBUG("Querying order: " + txid);
     
-    std::string response = http_post(url, postdata, headers);
+    std::string response = post_private(*query_orders_request_, params_);
     if (response.empty()) {
         result.error = "Empty response from Kraken";
         return result;
@@ -474,13 +1147,13 @@ OrderResult KrakenClient::query_order(const std::string& txid) {
                 result.error += err.get<std::string>() + "; ";
             }
             LOG_ERROR("Kraken query order error: " + result.error);
-            apply_backoff();
+            record_failure();
             return result;
         }
         
         if (!j.contains("result")) {
             result.error = "No result in query response";
-            apply_backoff();
+            record_failure();
             return result;
         }
         
@@ -528,11 +1201,11 @@ OrderResult KrakenClient::query_order(const std::string& txid) {
     } catch (const json::exception& e) {
         result.error = "JSON parse error: " + std::string(e.what());
         LOG_ERROR(result.error);
-        apply_backoff();
+        record_failure();
     } catch (const std::exception& e) {
         result.error = "Parse error: " + std::string(e.what());
         LOG_ERROR(result.error);
-        apply_backoff();
+        record_failure();
     }
     
     return result;
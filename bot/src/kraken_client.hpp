@@ -3,9 +3,20 @@
 
 #include <string>
 #include <optional>
+#include <string_view>
 #include <map>
 #include <chrono>
 #include <mutex>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
+#include "clock_sync.hpp"
+#include "http_transport.hpp"
+#include "circuit_breaker.hpp"
+
+class PrivateRequestTemplate;
 
 // Result types for API responses
 struct TickerResult {
@@ -14,7 +25,85 @@ struct TickerResult {
     double last_price = 0.0;
     double bid_price = 0.0;
     double ask_price = 0.0;
-    int64_t timestamp = 0;  // Unix epoch seconds when fetched
+    double bid_volume = 0.0;  // Size resting at the best bid
+    double ask_volume = 0.0;  // Size resting at the best ask
+    double volume_24h = 0.0;
+    int64_t timestamp = 0;    // Unix epoch seconds when fetched
+    int64_t receive_ns = 0;   // Local epoch ns when the response's first byte arrived
+    int64_t exchange_ns = 0;  // Estimated exchange time the quote was served
+};
+
+struct ServerTimeResult {
+    bool success = false;
+    std::string error;
+    int64_t unixtime = 0;
+    ClockSample sample;
+};
+
+struct MultiTickerResult {
+    bool success = false;
+    std::string error;
+    std::map<std::string, TickerResult> tickers;  // Keyed by Kraken pair name
+};
+
+struct AssetPairsResult {
+    bool success = false;
+    std::string error;
+    std::vector<std::string> pairs;  // Kraken pair names (e.g. XXBTZCAD)
+};
+
+struct BookLevel {
+    double price = 0.0;
+    double volume = 0.0;
+};
+
+struct DepthResult {
+    bool success = false;
+    std::string error;
+    std::vector<BookLevel> bids;  // Best (highest) first
+    std::vector<BookLevel> asks;  // Best (lowest) first
+    int64_t receive_ns = 0;
+    int64_t exchange_ns = 0;
+};
+
+struct TradePrint {
+    double price = 0.0;
+    double volume = 0.0;
+    int64_t time_ns = 0;          // Exchange time of the trade
+    bool buy_aggressor = false;   // Taker was the buyer (lifted the ask)
+    bool has_side = false;        // Side was reported; otherwise buy_aggressor
+                                  // is a guess and should be tick-ruled
+    uint64_t trade_id = 0;        // Per-pair, increasing; 0 if not sent
+};
+
+struct TradesResult {
+    bool success = false;
+    std::string error;
+    std::vector<TradePrint> trades;  // Oldest first
+    std::string last;                // Cursor to pass as since next time
+};
+
+struct OhlcBar {
+    int64_t time = 0;             // Bar open, Unix epoch seconds
+    double open = 0.0;
+    double high = 0.0;
+    double low = 0.0;
+    double close = 0.0;
+    double volume = 0.0;
+};
+
+struct OhlcResult {
+    bool success = false;
+    std::string error;
+    std::vector<OhlcBar> bars;    // Oldest first, closed bars only
+};
+
+struct FeeTierResult {
+    bool success = false;
+    std::string error;
+    double volume_30d = 0.0;      // In the fee schedule's currency
+    double taker_fee_pct = 0.0;   // Fractions (0.0026 = 0.26%)
+    double maker_fee_pct = 0.0;
 };
 
 struct BalanceResult {
@@ -37,25 +126,85 @@ struct OrderResult {
 class KrakenClient {
 public:
     KrakenClient(const std::string& api_base, int64_t min_delay_ms);
+    ~KrakenClient();
     
     // Initialize with API credentials
     bool init();
     
+    // Replace the HTTP transport (e.g. with a fault-injecting decorator)
+    void set_transport(std::unique_ptr<HttpTransport> transport);
+    
     // Public API - Ticker
     TickerResult get_ticker(const std::string& pair);
     
+    // Public API - Ticker for many pairs in a single request
+    MultiTickerResult get_tickers(const std::vector<std::string>& pairs);
+    
+    // Public API - Online pairs quoted in the given asset (e.g. ZCAD)
+    AssetPairsResult get_asset_pairs(const std::string& quote);
+    
+    // Public API - Order book, up to count levels per side
+    DepthResult get_depth(const std::string& pair, int count);
+    
+    // Public API - Trade prints after the since cursor (empty = most recent)
+    TradesResult get_recent_trades(const std::string& pair, const std::string& since);
+    
+    // Public API - OHLC bars of interval_minutes, oldest first; the last,
+    // still-forming bar is dropped
+    OhlcResult get_ohlc(const std::string& pair, int interval_minutes);
+    
+    // Public API - Server time; each call also feeds the clock estimator
+    ServerTimeResult get_server_time();
+    
+    // Probe /0/public/Time a few times and log the resulting estimate
+    bool sync_clock(int probes);
+    
+    // Offset/RTT estimate against Kraken's clock
+    const ClockSync& clock() const { return clock_; }
+    
     // Private API - Balance
     BalanceResult get_balance();
     
+    // Private API - 30-day volume and the account's fee tier for pair
+    FeeTierResult get_trade_volume(const std::string& pair);
+    
     // Private API - Place market order
     OrderResult place_market_order(const std::string& pair, const std::string& side, double volume);
     
     // Private API - Query order status
     OrderResult query_order(const std::string& txid);
     
-    // Set exponential backoff parameters
+    // Requests allowed back to back before the min_delay_ms spacing applies
+    // (default 1: strict spacing)
+    void set_rate_limit_burst(int burst);
+    
+    // Set exponential backoff parameters (every endpoint class)
     void set_backoff_params(int max_retries, int64_t initial_backoff_ms, int64_t max_backoff_ms);
     
+    // Breaker, retry budget and hedging policy (every endpoint class;
+    // hedging only ever applies to market data)
+    void set_endpoint_policy(const EndpointPolicy& policy);
+    
+    // Per-class breaker state, retries, hedges and latency
+    std::vector<EndpointMetrics> endpoint_metrics() const;
+    
+    // Timeout applied to each request (one stream under HTTP/2)
+    void set_request_timeout_ms(int64_t timeout_ms) { request_timeout_ms_ = timeout_ms; }
+    
+    // Protocol, connection and stream counters from the transport
+    HttpTransportStats transport_stats() const { return transport_->transport_stats(); }
+    
+    // Resolve and pin the API host's addresses without sending a request
+    bool pin_host() { return transport_->pin_host(api_base_); }
+    
+    // Pin the API host's addresses and open a connection with a Time request
+    // (which also feeds the clock estimate), so the first real calls run warm
+    bool warm_up();
+    
+    // warm_up() again if nothing was sent for idle_seconds, before the
+    // server or a middlebox drops the idle connection; 0 disables
+    void keep_warm(int64_t idle_seconds);
+    
     // Get consecutive failure count
     int get_consecutive_failures() const { return consecutive_failures_; }
     
@@ -64,34 +213,84 @@ public:
 
 private:
     // HTTP request helpers
-    std::string http_get(const std::string& url);
-    std::string http_post(const std::string& url, const std::string& postdata, 
-                          const std::map<std::string, std::string>& headers);
+    std::string http_get(const std::string& url, HttpTiming* timing = nullptr);
+    // Sign params with the endpoint's template and send it
+    std::string post_private(PrivateRequestTemplate& tmpl, std::string_view params);
+    uint64_t next_nonce();
     
-    // Kraken authentication
-    std::string generate_signature(const std::string& uri_path, const std::string& nonce, 
-                                   const std::string& postdata);
+    // Breaker check, class backoff, retries (idempotent classes) and hedging
+    std::string perform(const HttpRequest& request, HttpTiming* timing);
+    HttpResponse send(const HttpRequest& request, CircuitBreaker& breaker);
+    CircuitBreaker& breaker(EndpointClass cls) { return *breakers_[static_cast<size_t>(cls)]; }
     
-    // Rate limiting
-    void enforce_rate_limit();
-    void apply_backoff();
+    // Rate limiting: a token from the shared bucket plus the class's own backoff
+    void enforce_rate_limit(EndpointClass cls);
+    void refill_tokens(std::chrono::steady_clock::time_point now);
+    
+    // Hedge accounting against the same bucket: time until the next token,
+    // and a non-blocking claim of it
+    int64_t next_slot_ms();
+    bool try_take_slot();
+    
+    // Count a failed call toward the halt threshold
+    void record_failure();
+    
+    // Hedging: the primary runs on the calling thread while a timer thread
+    // (started with the first hedgeable request) watches its deadline and
+    // only then starts a thread for the hedge
+    struct HedgeState;
+    struct HedgeThread {
+        std::thread thread;
+        std::shared_ptr<HedgeState> state;
+    };
+    void schedule_hedge(std::shared_ptr<HedgeState> state);
+    void hedge_loop();
+    void launch_hedge(const std::shared_ptr<HedgeState>& state);
     
     // API credentials
     std::string api_key_;
     std::string api_secret_;
     std::string api_base_;
     
-    // Rate limiting
+    // Signed request templates (built by init()) and their scratch params
+    std::unique_ptr<PrivateRequestTemplate> balance_request_;
+    std::unique_ptr<PrivateRequestTemplate> add_order_request_;
+    std::unique_ptr<PrivateRequestTemplate> query_orders_request_;
+    std::unique_ptr<PrivateRequestTemplate> trade_volume_request_;
+    std::string params_;
+    uint64_t last_nonce_ = 0;
+    
+    // Rate limiting: a token bucket of rate_limit_burst_ tokens refilled one
+    // per min_delay_ms_
     int64_t min_delay_ms_;
+    int64_t request_timeout_ms_ = 30000;
+    int rate_limit_burst_ = 1;
+    double tokens_ = 1.0;
     std::chrono::steady_clock::time_point last_request_time_;
+    std::chrono::steady_clock::time_point refill_time_;
     std::mutex request_mutex_;
     
-    // Backoff
-    int max_retries_ = 3;
-    int64_t initial_backoff_ms_ = 1000;
-    int64_t max_backoff_ms_ = 30000;
-    int consecutive_failures_ = 0;
-    int64_t current_backoff_ms_ = 0;
+    // Failures across all classes, for the halt check (startup calls run
+    // concurrently)
+    std::atomic<int> consecutive_failures_{0};
+    
+    // One breaker per EndpointClass
+    std::vector<std::unique_ptr<CircuitBreaker>> breakers_;
+    
+    // Exchange clock estimate
+    ClockSync clock_;
+    
+    // Shared so a hedge still running after its twin won keeps the
+    // transport alive if set_transport() replaces it
+    std::shared_ptr<HttpTransport> transport_;
+    
+    // Pending hedge deadlines and launched hedges, joined on destruction
+    std::mutex hedge_mutex_;
+    std::condition_variable hedge_cv_;
+    std::vector<std::shared_ptr<HedgeState>> hedge_pending_;
+    std::vector<HedgeThread> hedge_threads_;
+    std::thread hedge_timer_;
+    bool hedge_stopping_ = false;
     
     // Initialization flag
     bool initialized_ = false;
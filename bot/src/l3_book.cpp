@@ -0,0 +1,288 @@
+#include "l3_book.hpp"
+#include <algorithm>
+
+// Large cancels kept until taken; older ones are dropped first
+static constexpr size_t kMaxPendingCancels = 256;
+
+// splitmix64 finaliser: order keys are spread over the table even when the
+// exchange hands out ids with long shared prefixes
+static inline uint64_t mix(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+L3Book::L3Book(double large_cancel_volume, size_t expected_orders)
+    : large_cancel_volume_(large_cancel_volume) {
+    size_t slots = 16;
+    while (slots < expected_orders * 2) {
+        slots *= 2;
+    }
+    slots_.assign(slots, Slot{0, kNone});
+    mask_ = slots - 1;
+    orders_.reserve(expected_orders);
+}
+
+uint64_t L3Book::key_of(std::string_view order_id) {
+    // FNV-1a
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (char c : order_id) {
+        h ^= static_cast<unsigned char>(c);
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+size_t L3Book::slot_for(uint64_t id) const {
+    size_t i = mix(id) & mask_;
+    while (slots_[i].order != kNone && slots_[i].id != id) {
+        i = (i + 1) & mask_;
+    }
+    return i;
+}
+
+void L3Book::insert_slot(uint64_t id, uint32_t order) {
+    slots_[slot_for(id)] = Slot{id, order};
+}
+
+void L3Book::erase_slot(size_t i) {
+    // Backward-shift deletion: pull later entries of the probe run into the
+    // hole unless that would move them before their home slot
+    size_t j = i;
+    for (;;) {
+        j = (j + 1) & mask_;
+        if (slots_[j].order == kNone) {
+            break;
+        }
+        size_t home = mix(slots_[j].id) & mask_;
+        if (((j - home) & mask_) >= ((j - i) & mask_)) {
+            slots_[i] = slots_[j];
+            i = j;
+        }
+    }
+    slots_[i].order = kNone;
+}
+
+void L3Book::grow() {
+    std::vector<Slot> old;
+    old.swap(slots_);
+    slots_.assign(old.size() * 2, Slot{0, kNone});
+    mask_ = slots_.size() - 1;
+    for (const Slot& slot : old) {
+        if (slot.order != kNone) {
+            insert_slot(slot.id, slot.order);
+        }
+    }
+}
+
+uint32_t L3Book::find_or_add_level(bool bid, double price) {
+    std::vector<LevelRef>& side = bid ? bids_ : asks_;
+    auto it = std::lower_bound(side.begin(), side.end(), price, [bid](const LevelRef& ref, double p) {
+        return bid ? ref.price < p : ref.price > p;
+    });
+    if (it != side.end() && it->price == price) {
+        return it->level;
+    }
+
+    uint32_t level;
+    if (free_level_ != kNone) {
+        level = free_level_;
+        free_level_ = levels_[level].next_free;
+    } else {
+        level = static_cast<uint32_t>(levels_.size());
+        levels_.emplace_back();
+    }
+    Level& lv = levels_[level];
+    lv = Level{};
+    lv.price = price;
+    lv.bid = bid;
+    side.insert(it, LevelRef{price, level});
+    return level;
+}
+
+void L3Book::release_level(uint32_t level) {
+    Level& lv = levels_[level];
+    std::vector<LevelRef>& side = lv.bid ? bids_ : asks_;
+    const bool bid = lv.bid;
+    auto it = std::lower_bound(side.begin(), side.end(), lv.price, [bid](const LevelRef& ref, double p) {
+        return bid ? ref.price < p : ref.price > p;
+    });
+    if (it != side.end() && it->level == level) {
+        side.erase(it);
+    }
+    lv.next_free = free_level_;
+    free_level_ = level;
+}
+
+void L3Book::link_back(uint32_t order, uint32_t level) {
+    Order& o = orders_[order];
+    Level& lv = levels_[level];
+    o.level = level;
+    o.prev = lv.tail;
+    o.next = kNone;
+    if (lv.tail != kNone) {
+        orders_[lv.tail].next = order;
+    } else {
+        lv.head = order;
+    }
+    lv.tail = order;
+    lv.volume += o.volume;
+    lv.orders++;
+}
+
+void L3Book::unlink(uint32_t order) {
+    Order& o = orders_[order];
+    Level& lv = levels_[o.level];
+    if (o.prev != kNone) {
+        orders_[o.prev].next = o.next;
+    } else {
+        lv.head = o.next;
+    }
+    if (o.next != kNone) {
+        orders_[o.next].prev = o.prev;
+    } else {
+        lv.tail = o.prev;
+    }
+    lv.orders--;
+    lv.volume -= o.volume;
+    if (lv.orders == 0) {
+        release_level(o.level);
+    }
+    o.level = kNone;
+}
+
+void L3Book::free_order(uint32_t order) {
+    orders_[order].next = free_order_;
+    free_order_ = order;
+}
+
+bool L3Book::add(uint64_t order_id, bool bid, double price, double volume) {
+    if (volume <= 0.0 || slots_[slot_for(order_id)].order != kNone) {
+        stats_.unknown++;
+        return false;
+    }
+    // Keep the load factor at or below one half
+    if ((live_orders_ + 1) * 2 > slots_.size()) {
+        grow();
+    }
+
+    uint32_t order;
+    if (free_order_ != kNone) {
+        order = free_order_;
+        free_order_ = orders_[order].next;
+    } else {
+        order = static_cast<uint32_t>(orders_.size());
+        orders_.emplace_back();
+    }
+    orders_[order].id = order_id;
+    orders_[order].volume = volume;
+    link_back(order, find_or_add_level(bid, price));
+    insert_slot(order_id, order);
+    live_orders_++;
+    stats_.adds++;
+    return true;
+}
+
+bool L3Book::modify(uint64_t order_id, double price, double volume) {
+    if (volume <= 0.0) {
+        return remove(order_id);
+    }
+    const size_t slot = slot_for(order_id);
+    if (slots_[slot].order == kNone) {
+        stats_.unknown++;
+        return false;
+    }
+    const uint32_t order = slots_[slot].order;
+    Order& o = orders_[order];
+    Level& lv = levels_[o.level];
+    if (price == lv.price && volume <= o.volume) {
+        lv.volume += volume - o.volume;
+        o.volume = volume;
+    } else {
+        const bool bid = lv.bid;
+        unlink(order);
+        orders_[order].volume = volume;
+        link_back(order, find_or_add_level(bid, price));
+    }
+    stats_.modifies++;
+    return true;
+}
+
+bool L3Book::remove(uint64_t order_id) {
+    const size_t slot = slot_for(order_id);
+    if (slots_[slot].order == kNone) {
+        stats_.unknown++;
+        return false;
+    }
+    const uint32_t order = slots_[slot].order;
+    const Order& o = orders_[order];
+    if (large_cancel_volume_ > 0.0 && o.volume >= large_cancel_volume_) {
+        const Level& lv = levels_[o.level];
+        const std::vector<LevelRef>& side = lv.bid ? bids_ : asks_;
+        large_cancels_.push_back(LargeCancel{order_id, lv.bid, lv.price, o.volume,
+                                             !side.empty() && side.back().level == o.level});
+        if (large_cancels_.size() > kMaxPendingCancels) {
+            large_cancels_.pop_front();
+        }
+        stats_.large_cancels++;
+    }
+    unlink(order);
+    erase_slot(slot);
+    free_order(order);
+    live_orders_--;
+    stats_.deletes++;
+    return true;
+}
+
+void L3Book::clear() {
+    std::fill(slots_.begin(), slots_.end(), Slot{0, kNone});
+    orders_.clear();
+    free_order_ = kNone;
+    levels_.clear();
+    free_level_ = kNone;
+    bids_.clear();
+    asks_.clear();
+    live_orders_ = 0;
+    large_cancels_.clear();
+}
+
+QueuePosition L3Book::queue_position(uint64_t order_id) const {
+    QueuePosition q;
+    const uint32_t order = slots_[slot_for(order_id)].order;
+    if (order == kNone) {
+        return q;
+    }
+    const Level& lv = levels_[orders_[order].level];
+    q.found = true;
+    q.level_volume = lv.volume;
+    for (uint32_t i = lv.head; i != order; i = orders_[i].next) {
+        q.volume_ahead += orders_[i].volume;
+        q.orders_ahead++;
+    }
+    return q;
+}
+
+double L3Book::level_volume(bool bid, double price) const {
+    const std::vector<LevelRef>& side = bid ? bids_ : asks_;
+    auto it = std::lower_bound(side.begin(), side.end(), price, [bid](const LevelRef& ref, double p) {
+        return bid ? ref.price < p : ref.price > p;
+    });
+    return it != side.end() && it->price == price ? levels_[it->level].volume : 0.0;
+}
+
+double L3Book::best_bid() const {
+    return bids_.empty() ? 0.0 : bids_.back().price;
+}
+
+double L3Book::best_ask() const {
+    return asks_.empty() ? 0.0 : asks_.back().price;
+}
+
+std::vector<LargeCancel> L3Book::take_large_cancels() {
+    std::vector<LargeCancel> out(large_cancels_.begin(), large_cancels_.end());
+    large_cancels_.clear();
+    return out;
+}
@@ -0,0 +1,140 @@
+#ifndef L3_BOOK_HPP
+#define L3_BOOK_HPP
+
+#include <string_view>
+#include <vector>
+#include <deque>
+#include <cstddef>
+#include <cstdint>
+
+// Where an order sits in its level's FIFO
+struct QueuePosition {
+    bool found = false;
+    double volume_ahead = 0.0;    // Resting before it at the same price
+    uint32_t orders_ahead = 0;
+    double level_volume = 0.0;    // Whole level, including the order
+};
+
+// A resting order of at least the large-cancel volume left the book. A
+// delete does not say why: away from the touch it was cancelled; at the
+// touch it may also have been filled.
+struct LargeCancel {
+    uint64_t order_id = 0;
+    bool bid = true;
+    double price = 0.0;
+    double volume = 0.0;
+    bool at_touch = false;        // Level was the best on its side
+};
+
+struct L3Stats {
+    uint64_t adds = 0;
+    uint64_t modifies = 0;
+    uint64_t deletes = 0;
+    uint64_t unknown = 0;         // Modify/delete for an id not in the book,
+                                  // or an add for one already in it
+    uint64_t large_cancels = 0;
+};
+
+// Order-by-order book for one pair. Orders are found by id through an
+// open-addressing hash (linear probing, backward-shift deletion). Each
+// price level keeps its orders in arrival order as an intrusive doubly
+// linked list threaded through a pooled order array. Add, modify and delete
+// are O(1) apart from the first order at a new price, which inserts the
+// level into a per-side array kept worst to best, so levels near the touch
+// shift few entries. Queue position walks the level from its head.
+class L3Book {
+public:
+    explicit L3Book(double large_cancel_volume = 0.0, size_t expected_orders = 1024);
+
+    // Exchange order ids are strings; this folds one to the 64-bit key the
+    // book uses
+    static uint64_t key_of(std::string_view order_id);
+
+    // False if the id is already resting (counted as unknown)
+    bool add(uint64_t order_id, bool bid, double price, double volume);
+
+    // A smaller volume at the same price keeps the order's place; a price
+    // change or a larger volume sends it to the back of its (new) level.
+    // Volume 0 deletes. False if the id is not resting.
+    bool modify(uint64_t order_id, double price, double volume);
+
+    // False if the id is not resting
+    bool remove(uint64_t order_id);
+
+    void clear();
+
+    QueuePosition queue_position(uint64_t order_id) const;
+
+    // What a new order joining the back of this level would have ahead
+    double level_volume(bool bid, double price) const;
+
+    // 0 when the side is empty
+    double best_bid() const;
+    double best_ask() const;
+    size_t order_count() const { return live_orders_; }
+    size_t level_count(bool bid) const { return bid ? bids_.size() : asks_.size(); }
+
+    // Large cancels since the last call, oldest first (the newest 256 at most)
+    std::vector<LargeCancel> take_large_cancels();
+
+    const L3Stats& stats() const { return stats_; }
+
+private:
+    static constexpr uint32_t kNone = UINT32_MAX;
+
+    struct Order {
+        uint64_t id = 0;
+        double volume = 0.0;
+        uint32_t level = kNone;
+        uint32_t prev = kNone;
+        uint32_t next = kNone;     // Also links the free list
+    };
+
+    struct Level {
+        double price = 0.0;
+        double volume = 0.0;
+        uint32_t orders = 0;
+        uint32_t head = kNone;
+        uint32_t tail = kNone;
+        uint32_t next_free = kNone;
+        bool bid = true;
+    };
+
+    struct LevelRef {
+        double price;
+        uint32_t level;
+    };
+
+    struct Slot {
+        uint64_t id;
+        uint32_t order;            // kNone when empty
+    };
+
+    // Hash table
+    size_t slot_for(uint64_t id) const;
+    void insert_slot(uint64_t id, uint32_t order);
+    void erase_slot(size_t slot);
+    void grow();
+
+    uint32_t find_or_add_level(bool bid, double price);
+    void release_level(uint32_t level);
+    void link_back(uint32_t order, uint32_t level);
+    void unlink(uint32_t order);
+    void free_order(uint32_t order);
+
+    std::vector<Slot> slots_;
+    size_t mask_ = 0;
+    std::vector<Order> orders_;
+    uint32_t free_order_ = kNone;
+    std::vector<Level> levels_;
+    uint32_t free_level_ = kNone;
+    std::vector<LevelRef> bids_;       // Worst (lowest) to best
+    std::vector<LevelRef> asks_;       // Worst (highest) to best
+    size_t live_orders_ = 0;
+
+    double large_cancel_volume_;
+    std::deque<LargeCancel> large_cancels_;
+    L3Stats stats_;
+};
+
+#endif // L3_BOOK_HPP
@@ -0,0 +1,58 @@
+#include "leader_lease.hpp"
+#include "logger.hpp"
+#include "util.hpp"
+#include <sys/file.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <fstream>
+#include <cstring>
+#include <cerrno>
+
+LeaderLease::LeaderLease(const std::string& path)
+    : path_(path) {
+}
+
+LeaderLease::~LeaderLease() {
+    if (fd_ >= 0) {
+        // Closing the descriptor releases the lock
+        close(fd_);
+    }
+}
+
+bool LeaderLease::try_acquire() {
+    if (held_) {
+        return true;
+    }
+
+    if (fd_ < 0) {
+        fd_ = open(path_.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd_ < 0) {
+            LOG_ERROR("Failed to open lease file " + path_ + ": " + std::string(std::strerror(errno)));
+            return false;
+        }
+    }
+
+    if (flock(fd_, LOCK_EX | LOCK_NB) != 0) {
+        if (errno != EWOULDBLOCK) {
+            LOG_ERROR("flock(" + path_ + ") failed: " + std::string(std::strerror(errno)));
+        }
+        return false;
+    }
+    held_ = true;
+
+    // Record who holds the lease for operators and the standby's logs
+    char host[256] = {};
+    gethostname(host, sizeof(host) - 1);
+    std::string owner = std::to_string(getpid()) + "@" + host + " since " + util::now_iso8601() + "\n";
+    if (ftruncate(fd_, 0) != 0 || pwrite(fd_, owner.data(), owner.size(), 0) < 0) {
+        LOG_WARNING("Failed to record lease owner in " + path_);
+    }
+    return true;
+}
+
+std::string LeaderLease::holder() const {
+    std::ifstream file(path_);
+    std::string line;
+    std::getline(file, line);
+    return line.empty() ? "unknown" : line;
+}
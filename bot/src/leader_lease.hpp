@@ -0,0 +1,31 @@
+#ifndef LEADER_LEASE_HPP
+#define LEADER_LEASE_HPP
+
+#include <string>
+
+// Leadership as an exclusive flock() on a lease file. The kernel drops the
+// lock the moment the holder exits or crashes, so a standby polling
+// try_acquire() takes over within one poll interval. On a LAN the file must
+// live on a filesystem with working advisory locks (e.g. NFSv4).
+class LeaderLease {
+public:
+    explicit LeaderLease(const std::string& path);
+    ~LeaderLease();
+
+    LeaderLease(const LeaderLease&) = delete;
+    LeaderLease& operator=(const LeaderLease&) = delete;
+
+    // Non-blocking; true once this process holds the lease
+    bool try_acquire();
+    bool held() const { return held_; }
+
+    // "pid@host since <time>" as written by the current holder
+    std::string holder() const;
+
+private:
+    std::string path_;
+    int fd_ = -1;
+    bool held_ = false;
+};
+
+#endif // LEADER_LEASE_HPP
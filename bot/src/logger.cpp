@@ -1,5 +1,6 @@
 #include "logger.hpp"
 #include "util.hpp"
+#include "tick_arena.hpp"
 #include <iostream>
 #include <filesystem>
 #include <iomanip>
@@ -46,6 +47,11 @@ void Logger::set_level(Level level) {
     min_level_ = level;
 }
 
+void Logger::set_console(bool enabled) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    console_ = enabled;
+}
+
 std::string Logger::level_to_string(Level level) const {
     switch (level) {
         case Level::DEBUG:   return "DEBUG";
@@ -56,7 +62,7 @@ std::string Logger::level_to_string(Level level) const {
     }
 }
 
-void Logger::write(Level level, const std::string& msg) {
+void Logger::write(Level level, std::string_view msg) {
     std::lock_guard<std::mutex> lock(mutex_);
     
     if (level < min_level_) {
@@ -66,15 +72,18 @@ void Logger::write(Level level, const std::string& msg) {
     std::string timestamp = util::now_iso8601();
     std::string level_str = level_to_string(level);
     
-    std::ostringstream oss;
+    // On the trading loop the line is formatted in the tick arena
+    ArenaOStream oss(std::ios_base::out, tick_resource());
     oss << "[" << timestamp << "] [" << std::setw(7) << level_str << "] " << msg;
-    std::string formatted = oss.str();
+    std::string_view formatted = oss.view();
     
     // Write to console
-    if (level == Level::ERROR) {
-        std::cerr << formatted << std::endl;
-    } else {
-        std::cout << formatted << std::endl;
+    if (console_) {
+        if (level == Level::ERROR) {
+            std::cerr << formatted << std::endl;
+        } else {
+            std::cout << formatted << std::endl;
+        }
     }
     
     // Write to file
@@ -84,23 +93,23 @@ void Logger::write(Level level, const std::string& msg) {
     }
 }
 
-void Logger::debug(const std::string& msg) {
+void Logger::debug(std::string_view msg) {
     write(Level::DEBUG, msg);
 }
 
-void Logger::info(const std::string& msg) {
+void Logger::info(std::string_view msg) {
     write(Level::INFO, msg);
 }
 
-void Logger::warning(const std::string& msg) {
+void Logger::warning(std::string_view msg) {
     write(Level::WARNING, msg);
 }
 
-void Logger::error(const std::string& msg) {
+void Logger::error(std::string_view msg) {
     write(Level::ERROR, msg);
 }
 
-void Logger::log(Level level, const std::string& msg) {
+void Logger::log(Level level, std::string_view msg) {
     write(level, msg);
 }
 
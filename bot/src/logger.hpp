@@ -2,6 +2,7 @@
 #define LOGGER_HPP
 
 #include <string>
+#include <string_view>
 #include <fstream>
 #include <mutex>
 #include <memory>
@@ -20,12 +21,15 @@ public:
     void init(const std::string& log_dir = "logs", const std::string& log_filename = "bot.log");
     void set_level(Level level);
     
-    void debug(const std::string& msg);
-    void info(const std::string& msg);
-    void warning(const std::string& msg);
-    void error(const std::string& msg);
+    // Benchmarks keep the file output but silence the console
+    void set_console(bool enabled);
     
-    void log(Level level, const std::string& msg);
+    void debug(std::string_view msg);
+    void info(std::string_view msg);
+    void warning(std::string_view msg);
+    void error(std::string_view msg);
+    
+    void log(Level level, std::string_view msg);
 
 private:
     Logger() = default;
@@ -34,7 +38,7 @@ private:
     Logger(const Logger&) = delete;
     Logger& operator=(const Logger&) = delete;
     
-    void write(Level level, const std::string& msg);
+    void write(Level level, std::string_view msg);
     std::string level_to_string(Level level) const;
     void ensure_log_dir(const std::string& log_dir);
 
@@ -42,6 +46,7 @@ private:
     std::mutex mutex_;
     Level min_level_ = Level::INFO;
     bool initialized_ = false;
+    bool console_ = true;
 };
 
 // Convenience macros
@@ -2,7 +2,21 @@
 #include "state.hpp"
 #include "logger.hpp"
 #include "kraken_client.hpp"
+#include "fault_injection.hpp"
+#include "http_recording.hpp"
 #include "strategy.hpp"
+#include "scanner.hpp"
+#include "paper_exchange.hpp"
+#include "trade_tape.hpp"
+#include "market_data.hpp"
+#include "market_bus.hpp"
+#include "leader_lease.hpp"
+#include "state_journal.hpp"
+#include "tick_store.hpp"
+#include "tick_archive.hpp"
+#include "indicator_kernels.hpp"
+#include "startup.hpp"
+#include "tick_arena.hpp"
 #include "util.hpp"
 
 #include <iostream>
@@ -12,6 +26,9 @@
 #include <atomic>
 #include <filesystem>
 #include <fstream>
+#include <memory>
+#include <optional>
+#include <algorithm>
 #include <nlohmann/json.hpp>
 
 // Global flag for graceful shutdown
@@ -30,14 +47,14 @@ bool check_kill_switch(const std::string& kill_switch_file) {
     return false;
 }
 
-void reconcile_live_state(TradingState& state, KrakenClient& client, double current_price, const Config& config) {
+bool reconcile_live_state(TradingState& state, const BalanceResult& balance, double current_price,
+                          const Config& config) {
     LOG_INFO("Reconciling state with live Kraken balances...");
     
-    BalanceResult balance = client.get_balance();
     if (!balance.success) {
         LOG_ERROR("Failed to fetch balances for reconciliation: " + balance.error);
         LOG_WARNING("Proceeding with persisted state - manual verification recommended");
-        return;
+        return false;
     }
     
     const double btc_threshold = 0.000001;  // Minimum BTC to consider as "holding"
@@ -74,14 +91,28 @@ void reconcile_live_state(TradingState& state, KrakenClient& client, double curr
     }
     
     state.save(config.state_file);
+    return true;
+}
+
+// Smallest Kraken OHLC interval (minutes) at least as long as the poll
+// interval, so backfilled closes are spaced no closer than live samples
+static int backfill_interval_minutes(int64_t poll_interval_seconds) {
+    for (int minutes : {1, 5, 15, 30, 60, 240, 1440}) {
+        if (minutes * 60 >= poll_interval_seconds) {
+            return minutes;
+        }
+    }
+    return 1440;
 }
 
 void log_status(const TradingState& state, const TradeContext& ctx, const Config& config) {
-    std::ostringstream oss;
+    ArenaOStream oss(std::ios_base::out, tick_resource());
     oss << std::fixed << std::setprecision(2);
     
     oss << "Status | "
-        << "price=" << ctx.current_price
+        << "pair=" << ctx.pair
+        << " | price=" << ctx.current_price
+        << " | age=" << ctx.price_age_ms << "ms"
         << " | mode=" << mode_to_string(state.mode)
         << " | entry=" << (state.entry_price.has_value() ? std::to_string(state.entry_price.value()) : "null")
         << " | exit=" << (state.exit_price.has_value() ? std::to_string(state.exit_price.value()) : "null")
@@ -95,18 +126,34 @@ void log_status(const TradingState& state, const TradeContext& ctx, const Config
         << " | risk_pct=" << (config.risk_per_trade_pct * 100) << "%"
         << " | risk_cad=" << ctx.sizing.risk_cad
         << " | pos_cad=" << ctx.sizing.position_cad
-        << " | max_pos=" << ctx.sizing.max_position_cad
-        << " | decision=" << decision_to_string(ctx.decision)
+        << " | max_pos=" << ctx.sizing.max_position_cad;
+    if (ctx.book_valid) {
+        oss << " | imb=" << ctx.book_imbalance << " | micro=" << ctx.microprice;
+    }
+    if (ctx.vwap > 0.0) {
+        oss << " | vwap=" << ctx.vwap << " | buy_vol=" << std::setprecision(4) << ctx.tape_buy_volume
+            << " | sell_vol=" << ctx.tape_sell_volume << std::setprecision(2);
+    }
+    if (ctx.flow_valid) {
+        oss << " | vpin=" << std::setprecision(3) << ctx.vpin << " | ofi=" << ctx.flow_imbalance
+            << std::setprecision(2);
+    }
+    oss << " | decision=" << decision_to_string(ctx.decision)
         << " | reason=" << ctx.decision_reason;
     
-    LOG_INFO(oss.str());
+    LOG_INFO(oss.view());
 }
 
-void write_ui_status(const TradingState& state, const TradeContext& ctx, const Config& config) {
+void write_ui_status(const TradingState& state, const TradeContext& ctx, const Config& config,
+                     const Scanner* scanner, const KrakenClient& client,
+                     MarketDataBus& bus, MarketDataBus::ConsumerId ui_consumer,
+                     const StartupReport& startup, const TickArena* arena, const TradeTape* tape) {
     namespace fs = std::filesystem;
     fs::create_directories(config.ui_dir);
 
-    nlohmann::json j;
+    // Rebuilt every tick, so the tree lives in the tick arena
+    TickJson j;
+    j["pair"] = ctx.pair;
     j["price"] = ctx.current_price;
     j["mode"] = mode_to_string(state.mode);
     j["entry_price"] = state.entry_price.has_value() ? state.entry_price.value() : 0.0;
@@ -125,9 +172,107 @@ void write_ui_status(const TradingState& state, const TradeContext& ctx, const C
     j["atr"] = ctx.atr;
     j["sma_short"] = ctx.sma_short;
     j["sma_long"] = ctx.sma_long;
+    if (tape != nullptr) {
+        const TapeStats& t = tape->stats();
+        j["tape"] = {
+            {"vwap", ctx.vwap}, {"volume", ctx.tape_volume}, {"buy_volume", ctx.tape_buy_volume},
+            {"sell_volume", ctx.tape_sell_volume}, {"prints", t.prints}, {"duplicates", t.duplicates},
+            {"late", t.late}, {"pages", t.pages}, {"failures", t.failures}, {"bars", t.bars},
+            {"tick_ruled", t.tick_ruled}
+        };
+        if (const FlowToxicity* flow = tape->flow()) {
+            FlowSignals f = flow->signals();
+            j["flow"] = {
+                {"valid", f.valid}, {"vpin", f.vpin}, {"imbalance", f.imbalance}, {"buckets", f.buckets},
+                {"bucket_fill", f.bucket_fill}, {"buckets_closed", f.buckets_closed}
+            };
+        }
+    }
+    if (ctx.book_valid) {
+        j["book"] = {
+            {"imbalance", ctx.book_imbalance}, {"microprice", ctx.microprice}, {"weighted_mid", ctx.weighted_mid},
+            {"bid_slope", ctx.bid_slope}, {"ask_slope", ctx.ask_slope}
+        };
+    }
+    j["price_age_ms"] = ctx.price_age_ms;
+    j["clock_offset_ms"] = static_cast<double>(client.clock().offset_ns()) / 1e6;
+    j["clock_rtt_ms"] = static_cast<double>(client.clock().rtt_ns()) / 1e6;
+
+    // Breaker state and retry/hedge counters per endpoint class
+    TickJson endpoints = TickJson::array();
+    for (const EndpointMetrics& m : client.endpoint_metrics()) {
+        endpoints.push_back({
+            {"class", m.name}, {"state", breaker_state_to_string(m.state)},
+            {"requests", m.requests}, {"failures", m.failures}, {"retries", m.retries},
+            {"hedges", m.hedges}, {"hedge_wins", m.hedge_wins}, {"short_circuited", m.short_circuited},
+            {"trips", m.trips}, {"latency_p50_ms", m.latency_p50_ms}, {"latency_p99_ms", m.latency_p99_ms}
+        });
+    }
+    j["endpoints"] = endpoints;
+    
+    HttpTransportStats http = client.transport_stats();
+    j["http"] = {
+        {"http2", http.http2}, {"requests", http.requests}, {"h2_streams", http.h2_streams},
+        {"h1_requests", http.h1_requests}, {"connections", http.connections}, {"timeouts", http.timeouts},
+        {"cancelled", http.cancelled}, {"errors", http.errors}, {"active_streams", http.active},
+        {"peak_streams", http.peak_active}, {"cold_requests", http.cold_requests},
+        {"warm_requests", http.warm_requests}, {"cold_p50_ms", http.cold_p50_ms}, {"cold_p99_ms", http.cold_p99_ms},
+        {"warm_p50_ms", http.warm_p50_ms}, {"warm_p99_ms", http.warm_p99_ms}, {"cold_dns_ms", http.cold_dns_ms},
+        {"cold_connect_ms", http.cold_connect_ms}, {"cold_tls_ms", http.cold_tls_ms},
+        {"pinned_hosts", http.pinned_hosts}
+    };
+
+    TickJson steps = TickJson::array();
+    for (const StartupStepReport& step : startup.steps) {
+        steps.push_back({{"name", step.name}, {"ok", step.ok}, {"start_ms", step.start_ms}, {"end_ms", step.end_ms}});
+    }
+    j["startup"] = {
+        {"total_ms", startup.total_ms}, {"first_decision_ms", startup.first_decision_ms}, {"steps", steps}
+    };
+
+    // Usage of the previous tick; the current one is still being built
+    if (arena != nullptr) {
+        const TickArenaStats& a = arena->stats();
+        j["arena"] = {
+            {"capacity_bytes", a.capacity}, {"ticks", a.ticks}, {"last_tick_bytes", a.last_tick_bytes},
+            {"last_tick_allocations", a.last_tick_allocations}, {"high_water_bytes", a.high_water_bytes},
+            {"overflow_ticks", a.overflow_ticks}
+        };
+    }
+
+    // Latest bar per pair since the previous write; bursts are conflated by the bus
+    TickJson markets = TickJson::object();
+    for (const ConflatedUpdate& u : bus.poll(ui_consumer)) {
+        markets[u.latest.pair] = {
+            {"open", u.open}, {"high", u.high}, {"low", u.low}, {"close", u.close},
+            {"volume", u.volume}, {"updates", u.updates}
+        };
+    }
+    j["markets"] = markets;
+
+    TickJson bus_stats = TickJson::array();
+    for (const BusConsumerStats& c : bus.stats()) {
+        bus_stats.push_back({{"consumer", c.name}, {"delivered", c.delivered}, {"conflated", c.conflated}});
+    }
+    j["bus"] = bus_stats;
+
+    if (scanner != nullptr) {
+        TickJson candidates = TickJson::array();
+        const auto& ranking = scanner->ranking();
+        size_t limit = std::min(ranking.size(), static_cast<size_t>(config.scanner_top_n));
+        for (size_t k = 0; k < limit; k++) {
+            candidates.push_back({
+                {"pair", ranking[k].pair},
+                {"score", ranking[k].score},
+                {"eligible", ranking[k].eligible},
+                {"reason", ranking[k].reason}
+            });
+        }
+        j["scanner"] = candidates;
+    }
 
     std::ofstream status_file(config.ui_dir + "/status.json");
-    status_file << j.dump(2) << std::endl;
+    status_file << std::setw(2) << j << std::endl;
 
     fs::path index_path = fs::path(config.ui_dir) / "index.html";
     if (!fs::exists(index_path)) {
@@ -153,6 +298,7 @@ void write_ui_status(const TradingState& state, const TradeContext& ctx, const C
                       "      const res = await fetch('status.json?_=' + Date.now());\n"
                       "      const s = await res.json();\n"
                       "      document.getElementById('card').innerHTML = `\n"
+                      "        <div class=\"row\"><span class=\"label\">Pair:</span> ${s.pair}</div>\n"
                       "        <div class=\"row\"><span class=\"label\">Price:</span> ${s.price}</div>\n"
                       "        <div class=\"row\"><span class=\"label\">Mode:</span> ${s.mode}</div>\n"
                       "        <div class=\"row\"><span class=\"label\">Entry:</span> ${s.entry_price}</div>\n"
@@ -167,6 +313,7 @@ void write_ui_status(const TradingState& state, const TradeContext& ctx, const C
                       "        <div class=\"row\"><span class=\"label\">Spread %:</span> ${(s.spread_pct * 100).toFixed(4)}</div>\n"
                       "        <div class=\"row\"><span class=\"label\">ATR:</span> ${s.atr}</div>\n"
                       "        <div class=\"row\"><span class=\"label\">SMA Short/Long:</span> ${s.sma_short} / ${s.sma_long}</div>\n"
+                      "        <div class=\"row\"><span class=\"label\">Top Candidates:</span> ${(s.scanner || []).map(c => c.pair).join(', ')}</div>\n"
                       "      `;\n"
                       "    }\n"
                       "    loadStatus();\n"
@@ -178,6 +325,9 @@ void write_ui_status(const TradingState& state, const TradeContext& ctx, const C
 }
 
 int main(int argc, char* argv[]) {
+    // Time to first decision is measured from here
+    const auto process_start = std::chrono::steady_clock::now();
+    
     // Set up signal handlers
     std::signal(SIGINT, signal_handler);
     std::signal(SIGTERM, signal_handler);
@@ -212,6 +362,12 @@ int main(int argc, char* argv[]) {
     
     config.log_config();
     
+    if (!kernels::set_isa(config.indicator_isa)) {
+        LOG_WARNING("indicator_isa " + config.indicator_isa + " is not supported by this CPU, using " +
+                    kernels::isa_name(kernels::active_isa()));
+    }
+    LOG_INFO("Indicator kernels: " + kernels::isa_name(kernels::active_isa()));
+    
     // Log mode
     if (config.dry_run) {
         LOG_INFO("*** RUNNING IN DRY-RUN MODE - NO REAL ORDERS WILL BE PLACED ***");
@@ -227,15 +383,47 @@ int main(int argc, char* argv[]) {
     
     // Initialize Kraken client
     KrakenClient client(config.kraken_api_base, config.rate_limit_min_delay_ms);
+    client.set_endpoint_policy(config.endpoint_policy());
+    client.set_request_timeout_ms(config.http_timeout_ms);
     
-    if (!config.dry_run) {
-        if (!client.init()) {
-            LOG_ERROR("Failed to initialize Kraken client - API credentials required for live mode");
-            return 1;
+    // Transport stack: curl or a recorded session, optionally under the
+    // fault schedule, optionally recorded
+    try {
+        std::unique_ptr<HttpTransport> transport;
+        if (!config.http_replay_file.empty()) {
+            transport = ReplayTransport::load(config.http_replay_file, config.http_replay_speed);
+        } else {
+            transport = std::make_unique<CurlTransport>(config.curl_options());
         }
-    } else {
-        // In dry-run mode, credentials are optional (only public endpoints used)
-        client.init();  // Will warn if not set, but won't fail
+        // Soak testing: perturb every request according to a seeded schedule
+        if (!config.fault_schedule_file.empty()) {
+            transport = std::make_unique<FaultInjectingTransport>(
+                std::move(transport), FaultSchedule::load(config.fault_schedule_file));
+        }
+        if (!config.http_record_file.empty()) {
+            transport = std::make_unique<RecordingTransport>(std::move(transport), config.http_record_file);
+        }
+        client.set_transport(std::move(transport));
+    } catch (const std::exception& e) {
+        LOG_ERROR(std::string("Failed to set up HTTP transport: ") + e.what());
+        return 1;
+    }
+    
+    // In dry-run mode, credentials are optional (only public endpoints used);
+    // init() warns if they are not set
+    const bool have_credentials = client.init();
+    if (!config.dry_run && !have_credentials) {
+        LOG_ERROR("Failed to initialize Kraken client - API credentials required for live mode");
+        return 1;
+    }
+    
+    // Startup requests go out together within the burst
+    client.set_rate_limit_burst(config.rate_limit_burst);
+    
+    // Resolve the API host now so no startup request waits on DNS; the
+    // connection opens with the first of them
+    if (config.http_prewarm) {
+        client.pin_host();
     }
     
     // Load or initialize state
@@ -243,8 +431,302 @@ int main(int argc, char* argv[]) {
     state.check_date_rollover();
     state.log_state();
     
+    // Shared market data: one batched Ticker request per tick for every pair in use
+    MarketDataCache market_data(client);
+    market_data.track(config.pair);
+    market_data.track(state.pair);
+    if (config.book_signals_enabled) {
+        market_data.track_book(config.pair, config.book_depth, config.book_signal_levels);
+    }
+    if (config.market_data_source == "shm") {
+        // Quotes come from market_gateway; a silent gateway ages out like a failed poll
+        if (!market_data.attach_ring(config.shm_name, config.stale_price_seconds * 1000)) {
+            LOG_ERROR("Failed to attach to market data ring " + config.shm_name);
+            return 1;
+        }
+    }
+    
+    // Record quotes for backtests
+    std::unique_ptr<TickRecorder> recorder;
+    if (!config.tick_store_dir.empty()) {
+        recorder = std::make_unique<TickRecorder>(config.tick_store_dir, config.tick_segment_seconds);
+    }
+    std::unique_ptr<TickCompactor> compactor;
+    if (config.tick_compact_enabled) {
+        compactor = std::make_unique<TickCompactor>(config.tick_store_dir);
+        compactor->start(config.tick_compact_interval_seconds);
+    }
+    
+    // Conflating fan-out of market updates to non-strategy consumers
+    MarketDataBus bus;
+    MarketDataBus::ConsumerId ui_consumer = bus.subscribe("ui");
+    std::unique_ptr<BusBarLogger> bar_logger;
+    if (config.bus_log_interval_seconds > 0) {
+        bar_logger = std::make_unique<BusBarLogger>(bus, "log");
+        bar_logger->start(config.bus_log_interval_seconds);
+    }
+    
     // Create strategy
-    Strategy strategy(config, state, client);
+    Strategy strategy(config, state, client, market_data);
+    
+    // Multi-pair scanner; its pairs are discovered during startup
+    std::unique_ptr<Scanner> scanner;
+    if (config.scanner_enabled) {
+        scanner = std::make_unique<Scanner>(config, client);
+    }
+    
+    // Failover: the lease holder trades; anyone else becomes a hot standby
+    std::unique_ptr<LeaderLease> lease;
+    std::unique_ptr<StateJournal> journal;
+    bool standby = false;
+    if (config.failover_enabled) {
+        lease = std::make_unique<LeaderLease>(config.failover_lease_file);
+        journal = std::make_unique<StateJournal>(config.state_journal_file);
+        standby = !lease->try_acquire();
+        if (standby) {
+            LOG_INFO("Standing by: lease " + config.failover_lease_file + " held by " + lease->holder());
+        } else {
+            LOG_INFO("Lease acquired: " + config.failover_lease_file);
+        }
+    }
+    
+    // Apply the newest journal record, so reconciliation checks the
+    // leader's last state rather than state.json
+    JournalRecord record;
+    bool have_record = false;
+    bool indicators_restored = false;
+    auto resume_from_journal = [&] {
+        if (!have_record) {
+            return;
+        }
+        int64_t age_ms = (util::now_epoch_ns() - record.written_ns) / 1'000'000;
+        state = record.state;
+        state.check_date_rollover();
+        market_data.track(state.pair);
+        // Old windows would mix stale prices into the indicators
+        if (age_ms <= config.stale_price_seconds * 1000) {
+            strategy.restore_indicators(record.indicators);
+            indicators_restored = true;
+        }
+        state.save(config.state_file);
+        LOG_INFO("Resumed from journal seq " + std::to_string(record.seq) + " (" +
+                 std::to_string(age_ms) + "ms old, " +
+                 std::to_string(record.indicators.prices.size()) + " prices)");
+        state.log_state();
+    };
+    
+    // Startup fetches run as a dependency graph so independent requests
+    // overlap. Private calls stay in one chain: Kraken rejects a nonce that
+    // arrives after a larger one. A standby runs the public steps before it
+    // waits for the lease and the private ones after taking it.
+    StartupGraph startup;
+    BalanceResult balance;
+    FeeTierResult fee_tier;
+    std::string position_pair;
+    std::string backfilled_pair;
+    const int backfill_interval = backfill_interval_minutes(
+        config.indicator_source == "tape" ? config.tape_bar_seconds : config.poll_interval_seconds);
+    auto update_position_pair = [&] {
+        position_pair = state.mode == TradingMode::LONG && !state.pair.empty() ? state.pair : config.pair;
+    };
+    
+    // Every print for pair from here on, as volume bars
+    std::unique_ptr<FlowToxicity> flow;
+    std::unique_ptr<TradeTape> tape;
+    if (config.tape_enabled) {
+        // Indicators never look further back than their longest window, so
+        // bars beyond it that wait undrained (standby, early-return ticks)
+        // can go
+        tape = std::make_unique<TradeTape>(config.pair, config.tape_bar_seconds, config.tape_vwap_bars,
+                                           std::max(config.trend_window_long, config.atr_window) + 1);
+        if (config.vpin_enabled) {
+            flow = std::make_unique<FlowToxicity>(config.vpin_bucket_volume, config.vpin_buckets);
+            tape->attach_flow(flow.get());
+        }
+        tape->attach_bus(&bus);
+        strategy.attach_trade_tape(tape.get());
+    }
+    
+    // Closed bars fill the SMA/ATR windows, so the first decision does not
+    // wait trend_window_long polls (or tape bars) for them
+    auto add_backfill = [&](StartupGraph& graph) {
+        graph.add("backfill", {}, [&] {
+            OhlcResult ohlc = client.get_ohlc(position_pair, backfill_interval);
+            if (!ohlc.success) {
+                LOG_WARNING("Indicator backfill failed, warming up from live ticks: " + ohlc.error);
+                return false;
+            }
+            std::vector<double> closes;
+            closes.reserve(ohlc.bars.size());
+            for (const OhlcBar& bar : ohlc.bars) {
+                closes.push_back(bar.close);
+            }
+            strategy.backfill_indicators(closes);
+            backfilled_pair = position_pair;
+            LOG_INFO("Backfilled indicators from " + std::to_string(closes.size()) + " " +
+                     std::to_string(backfill_interval) + "m bars of " + position_pair);
+            return true;
+        });
+    };
+    
+    auto add_public_steps = [&](StartupGraph& graph) {
+        // Estimate the offset to Kraken's clock so quote ages are measured on the exchange clock
+        graph.add("clock", {}, [&] {
+            if (!client.sync_clock(3)) {
+                LOG_WARNING("Clock sync failed, quote ages fall back to the local clock");
+                return false;
+            }
+            return true;
+        });
+        
+        // The first tick's quotes
+        graph.add("ticker", {}, [&] {
+            return market_data.refresh();
+        });
+        
+        if (scanner) {
+            graph.add("pairs", {}, [&] {
+                return scanner->discover();
+            });
+        }
+        
+        // The startup poll only positions the tape's since cursor
+        if (tape) {
+            graph.add("tape", {}, [&] {
+                return tape->poll(client, 1, client.clock().to_exchange_ns(util::now_epoch_ns()));
+            });
+        }
+        
+        if (config.startup_backfill && !indicators_restored) {
+            add_backfill(graph);
+        }
+    };
+    
+    // quote_step names the step that fetched the quote reconciliation uses,
+    // or is empty when it is already in the cache
+    auto add_private_steps = [&](StartupGraph& graph, const std::string& quote_step) {
+        // Live mode: reconcile state with actual balances, using the startup
+        // quote for a missing entry price
+        if (!config.dry_run) {
+            graph.add("balance", {}, [&] {
+                balance = client.get_balance();
+                return balance.success;
+            });
+            std::vector<std::string> after{"balance"};
+            if (!quote_step.empty()) {
+                after.insert(after.begin(), quote_step);
+            }
+            graph.add("reconcile", after, [&] {
+                std::shared_ptr<const SnapshotTable> table = market_data.snapshot();
+                const MarketSnapshot* quote = table->find(config.pair);
+                if (quote == nullptr || quote->last_price <= 0) {
+                    LOG_ERROR("Failed to get price for reconciliation");
+                    LOG_WARNING("Proceeding without reconciliation");
+                    return false;
+                }
+                return reconcile_live_state(state, balance, quote->last_price, config);
+            });
+        }
+        
+        if (have_credentials) {
+            graph.add("fees", config.dry_run ? std::vector<std::string>{} : std::vector<std::string>{"balance"}, [&] {
+                fee_tier = client.get_trade_volume(config.pair);
+                return fee_tier.success;
+            });
+        }
+    };
+    
+    StartupReport startup_report;
+    auto last_clock_sync = std::chrono::steady_clock::now();
+    if (!standby) {
+        if (journal) {
+            have_record = journal->tail(record);
+            resume_from_journal();
+        }
+        update_position_pair();
+        add_public_steps(startup);
+        add_private_steps(startup, "ticker");
+        startup_report = startup.run();
+        log_startup_report(startup_report);
+        last_clock_sync = std::chrono::steady_clock::now();
+    } else {
+        update_position_pair();
+        add_public_steps(startup);
+        startup_report = startup.run();
+        log_startup_report(startup_report);
+        last_clock_sync = std::chrono::steady_clock::now();
+        
+        // Hot standby: clock, quotes, pairs, tape and indicators are ready,
+        // so taking over only means applying the newest journal record and
+        // checking the account. Quotes, the tape and the clock estimate keep
+        // updating meanwhile.
+        auto started_waiting = std::chrono::steady_clock::now();
+        auto last_refresh = started_waiting;
+        have_record = journal->tail(record);
+        while (g_running && !lease->try_acquire()) {
+            have_record = journal->tail(record) || have_record;
+            auto now = std::chrono::steady_clock::now();
+            if (now - last_refresh >= std::chrono::seconds(config.poll_interval_seconds)) {
+                last_refresh = now;
+                market_data.refresh();
+                if (tape) {
+                    tape->poll(client, config.tape_max_pages, client.clock().to_exchange_ns(util::now_epoch_ns()));
+                }
+            }
+            if (config.clock_sync_interval_seconds > 0 &&
+                now - last_clock_sync >= std::chrono::seconds(config.clock_sync_interval_seconds)) {
+                client.sync_clock(1);
+                last_clock_sync = now;
+            }
+            // Take over on a warm connection
+            client.keep_warm(config.http_keepalive_seconds);
+            std::this_thread::sleep_for(std::chrono::milliseconds(config.failover_poll_ms));
+        }
+        if (!g_running) {
+            LOG_INFO("Standby stopped before taking over");
+            return 0;
+        }
+        // The old leader may have written one last record before exiting
+        have_record = journal->tail(record) || have_record;
+        LOG_WARNING("Lease acquired, taking over as leader");
+        resume_from_journal();
+        update_position_pair();
+        
+        StartupGraph takeover;
+        // Bars fetched before a long wait, or for a pair the journal moved
+        // the position to, are no use to the indicators
+        if (config.startup_backfill && !indicators_restored &&
+            (position_pair != backfilled_pair ||
+             std::chrono::steady_clock::now() - started_waiting >= std::chrono::minutes(backfill_interval))) {
+            add_backfill(takeover);
+        }
+        add_private_steps(takeover, "");
+        StartupReport takeover_report = takeover.run();
+        log_startup_report(takeover_report);
+        append_startup_report(startup_report, takeover_report);
+    }
+    
+    if (scanner) {
+        if (!startup.ok("pairs")) {
+            LOG_ERROR("Scanner initialization failed");
+            return 1;
+        }
+        market_data.track(scanner->pairs());
+        strategy.attach_scanner(scanner.get());
+    }
+    
+    // Local matching engine for dry-run orders, charging the account's own
+    // fee tier when credentials are available
+    std::unique_ptr<PaperExchange> paper;
+    if (config.paper_engine_enabled) {
+        double maker_fee = fee_tier.success ? fee_tier.maker_fee_pct : config.paper_maker_fee_pct;
+        double taker_fee = fee_tier.success ? fee_tier.taker_fee_pct : config.paper_taker_fee_pct;
+        paper = std::make_unique<PaperExchange>(maker_fee, taker_fee, &client.clock());
+        strategy.attach_paper_exchange(paper.get());
+        LOG_INFO("Paper matching engine enabled: " + config.paper_entry_order + " entries" +
+                 (config.paper_stop_orders ? ", resting stop-loss" : "") +
+                 (fee_tier.success ? ", account fee tier" : ""));
+    }
     
     // Initialize simulation if in dry-run mode
     if (config.dry_run) {
@@ -254,16 +736,17 @@ int main(int argc, char* argv[]) {
         }
         LOG_INFO("Simulation initialized: CAD=" + std::to_string(state.sim_cad_balance) + 
                  ", XBT=" + std::to_string(state.sim_btc_balance));
-    } else {
-        // Live mode: reconcile state with actual balances
-        // First get current price for potential entry_price fallback
-        TickerResult ticker = client.get_ticker(config.pair);
-        if (ticker.success) {
-            reconcile_live_state(state, client, ticker.last_price, config);
-        } else {
-            LOG_ERROR("Failed to get price for reconciliation: " + ticker.error);
-            LOG_WARNING("Proceeding without reconciliation");
-        }
+    }
+    
+    // The scanner's pairs were not part of the startup fetch, and a
+    // standby's quotes are as old as its last refresh
+    bool quotes_prefetched = startup.ok("ticker") && !scanner && !standby;
+    
+    // Transient allocations of each tick come from one buffer that is
+    // rewound when the tick ends
+    std::unique_ptr<TickArena> tick_arena;
+    if (config.tick_arena_bytes > 0) {
+        tick_arena = std::make_unique<TickArena>(static_cast<size_t>(config.tick_arena_bytes));
     }
     
     LOG_INFO("Entering main loop...");
@@ -271,6 +754,12 @@ int main(int argc, char* argv[]) {
     
     // Main trading loop
     while (g_running) {
+        // Declared first so everything below is gone before the arena resets
+        std::optional<TickArena::Scope> tick_scope;
+        if (tick_arena) {
+            tick_scope.emplace(*tick_arena);
+        }
+        
         // Check kill switch
         if (check_kill_switch(config.kill_switch_file)) {
             LOG_INFO("Exiting due to kill switch");
@@ -285,12 +774,66 @@ int main(int argc, char* argv[]) {
             break;
         }
         
+        // Keep the clock estimate fresh
+        if (config.clock_sync_interval_seconds > 0 &&
+            std::chrono::steady_clock::now() - last_clock_sync >=
+                std::chrono::seconds(config.clock_sync_interval_seconds)) {
+            client.sync_clock(1);
+            last_clock_sync = std::chrono::steady_clock::now();
+        }
+        
+        // Refresh every tracked pair in one batch; on failure the previous
+        // quotes are kept and age out through the staleness check
+        if (quotes_prefetched) {
+            quotes_prefetched = false;
+        } else if (!market_data.refresh()) {
+            LOG_WARNING("Market data refresh failed, keeping previous snapshot");
+        }
+        bus.publish(*market_data.snapshot());
+        if (recorder) {
+            recorder->record(*market_data.snapshot());
+        }
+        
+        // Re-rank every scanned pair before the strategy picks one
+        if (scanner) {
+            if (scanner->scan(*market_data.snapshot())) {
+                scanner->log_ranking(config.scanner_top_n);
+            } else {
+                LOG_WARNING("Scanner has no fresh data this tick");
+            }
+        }
+        
+        // Match paper orders against the prints and book since the last tick
+        if (paper) {
+            std::vector<std::string> pairs = paper->active_pairs();
+            std::string pair = state.mode == TradingMode::LONG && !state.pair.empty() ? state.pair : config.pair;
+            if (std::find(pairs.begin(), pairs.end(), pair) == pairs.end()) {
+                pairs.push_back(pair);
+            }
+            paper->poll(client, pairs, config.paper_book_depth);
+        }
+        
+        // Prints since the previous tick; on failure the cursor stays put
+        // and the next tick catches up
+        if (tape && !tape->poll(client, config.tape_max_pages, client.clock().to_exchange_ns(util::now_epoch_ns()))) {
+            LOG_WARNING("Trade tape refresh failed for " + tape->pair());
+        }
+        
         // Evaluate strategy
         TradeContext ctx = strategy.evaluate();
         
+        // First decision made on a fresh quote and complete indicators
+        if (startup_report.first_decision_ms < 0 && ctx.current_price > 0 && !ctx.price_stale &&
+            strategy.indicators_ready()) {
+            startup_report.first_decision_ms = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - process_start).count();
+            LOG_INFO("Time to first decision: " + std::to_string(static_cast<int64_t>(startup_report.first_decision_ms)) +
+                     "ms (startup graph " + std::to_string(static_cast<int64_t>(startup_report.total_ms)) + "ms)");
+        }
+        
         // Log status
         log_status(state, ctx, config);
-        write_ui_status(state, ctx, config);
+        write_ui_status(state, ctx, config, scanner.get(), client, bus, ui_consumer, startup_report, tick_arena.get(), tape.get());
         
         // Execute if needed
         if (ctx.decision == Decision::BUY || ctx.decision == Decision::SELL) {
@@ -298,15 +841,37 @@ int main(int argc, char* argv[]) {
                 LOG_ERROR("Failed to execute " + decision_to_string(ctx.decision));
             }
         }
+        if (paper) {
+            strategy.manage_paper_orders(ctx);
+        }
+        
+        // Hand the tick's state and indicators to the standby
+        if (journal && !journal->append(state, strategy.indicator_windows())) {
+            LOG_WARNING("Failed to append to state journal");
+        }
         
         // Sleep until next poll
         for (int64_t i = 0; i < config.poll_interval_seconds && g_running; i++) {
             std::this_thread::sleep_for(std::chrono::seconds(1));
+            client.keep_warm(config.http_keepalive_seconds);
         }
     }
     
     LOG_INFO("Shutting down...");
     
+    if (tick_arena) {
+        const TickArenaStats& a = tick_arena->stats();
+        LOG_INFO("Tick arena: " + std::to_string(a.ticks) + " ticks, last " + std::to_string(a.last_tick_bytes) +
+                 " bytes, high water " + std::to_string(a.high_water_bytes) + " of " + std::to_string(a.capacity) +
+                 " bytes, " + std::to_string(a.overflow_ticks) + " overflowed");
+    }
+    if (compactor) {
+        compactor->stop();
+        CompactionStats c = compactor->totals();
+        LOG_INFO("Tick compactor: " + std::to_string(c.segments) + " segments, " + std::to_string(c.hot_bytes) +
+                 " -> " + std::to_string(c.cold_bytes) + " bytes, " + std::to_string(c.failures) + " failed");
+    }
+    
     // Final state save
     state.save(config.state_file);
     
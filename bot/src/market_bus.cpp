@@ -0,0 +1,147 @@
+#include "market_bus.hpp"
+#include "logger.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+
+MarketDataBus::ConsumerId MarketDataBus::subscribe(const std::string& name) {
+    std::lock_guard<std::mutex> lock(consumers_mutex_);
+    auto consumer = std::make_unique<Consumer>();
+    consumer->name = name;
+    consumers_.push_back(std::move(consumer));
+    return consumers_.size() - 1;
+}
+
+void MarketDataBus::publish(const MarketUpdate& update) {
+    if (update.pair.empty() || update.price <= 0.0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(consumers_mutex_);
+    for (auto& consumer : consumers_) {
+        std::lock_guard<std::mutex> slot_lock(consumer->mutex);
+        auto [it, inserted] = consumer->slots.try_emplace(update.pair);
+        ConflatedUpdate& slot = it->second;
+
+        if (inserted) {
+            slot.open = update.price;
+            slot.high = update.price;
+            slot.low = update.price;
+        } else {
+            slot.high = std::max(slot.high, update.price);
+            slot.low = std::min(slot.low, update.price);
+            consumer->conflated++;
+        }
+        slot.close = update.price;
+        slot.volume += update.volume;
+        slot.updates++;
+        slot.latest = update;
+    }
+}
+
+void MarketDataBus::publish(const SnapshotTable& table) {
+    for (const auto& snap : table.snapshots()) {
+        if (snap.version != table.version()) {
+            continue;
+        }
+        MarketUpdate update;
+        update.pair = snap.pair;
+        update.price = snap.last_price;
+        update.bid_price = snap.bid_price;
+        update.ask_price = snap.ask_price;
+        update.receive_ns = snap.receive_ns;
+        update.exchange_ns = snap.exchange_ns;
+        publish(update);
+    }
+}
+
+std::vector<ConflatedUpdate> MarketDataBus::poll(ConsumerId id) {
+    Consumer* consumer = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(consumers_mutex_);
+        if (id >= consumers_.size()) {
+            return {};
+        }
+        consumer = consumers_[id].get();
+    }
+
+    // Swap the slots out so publishers only wait for the swap
+    std::unordered_map<std::string, ConflatedUpdate> taken;
+    {
+        std::lock_guard<std::mutex> slot_lock(consumer->mutex);
+        taken.swap(consumer->slots);
+        consumer->delivered += taken.size();
+    }
+
+    std::vector<ConflatedUpdate> updates;
+    updates.reserve(taken.size());
+    for (auto& [pair, update] : taken) {
+        updates.push_back(std::move(update));
+    }
+    return updates;
+}
+
+std::vector<BusConsumerStats> MarketDataBus::stats() const {
+    std::lock_guard<std::mutex> lock(consumers_mutex_);
+    std::vector<BusConsumerStats> out;
+    out.reserve(consumers_.size());
+    for (const auto& consumer : consumers_) {
+        std::lock_guard<std::mutex> slot_lock(consumer->mutex);
+        BusConsumerStats s;
+        s.name = consumer->name;
+        s.delivered = consumer->delivered;
+        s.conflated = consumer->conflated;
+        s.pending = consumer->slots.size();
+        out.push_back(s);
+    }
+    return out;
+}
+
+BusBarLogger::BusBarLogger(MarketDataBus& bus, const std::string& name)
+    : bus_(bus)
+    , consumer_(bus.subscribe(name)) {
+}
+
+BusBarLogger::~BusBarLogger() {
+    stop();
+}
+
+void BusBarLogger::start(int interval_seconds) {
+    if (worker_.joinable()) {
+        return;
+    }
+    stopping_ = false;
+    worker_ = std::thread([this, interval_seconds] {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!cv_.wait_for(lock, std::chrono::seconds(interval_seconds), [this] { return stopping_; })) {
+            lock.unlock();
+            log_bars();
+            lock.lock();
+        }
+    });
+}
+
+void BusBarLogger::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+void BusBarLogger::log_bars() {
+    std::vector<ConflatedUpdate> updates = bus_.poll(consumer_);
+    std::sort(updates.begin(), updates.end(), [](const ConflatedUpdate& a, const ConflatedUpdate& b) {
+        return a.latest.pair < b.latest.pair;
+    });
+    for (const ConflatedUpdate& u : updates) {
+        std::ostringstream oss;
+        oss << std::setprecision(10) << "Bar " << u.latest.pair << ": o=" << u.open << " h=" << u.high
+            << " l=" << u.low << " c=" << u.close << " vol=" << u.volume << " (" << u.updates << " updates)";
+        LOG_INFO(oss.str());
+    }
+}
@@ -0,0 +1,103 @@
+#ifndef MARKET_BUS_HPP
+#define MARKET_BUS_HPP
+
+#include "market_data.hpp"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <cstdint>
+
+// One market data event: a quote refresh or a trade print
+struct MarketUpdate {
+    std::string pair;
+    double price = 0.0;        // Last trade price
+    double bid_price = 0.0;
+    double ask_price = 0.0;
+    double volume = 0.0;       // Volume traded in this event (0 for quotes)
+    int64_t receive_ns = 0;
+    int64_t exchange_ns = 0;
+};
+
+// Everything a consumer missed for one pair since its last poll, folded into
+// the newest update plus an OHLC/volume bar over the merged prices
+struct ConflatedUpdate {
+    MarketUpdate latest;
+    double open = 0.0;
+    double high = 0.0;
+    double low = 0.0;
+    double close = 0.0;
+    double volume = 0.0;
+    uint64_t updates = 0;      // Events merged into this one (1 = nothing dropped)
+};
+
+struct BusConsumerStats {
+    std::string name;
+    uint64_t delivered = 0;    // Conflated updates handed out by poll()
+    uint64_t conflated = 0;    // Events merged away because the consumer lagged
+    size_t pending = 0;        // Pairs with an update waiting
+};
+
+// Latest-value-per-pair fan-out. Each consumer owns one slot per pair; a
+// publish either fills an empty slot or merges into the pending one, so a
+// slow consumer costs O(pairs) memory and poll() returns at most one update
+// per pair no matter how bursty the feed was.
+class MarketDataBus {
+public:
+    using ConsumerId = size_t;
+
+    ConsumerId subscribe(const std::string& name);
+
+    void publish(const MarketUpdate& update);
+
+    // Publish every row refreshed by the table's version
+    void publish(const SnapshotTable& table);
+
+    // Take all pending updates for a consumer
+    std::vector<ConflatedUpdate> poll(ConsumerId id);
+
+    std::vector<BusConsumerStats> stats() const;
+
+private:
+    struct Consumer {
+        std::string name;
+        std::mutex mutex;
+        std::unordered_map<std::string, ConflatedUpdate> slots;
+        uint64_t delivered = 0;
+        uint64_t conflated = 0;
+    };
+
+    mutable std::mutex consumers_mutex_;
+    std::vector<std::unique_ptr<Consumer>> consumers_;
+};
+
+// Bus consumer on its own thread: every interval it takes whatever has
+// accumulated and logs one bar per pair. A tick's quotes and prints arrive
+// many times per interval, so this consumer always lags and its slots
+// conflate.
+class BusBarLogger {
+public:
+    BusBarLogger(MarketDataBus& bus, const std::string& name);
+    ~BusBarLogger();
+
+    BusBarLogger(const BusBarLogger&) = delete;
+    BusBarLogger& operator=(const BusBarLogger&) = delete;
+
+    void start(int interval_seconds);
+    void stop();
+
+private:
+    void log_bars();
+
+    MarketDataBus& bus_;
+    MarketDataBus::ConsumerId consumer_;
+    std::thread worker_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_ = false;
+};
+
+#endif // MARKET_BUS_HPP
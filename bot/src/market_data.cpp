@@ -0,0 +1,297 @@
+#include "market_data.hpp"
+#include "shm_ring.hpp"
+#include "logger.hpp"
+#include "util.hpp"
+#include <algorithm>
+#include <thread>
+
+// Pairs per Ticker request; keeps the query string well under URL limits
+static constexpr size_t kTickerBatchSize = 200;
+
+SnapshotTable::SnapshotTable(std::vector<MarketSnapshot> snapshots, uint64_t version)
+    : snapshots_(std::move(snapshots))
+    , version_(version) {
+    index_.reserve(snapshots_.size());
+    for (size_t i = 0; i < snapshots_.size(); i++) {
+        index_.emplace(snapshots_[i].pair, i);
+    }
+}
+
+const MarketSnapshot* SnapshotTable::find(const std::string& pair) const {
+    auto it = index_.find(pair);
+    if (it == index_.end()) {
+        return nullptr;
+    }
+    return &snapshots_[it->second];
+}
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free && std::atomic<size_t>::is_always_lock_free,
+              "SnapshotSlots readers must not take a lock");
+
+SnapshotSlots::SnapshotSlots(std::shared_ptr<const SnapshotTable> initial) {
+    slots_[0].table = std::move(initial);
+}
+
+std::shared_ptr<const SnapshotTable> SnapshotSlots::load() const {
+    // seq_cst on both sides: a reader that still sees its slot as current
+    // after counting in is visible to a writer about to refill that slot
+    for (;;) {
+        size_t index = current_.load();
+        const Slot& slot = slots_[index];
+        slot.readers.fetch_add(1);
+        if (current_.load() == index) {
+            std::shared_ptr<const SnapshotTable> table = slot.table;
+            slot.readers.fetch_sub(1, std::memory_order_release);
+            return table;
+        }
+        slot.readers.fetch_sub(1, std::memory_order_release);
+    }
+}
+
+void SnapshotSlots::store(std::shared_ptr<const SnapshotTable> table) {
+    std::lock_guard<std::mutex> lock(writer_mutex_);
+    size_t next = (current_.load(std::memory_order_relaxed) + 1) % kSlots;
+    Slot& slot = slots_[next];
+    // Only readers that found this slot current kSlots - 1 publishes ago and
+    // have not yet copied can be here
+    while (slot.readers.load() != 0) {
+        std::this_thread::yield();
+    }
+    slot.table = std::move(table);
+    current_.store(next);
+}
+
+MarketDataCache::MarketDataCache(KrakenClient& client)
+    : client_(client)
+    , table_(std::make_shared<const SnapshotTable>()) {
+}
+
+MarketDataCache::~MarketDataCache() = default;
+
+bool MarketDataCache::attach_ring(const std::string& shm_name, int64_t heartbeat_timeout_ms) {
+    auto reader = std::make_unique<ShmRingReader>(shm_name);
+    if (!reader->is_open()) {
+        return false;
+    }
+    // Start at the live edge; older records are already reflected in nothing we hold
+    reader->seek_to_end();
+    ring_ = std::move(reader);
+    ring_name_ = shm_name;
+    ring_heartbeat_timeout_ns_ = heartbeat_timeout_ms * 1'000'000;
+    return true;
+}
+
+void MarketDataCache::track(const std::string& pair) {
+    if (pair.empty()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(pairs_mutex_);
+    if (pair_index_.count(pair) == 0) {
+        pair_index_.emplace(pair, pairs_.size());
+        pairs_.push_back(pair);
+    }
+}
+
+void MarketDataCache::track(const std::vector<std::string>& pairs) {
+    for (const auto& pair : pairs) {
+        track(pair);
+    }
+}
+
+void MarketDataCache::track_book(const std::string& pair, int depth, int signal_levels) {
+    track(pair);
+    for (const TrackedBook& tracked : books_) {
+        if (tracked.pair == pair) {
+            return;
+        }
+    }
+    books_.push_back({pair, depth, OrderBook(signal_levels)});
+}
+
+size_t MarketDataCache::tracked_count() const {
+    std::lock_guard<std::mutex> lock(pairs_mutex_);
+    return pairs_.size();
+}
+
+bool MarketDataCache::refresh() {
+    if (ring_) {
+        return refresh_from_ring();
+    }
+    
+    std::vector<std::string> pairs;
+    {
+        std::lock_guard<std::mutex> lock(pairs_mutex_);
+        pairs = pairs_;
+    }
+    if (pairs.empty()) {
+        return false;
+    }
+
+    std::shared_ptr<const SnapshotTable> previous = snapshot();
+    const uint64_t version = ++version_;
+
+    // Start from the previous quotes so failed batches keep aging
+    std::vector<MarketSnapshot> rows(pairs.size());
+    for (size_t i = 0; i < pairs.size(); i++) {
+        const MarketSnapshot* old = previous->find(pairs[i]);
+        if (old != nullptr) {
+            rows[i] = *old;
+        } else {
+            rows[i].pair = pairs[i];
+        }
+    }
+
+    size_t updated = 0;
+    for (size_t start = 0; start < pairs.size(); start += kTickerBatchSize) {
+        size_t end = std::min(pairs.size(), start + kTickerBatchSize);
+        std::vector<std::string> batch(pairs.begin() + static_cast<std::ptrdiff_t>(start),
+                                       pairs.begin() + static_cast<std::ptrdiff_t>(end));
+
+        MultiTickerResult result = client_.get_tickers(batch);
+        if (!result.success) {
+            LOG_WARNING("Market data batch failed: " + result.error);
+            continue;
+        }
+
+        for (size_t i = start; i < end; i++) {
+            auto it = result.tickers.find(pairs[i]);
+            // Kraken answers with the canonical pair name; a lone altname
+            // request (e.g. XBTCAD) still maps to its single result
+            if (it == result.tickers.end() && end - start == 1 && result.tickers.size() == 1) {
+                it = result.tickers.begin();
+            }
+            if (it == result.tickers.end()) {
+                continue;
+            }
+            const TickerResult& ticker = it->second;
+            MarketSnapshot& row = rows[i];
+            row.last_price = ticker.last_price;
+            row.bid_price = ticker.bid_price;
+            row.ask_price = ticker.ask_price;
+            row.bid_volume = ticker.bid_volume;
+            row.ask_volume = ticker.ask_volume;
+            row.volume_24h = ticker.volume_24h;
+            row.timestamp = ticker.timestamp;
+            row.receive_ns = ticker.receive_ns;
+            row.exchange_ns = ticker.exchange_ns;
+            row.version = version;
+            updated++;
+        }
+    }
+
+    // A failed Depth call keeps the previous signals; their receive_ns
+    // shows how old they are
+    for (TrackedBook& tracked : books_) {
+        auto row = std::find_if(rows.begin(), rows.end(),
+                                [&](const MarketSnapshot& r) { return r.pair == tracked.pair; });
+        if (row == rows.end()) {
+            continue;
+        }
+        DepthResult depth = client_.get_depth(tracked.pair, tracked.depth);
+        if (!depth.success) {
+            LOG_WARNING("Book refresh failed for " + tracked.pair + ": " + depth.error);
+            continue;
+        }
+        tracked.book.apply_snapshot(depth.bids, depth.asks, depth.receive_ns);
+        row->book = tracked.book.signals();
+    }
+
+    table_.store(std::make_shared<const SnapshotTable>(std::move(rows), version));
+
+    if (updated < pairs.size()) {
+        LOG_DEBUG("Market data refresh updated " + std::to_string(updated) + "/" +
+                  std::to_string(pairs.size()) + " pairs");
+    }
+    return updated > 0;
+}
+
+void MarketDataCache::publish(const MarketSnapshot& snap) {
+    track(snap.pair);
+    std::shared_ptr<const SnapshotTable> previous = snapshot();
+    const uint64_t version = ++version_;
+    
+    std::vector<MarketSnapshot> rows = previous->snapshots();
+    bool found = false;
+    for (auto& row : rows) {
+        if (row.pair == snap.pair) {
+            row = snap;
+            row.version = version;
+            found = true;
+        }
+    }
+    if (!found) {
+        rows.push_back(snap);
+        rows.back().version = version;
+    }
+    
+    table_.store(std::make_shared<const SnapshotTable>(std::move(rows), version));
+}
+
+bool MarketDataCache::refresh_from_ring() {
+    std::shared_ptr<const SnapshotTable> previous = snapshot();
+    const uint64_t version = ++version_;
+
+    std::vector<MarketSnapshot> rows;
+    std::unordered_map<std::string, size_t> row_index;
+    {
+        std::lock_guard<std::mutex> lock(pairs_mutex_);
+        rows.resize(pairs_.size());
+        for (size_t i = 0; i < pairs_.size(); i++) {
+            const MarketSnapshot* old = previous->find(pairs_[i]);
+            if (old != nullptr) {
+                rows[i] = *old;
+            } else {
+                rows[i].pair = pairs_[i];
+            }
+            row_index.emplace(pairs_[i], i);
+        }
+    }
+
+    size_t updated = 0;
+    ShmRecord record;
+    while (ring_->read(record)) {
+        if (record.type != ShmRecordType::TICK) {
+            continue;
+        }
+        auto it = row_index.find(record.pair_name());
+        if (it == row_index.end()) {
+            continue;
+        }
+        MarketSnapshot& row = rows[it->second];
+        row.last_price = record.tick.last_price;
+        row.bid_price = record.tick.bid_price;
+        row.ask_price = record.tick.ask_price;
+        row.volume_24h = record.tick.volume_24h;
+        row.receive_ns = record.receive_ns;
+        row.exchange_ns = record.exchange_ns;
+        row.timestamp = record.receive_ns / 1'000'000'000;
+        row.version = version;
+        updated++;
+    }
+
+    if (ring_->lost() > ring_lost_reported_) {
+        LOG_WARNING("Market data reader lagged: lost " + std::to_string(ring_->lost() - ring_lost_reported_) +
+                    " records from the shared memory ring");
+        ring_lost_reported_ = ring_->lost();
+    }
+
+    table_.store(std::make_shared<const SnapshotTable>(std::move(rows), version));
+
+    int64_t heartbeat_age = util::now_epoch_ns() - ring_->writer_heartbeat_ns();
+    if (heartbeat_age > ring_heartbeat_timeout_ns_) {
+        LOG_WARNING("Market data gateway heartbeat is " + std::to_string(heartbeat_age / 1'000'000) + "ms old");
+        // A gateway restarted with another ring size publishes to a new
+        // segment; everything in it is newer than what we hold, so read it
+        // from the start
+        if (ring_->superseded()) {
+            auto reader = std::make_unique<ShmRingReader>(ring_name_);
+            if (reader->is_open()) {
+                LOG_WARNING("Shared memory ring " + ring_name_ + " was replaced, re-attached");
+                ring_ = std::move(reader);
+                ring_lost_reported_ = 0;
+            }
+        }
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,144 @@
+#ifndef MARKET_DATA_HPP
+#define MARKET_DATA_HPP
+
+#include "kraken_client.hpp"
+#include "order_book.hpp"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <cstdint>
+
+class ShmRingReader;
+
+// Latest quote for one pair
+struct MarketSnapshot {
+    std::string pair;
+    double last_price = 0.0;
+    double bid_price = 0.0;
+    double ask_price = 0.0;
+    double bid_volume = 0.0;
+    double ask_volume = 0.0;
+    double volume_24h = 0.0;
+    int64_t timestamp = 0;     // Unix epoch seconds when fetched
+    int64_t receive_ns = 0;    // Local epoch ns when the quote arrived
+    int64_t exchange_ns = 0;   // Estimated exchange time the quote was served
+    uint64_t version = 0;      // Refresh that produced this quote
+    BookSignals book;          // Pairs tracked with track_book() only
+};
+
+// Immutable per-pair table. A new table is built on every refresh and
+// published whole, so readers never observe a half-updated table.
+class SnapshotTable {
+public:
+    SnapshotTable() = default;
+    SnapshotTable(std::vector<MarketSnapshot> snapshots, uint64_t version);
+
+    const MarketSnapshot* find(const std::string& pair) const;
+    const std::vector<MarketSnapshot>& snapshots() const { return snapshots_; }
+    uint64_t version() const { return version_; }
+
+private:
+    std::vector<MarketSnapshot> snapshots_;
+    std::unordered_map<std::string, size_t> index_;
+    uint64_t version_ = 0;
+};
+
+// The current SnapshotTable, published by one writer at a time and read
+// without locks. std::atomic<std::shared_ptr> is not lock-free in libstdc++
+// (every load takes an internal spinlock), so the table rotates through a few
+// slots instead. A reader counts itself into the current slot, checks the
+// slot is still current and copies its shared_ptr; the writer fills the
+// next slot, waiting only while a reader is mid-copy there, then makes it
+// current. A superseded table is freed once its slot is refilled and its
+// last reader drops it.
+class SnapshotSlots {
+public:
+    explicit SnapshotSlots(std::shared_ptr<const SnapshotTable> initial);
+
+    // Never blocks; retries only if a publish moved past its slot
+    std::shared_ptr<const SnapshotTable> load() const;
+
+    void store(std::shared_ptr<const SnapshotTable> table);
+
+private:
+    static constexpr size_t kSlots = 4;
+
+    struct alignas(64) Slot {
+        std::shared_ptr<const SnapshotTable> table;
+        mutable std::atomic<uint32_t> readers{0};
+    };
+
+    std::array<Slot, kSlots> slots_;
+    std::atomic<size_t> current_{0};
+    std::mutex writer_mutex_;
+};
+
+// Fetches every tracked pair with batched Ticker requests (one request per
+// 200 pairs), or drains a market_gateway ring, and publishes the result as a
+// shared immutable SnapshotTable.
+// Readers take a reference with snapshot() and keep it for as long as they
+// need; the refresh thread never waits on them. Pairs missing from a refresh
+// keep their previous quote and timestamp, so their age keeps growing.
+class MarketDataCache {
+public:
+    explicit MarketDataCache(KrakenClient& client);
+    ~MarketDataCache();
+
+    // Add a pair to the refresh set (no-op if already tracked)
+    void track(const std::string& pair);
+    void track(const std::vector<std::string>& pairs);
+
+    // Also keep an L2 book for pair, fetched as a Depth snapshot of depth
+    // levels on every REST refresh and applied as level changes; its
+    // signals over the top signal_levels appear in the pair's snapshot.
+    // Call before the refresh loop starts.
+    void track_book(const std::string& pair, int depth, int signal_levels);
+
+    // Read quotes from a market_gateway shared-memory ring instead of
+    // polling Kraken; the gateway counts as down once its heartbeat is older
+    // than heartbeat_timeout_ms
+    bool attach_ring(const std::string& shm_name, int64_t heartbeat_timeout_ms);
+
+    // Fetch all tracked pairs and publish a new table
+    bool refresh();
+    
+    // Publish one quote from an outside source (backtest replay); the pair
+    // is tracked if it was not already
+    void publish(const MarketSnapshot& snap);
+
+    // Current table; never null
+    std::shared_ptr<const SnapshotTable> snapshot() const {
+        return table_.load();
+    }
+
+    size_t tracked_count() const;
+
+private:
+    bool refresh_from_ring();
+
+    KrakenClient& client_;
+    std::unique_ptr<ShmRingReader> ring_;
+    std::string ring_name_;
+    int64_t ring_heartbeat_timeout_ns_ = 0;
+    uint64_t ring_lost_reported_ = 0;
+
+    mutable std::mutex pairs_mutex_;
+    std::vector<std::string> pairs_;
+    std::unordered_map<std::string, size_t> pair_index_;
+
+    struct TrackedBook {
+        std::string pair;
+        int depth;
+        OrderBook book;
+    };
+    std::vector<TrackedBook> books_;     // Refresh thread only
+
+    SnapshotSlots table_;
+    uint64_t version_ = 0;
+};
+
+#endif // MARKET_DATA_HPP
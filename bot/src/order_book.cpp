@@ -0,0 +1,142 @@
+#include "order_book.hpp"
+#include "tick_arena.hpp"
+#include <algorithm>
+#include <cmath>
+
+// Level changes between exact re-sums of a side's running depth, which
+// bounds floating-point drift from repeated add/subtract
+static constexpr uint64_t kResumInterval = 4096;
+
+OrderBook::OrderBook(int signal_levels)
+    : signal_levels_(static_cast<size_t>(std::max(signal_levels, 1))) {
+    bids_.bid = true;
+    asks_.bid = false;
+}
+
+void OrderBook::apply(bool bid, double price, double volume) {
+    apply(bid ? bids_ : asks_, price, volume);
+}
+
+void OrderBook::apply(Side& side, double price, double volume) {
+    std::vector<BookLevel>& levels = side.levels;
+    const size_t n = signal_levels_;
+    auto it = std::lower_bound(levels.begin(), levels.end(), price, [&](const BookLevel& level, double p) {
+        return side.bid ? level.price > p : level.price < p;
+    });
+    const size_t i = static_cast<size_t>(it - levels.begin());
+    const bool exists = it != levels.end() && it->price == price;
+
+    if (exists && volume > 0.0) {
+        if (i < n) {
+            side.top_volume += volume - it->volume;
+        }
+        it->volume = volume;
+    } else if (exists) {
+        // Removing a top level pulls the next one into the window
+        if (i < n) {
+            side.top_volume -= it->volume;
+        }
+        levels.erase(it);
+        if (i < n && levels.size() >= n) {
+            side.top_volume += levels[n - 1].volume;
+        }
+    } else if (volume > 0.0) {
+        // Inserting into the window pushes its last level out
+        levels.insert(it, BookLevel{price, volume});
+        if (i < n) {
+            side.top_volume += volume;
+            if (levels.size() > n) {
+                side.top_volume -= levels[n].volume;
+            }
+        }
+    } else {
+        return;
+    }
+
+    updates_++;
+    if (levels.empty() || updates_ % kResumInterval == 0) {
+        resum(side);
+    }
+}
+
+void OrderBook::resum(Side& side) {
+    side.top_volume = 0.0;
+    size_t k = std::min(signal_levels_, side.levels.size());
+    for (size_t i = 0; i < k; i++) {
+        side.top_volume += side.levels[i].volume;
+    }
+}
+
+size_t OrderBook::diff(Side& side, const std::vector<BookLevel>& target) {
+    // Merge the two best-first lists into the level changes, then apply
+    // those; unchanged levels cost a comparison and nothing else
+    std::pmr::vector<BookLevel> changes(tick_resource());
+    const std::vector<BookLevel>& current = side.levels;
+    size_t i = 0;
+    size_t j = 0;
+    while (i < current.size() || j < target.size()) {
+        if (j == target.size() ||
+            (i < current.size() && (side.bid ? current[i].price > target[j].price
+                                             : current[i].price < target[j].price))) {
+            changes.push_back({current[i].price, 0.0});
+            i++;
+        } else if (i == current.size() || current[i].price != target[j].price) {
+            changes.push_back(target[j]);
+            j++;
+        } else {
+            if (current[i].volume != target[j].volume) {
+                changes.push_back(target[j]);
+            }
+            i++;
+            j++;
+        }
+    }
+    for (const BookLevel& change : changes) {
+        apply(side, change.price, change.volume);
+    }
+    return changes.size();
+}
+
+size_t OrderBook::apply_snapshot(const std::vector<BookLevel>& bids, const std::vector<BookLevel>& asks,
+                                 int64_t receive_ns) {
+    receive_ns_ = receive_ns;
+    return diff(bids_, bids) + diff(asks_, asks);
+}
+
+BookSignals OrderBook::signals() const {
+    BookSignals s;
+    s.levels = static_cast<int>(signal_levels_);
+    s.updates = updates_;
+    s.receive_ns = receive_ns_;
+    if (bids_.levels.empty() || asks_.levels.empty()) {
+        return s;
+    }
+    s.valid = true;
+
+    const BookLevel& bid = bids_.levels.front();
+    const BookLevel& ask = asks_.levels.front();
+    const double mid = (bid.price + ask.price) / 2.0;
+
+    const double touch = bid.volume + ask.volume;
+    s.microprice = touch > 0.0 ? (ask.price * bid.volume + bid.price * ask.volume) / touch : mid;
+
+    const double depth = bids_.top_volume + asks_.top_volume;
+    if (depth > 0.0) {
+        s.imbalance = (bids_.top_volume - asks_.top_volume) / depth;
+        s.weighted_mid = (ask.price * bids_.top_volume + bid.price * asks_.top_volume) / depth;
+    } else {
+        s.weighted_mid = mid;
+    }
+
+    auto slope = [&](const Side& side) {
+        size_t k = std::min(signal_levels_, side.levels.size());
+        if (k < 2) {
+            return 0.0;
+        }
+        double range_pct = std::fabs(side.levels.front().price - side.levels[k - 1].price) / mid * 100.0;
+        return range_pct > 0.0 ? side.top_volume / range_pct : 0.0;
+    };
+    s.bid_slope = slope(bids_);
+    s.ask_slope = slope(asks_);
+    return s;
+}
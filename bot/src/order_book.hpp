@@ -0,0 +1,65 @@
+#ifndef ORDER_BOOK_HPP
+#define ORDER_BOOK_HPP
+
+#include "kraken_client.hpp"
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// Short-term pressure read off the top levels of an L2 book
+struct BookSignals {
+    bool valid = false;          // Both sides have at least one level
+    int levels = 0;              // Levels per side the depth figures cover
+    double imbalance = 0.0;      // (bid - ask) / (bid + ask) volume over the
+                                 // top levels, -1 (all asks) .. 1 (all bids)
+    double microprice = 0.0;     // Best bid/ask weighted by the opposite
+                                 // side's size at the touch
+    double weighted_mid = 0.0;   // Best bid/ask weighted by the opposite
+                                 // side's depth over the top levels
+    double bid_slope = 0.0;      // Volume in the top levels per 1% of price
+    double ask_slope = 0.0;      // between the touch and the last level;
+                                 // 0 with fewer than two levels
+    uint64_t updates = 0;        // Level changes applied so far
+    int64_t receive_ns = 0;      // Local time of the last book applied
+};
+
+// L2 book for one pair that keeps its signals up to date as levels change.
+// Each side holds the depth of its top signal_levels levels as a running
+// sum, so a level change costs O(1) for the signals (plus locating and
+// shifting the level in a sorted vector) instead of a rescan of the book.
+class OrderBook {
+public:
+    explicit OrderBook(int signal_levels);
+
+    // Set one level; volume 0 removes it
+    void apply(bool bid, double price, double volume);
+
+    // Bring the book to a full snapshot (best first) by applying only the
+    // levels that differ from the current book; returns how many changed
+    size_t apply_snapshot(const std::vector<BookLevel>& bids, const std::vector<BookLevel>& asks,
+                          int64_t receive_ns);
+
+    BookSignals signals() const;
+
+    const std::vector<BookLevel>& bids() const { return bids_.levels; }
+    const std::vector<BookLevel>& asks() const { return asks_.levels; }
+
+private:
+    struct Side {
+        bool bid = true;
+        std::vector<BookLevel> levels;   // Best first
+        double top_volume = 0.0;         // Sum over the first signal_levels
+    };
+
+    void apply(Side& side, double price, double volume);
+    size_t diff(Side& side, const std::vector<BookLevel>& target);
+    void resum(Side& side);
+
+    size_t signal_levels_;
+    Side bids_;
+    Side asks_;
+    uint64_t updates_ = 0;
+    int64_t receive_ns_ = 0;
+};
+
+#endif // ORDER_BOOK_HPP
@@ -0,0 +1,389 @@
+#include "paper_exchange.hpp"
+#include "logger.hpp"
+#include "util.hpp"
+#include <algorithm>
+#include <cmath>
+
+static constexpr double kVolumeEpsilon = 1e-12;
+
+static bool same_price(double a, double b) {
+    return std::fabs(a - b) <= 1e-9 * std::max(std::fabs(a), std::fabs(b));
+}
+
+static bool is_stop(PaperOrderType type) {
+    return type == PaperOrderType::STOP_LOSS || type == PaperOrderType::STOP_LOSS_LIMIT;
+}
+
+static bool is_limit(PaperOrderType type) {
+    return type == PaperOrderType::LIMIT || type == PaperOrderType::STOP_LOSS_LIMIT;
+}
+
+// Whether an opposite-side price is acceptable to a limit order
+static bool marketable(const PaperOrder& order, double price) {
+    return order.buy ? price <= order.limit_price : price >= order.limit_price;
+}
+
+std::string paper_order_type_to_string(PaperOrderType type) {
+    switch (type) {
+        case PaperOrderType::MARKET: return "market";
+        case PaperOrderType::LIMIT: return "limit";
+        case PaperOrderType::STOP_LOSS: return "stop-loss";
+        case PaperOrderType::STOP_LOSS_LIMIT: return "stop-loss-limit";
+        default: return "unknown";
+    }
+}
+
+PaperExchange::PaperExchange(double maker_fee_pct, double taker_fee_pct, const ClockSync* clock)
+    : maker_fee_pct_(maker_fee_pct)
+    , taker_fee_pct_(taker_fee_pct)
+    , clock_(clock) {
+}
+
+void PaperExchange::fill(PaperOrder& order, double price, double volume, bool maker, int64_t time_ns) {
+    volume = std::min(volume, order.remaining());
+    if (volume <= kVolumeEpsilon) {
+        return;
+    }
+
+    double fee = price * volume * (maker ? maker_fee_pct_ : taker_fee_pct_);
+    order.avg_price = (order.avg_price * order.filled + price * volume) / (order.filled + volume);
+    order.filled += volume;
+    order.fee_cad += fee;
+    if (order.remaining() <= kVolumeEpsilon) {
+        order.filled = order.volume;
+        order.status = PaperOrderStatus::FILLED;
+    }
+
+    PaperFill f;
+    f.order_id = order.id;
+    f.pair = order.pair;
+    f.buy = order.buy;
+    f.price = price;
+    f.volume = volume;
+    f.fee_cad = fee;
+    f.maker = maker;
+    f.time_ns = time_ns;
+    fills_.push_back(f);
+
+    LOG_INFO("[PAPER] " + std::string(order.buy ? "BUY " : "SELL ") + std::to_string(volume) + " " +
+             order.pair + " @ " + std::to_string(price) + (maker ? " (maker)" : " (taker)") +
+             " order #" + std::to_string(order.id) + " " + std::to_string(order.filled) + "/" +
+             std::to_string(order.volume));
+}
+
+void PaperExchange::take_liquidity(Market& market, PaperOrder& order, int64_t time_ns) {
+    auto& levels = order.buy ? market.asks : market.bids;
+    const bool limited = is_limit(order.type);
+
+    size_t consumed = 0;
+    double worst = 0.0;
+    for (auto& level : levels) {
+        if (order.remaining() <= kVolumeEpsilon) break;
+        if (limited && !marketable(order, level.price)) break;
+        double qty = std::min(level.volume, order.remaining());
+        fill(order, level.price, qty, false, time_ns);
+        worst = level.price;
+        level.volume -= qty;
+        if (level.volume > kVolumeEpsilon) break;
+        consumed++;
+    }
+    levels.erase(levels.begin(), levels.begin() + static_cast<std::ptrdiff_t>(consumed));
+
+    // Market orders larger than the fetched depth (or sent before any book
+    // arrived) fill the rest at the worst price seen
+    if (!limited && order.remaining() > kVolumeEpsilon) {
+        double price = worst > 0.0 ? worst : market.last_price;
+        if (price <= 0.0) {
+            LOG_ERROR("[PAPER] No book or last price for " + order.pair + ", canceling order #" +
+                      std::to_string(order.id));
+            order.status = PaperOrderStatus::CANCELED;
+            return;
+        }
+        fill(order, price, order.remaining(), false, time_ns);
+    }
+}
+
+void PaperExchange::rest(Market& market, PaperOrder& order) {
+    // Join the back of the level: everything already there is ahead of us
+    const auto& levels = order.buy ? market.bids : market.asks;
+    order.queue_ahead = 0.0;
+    for (const auto& level : levels) {
+        if (same_price(level.price, order.limit_price)) {
+            order.queue_ahead = level.volume;
+            break;
+        }
+    }
+}
+
+void PaperExchange::activate(Market& market, PaperOrder& order, int64_t time_ns) {
+    if (order.type == PaperOrderType::STOP_LOSS) {
+        order.type = PaperOrderType::MARKET;
+    } else if (order.type == PaperOrderType::STOP_LOSS_LIMIT) {
+        order.type = PaperOrderType::LIMIT;
+    }
+
+    if (order.type == PaperOrderType::LIMIT) {
+        const auto& opposite = order.buy ? market.asks : market.bids;
+        if (order.post_only && !opposite.empty() && marketable(order, opposite.front().price)) {
+            LOG_INFO("[PAPER] Post-only order #" + std::to_string(order.id) + " would take liquidity, canceled");
+            order.status = PaperOrderStatus::CANCELED;
+            return;
+        }
+    }
+
+    take_liquidity(market, order, time_ns);
+    if (order.type == PaperOrderType::LIMIT && order.status == PaperOrderStatus::OPEN) {
+        rest(market, order);
+    }
+}
+
+uint64_t PaperExchange::submit(PaperOrder order, double reference_price) {
+    if (order.volume <= 0.0 || order.pair.empty() ||
+        (is_limit(order.type) && order.limit_price <= 0.0) ||
+        (is_stop(order.type) && order.stop_price <= 0.0)) {
+        LOG_ERROR("[PAPER] Rejected invalid " + paper_order_type_to_string(order.type) + " order for " + order.pair);
+        return 0;
+    }
+
+    Market& market = markets_[order.pair];
+    if (market.last_price <= 0.0) {
+        market.last_price = reference_price;
+    }
+
+    order.id = next_id_++;
+    order.status = PaperOrderStatus::OPEN;
+    order.triggered = false;
+    order.filled = 0.0;
+    order.avg_price = 0.0;
+    order.fee_cad = 0.0;
+    order.created_ns = util::now_epoch_ns();
+    order.created_exchange_ns = clock_ != nullptr ? clock_->to_exchange_ns(order.created_ns) : order.created_ns;
+
+    LOG_INFO("[PAPER] New " + paper_order_type_to_string(order.type) + " " + (order.buy ? "buy " : "sell ") +
+             std::to_string(order.volume) + " " + order.pair +
+             (is_limit(order.type) ? " limit " + std::to_string(order.limit_price) : "") +
+             (is_stop(order.type) ? " stop " + std::to_string(order.stop_price) : "") +
+             " order #" + std::to_string(order.id));
+
+    // Stops wait for a print at or through stop_price
+    if (!is_stop(order.type)) {
+        activate(market, order, order.created_ns);
+        if (order.status == PaperOrderStatus::CANCELED) {
+            return 0;
+        }
+    }
+    if (order.status == PaperOrderStatus::OPEN) {
+        if (order.type == PaperOrderType::LIMIT) {
+            LOG_INFO("[PAPER] Order #" + std::to_string(order.id) + " resting with " +
+                     std::to_string(order.queue_ahead) + " ahead");
+        }
+        market.orders.push_back(order);
+    }
+    return order.id;
+}
+
+bool PaperExchange::cancel(uint64_t id) {
+    for (auto& [pair, market] : markets_) {
+        for (auto& order : market.orders) {
+            if (order.id == id && order.status == PaperOrderStatus::OPEN) {
+                order.status = PaperOrderStatus::CANCELED;
+                LOG_INFO("[PAPER] Canceled order #" + std::to_string(id) + " (" +
+                         std::to_string(order.filled) + "/" + std::to_string(order.volume) + " filled)");
+                sweep_closed(market);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void PaperExchange::cancel_all(const std::string& pair) {
+    auto it = markets_.find(pair);
+    if (it == markets_.end()) {
+        return;
+    }
+    for (auto& order : it->second.orders) {
+        order.status = PaperOrderStatus::CANCELED;
+        LOG_INFO("[PAPER] Canceled order #" + std::to_string(order.id));
+    }
+    it->second.orders.clear();
+}
+
+void PaperExchange::match_book(Market& market, int64_t time_ns) {
+    for (auto& order : market.orders) {
+        if (order.status != PaperOrderStatus::OPEN) continue;
+
+        if (is_stop(order.type)) {
+            if (order.triggered) {
+                activate(market, order, time_ns);
+            }
+            continue;
+        }
+
+        if (order.type != PaperOrderType::LIMIT) continue;
+
+        // The other side quoting at or through our price means someone
+        // crossed into the level since the last snapshot. Only the volume
+        // that crossed trades: it works through the queue ahead first, and
+        // what reaches us is taken out of the snapshot so later orders at
+        // the same price cannot fill against it again.
+        auto& opposite = order.buy ? market.asks : market.bids;
+        double crossed = 0.0;
+        for (const auto& level : opposite) {
+            if (!marketable(order, level.price)) break;
+            crossed += level.volume;
+        }
+        if (crossed > kVolumeEpsilon) {
+            double ahead = std::min(crossed, order.queue_ahead);
+            order.queue_ahead -= ahead;
+            double qty = std::min(crossed - ahead, order.remaining());
+            fill(order, order.limit_price, qty, true, time_ns);
+
+            double used = ahead + qty;
+            size_t consumed = 0;
+            for (auto& level : opposite) {
+                if (used <= kVolumeEpsilon) break;
+                double take = std::min(level.volume, used);
+                level.volume -= take;
+                used -= take;
+                if (level.volume > kVolumeEpsilon) break;
+                consumed++;
+            }
+            opposite.erase(opposite.begin(), opposite.begin() + static_cast<std::ptrdiff_t>(consumed));
+            if (order.status != PaperOrderStatus::OPEN) continue;
+        }
+
+        // Volume that left the level without printing was canceled; assume
+        // it was ahead of us, so the queue never exceeds the level
+        const auto& same = order.buy ? market.bids : market.asks;
+        double level_volume = 0.0;
+        for (const auto& level : same) {
+            if (same_price(level.price, order.limit_price)) {
+                level_volume = level.volume;
+                break;
+            }
+        }
+        order.queue_ahead = std::min(order.queue_ahead, level_volume);
+    }
+    sweep_closed(market);
+}
+
+void PaperExchange::on_book(const std::string& pair, std::vector<BookLevel> bids, std::vector<BookLevel> asks) {
+    Market& market = markets_[pair];
+    market.bids = std::move(bids);
+    market.asks = std::move(asks);
+    match_book(market, util::now_epoch_ns());
+}
+
+void PaperExchange::on_trades(const std::string& pair, const std::vector<TradePrint>& trades) {
+    Market& market = markets_[pair];
+
+    for (const auto& print : trades) {
+        market.last_price = print.price;
+        market.last_time_ns = print.time_ns;
+        double available = print.volume;
+
+        for (auto& order : market.orders) {
+            if (order.status != PaperOrderStatus::OPEN) continue;
+            // The cursor runs from the previous poll, so a batch can hold
+            // prints from before the order existed
+            if (print.time_ns < order.created_exchange_ns) continue;
+
+            if (is_stop(order.type)) {
+                if (!order.triggered &&
+                    (order.buy ? print.price >= order.stop_price : print.price <= order.stop_price)) {
+                    order.triggered = true;
+                    LOG_INFO("[PAPER] Stop order #" + std::to_string(order.id) + " triggered at " +
+                             std::to_string(print.price));
+                }
+                continue;
+            }
+
+            if (order.type != PaperOrderType::LIMIT) continue;
+
+            // A print beyond our price cleared the whole level
+            bool through = order.buy ? print.price < order.limit_price : print.price > order.limit_price;
+            if (through && !same_price(print.price, order.limit_price)) {
+                fill(order, order.limit_price, order.remaining(), true, print.time_ns);
+                continue;
+            }
+
+            // A print at our price from the other side works through the queue
+            bool hits_us = order.buy ? !print.buy_aggressor : print.buy_aggressor;
+            if (hits_us && same_price(print.price, order.limit_price) && available > kVolumeEpsilon) {
+                double ahead = std::min(available, order.queue_ahead);
+                order.queue_ahead -= ahead;
+                available -= ahead;
+                double qty = std::min(available, order.remaining());
+                if (qty > kVolumeEpsilon) {
+                    fill(order, order.limit_price, qty, true, print.time_ns);
+                    available -= qty;
+                }
+            }
+        }
+    }
+    sweep_closed(market);
+}
+
+void PaperExchange::poll(KrakenClient& client, const std::vector<std::string>& pairs, int depth) {
+    for (const auto& pair : pairs) {
+        Market& market = markets_[pair];
+
+        TradesResult trades = client.get_recent_trades(pair, market.trade_cursor);
+        if (trades.success) {
+            if (market.cursor_ready) {
+                on_trades(pair, trades.trades);
+            } else if (!trades.trades.empty()) {
+                market.last_price = trades.trades.back().price;
+            }
+            market.cursor_ready = true;
+            market.trade_cursor = trades.last;
+        }
+
+        DepthResult book = client.get_depth(pair, depth);
+        if (book.success) {
+            on_book(pair, std::move(book.bids), std::move(book.asks));
+        } else {
+            // Triggered stops still execute, against the previous book
+            match_book(market, util::now_epoch_ns());
+        }
+    }
+}
+
+std::vector<PaperFill> PaperExchange::take_fills() {
+    std::vector<PaperFill> out;
+    out.swap(fills_);
+    return out;
+}
+
+const PaperOrder* PaperExchange::find(uint64_t id) const {
+    for (const auto& [pair, market] : markets_) {
+        for (const auto& order : market.orders) {
+            if (order.id == id) {
+                return &order;
+            }
+        }
+    }
+    return nullptr;
+}
+
+std::vector<PaperOrder> PaperExchange::open_orders(const std::string& pair) const {
+    auto it = markets_.find(pair);
+    return it != markets_.end() ? it->second.orders : std::vector<PaperOrder>{};
+}
+
+std::vector<std::string> PaperExchange::active_pairs() const {
+    std::vector<std::string> pairs;
+    for (const auto& [pair, market] : markets_) {
+        if (!market.orders.empty()) {
+            pairs.push_back(pair);
+        }
+    }
+    return pairs;
+}
+
+void PaperExchange::sweep_closed(Market& market) {
+    market.orders.erase(std::remove_if(market.orders.begin(), market.orders.end(),
+                                       [](const PaperOrder& o) { return o.status != PaperOrderStatus::OPEN; }),
+                        market.orders.end());
+}
@@ -0,0 +1,124 @@
+#ifndef PAPER_EXCHANGE_HPP
+#define PAPER_EXCHANGE_HPP
+
+#include "kraken_client.hpp"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+enum class PaperOrderType {
+    MARKET,
+    LIMIT,
+    STOP_LOSS,        // Market order once the last trade reaches stop_price
+    STOP_LOSS_LIMIT   // Limit order at limit_price once triggered
+};
+
+enum class PaperOrderStatus {
+    OPEN,
+    FILLED,
+    CANCELED
+};
+
+std::string paper_order_type_to_string(PaperOrderType type);
+
+struct PaperOrder {
+    uint64_t id = 0;
+    std::string pair;
+    bool buy = true;
+    PaperOrderType type = PaperOrderType::MARKET;
+    double volume = 0.0;
+    double limit_price = 0.0;
+    double stop_price = 0.0;
+    bool post_only = false;          // Cancel instead of taking liquidity
+
+    PaperOrderStatus status = PaperOrderStatus::OPEN;
+    bool triggered = false;          // Stop reached (stop orders only)
+    double filled = 0.0;
+    double avg_price = 0.0;
+    double fee_cad = 0.0;
+    double queue_ahead = 0.0;        // Estimated volume ahead at limit_price
+    int64_t created_ns = 0;
+    int64_t created_exchange_ns = 0; // Prints before this predate the order
+
+    double remaining() const { return volume - filled; }
+};
+
+struct PaperFill {
+    uint64_t order_id = 0;
+    std::string pair;
+    bool buy = true;
+    double price = 0.0;
+    double volume = 0.0;
+    double fee_cad = 0.0;
+    bool maker = false;
+    int64_t time_ns = 0;
+};
+
+// Local matching engine for dry-run orders, driven by the real order book
+// and trade prints.
+//
+// Market and marketable limit orders walk the latest book snapshot (and
+// consume it until the next one). Resting limits join the back of their
+// price level: the queue ahead shrinks with prints that hit the level and
+// with cancellations seen in later snapshots, and the order fills once the
+// queue is exhausted or the price trades or quotes through it. Stops trigger
+// on trade prints and execute against the next book snapshot. Only prints
+// at or after an order's submission (on the exchange clock) touch it.
+class PaperExchange {
+public:
+    // clock maps submission times onto exchange time; without it the local
+    // clock is assumed to agree with the exchange
+    PaperExchange(double maker_fee_pct, double taker_fee_pct, const ClockSync* clock = nullptr);
+
+    // Returns the order id, or 0 if the order was rejected. reference_price
+    // fills market orders when no book has been seen for the pair yet.
+    uint64_t submit(PaperOrder order, double reference_price);
+    bool cancel(uint64_t id);
+    void cancel_all(const std::string& pair);
+
+    // Feed market data; bids and asks best first, prints oldest first
+    void on_book(const std::string& pair, std::vector<BookLevel> bids, std::vector<BookLevel> asks);
+    void on_trades(const std::string& pair, const std::vector<TradePrint>& trades);
+
+    // Fetch prints then the book for each pair. The first call per pair only
+    // positions the trade cursor.
+    void poll(KrakenClient& client, const std::vector<std::string>& pairs, int depth);
+
+    // Fills since the last call, oldest first
+    std::vector<PaperFill> take_fills();
+
+    // Open order by id, or nullptr once filled or canceled
+    const PaperOrder* find(uint64_t id) const;
+    std::vector<PaperOrder> open_orders(const std::string& pair) const;
+
+    // Pairs with open orders
+    std::vector<std::string> active_pairs() const;
+
+private:
+    struct Market {
+        std::vector<BookLevel> bids;
+        std::vector<BookLevel> asks;
+        std::vector<PaperOrder> orders;  // Open orders, submission order
+        std::string trade_cursor;
+        bool cursor_ready = false;
+        double last_price = 0.0;
+        int64_t last_time_ns = 0;
+    };
+
+    void fill(PaperOrder& order, double price, double volume, bool maker, int64_t time_ns);
+    void take_liquidity(Market& market, PaperOrder& order, int64_t time_ns);
+    void rest(Market& market, PaperOrder& order);
+    void activate(Market& market, PaperOrder& order, int64_t time_ns);
+    void match_book(Market& market, int64_t time_ns);
+    void sweep_closed(Market& market);
+
+    double maker_fee_pct_;
+    double taker_fee_pct_;
+    const ClockSync* clock_;
+    uint64_t next_id_ = 1;
+    std::unordered_map<std::string, Market> markets_;
+    std::vector<PaperFill> fills_;
+};
+
+#endif // PAPER_EXCHANGE_HPP
@@ -0,0 +1,146 @@
+#include "kraken_client.hpp"
+#include "http_recording.hpp"
+#include "replay_workload.hpp"
+#include "logger.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+// Inspect an HTTP recording and benchmark the client's parsers on it.
+//
+//   http_replay <recording> [--bench N] [--quote ZCAD]
+//
+// Without --bench, prints per-endpoint counts, sizes, errors and recorded
+// latency. With --bench, replays every recorded public call N times at full
+// speed through KrakenClient (transport, breaker and parser included) and
+// reports the cost per call and parse throughput per endpoint.
+
+static std::string fmt(double v, const char* spec = "%.1f") {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), spec, v);
+    return buf;
+}
+
+static double percentile(std::vector<double> values, double q) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    size_t k = std::min(values.size() - 1, static_cast<size_t>(q * static_cast<double>(values.size())));
+    std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(k), values.end());
+    return values[k];
+}
+
+struct EndpointSummary {
+    uint64_t count = 0;
+    uint64_t errors = 0;
+    uint64_t bytes = 0;
+    std::vector<double> latency_ms;
+    double bench_ns = 0.0;
+    uint64_t bench_calls = 0;
+    uint64_t bench_bytes = 0;
+};
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: http_replay <recording> [--bench N] [--quote ZCAD]" << std::endl;
+        return 1;
+    }
+    std::string path = argv[1];
+    int bench_passes = 0;
+    std::string quote = "ZCAD";
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--bench" && i + 1 < argc) {
+            bench_passes = std::stoi(argv[++i]);
+        } else if (arg == "--quote" && i + 1 < argc) {
+            quote = argv[++i];
+        } else {
+            std::cerr << "http_replay: unknown option " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<HttpRecord> records;
+    try {
+        records = read_http_records(path);
+    } catch (const std::exception& e) {
+        std::cerr << "http_replay: " << e.what() << std::endl;
+        return 1;
+    }
+    if (records.empty()) {
+        std::cerr << "http_replay: " << path << " has no records" << std::endl;
+        return 1;
+    }
+
+    std::map<std::string, EndpointSummary> endpoints;
+    for (const HttpRecord& r : records) {
+        EndpointSummary& s = endpoints[r.method + " " + record_path(r.target)];
+        s.count++;
+        s.bytes += r.response.body.size();
+        if (!r.response.ok || r.response.status != 200) {
+            s.errors++;
+        }
+        s.latency_ms.push_back(static_cast<double>(r.done_ns - r.start_ns) / 1e6);
+    }
+
+    double span_s = static_cast<double>(records.back().done_ns - records.front().start_ns) / 1e9;
+    std::cout << path << ": " << records.size() << " exchanges over " << fmt(span_s) << "s" << std::endl;
+
+    if (bench_passes > 0) {
+        // Quiet the per-call logging so it does not dominate, but keep the
+        // message formatting the real code paths do
+        Logger::instance().set_level(Logger::Level::ERROR);
+
+        KrakenClient client("http://replay", 0);
+        EndpointPolicy policy;
+        policy.max_retries = 0;
+        policy.failure_threshold = INT_MAX;
+        client.set_endpoint_policy(policy);
+        client.set_transport(std::make_unique<ReplayTransport>(records, 0.0, true));
+
+        for (int pass = 0; pass < bench_passes; pass++) {
+            for (const HttpRecord& r : records) {
+                if (r.response.cancelled) {
+                    continue;
+                }
+                auto start = std::chrono::steady_clock::now();
+                if (!replay_public_call(client, r, quote)) {
+                    continue;
+                }
+                double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+                EndpointSummary& s = endpoints[r.method + " " + record_path(r.target)];
+                s.bench_ns += ns;
+                s.bench_calls++;
+                s.bench_bytes += r.response.body.size();
+            }
+        }
+    }
+
+    std::printf("%-28s %8s %7s %10s %10s %10s", "endpoint", "count", "errors", "avg bytes", "p50 ms", "p99 ms");
+    if (bench_passes > 0) {
+        std::printf(" %12s %10s", "us/call", "MB/s");
+    }
+    std::printf("\n");
+    for (auto& [name, s] : endpoints) {
+        std::printf("%-28s %8llu %7llu %10.0f %10.1f %10.1f", name.c_str(),
+                    static_cast<unsigned long long>(s.count), static_cast<unsigned long long>(s.errors),
+                    static_cast<double>(s.bytes) / static_cast<double>(s.count),
+                    percentile(s.latency_ms, 0.50), percentile(s.latency_ms, 0.99));
+        if (bench_passes > 0) {
+            if (s.bench_calls > 0) {
+                std::printf(" %12.2f %10.1f", s.bench_ns / static_cast<double>(s.bench_calls) / 1e3,
+                            static_cast<double>(s.bench_bytes) / (s.bench_ns / 1e9) / 1e6);
+            } else {
+                std::printf(" %12s %10s", "-", "-");
+            }
+        }
+        std::printf("\n");
+    }
+    return 0;
+}
@@ -0,0 +1,135 @@
+#include "replay_workload.hpp"
+#include <nlohmann/json.hpp>
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+using json = nlohmann::json;
+
+// Session clock of synthetic recordings (2025-06-15T00:00:00Z)
+static constexpr int64_t kSyntheticStartSeconds = 1749945600;
+
+std::string record_path(const std::string& target) {
+    return target.substr(0, target.find('?'));
+}
+
+// Value of key in the target's query string ("" when absent)
+static std::string query_param(const std::string& target, const std::string& key) {
+    size_t q = target.find('?');
+    while (q != std::string::npos) {
+        size_t start = q + 1;
+        size_t end = target.find('&', start);
+        std::string item = target.substr(start, end == std::string::npos ? std::string::npos : end - start);
+        if (item.compare(0, key.size() + 1, key + "=") == 0) {
+            return item.substr(key.size() + 1);
+        }
+        q = end;
+    }
+    return "";
+}
+
+bool replay_public_call(KrakenClient& client, const HttpRecord& record, const std::string& quote) {
+    const std::string path = record_path(record.target);
+    if (path == "/0/public/Ticker") {
+        std::string pairs = query_param(record.target, "pair");
+        if (pairs.find(',') == std::string::npos) {
+            client.get_ticker(pairs);
+        } else {
+            std::vector<std::string> list;
+            size_t start = 0;
+            while (start <= pairs.size()) {
+                size_t comma = pairs.find(',', start);
+                list.push_back(pairs.substr(start, comma == std::string::npos ? std::string::npos : comma - start));
+                if (comma == std::string::npos) {
+                    break;
+                }
+                start = comma + 1;
+            }
+            client.get_tickers(list);
+        }
+    } else if (path == "/0/public/Depth") {
+        std::string count = query_param(record.target, "count");
+        client.get_depth(query_param(record.target, "pair"), count.empty() ? 100 : std::stoi(count));
+    } else if (path == "/0/public/Trades") {
+        client.get_recent_trades(query_param(record.target, "pair"), query_param(record.target, "since"));
+    } else if (path == "/0/public/Time") {
+        client.get_server_time();
+    } else if (path == "/0/public/AssetPairs") {
+        client.get_asset_pairs(quote);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+static std::string price_str(double v, const char* spec = "%.1f") {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), spec, v);
+    return buf;
+}
+
+static HttpRecord synthetic_record(const std::string& target, const json& result, int64_t at_ns) {
+    HttpRecord r;
+    r.method = "GET";
+    r.target = target;
+    r.response.ok = true;
+    r.response.status = 200;
+    r.response.body = json{{"error", json::array()}, {"result", result}}.dump();
+    r.start_ns = at_ns;
+    r.response.timing.send_ns = at_ns + 100'000;
+    r.response.timing.recv_ns = at_ns + 900'000;
+    r.done_ns = at_ns + 1'000'000;
+    return r;
+}
+
+std::vector<HttpRecord> synthetic_http_session(const std::string& pair, size_t ticks, uint64_t seed,
+                                               double start_price, int book_levels, int trades_per_page) {
+    std::mt19937_64 rng(seed);
+    std::normal_distribution<double> step(0.0, 0.004);
+    std::normal_distribution<double> print_noise(0.0, 0.002);
+    std::uniform_real_distribution<double> size(0.01, 1.0);
+
+    std::vector<HttpRecord> records;
+    records.reserve(ticks * 3 + ticks / 10 + 1);
+    double price = start_price;
+    for (size_t i = 0; i < ticks; i++) {
+        const int64_t now_s = kSyntheticStartSeconds + static_cast<int64_t>(i);
+        const int64_t now_ns = now_s * 1'000'000'000;
+        price *= 1.0 + step(rng);
+
+        json ticker = {{pair, {
+            {"a", {price_str(price * 1.0002), "1", "1.000"}},
+            {"b", {price_str(price * 0.9998), "1", "1.000"}},
+            {"c", {price_str(price), "0.10000000"}},
+            {"v", {"10.5", "20.25"}},
+            {"h", {price_str(price * 1.01), price_str(price * 1.02)}},
+            {"l", {price_str(price * 0.99), price_str(price * 0.98)}},
+            {"o", price_str(price)}
+        }}};
+        records.push_back(synthetic_record("/0/public/Ticker?pair=" + pair, ticker, now_ns));
+
+        json bids = json::array();
+        json asks = json::array();
+        for (int level = 0; level < book_levels; level++) {
+            bids.push_back({price_str(price * (0.9998 - level * 0.0002)), price_str(size(rng), "%.8f"), now_s});
+            asks.push_back({price_str(price * (1.0002 + level * 0.0002)), price_str(size(rng), "%.8f"), now_s});
+        }
+        records.push_back(synthetic_record("/0/public/Depth?pair=" + pair + "&count=" + std::to_string(book_levels),
+                                           json{{pair, {{"bids", bids}, {"asks", asks}}}}, now_ns));
+
+        json prints = json::array();
+        for (int t = 0; t < trades_per_page; t++) {
+            prints.push_back({price_str(price * (1.0 + print_noise(rng))), price_str(size(rng) * 0.5, "%.8f"),
+                              static_cast<double>(now_s) - 1.0 + t * 0.01, (t % 2) ? "b" : "s", "m", "",
+                              static_cast<int64_t>(i) * trades_per_page + t});
+        }
+        records.push_back(synthetic_record("/0/public/Trades?pair=" + pair,
+                                           json{{pair, prints}, {"last", std::to_string(now_ns)}}, now_ns));
+
+        if (i % 10 == 0) {
+            records.push_back(synthetic_record("/0/public/Time",
+                                               json{{"unixtime", now_s}, {"rfc1123", ""}}, now_ns));
+        }
+    }
+    return records;
+}
@@ -0,0 +1,28 @@
+#ifndef REPLAY_WORKLOAD_HPP
+#define REPLAY_WORKLOAD_HPP
+
+#include "http_recording.hpp"
+#include "kraken_client.hpp"
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// Replayed HTTP sessions as client workloads, shared by http_replay and
+// trading_bench
+
+// Issue the client call that produced this record; false for endpoints that
+// cannot be replayed without credentials (private calls)
+bool replay_public_call(KrakenClient& client, const HttpRecord& record, const std::string& quote);
+
+// Deterministic public market data session for one pair: per tick a Ticker,
+// a Depth of book_levels per side and a Trades page of trades_per_page
+// prints, plus a Time call every tenth tick. Prices follow a seeded random
+// walk from start_price, so the strategy sees entries and exits.
+std::vector<HttpRecord> synthetic_http_session(const std::string& pair, size_t ticks, uint64_t seed,
+                                               double start_price = 90000.0, int book_levels = 100,
+                                               int trades_per_page = 100);
+
+// "/0/public/Depth" from "/0/public/Depth?pair=X&count=10"
+std::string record_path(const std::string& target);
+
+#endif // REPLAY_WORKLOAD_HPP
@@ -0,0 +1,142 @@
+#include "request_template.hpp"
+#include <openssl/evp.h>
+#include <openssl/crypto.h>
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+
+static constexpr size_t kSha512Block = 128;
+static constexpr size_t kSha256Size = 32;
+// base64 of a 64-byte digest
+static constexpr size_t kSignatureChars = 88;
+
+void base64_encode_into(const unsigned char* data, size_t len, char* out) {
+    static constexpr char kTable[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    size_t i = 0;
+    for (; i + 3 <= len; i += 3) {
+        uint32_t v = (static_cast<uint32_t>(data[i]) << 16) | (static_cast<uint32_t>(data[i + 1]) << 8) | data[i + 2];
+        *out++ = kTable[(v >> 18) & 0x3f];
+        *out++ = kTable[(v >> 12) & 0x3f];
+        *out++ = kTable[(v >> 6) & 0x3f];
+        *out++ = kTable[v & 0x3f];
+    }
+    if (i < len) {
+        uint32_t v = static_cast<uint32_t>(data[i]) << 16;
+        if (i + 1 < len) {
+            v |= static_cast<uint32_t>(data[i + 1]) << 8;
+        }
+        *out++ = kTable[(v >> 18) & 0x3f];
+        *out++ = kTable[(v >> 12) & 0x3f];
+        *out++ = i + 1 < len ? kTable[(v >> 6) & 0x3f] : '=';
+        *out++ = '=';
+    }
+}
+
+// Digests are fetched explicitly: EVP_sha512()/EVP_sha256() would repeat the
+// provider lookup on every init
+HmacSha512::HmacSha512(const std::string& key_raw) {
+    EVP_MD* md = EVP_MD_fetch(nullptr, "SHA512", nullptr);
+    if (md == nullptr) {
+        throw std::runtime_error("SHA-512 is not available");
+    }
+    unsigned char key[kSha512Block] = {};
+    if (key_raw.size() > kSha512Block) {
+        unsigned int len = 0;
+        EVP_Digest(key_raw.data(), key_raw.size(), key, &len, md, nullptr);
+    } else {
+        std::memcpy(key, key_raw.data(), key_raw.size());
+    }
+
+    unsigned char ipad[kSha512Block];
+    unsigned char opad[kSha512Block];
+    for (size_t i = 0; i < kSha512Block; i++) {
+        ipad[i] = key[i] ^ 0x36;
+        opad[i] = key[i] ^ 0x5c;
+    }
+    OPENSSL_cleanse(key, sizeof(key));
+
+    inner_ = EVP_MD_CTX_new();
+    outer_ = EVP_MD_CTX_new();
+    work_ = EVP_MD_CTX_new();
+    if (inner_ == nullptr || outer_ == nullptr || work_ == nullptr ||
+        EVP_DigestInit_ex(inner_, md, nullptr) != 1 || EVP_DigestUpdate(inner_, ipad, sizeof(ipad)) != 1 ||
+        EVP_DigestInit_ex(outer_, md, nullptr) != 1 || EVP_DigestUpdate(outer_, opad, sizeof(opad)) != 1) {
+        EVP_MD_free(md);
+        throw std::runtime_error("Failed to initialize HMAC-SHA512");
+    }
+    // The contexts hold their own reference
+    EVP_MD_free(md);
+    OPENSSL_cleanse(ipad, sizeof(ipad));
+    OPENSSL_cleanse(opad, sizeof(opad));
+}
+
+HmacSha512::~HmacSha512() {
+    EVP_MD_CTX_free(inner_);
+    EVP_MD_CTX_free(outer_);
+    EVP_MD_CTX_free(work_);
+}
+
+void HmacSha512::sign(const unsigned char* data, size_t len, unsigned char out[kDigestSize]) {
+    unsigned char inner_hash[kDigestSize];
+    unsigned int n = 0;
+    EVP_MD_CTX_copy_ex(work_, inner_);
+    EVP_DigestUpdate(work_, data, len);
+    EVP_DigestFinal_ex(work_, inner_hash, &n);
+    EVP_MD_CTX_copy_ex(work_, outer_);
+    EVP_DigestUpdate(work_, inner_hash, sizeof(inner_hash));
+    EVP_DigestFinal_ex(work_, out, &n);
+}
+
+PrivateRequestTemplate::PrivateRequestTemplate(const std::string& api_base, const std::string& uri_path,
+                                               const std::string& api_key, std::shared_ptr<HmacSha512> hmac)
+    : uri_path_(uri_path)
+    , hmac_(std::move(hmac)) {
+    sha256_md_ = EVP_MD_fetch(nullptr, "SHA256", nullptr);
+    sha256_ = EVP_MD_CTX_new();
+    if (sha256_md_ == nullptr || sha256_ == nullptr) {
+        throw std::runtime_error("Failed to allocate SHA-256 context");
+    }
+
+    request_.method = "POST";
+    request_.url = api_base + uri_path;
+    request_.header_lines.push_back("API-Key: " + api_key);
+    request_.header_lines.push_back("API-Sign: " + std::string(kSignatureChars, 'A'));
+    sign_line_ = request_.header_lines.size() - 1;
+    sign_offset_ = std::strlen("API-Sign: ");
+    request_.body.reserve(256);
+
+    hmac_input_ = uri_path + std::string(kSha256Size, '\0');
+}
+
+PrivateRequestTemplate::~PrivateRequestTemplate() {
+    EVP_MD_CTX_free(sha256_);
+    EVP_MD_free(sha256_md_);
+}
+
+HttpRequest& PrivateRequestTemplate::build(uint64_t nonce, std::string_view params) {
+    char digits[24];
+    auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), nonce);
+    (void)ec;
+    const std::string_view nonce_str(digits, static_cast<size_t>(end - digits));
+
+    std::string& body = request_.body;
+    body.assign("nonce=");
+    body.append(nonce_str);
+    if (!params.empty()) {
+        body.push_back('&');
+        body.append(params);
+    }
+
+    // API-Sign = base64(HMAC-SHA512(secret, uri_path + SHA256(nonce + postdata)))
+    unsigned char* digest = reinterpret_cast<unsigned char*>(hmac_input_.data() + uri_path_.size());
+    unsigned int n = 0;
+    EVP_DigestInit_ex(sha256_, sha256_md_, nullptr);
+    EVP_DigestUpdate(sha256_, nonce_str.data(), nonce_str.size());
+    EVP_DigestUpdate(sha256_, body.data(), body.size());
+    EVP_DigestFinal_ex(sha256_, digest, &n);
+
+    unsigned char mac[HmacSha512::kDigestSize];
+    hmac_->sign(reinterpret_cast<const unsigned char*>(hmac_input_.data()), hmac_input_.size(), mac);
+    base64_encode_into(mac, sizeof(mac), request_.header_lines[sign_line_].data() + sign_offset_);
+    return request_;
+}
@@ -0,0 +1,69 @@
+#ifndef REQUEST_TEMPLATE_HPP
+#define REQUEST_TEMPLATE_HPP
+
+#include "http_transport.hpp"
+#include <string>
+#include <string_view>
+#include <memory>
+#include <cstdint>
+
+struct evp_md_ctx_st;
+struct evp_md_st;
+
+// HMAC-SHA512 under a fixed key. The key's inner and outer pad blocks are
+// hashed once; each signature copies those states and runs one compression
+// per side.
+class HmacSha512 {
+public:
+    static constexpr size_t kDigestSize = 64;
+
+    explicit HmacSha512(const std::string& key_raw);
+    ~HmacSha512();
+
+    HmacSha512(const HmacSha512&) = delete;
+    HmacSha512& operator=(const HmacSha512&) = delete;
+
+    void sign(const unsigned char* data, size_t len, unsigned char out[kDigestSize]);
+
+private:
+    evp_md_ctx_st* inner_ = nullptr;
+    evp_md_ctx_st* outer_ = nullptr;
+    evp_md_ctx_st* work_ = nullptr;
+};
+
+// One signed private endpoint. The URL, the header lines (API-Key, a
+// fixed-width API-Sign placeholder) and the postdata prefix are built once;
+// build() writes the nonce, parameters and signature into the same buffers,
+// so once they have grown to fit, a call does not allocate. Not thread-safe:
+// one template per endpoint, used from the thread that owns the client.
+class PrivateRequestTemplate {
+public:
+    PrivateRequestTemplate(const std::string& api_base, const std::string& uri_path,
+                           const std::string& api_key, std::shared_ptr<HmacSha512> hmac);
+    ~PrivateRequestTemplate();
+
+    PrivateRequestTemplate(const PrivateRequestTemplate&) = delete;
+    PrivateRequestTemplate& operator=(const PrivateRequestTemplate&) = delete;
+
+    // params is url-encoded "key=value&..." without the nonce (may be empty).
+    // The returned request stays valid until the next build().
+    HttpRequest& build(uint64_t nonce, std::string_view params);
+
+    const std::string& uri_path() const { return uri_path_; }
+
+private:
+    std::string uri_path_;
+    std::shared_ptr<HmacSha512> hmac_;
+    evp_md_ctx_st* sha256_ = nullptr;
+    evp_md_st* sha256_md_ = nullptr;
+
+    HttpRequest request_;
+    size_t sign_line_ = 0;        // Index of the API-Sign line
+    size_t sign_offset_ = 0;      // Signature start within that line
+    std::string hmac_input_;      // uri_path + SHA256(nonce + postdata)
+};
+
+// Standard base64 of len bytes into out (4 * ceil(len / 3) chars, no NUL)
+void base64_encode_into(const unsigned char* data, size_t len, char* out);
+
+#endif // REQUEST_TEMPLATE_HPP
@@ -0,0 +1,178 @@
+#include "config.hpp"
+#include "logger.hpp"
+#include "risk_sim.hpp"
+#include "trade_ledger.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Monte Carlo risk of ruin for the current position sizing.
+//
+//   risk_sim [options] [ledger.jsonl ...]
+//
+// Bootstraps round-trip returns from the trade ledger (live, dry-run or
+// backtest runs that set ledger_file) and reports ruin probability and
+// drawdown percentiles at the configured sizing and at fractional Kelly.
+
+static void usage() {
+    std::cerr << "Usage: risk_sim [options] [ledger.jsonl ...]\n"
+              << "  --config <file>       Config for current sizing (default config.json)\n"
+              << "  --paths <n>           Simulated paths (default 1000000)\n"
+              << "  --trades <n>          Trades per path (default 250)\n"
+              << "  --ruin-pct <p>        Drawdown counted as ruin (default 0.5)\n"
+              << "  --kelly-mult <k>      Fractional Kelly to recommend (default 0.5)\n"
+              << "  --threads <n>         Worker threads (default: all cores)\n"
+              << "  --seed <n>            RNG seed (default 42)\n"
+              << "Ledgers default to the config's ledger_file." << std::endl;
+}
+
+static std::string pct(double v) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.2f%%", v * 100.0);
+    return buf;
+}
+
+static std::string num(double v) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.3f", v);
+    return buf;
+}
+
+static void log_report(const RiskReport& r) {
+    LOG_INFO(r.label + ": position " + pct(r.position_fraction) + " of equity (risk_per_trade_pct " +
+             num(r.risk_per_trade_pct) + ")");
+    LOG_INFO("  Risk of ruin:      " + pct(r.risk_of_ruin));
+    LOG_INFO("  Max drawdown:      p50 " + pct(r.drawdown_p50) + ", p90 " + pct(r.drawdown_p90) +
+             ", p99 " + pct(r.drawdown_p99));
+    LOG_INFO("  Final equity (x):  p05 " + num(r.final_p05) + ", p50 " + num(r.final_p50) +
+             ", p95 " + num(r.final_p95));
+    LOG_INFO("  Simulated in " + num(r.elapsed_ms) + " ms");
+}
+
+int main(int argc, char* argv[]) {
+    RiskSimOptions options;
+    std::string config_file = "config.json";
+    std::vector<std::string> ledgers;
+
+    try {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            auto value = [&]() -> std::string {
+                if (i + 1 >= argc) {
+                    throw std::runtime_error("missing value for " + arg);
+                }
+                return argv[++i];
+            };
+            if (arg == "--config") {
+                config_file = value();
+            } else if (arg == "--paths") {
+                options.paths = std::stoull(value());
+            } else if (arg == "--trades") {
+                options.trades_per_path = std::stoi(value());
+            } else if (arg == "--ruin-pct") {
+                options.ruin_drawdown = std::stod(value());
+            } else if (arg == "--kelly-mult") {
+                options.kelly_multiplier = std::stod(value());
+            } else if (arg == "--threads") {
+                options.threads = std::stoi(value());
+            } else if (arg == "--seed") {
+                options.seed = std::stoull(value());
+            } else if (arg == "-h" || arg == "--help") {
+                usage();
+                return 0;
+            } else if (!arg.empty() && arg[0] == '-') {
+                throw std::runtime_error("unknown option " + arg);
+            } else {
+                ledgers.push_back(arg);
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "risk_sim: " << e.what() << std::endl;
+        usage();
+        return 1;
+    }
+
+    if (options.paths == 0 || options.trades_per_path <= 0 ||
+        options.ruin_drawdown <= 0.0 || options.ruin_drawdown >= 1.0 ||
+        options.kelly_multiplier <= 0.0) {
+        std::cerr << "risk_sim: paths and trades must be positive, ruin-pct in (0, 1), kelly-mult > 0" << std::endl;
+        return 1;
+    }
+
+    Config config;
+    try {
+        config = Config::load(config_file);
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to load config: " << e.what() << std::endl;
+        return 1;
+    }
+    Logger::instance().init(config.log_dir, "risk_sim.log");
+
+    if (ledgers.empty()) {
+        ledgers.push_back(config.ledger_file);
+    }
+
+    std::vector<LedgerEntry> entries;
+    for (const auto& path : ledgers) {
+        auto loaded = TradeLedger::load(path);
+        LOG_INFO("Loaded " + std::to_string(loaded.size()) + " fills from " + path);
+        entries.insert(entries.end(), loaded.begin(), loaded.end());
+    }
+
+    auto returns = round_trip_returns(entries);
+    if (returns.size() < 2) {
+        LOG_ERROR("Need at least 2 round trips to bootstrap, have " + std::to_string(returns.size()));
+        return 1;
+    }
+
+    double wins = 0.0;
+    double mean = 0.0;
+    for (double r : returns) {
+        wins += r > 0.0 ? 1.0 : 0.0;
+        mean += r;
+    }
+    mean /= static_cast<double>(returns.size());
+    LOG_INFO(std::to_string(returns.size()) + " round trips, win rate " +
+             pct(wins / static_cast<double>(returns.size())) + ", mean return " + pct(mean));
+    LOG_INFO("Simulating " + std::to_string(options.paths) + " paths x " +
+             std::to_string(options.trades_per_path) + " trades, ruin at -" + pct(options.ruin_drawdown));
+
+    // calculate_sizing maps risk_per_trade_pct to a position fraction via the
+    // stop distance, so Kelly fractions convert back the same way
+    auto to_risk_pct = [&](double fraction) { return fraction * config.stop_loss_pct; };
+
+    double kelly = kelly_fraction(returns);
+    double fractional = std::min(kelly * options.kelly_multiplier, sizing_fraction(config));
+
+    struct Candidate {
+        std::string label;
+        double fraction;
+    };
+    std::vector<Candidate> candidates = {
+        {"Current sizing", sizing_fraction(config)},
+        {"Fractional Kelly (" + num(options.kelly_multiplier) + "x)", fractional},
+        {"Full Kelly", kelly},
+    };
+
+    for (const auto& c : candidates) {
+        RiskReport report = simulate_paths(returns, c.fraction, options);
+        report.label = c.label;
+        report.risk_per_trade_pct = &c == &candidates.front() ? config.risk_per_trade_pct : to_risk_pct(c.fraction);
+        log_report(report);
+    }
+
+    if (kelly <= 0.0) {
+        LOG_WARNING("Ledger has no edge (Kelly fraction is 0) - do not size up");
+    } else {
+        LOG_INFO("Recommended risk_per_trade_pct: " + num(to_risk_pct(fractional)) +
+                 " (current " + num(config.risk_per_trade_pct) + ")");
+        if (fractional >= sizing_fraction(config)) {
+            LOG_INFO("Position size is already capped by max_position_pct/min_cad_required_pct");
+        }
+    }
+    return 0;
+}
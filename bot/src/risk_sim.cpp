@@ -0,0 +1,207 @@
+#include "risk_sim.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <map>
+#include <thread>
+#include <utility>
+
+std::vector<double> round_trip_returns(const std::vector<LedgerEntry>& entries) {
+    // (pair, entry_time) -> (pnl, cost), in order of first fill
+    std::map<std::pair<std::string, int64_t>, std::pair<double, double>> trips;
+    std::vector<std::pair<std::string, int64_t>> order;
+    for (const auto& e : entries) {
+        if (e.entry_price <= 0.0 || e.volume <= 0.0) {
+            continue;
+        }
+        auto key = std::make_pair(e.pair, e.entry_time);
+        auto [it, inserted] = trips.try_emplace(key, 0.0, 0.0);
+        if (inserted) {
+            order.push_back(key);
+        }
+        it->second.first += e.pnl_cad;
+        it->second.second += e.volume * e.entry_price;
+    }
+
+    std::vector<double> returns;
+    returns.reserve(order.size());
+    for (const auto& key : order) {
+        const auto& [pnl, cost] = trips[key];
+        returns.push_back(pnl / cost);
+    }
+    return returns;
+}
+
+double sizing_fraction(const Config& config) {
+    double fraction = config.stop_loss_pct > 0 ? config.risk_per_trade_pct / config.stop_loss_pct : 0.0;
+    fraction = std::min(fraction, config.max_position_pct);
+    // position + fee buffer must fit in available CAD
+    return std::min(fraction, 1.0 - config.min_cad_required_pct);
+}
+
+double kelly_fraction(const std::vector<double>& returns) {
+    if (returns.empty()) {
+        return 0.0;
+    }
+    double worst = *std::min_element(returns.begin(), returns.end());
+    double hi = worst < 0.0 ? std::min(1.0, -0.999 / worst) : 1.0;
+
+    auto growth = [&](double f) {
+        double sum = 0.0;
+        for (double r : returns) {
+            sum += std::log1p(f * r);
+        }
+        return sum / static_cast<double>(returns.size());
+    };
+
+    // Mean log growth is concave in f
+    double lo = 0.0;
+    for (int iter = 0; iter < 100; iter++) {
+        double m1 = lo + (hi - lo) / 3.0;
+        double m2 = hi - (hi - lo) / 3.0;
+        if (growth(m1) < growth(m2)) {
+            lo = m1;
+        } else {
+            hi = m2;
+        }
+    }
+    return (lo + hi) / 2.0;
+}
+
+namespace {
+
+constexpr size_t kLanes = 16;
+
+uint64_t splitmix64(uint64_t& x) {
+    uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+struct BlockOutput {
+    float max_drawdown[kLanes];
+    float final_equity[kLanes];
+    uint8_t ruined[kLanes];
+};
+
+// kLanes independent paths with one xoshiro256+ generator per lane, laid out
+// so every inner loop runs across lanes and vectorizes (including the
+// outcome gather). Cloned per ISA and dispatched at load time.
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(__clang__)
+__attribute__((target_clones("avx512f", "avx2", "default")))
+#endif
+void simulate_block(const double* returns, uint32_t count, double fraction, int trades,
+                    double ruin_level, uint64_t seed, BlockOutput& out) {
+    uint64_t s0[kLanes], s1[kLanes], s2[kLanes], s3[kLanes];
+    for (size_t l = 0; l < kLanes; l++) {
+        s0[l] = splitmix64(seed);
+        s1[l] = splitmix64(seed);
+        s2[l] = splitmix64(seed);
+        s3[l] = splitmix64(seed);
+    }
+
+    double equity[kLanes], peak[kLanes], max_dd[kLanes];
+    uint64_t ruined[kLanes];
+    for (size_t l = 0; l < kLanes; l++) {
+        equity[l] = 1.0;
+        peak[l] = 1.0;
+        max_dd[l] = 0.0;
+        ruined[l] = 0;
+    }
+
+    for (int t = 0; t < trades; t++) {
+        uint64_t index[kLanes];
+        for (size_t l = 0; l < kLanes; l++) {
+            uint64_t r = s0[l] + s3[l];
+            uint64_t tmp = s1[l] << 17;
+            s2[l] ^= s0[l];
+            s3[l] ^= s1[l];
+            s1[l] ^= s2[l];
+            s0[l] ^= s3[l];
+            s2[l] ^= tmp;
+            s3[l] = (s3[l] << 45) | (s3[l] >> 19);
+            // Top 32 bits scaled to [0, count)
+            index[l] = ((r >> 32) * count) >> 32;
+        }
+        for (size_t l = 0; l < kLanes; l++) {
+            equity[l] *= 1.0 + fraction * returns[index[l]];
+            peak[l] = std::max(peak[l], equity[l]);
+            max_dd[l] = std::max(max_dd[l], 1.0 - equity[l] / peak[l]);
+            ruined[l] |= equity[l] <= ruin_level ? 1 : 0;
+        }
+    }
+
+    for (size_t l = 0; l < kLanes; l++) {
+        out.max_drawdown[l] = static_cast<float>(max_dd[l]);
+        out.final_equity[l] = static_cast<float>(equity[l]);
+        out.ruined[l] = static_cast<uint8_t>(ruined[l]);
+    }
+}
+
+double percentile(std::vector<float>& values, double q) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    size_t k = std::min(values.size() - 1, static_cast<size_t>(q * static_cast<double>(values.size())));
+    std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(k), values.end());
+    return values[k];
+}
+
+} // namespace
+
+RiskReport simulate_paths(const std::vector<double>& returns, double position_fraction,
+                          const RiskSimOptions& options) {
+    auto start = std::chrono::steady_clock::now();
+    RiskReport report;
+    report.position_fraction = position_fraction;
+    if (returns.empty() || options.paths == 0) {
+        return report;
+    }
+
+    const size_t blocks = (options.paths + kLanes - 1) / kLanes;
+    const size_t paths = blocks * kLanes;
+    std::vector<float> max_dd(paths);
+    std::vector<float> final_equity(paths);
+    std::vector<uint8_t> ruined(paths);
+    const double ruin_level = 1.0 - options.ruin_drawdown;
+
+    std::atomic<size_t> next_block{0};
+    auto worker = [&]() {
+        BlockOutput out;
+        for (size_t b = next_block.fetch_add(1); b < blocks; b = next_block.fetch_add(1)) {
+            // Seeded per block so results do not depend on the thread count
+            simulate_block(returns.data(), static_cast<uint32_t>(returns.size()), position_fraction,
+                           options.trades_per_path, ruin_level, options.seed ^ (b * 0x9e3779b97f4a7c15ULL), out);
+            std::copy(out.max_drawdown, out.max_drawdown + kLanes, max_dd.begin() + static_cast<std::ptrdiff_t>(b * kLanes));
+            std::copy(out.final_equity, out.final_equity + kLanes, final_equity.begin() + static_cast<std::ptrdiff_t>(b * kLanes));
+            std::copy(out.ruined, out.ruined + kLanes, ruined.begin() + static_cast<std::ptrdiff_t>(b * kLanes));
+        }
+    };
+
+    int threads = options.threads > 0 ? options.threads : static_cast<int>(std::thread::hardware_concurrency());
+    threads = std::max(1, threads);
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; t++) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : pool) {
+        thread.join();
+    }
+
+    size_t ruin_count = 0;
+    for (uint8_t r : ruined) {
+        ruin_count += r;
+    }
+    report.risk_of_ruin = static_cast<double>(ruin_count) / static_cast<double>(paths);
+    report.drawdown_p50 = percentile(max_dd, 0.50);
+    report.drawdown_p90 = percentile(max_dd, 0.90);
+    report.drawdown_p99 = percentile(max_dd, 0.99);
+    report.final_p05 = percentile(final_equity, 0.05);
+    report.final_p50 = percentile(final_equity, 0.50);
+    report.final_p95 = percentile(final_equity, 0.95);
+    report.elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return report;
+}
@@ -0,0 +1,48 @@
+#ifndef RISK_SIM_HPP
+#define RISK_SIM_HPP
+
+#include "config.hpp"
+#include "trade_ledger.hpp"
+#include <string>
+#include <vector>
+#include <cstdint>
+
+struct RiskSimOptions {
+    uint64_t paths = 1'000'000;
+    int trades_per_path = 250;
+    double ruin_drawdown = 0.5;      // Ruin = equity down this much from the start
+    double kelly_multiplier = 0.5;   // Fractional Kelly to recommend
+    int threads = 0;                 // 0 = hardware concurrency
+    uint64_t seed = 42;
+};
+
+struct RiskReport {
+    std::string label;
+    double position_fraction = 0.0;  // Position size as a fraction of equity
+    double risk_per_trade_pct = 0.0; // Same sizing in calculate_sizing terms
+    double risk_of_ruin = 0.0;
+    double drawdown_p50 = 0.0;       // Max drawdown percentiles across paths
+    double drawdown_p90 = 0.0;
+    double drawdown_p99 = 0.0;
+    double final_p05 = 0.0;          // Final equity multiple percentiles
+    double final_p50 = 0.0;
+    double final_p95 = 0.0;
+    double elapsed_ms = 0.0;
+};
+
+// Net return on the position for each round trip (fills grouped by pair and
+// entry time, total P&L over total cost basis)
+std::vector<double> round_trip_returns(const std::vector<LedgerEntry>& entries);
+
+// Position fraction produced by calculate_sizing for this config:
+// min(risk_per_trade_pct / stop_loss_pct, max_position_pct), less the fee buffer
+double sizing_fraction(const Config& config);
+
+// f maximizing the mean log growth over the sampled returns, capped at 1
+double kelly_fraction(const std::vector<double>& returns);
+
+// Bootstrap paths of trades_per_path outcomes at a fixed position fraction
+RiskReport simulate_paths(const std::vector<double>& returns, double position_fraction,
+                          const RiskSimOptions& options);
+
+#endif // RISK_SIM_HPP
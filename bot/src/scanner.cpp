@@ -0,0 +1,257 @@
+#include "scanner.hpp"
+#include "strategy.hpp"
+#include "logger.hpp"
+#include "indicator_kernels.hpp"
+#include "util.hpp"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <iomanip>
+
+Scanner::Scanner(const Config& config, KrakenClient& client)
+    : config_(config)
+    , client_(client) {
+}
+
+void Scanner::resize(size_t n) {
+    const size_t long_w = static_cast<size_t>(config_.trend_window_long);
+    const size_t atr_w = static_cast<size_t>(config_.atr_window);
+
+    last_.assign(n, 0.0);
+    bid_.assign(n, 0.0);
+    ask_.assign(n, 0.0);
+    timestamp_.assign(n, 0);
+    receive_ns_.assign(n, 0);
+    exchange_ns_.assign(n, 0);
+    first_sample_.assign(n, -1);
+    spread_pct_.assign(n, 0.0);
+    atr_.assign(n, 0.0);
+    sma_short_.assign(n, 0.0);
+    sma_long_.assign(n, 0.0);
+    tr_sum_.assign(n, 0.0);
+    short_sum_.assign(n, 0.0);
+    long_sum_.assign(n, 0.0);
+    price_ring_.assign(long_w * n, 0.0);
+    tr_ring_.assign(atr_w * n, 0.0);
+    samples_ = 0;
+}
+
+bool Scanner::discover() {
+    std::vector<std::string> universe = config_.scanner_pairs;
+
+    if (universe.empty()) {
+        AssetPairsResult pairs = client_.get_asset_pairs(config_.scanner_quote);
+        if (!pairs.success) {
+            LOG_ERROR("Scanner: pair discovery failed: " + pairs.error);
+            return false;
+        }
+        universe = std::move(pairs.pairs);
+        std::sort(universe.begin(), universe.end());
+    }
+
+    if (static_cast<int>(universe.size()) > config_.scanner_max_pairs) {
+        LOG_WARNING("Scanner: truncating universe from " + std::to_string(universe.size()) +
+                    " to " + std::to_string(config_.scanner_max_pairs) + " pairs");
+        universe.resize(static_cast<size_t>(config_.scanner_max_pairs));
+    }
+
+    if (universe.empty()) {
+        LOG_ERROR("Scanner: no pairs to scan");
+        return false;
+    }
+
+    pairs_ = std::move(universe);
+    index_.clear();
+    for (size_t i = 0; i < pairs_.size(); i++) {
+        index_[pairs_[i]] = i;
+    }
+    resize(pairs_.size());
+    ranking_.clear();
+
+    LOG_INFO("Scanner: tracking " + std::to_string(pairs_.size()) + " pairs");
+    return true;
+}
+
+bool Scanner::scan(const SnapshotTable& table) {
+    if (pairs_.empty()) {
+        return false;
+    }
+
+    size_t updated = 0;
+    for (size_t i = 0; i < pairs_.size(); i++) {
+        const MarketSnapshot* snap = table.find(pairs_[i]);
+        if (snap == nullptr || snap->timestamp == 0) {
+            continue;
+        }
+        last_[i] = snap->last_price;
+        bid_[i] = snap->bid_price;
+        ask_[i] = snap->ask_price;
+        timestamp_[i] = snap->timestamp;
+        receive_ns_[i] = snap->receive_ns;
+        exchange_ns_[i] = snap->exchange_ns;
+        updated++;
+    }
+
+    if (updated == 0) {
+        return false;
+    }
+
+    // Pairs missing from this tick carry their previous price forward so every
+    // ring slot stays aligned across pairs
+    update_indicators();
+    rank();
+    return true;
+}
+
+void Scanner::update_indicators() {
+    const size_t n = pairs_.size();
+    const size_t long_w = static_cast<size_t>(config_.trend_window_long);
+    const size_t short_w = static_cast<size_t>(config_.trend_window_short);
+    const size_t atr_w = static_cast<size_t>(config_.atr_window);
+    const double* last = last_.data();
+
+    // True range against the previous sample
+    if (samples_ > 0) {
+        const double* prev = &price_ring_[static_cast<size_t>((samples_ - 1) % static_cast<int64_t>(long_w)) * n];
+        double* tr = &tr_ring_[static_cast<size_t>((samples_ - 1) % static_cast<int64_t>(atr_w)) * n];
+        kernels::abs_change(tr, last, prev, n);
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        if (first_sample_[i] < 0 && last[i] > 0.0) {
+            first_sample_[i] = samples_;
+        }
+    }
+
+    double* slot = &price_ring_[static_cast<size_t>(samples_ % static_cast<int64_t>(long_w)) * n];
+    std::copy(last, last + n, slot);
+    samples_++;
+
+    // ATR: mean of the last atr_window true ranges, oldest first
+    const int64_t tr_count = std::min<int64_t>(samples_ - 1, static_cast<int64_t>(atr_w));
+    if (tr_count > 0) {
+        std::fill(tr_sum_.begin(), tr_sum_.end(), 0.0);
+        double* sum = tr_sum_.data();
+        const int64_t first = samples_ - 1 - tr_count;
+        for (int64_t k = 0; k < tr_count; k++) {
+            const double* tr = &tr_ring_[static_cast<size_t>((first + k) % static_cast<int64_t>(atr_w)) * n];
+            kernels::add_rows(sum, tr, n);
+        }
+        kernels::divide(atr_.data(), sum, static_cast<double>(tr_count), n);
+    }
+
+    // SMAs over a full long window, oldest first
+    if (samples_ >= static_cast<int64_t>(long_w)) {
+        std::fill(short_sum_.begin(), short_sum_.end(), 0.0);
+        std::fill(long_sum_.begin(), long_sum_.end(), 0.0);
+        double* short_sum = short_sum_.data();
+        double* long_sum = long_sum_.data();
+        const int64_t first = samples_ - static_cast<int64_t>(long_w);
+        for (size_t k = 0; k < long_w; k++) {
+            const double* p = &price_ring_[static_cast<size_t>((first + static_cast<int64_t>(k)) %
+                                                               static_cast<int64_t>(long_w)) * n];
+            kernels::add_rows(long_sum, p, n);
+            if (k >= long_w - short_w) {
+                kernels::add_rows(short_sum, p, n);
+            }
+        }
+        kernels::divide(sma_long_.data(), long_sum, static_cast<double>(long_w), n);
+        kernels::divide(sma_short_.data(), short_sum, static_cast<double>(short_w), n);
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        double mid = (bid_[i] + ask_[i]) / 2.0;
+        bool valid = bid_[i] > 0.0 && ask_[i] > 0.0 && ask_[i] >= bid_[i] && mid > 0.0;
+        spread_pct_[i] = valid ? (ask_[i] - bid_[i]) / mid : 0.0;
+    }
+}
+
+void Scanner::rank() {
+    const size_t n = pairs_.size();
+    const int64_t long_w = config_.trend_window_long;
+
+    ranking_.clear();
+    ranking_.reserve(n);
+
+    for (size_t i = 0; i < n; i++) {
+        ScanCandidate c;
+        c.index = i;
+        c.pair = pairs_[i];
+        c.last_price = last_[i];
+        c.spread_pct = spread_pct_[i];
+        c.atr_pct = last_[i] > 0.0 ? atr_[i] / last_[i] : 0.0;
+        c.trend_pct = sma_long_[i] > 0.0 ? sma_short_[i] / sma_long_[i] - 1.0 : 0.0;
+
+        if (last_[i] <= 0.0) {
+            c.reason = "No price";
+        } else if (first_sample_[i] < 0 || samples_ - first_sample_[i] < long_w) {
+            c.reason = "Warming up";
+        } else if (config_.max_spread_pct > 0 && c.spread_pct > config_.max_spread_pct) {
+            c.reason = "Spread too wide";
+        } else if (config_.min_atr_pct > 0 && c.atr_pct < config_.min_atr_pct) {
+            c.reason = "Volatility too low";
+        } else if (config_.require_trend_up &&
+                   (sma_short_[i] <= 0 || sma_long_[i] <= 0 || sma_short_[i] < sma_long_[i])) {
+            c.reason = "Trend down";
+        } else {
+            c.eligible = true;
+        }
+
+        // Volatility net of the entry cost, plus upward momentum
+        c.score = c.atr_pct - c.spread_pct + std::max(0.0, c.trend_pct);
+        ranking_.push_back(std::move(c));
+    }
+
+    std::sort(ranking_.begin(), ranking_.end(), [](const ScanCandidate& a, const ScanCandidate& b) {
+        if (a.eligible != b.eligible) return a.eligible;
+        return a.score > b.score;
+    });
+}
+
+bool Scanner::fill_context(const std::string& pair, TradeContext& ctx) const {
+    auto it = index_.find(pair);
+    if (it == index_.end()) {
+        return false;
+    }
+    size_t i = it->second;
+    if (last_[i] <= 0.0) {
+        return false;
+    }
+
+    ctx.pair = pair;
+    ctx.current_price = last_[i];
+    ctx.bid_price = bid_[i];
+    ctx.ask_price = ask_[i];
+    ctx.price_timestamp = timestamp_[i];
+    ctx.price_receive_ns = receive_ns_[i];
+    ctx.price_exchange_ns = exchange_ns_[i];
+    ctx.spread_pct = spread_pct_[i];
+    ctx.atr = atr_[i];
+    ctx.sma_short = sma_short_[i];
+    ctx.sma_long = sma_long_[i];
+    return true;
+}
+
+void Scanner::log_ranking(int top_n) const {
+    size_t eligible = 0;
+    for (const auto& c : ranking_) {
+        if (c.eligible) eligible++;
+    }
+
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(4);
+    oss << "Scanner | pairs=" << pairs_.size() << " | eligible=" << eligible;
+
+    size_t limit = std::min(ranking_.size(), static_cast<size_t>(top_n));
+    for (size_t k = 0; k < limit; k++) {
+        const auto& c = ranking_[k];
+        oss << "\n  #" << (k + 1) << " " << c.pair
+            << " score=" << c.score
+            << " atr%=" << (c.atr_pct * 100)
+            << " spread%=" << (c.spread_pct * 100)
+            << " trend%=" << (c.trend_pct * 100)
+            << (c.eligible ? "" : " [" + c.reason + "]");
+    }
+
+    LOG_INFO(oss.str());
+}
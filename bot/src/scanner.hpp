@@ -0,0 +1,93 @@
+#ifndef SCANNER_HPP
+#define SCANNER_HPP
+
+#include "config.hpp"
+#include "kraken_client.hpp"
+#include "market_data.hpp"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+struct TradeContext;
+
+// One ranked row of the scanner output
+struct ScanCandidate {
+    size_t index = 0;           // Row in the scanner's per-pair arrays
+    std::string pair;
+    double score = 0.0;
+    double last_price = 0.0;
+    double spread_pct = 0.0;
+    double atr_pct = 0.0;
+    double trend_pct = 0.0;     // sma_short / sma_long - 1
+    bool eligible = false;
+    std::string reason;         // Why the pair failed the market filters
+};
+
+// Evaluates the entry filters (spread, ATR, trend) for every pair in the
+// universe on each tick and ranks them. Indicator state is laid out
+// struct-of-arrays: one contiguous array per field, indexed by pair, so the
+// per-tick updates are plain loops across pairs that the compiler vectorizes.
+// Window sums are accumulated oldest-to-newest exactly like
+// Strategy::update_indicators, so a scanned pair sees the same SMA/ATR values
+// the single-pair path would compute.
+class Scanner {
+public:
+    Scanner(const Config& config, KrakenClient& client);
+
+    // Build the pair universe (explicit list or AssetPairs discovery)
+    bool discover();
+
+    // Pull every pair from the shared snapshot, update indicators and re-rank
+    bool scan(const SnapshotTable& table);
+
+    // Candidates sorted eligible-first, then by descending score
+    const std::vector<ScanCandidate>& ranking() const { return ranking_; }
+
+    // Copy the market fields of a pair into a trade context
+    bool fill_context(const std::string& pair, TradeContext& ctx) const;
+
+    // Log the best candidates
+    void log_ranking(int top_n) const;
+
+    const std::vector<std::string>& pairs() const { return pairs_; }
+    size_t pair_count() const { return pairs_.size(); }
+
+private:
+    void resize(size_t n);
+    void update_indicators();
+    void rank();
+
+    const Config& config_;
+    KrakenClient& client_;
+
+    std::vector<std::string> pairs_;
+    std::unordered_map<std::string, size_t> index_;
+
+    // Per-pair arrays
+    std::vector<double> last_;
+    std::vector<double> bid_;
+    std::vector<double> ask_;
+    std::vector<int64_t> timestamp_;
+    std::vector<int64_t> receive_ns_;
+    std::vector<int64_t> exchange_ns_;
+    std::vector<int64_t> first_sample_;   // Sample index of the first valid price, -1 if none
+    std::vector<double> spread_pct_;
+    std::vector<double> atr_;
+    std::vector<double> sma_short_;
+    std::vector<double> sma_long_;
+
+    // Scratch accumulators reused every tick
+    std::vector<double> tr_sum_;
+    std::vector<double> short_sum_;
+    std::vector<double> long_sum_;
+
+    // Ring buffers, slot-major: ring[slot * pair_count + pair]
+    std::vector<double> price_ring_;      // trend_window_long slots
+    std::vector<double> tr_ring_;         // atr_window slots
+    int64_t samples_ = 0;                 // Price samples taken per pair
+
+    std::vector<ScanCandidate> ranking_;
+};
+
+#endif // SCANNER_HPP
@@ -0,0 +1,269 @@
+#include "shm_ring.hpp"
+#include "logger.hpp"
+#include "util.hpp"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+
+static constexpr uint64_t kShmMagic = 0x4b524b4e4d445231ULL;  // "KRKNMDR1"
+static constexpr uint32_t kShmVersion = 1;
+
+static size_t ring_bytes(uint64_t capacity) {
+    return sizeof(ShmRingHeader) + static_cast<size_t>(capacity) * sizeof(ShmSlot);
+}
+
+std::string ShmRecord::pair_name() const {
+    return std::string(pair, strnlen(pair, kShmPairLen));
+}
+
+void ShmRecord::set_pair(const std::string& name) {
+    std::memset(pair, 0, kShmPairLen);
+    std::memcpy(pair, name.data(), std::min(name.size(), kShmPairLen));
+}
+
+ShmRingWriter::ShmRingWriter(const std::string& name, uint64_t capacity)
+    : name_(name) {
+    if (capacity == 0 || (capacity & (capacity - 1)) != 0) {
+        LOG_ERROR("Shared memory ring capacity must be a power of two: " + std::to_string(capacity));
+        return;
+    }
+
+    // A segment of the right size and layout is resumed: a restarted
+    // gateway continues the sequence so attached readers keep their cursors.
+    // Anything else is replaced, never resized or cleared in place, since
+    // readers may still have it mapped at its old size.
+    const size_t size = ring_bytes(capacity);
+    bool reuse = false;
+    int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd >= 0) {
+        struct stat st {};
+        if (fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) == size) {
+            void* addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if (addr != MAP_FAILED) {
+                const auto* header = static_cast<const ShmRingHeader*>(addr);
+                reuse = header->magic == kShmMagic && header->version == kShmVersion &&
+                        header->slot_size == sizeof(ShmSlot) && header->capacity == capacity;
+                if (reuse) {
+                    map_size_ = size;
+                    header_ = static_cast<ShmRingHeader*>(addr);
+                } else {
+                    munmap(addr, size);
+                }
+            }
+        }
+        close(fd);
+        if (!reuse) {
+            LOG_WARNING("Shared memory ring " + name + " has a different size or layout, replacing it; "
+                        "readers re-attach to the new one");
+            shm_unlink(name.c_str());
+        }
+    }
+
+    if (!reuse) {
+        fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+        if (fd < 0) {
+            LOG_ERROR("shm_open(" + name + ") failed: " + std::string(std::strerror(errno)));
+            return;
+        }
+        if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+            LOG_ERROR("ftruncate(" + name + ") failed: " + std::string(std::strerror(errno)));
+            close(fd);
+            shm_unlink(name.c_str());
+            return;
+        }
+        void* addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (addr == MAP_FAILED) {
+            LOG_ERROR("mmap(" + name + ") failed: " + std::string(std::strerror(errno)));
+            return;
+        }
+        map_size_ = size;
+        header_ = static_cast<ShmRingHeader*>(addr);
+
+        // New and zero-filled; readers check the magic before anything else
+        header_->version = kShmVersion;
+        header_->slot_size = sizeof(ShmSlot);
+        header_->capacity = capacity;
+        header_->write_seq.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        header_->magic = kShmMagic;
+    }
+    slots_ = reinterpret_cast<ShmSlot*>(reinterpret_cast<char*>(header_) + sizeof(ShmRingHeader));
+    header_->writer_pid.store(static_cast<int64_t>(getpid()), std::memory_order_relaxed);
+    heartbeat();
+
+    LOG_INFO("Shared memory ring " + name + " ready: " + std::to_string(capacity) + " slots, " +
+             std::to_string(size) + " bytes" + (reuse ? " (resumed)" : ""));
+}
+
+ShmRingWriter::~ShmRingWriter() {
+    if (header_ != nullptr) {
+        munmap(header_, map_size_);
+    }
+}
+
+void ShmRingWriter::publish(const ShmRecord& record) {
+    if (header_ == nullptr) {
+        return;
+    }
+
+    uint64_t words[kShmRecordWords] = {};
+    std::memcpy(words, &record, sizeof(ShmRecord));
+
+    const uint64_t n = header_->write_seq.load(std::memory_order_relaxed);
+    ShmSlot& slot = slots_[n & (header_->capacity - 1)];
+
+    slot.seq.store(2 * n + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < kShmRecordWords; i++) {
+        slot.words[i].store(words[i], std::memory_order_relaxed);
+    }
+    slot.seq.store(2 * n + 2, std::memory_order_release);
+    header_->write_seq.store(n + 1, std::memory_order_release);
+}
+
+void ShmRingWriter::heartbeat() {
+    if (header_ != nullptr) {
+        header_->heartbeat_ns.store(util::now_epoch_ns(), std::memory_order_release);
+    }
+}
+
+uint64_t ShmRingWriter::published() const {
+    return header_ != nullptr ? header_->write_seq.load(std::memory_order_relaxed) : 0;
+}
+
+ShmRingReader::ShmRingReader(const std::string& name)
+    : name_(name) {
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        LOG_ERROR("shm_open(" + name + ") failed: " + std::string(std::strerror(errno)) +
+                  " - is market_gateway running?");
+        return;
+    }
+
+    struct stat st {};
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(ShmRingHeader)) {
+        LOG_ERROR("Shared memory ring " + name + " is not initialized");
+        close(fd);
+        return;
+    }
+
+    void* addr = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        LOG_ERROR("mmap(" + name + ") failed: " + std::string(std::strerror(errno)));
+        return;
+    }
+
+    const auto* header = static_cast<const ShmRingHeader*>(addr);
+    if (header->magic != kShmMagic || header->version != kShmVersion ||
+        header->slot_size != sizeof(ShmSlot) ||
+        ring_bytes(header->capacity) != static_cast<size_t>(st.st_size)) {
+        LOG_ERROR("Shared memory ring " + name + " has an incompatible layout");
+        munmap(addr, static_cast<size_t>(st.st_size));
+        return;
+    }
+
+    map_size_ = static_cast<size_t>(st.st_size);
+    device_ = static_cast<uint64_t>(st.st_dev);
+    inode_ = static_cast<uint64_t>(st.st_ino);
+    header_ = header;
+    slots_ = reinterpret_cast<const ShmSlot*>(static_cast<const char*>(addr) + sizeof(ShmRingHeader));
+    LOG_INFO("Attached to shared memory ring " + name + " (" + std::to_string(header_->capacity) +
+             " slots, writer pid " + std::to_string(header_->writer_pid.load()) + ")");
+}
+
+ShmRingReader::~ShmRingReader() {
+    if (header_ != nullptr) {
+        munmap(const_cast<ShmRingHeader*>(header_), map_size_);
+    }
+}
+
+void ShmRingReader::seek_to_end() {
+    if (header_ != nullptr) {
+        next_ = header_->write_seq.load(std::memory_order_acquire);
+    }
+}
+
+uint64_t ShmRingReader::backlog() const {
+    if (header_ == nullptr) {
+        return 0;
+    }
+    uint64_t head = header_->write_seq.load(std::memory_order_acquire);
+    return head > next_ ? head - next_ : 0;
+}
+
+int64_t ShmRingReader::writer_heartbeat_ns() const {
+    return header_ != nullptr ? header_->heartbeat_ns.load(std::memory_order_acquire) : 0;
+}
+
+bool ShmRingReader::superseded() const {
+    if (header_ == nullptr) {
+        return false;
+    }
+    int fd = shm_open(name_.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st {};
+    bool other = fstat(fd, &st) == 0 &&
+                 (static_cast<uint64_t>(st.st_dev) != device_ || static_cast<uint64_t>(st.st_ino) != inode_);
+    close(fd);
+    return other;
+}
+
+bool ShmRingReader::read(ShmRecord& out) {
+    if (header_ == nullptr) {
+        return false;
+    }
+
+    const uint64_t capacity = header_->capacity;
+    for (;;) {
+        uint64_t head = header_->write_seq.load(std::memory_order_acquire);
+        if (next_ > head) {
+            // Writer re-initialized the ring
+            next_ = head;
+        }
+        if (next_ == head) {
+            return false;
+        }
+        if (head - next_ > capacity) {
+            // Lapped: the oldest unread records were overwritten
+            uint64_t resume = head - capacity + 1;
+            lost_ += resume - next_;
+            next_ = resume;
+        }
+
+        const ShmSlot& slot = slots_[next_ & (capacity - 1)];
+        const uint64_t expected = 2 * next_ + 2;
+        uint64_t words[kShmRecordWords];
+
+        uint64_t before = slot.seq.load(std::memory_order_acquire);
+        if (before == expected) {
+            for (size_t i = 0; i < kShmRecordWords; i++) {
+                words[i] = slot.words[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            uint64_t after = slot.seq.load(std::memory_order_relaxed);
+            if (after == expected) {
+                std::memcpy(&out, words, sizeof(ShmRecord));
+                next_++;
+                return true;
+            }
+        }
+
+        // The writer lapped us while we were reading this slot; the next
+        // pass through the loop re-reads head and skips the lost records
+        uint64_t latest = header_->write_seq.load(std::memory_order_acquire);
+        uint64_t resume = latest > capacity ? latest - capacity + 1 : next_ + 1;
+        if (resume <= next_) {
+            resume = next_ + 1;
+        }
+        lost_ += resume - next_;
+        next_ = resume;
+    }
+}
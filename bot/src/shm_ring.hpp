@@ -0,0 +1,142 @@
+#ifndef SHM_RING_HPP
+#define SHM_RING_HPP
+
+#include <string>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+// Record kinds carried by the shared-memory ring
+enum class ShmRecordType : uint32_t {
+    TICK = 1,   // last/bid/ask/volume
+    BOOK = 2,   // up to kShmBookLevels per side
+    BAR  = 3    // OHLCV bar
+};
+
+constexpr size_t kShmBookLevels = 5;
+constexpr size_t kShmPairLen = 16;
+
+struct ShmTick {
+    double last_price;
+    double bid_price;
+    double ask_price;
+    double volume_24h;
+};
+
+struct ShmBook {
+    double bid_price[kShmBookLevels];
+    double bid_volume[kShmBookLevels];
+    double ask_price[kShmBookLevels];
+    double ask_volume[kShmBookLevels];
+    uint32_t bid_levels;
+    uint32_t ask_levels;
+};
+
+struct ShmBar {
+    double open;
+    double high;
+    double low;
+    double close;
+    double volume;
+    int64_t start_ns;
+    int64_t interval_ns;
+};
+
+// Plain copy of one slot's contents
+struct ShmRecord {
+    ShmRecordType type;
+    uint32_t reserved;
+    char pair[kShmPairLen];
+    int64_t exchange_ns;
+    int64_t receive_ns;
+    union {
+        ShmTick tick;
+        ShmBook book;
+        ShmBar bar;
+    };
+
+    std::string pair_name() const;
+    void set_pair(const std::string& name);
+};
+
+constexpr size_t kShmRecordWords = (sizeof(ShmRecord) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+// One ring slot. seq is even when the slot is stable: 2 * (n + 1) after
+// record n was written, 2 * n + 1 while it is being written.
+struct alignas(64) ShmSlot {
+    std::atomic<uint64_t> seq;
+    std::atomic<uint64_t> words[kShmRecordWords];
+};
+
+struct alignas(64) ShmRingHeader {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t slot_size;
+    uint64_t capacity;                      // Power of two
+    std::atomic<uint64_t> write_seq;        // Records published so far
+    std::atomic<int64_t> heartbeat_ns;      // Writer liveness (epoch ns)
+    std::atomic<int64_t> writer_pid;
+};
+
+// Single producer. Resumes a compatible segment or creates a new one (an
+// incompatible one is unlinked, never resized under its readers) and
+// publishes records with a per-slot seqlock; never waits on readers.
+class ShmRingWriter {
+public:
+    ShmRingWriter(const std::string& name, uint64_t capacity);
+    ~ShmRingWriter();
+
+    ShmRingWriter(const ShmRingWriter&) = delete;
+    ShmRingWriter& operator=(const ShmRingWriter&) = delete;
+
+    bool is_open() const { return header_ != nullptr; }
+    void publish(const ShmRecord& record);
+    void heartbeat();
+    uint64_t published() const;
+
+private:
+    std::string name_;
+    size_t map_size_ = 0;
+    ShmRingHeader* header_ = nullptr;
+    ShmSlot* slots_ = nullptr;
+};
+
+// Any number of read-only consumers, each with its own cursor. A reader that
+// falls more than one ring behind is detected, counts the records it lost and
+// resumes at the oldest record still in the ring.
+class ShmRingReader {
+public:
+    explicit ShmRingReader(const std::string& name);
+    ~ShmRingReader();
+
+    ShmRingReader(const ShmRingReader&) = delete;
+    ShmRingReader& operator=(const ShmRingReader&) = delete;
+
+    bool is_open() const { return header_ != nullptr; }
+
+    // Copy the next record; false when caught up
+    bool read(ShmRecord& out);
+
+    // Skip everything published so far (attach at the live edge)
+    void seek_to_end();
+
+    uint64_t lost() const { return lost_; }
+    uint64_t backlog() const;
+    int64_t writer_heartbeat_ns() const;
+
+    // The name now refers to a different segment than the one mapped (the
+    // gateway replaced it); attach a new reader to follow it
+    bool superseded() const;
+
+private:
+    std::string name_;
+    uint64_t device_ = 0;
+    uint64_t inode_ = 0;
+    size_t map_size_ = 0;
+    const ShmRingHeader* header_ = nullptr;
+    const ShmSlot* slots_ = nullptr;
+    uint64_t next_ = 0;
+    uint64_t lost_ = 0;
+};
+
+#endif // SHM_RING_HPP
@@ -0,0 +1,217 @@
+#include "config.hpp"
+#include "logger.hpp"
+#include "kraken_client.hpp"
+#include "market_data.hpp"
+#include "fault_injection.hpp"
+#include "util.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <atomic>
+
+// Recovery soak test: drive the market data refresh loop through the fault
+// injection transport and measure what the faults cost.
+//
+//   fault_soak <schedule.json> [config.json] [--seconds N]
+//
+// Runs as fast as the client's rate limit and backoff allow, so capacity is
+// compared with the fault-free ceiling of one request per
+// rate_limit_min_delay_ms.
+
+static std::atomic<bool> g_running{true};
+
+static void signal_handler(int) {
+    g_running = false;
+}
+
+static std::string fmt(double v, const char* spec = "%.1f") {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), spec, v);
+    return buf;
+}
+
+static double percentile(std::vector<double> values, double q) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    size_t k = std::min(values.size() - 1, static_cast<size_t>(q * static_cast<double>(values.size())));
+    std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(k), values.end());
+    return values[k];
+}
+
+struct PhaseTally {
+    uint64_t attempts = 0;
+    uint64_t successes = 0;
+    double seconds = 0.0;
+};
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: fault_soak <schedule.json> [config.json] [--seconds N]" << std::endl;
+        return 1;
+    }
+    std::string schedule_file = argv[1];
+    std::string config_file = "config.json";
+    double seconds = 0.0;
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--seconds" && i + 1 < argc) {
+            seconds = std::stod(argv[++i]);
+        } else {
+            config_file = arg;
+        }
+    }
+
+    Config config;
+    FaultSchedule schedule;
+    try {
+        config = Config::load(config_file);
+        schedule = FaultSchedule::load(schedule_file);
+    } catch (const std::exception& e) {
+        std::cerr << "fault_soak: " << e.what() << std::endl;
+        return 1;
+    }
+    if (seconds <= 0.0) {
+        seconds = schedule.total_seconds();
+    }
+    if (seconds <= 0.0) {
+        std::cerr << "fault_soak: schedule has no finite duration, pass --seconds" << std::endl;
+        return 1;
+    }
+
+    Logger::instance().init(config.log_dir, "fault_soak.log");
+    std::signal(SIGINT, signal_handler);
+    std::signal(SIGTERM, signal_handler);
+
+    KrakenClient client(config.kraken_api_base, config.rate_limit_min_delay_ms);
+    client.set_endpoint_policy(config.endpoint_policy());
+    client.set_request_timeout_ms(config.http_timeout_ms);
+    client.set_rate_limit_burst(config.rate_limit_burst);
+    auto transport = std::make_unique<FaultInjectingTransport>(std::make_unique<CurlTransport>(config.curl_options()), schedule);
+    FaultInjectingTransport* faults = transport.get();
+    client.set_transport(std::move(transport));
+    if (config.http_prewarm) {
+        client.warm_up();
+    }
+
+    MarketDataCache market_data(client);
+    market_data.track(config.pair);
+
+    LOG_INFO("Soaking " + config.pair + " for " + fmt(seconds) + "s against " + config.kraken_api_base);
+
+    const int64_t stale_ns = config.stale_price_seconds * 1'000'000'000LL;
+    const auto start = std::chrono::steady_clock::now();
+    auto last = start;
+    uint64_t attempts = 0;
+    uint64_t successes = 0;
+    int halts = 0;
+    double stale_seconds = 0.0;
+    double outage_start = -1.0;
+    std::vector<double> recoveries;
+    std::vector<double> refresh_ms;
+    std::map<std::string, PhaseTally> phases;
+    std::vector<std::string> phase_order;
+
+    while (g_running) {
+        auto now = std::chrono::steady_clock::now();
+        double elapsed = std::chrono::duration<double>(now - start).count();
+        if (elapsed >= seconds) {
+            break;
+        }
+
+        std::string phase = faults->current_phase();
+        if (phases.find(phase) == phases.end()) {
+            phase_order.push_back(phase);
+            LOG_INFO("Phase: " + phase);
+        }
+        PhaseTally& tally = phases[phase];
+
+        bool ok = market_data.refresh();
+        auto done = std::chrono::steady_clock::now();
+        double done_s = std::chrono::duration<double>(done - start).count();
+        double step = std::chrono::duration<double>(done - last).count();
+        last = done;
+
+        attempts++;
+        tally.attempts++;
+        tally.seconds += step;
+
+        // Quotes the strategy would have rejected as stale over this step
+        const MarketSnapshot* snap = market_data.snapshot()->find(config.pair);
+        if (snap == nullptr || snap->receive_ns == 0 || util::now_epoch_ns() - snap->receive_ns > stale_ns) {
+            stale_seconds += step;
+        }
+
+        if (ok) {
+            successes++;
+            tally.successes++;
+            refresh_ms.push_back(std::chrono::duration<double, std::milli>(done - now).count());
+            if (outage_start >= 0.0) {
+                recoveries.push_back(done_s - outage_start);
+                outage_start = -1.0;
+            }
+        } else if (outage_start < 0.0) {
+            outage_start = elapsed;
+        }
+
+        // The bot halts here; keep going to measure the rest of the run
+        if (client.get_consecutive_failures() >= config.max_consecutive_failures) {
+            halts++;
+            LOG_WARNING("Bot would halt at t=" + fmt(done_s) + "s (" +
+                        std::to_string(client.get_consecutive_failures()) + " consecutive failures)");
+            client.reset_failures();
+        }
+    }
+
+    double total = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double ceiling = total * 1000.0 / static_cast<double>(std::max<int64_t>(1, config.rate_limit_min_delay_ms));
+    FaultStats stats = faults->stats();
+
+    LOG_INFO("=== Soak results (" + fmt(total) + "s) ===");
+    LOG_INFO("Refreshes: " + std::to_string(successes) + "/" + std::to_string(attempts) + " ok (" +
+             fmt(attempts > 0 ? 100.0 * static_cast<double>(successes) / static_cast<double>(attempts) : 0.0) + "%)");
+    LOG_INFO("Capacity: " + fmt(static_cast<double>(successes) * 60.0 / total) + " good refreshes/min, " +
+             fmt(100.0 * (1.0 - static_cast<double>(successes) / std::max(1.0, ceiling))) +
+             "% below the fault-free ceiling");
+    LOG_INFO("Stale quotes: " + fmt(100.0 * stale_seconds / total) + "% of the run");
+    LOG_INFO("Refresh latency: p50 " + fmt(percentile(refresh_ms, 0.5)) + "ms, p99 " +
+             fmt(percentile(refresh_ms, 0.99)) + "ms");
+    LOG_INFO("Outages: " + std::to_string(recoveries.size()) + (outage_start >= 0.0 ? " (+1 unrecovered)" : "") +
+             ", recovery p50 " + fmt(percentile(recoveries, 0.5), "%.2f") + "s, p95 " +
+             fmt(percentile(recoveries, 0.95), "%.2f") + "s, max " +
+             fmt(recoveries.empty() ? 0.0 : *std::max_element(recoveries.begin(), recoveries.end()), "%.2f") + "s");
+    LOG_INFO("Halts (max_consecutive_failures reached): " + std::to_string(halts));
+    for (const auto& name : phase_order) {
+        const PhaseTally& t = phases[name];
+        LOG_INFO("  " + name + ": " + std::to_string(t.successes) + "/" + std::to_string(t.attempts) + " ok over " +
+                 fmt(t.seconds) + "s");
+    }
+    for (const EndpointMetrics& m : client.endpoint_metrics()) {
+        if (m.requests == 0 && m.short_circuited == 0) continue;
+        LOG_INFO("  [" + m.name + "] breaker " + breaker_state_to_string(m.state) + ", " +
+                 std::to_string(m.trips) + " trips, " + std::to_string(m.short_circuited) + " short-circuited, " +
+                 std::to_string(m.retries) + " retries, " + std::to_string(m.hedges) + " hedges (" +
+                 std::to_string(m.hedge_wins) + " won), p50 " + fmt(m.latency_p50_ms) + "ms, p99 " +
+                 fmt(m.latency_p99_ms) + "ms");
+    }
+    HttpTransportStats http = client.transport_stats();
+    LOG_INFO("Transport: " + std::string(http.http2 ? "HTTP/2 multiplexed" : "HTTP/1.1") + ", " +
+             std::to_string(http.h2_streams) + " h2 streams, " + std::to_string(http.h1_requests) +
+             " HTTP/1.x requests over " + std::to_string(http.connections) + " connections (peak " +
+             std::to_string(http.peak_active) + " concurrent), " + std::to_string(http.timeouts) +
+             " stream timeouts, " + std::to_string(http.cancelled) + " cancelled");
+    LOG_INFO("Cold requests: " + std::to_string(http.cold_requests) + ", p50 " + fmt(http.cold_p50_ms) +
+             "ms, p99 " + fmt(http.cold_p99_ms) + "ms (dns " + fmt(http.cold_dns_ms) + "ms, connect " +
+             fmt(http.cold_connect_ms) + "ms, tls " + fmt(http.cold_tls_ms) + "ms); warm: " +
+             std::to_string(http.warm_requests) + ", p50 " + fmt(http.warm_p50_ms) + "ms, p99 " +
+             fmt(http.warm_p99_ms) + "ms");
+    LOG_INFO("Injected: " + std::to_string(stats.timeouts) + " timeouts, " + std::to_string(stats.http_errors) +
+             " HTTP errors, " + std::to_string(stats.rate_limited) + " rate limits, " +
+             std::to_string(stats.truncated) + " truncated, " + fmt(stats.injected_latency_ms / 1000.0) +
+             "s added latency over " + std::to_string(stats.requests) + " requests");
+    return 0;
+}
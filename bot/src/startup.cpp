@@ -0,0 +1,108 @@
+#include "startup.hpp"
+#include "logger.hpp"
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+void StartupGraph::add(const std::string& name, const std::vector<std::string>& after, Step step) {
+    Node node;
+    node.name = name;
+    node.step = std::move(step);
+    for (const std::string& dep : after) {
+        size_t i = 0;
+        while (i < nodes_.size() && nodes_[i].name != dep) {
+            i++;
+        }
+        if (i == nodes_.size()) {
+            throw std::invalid_argument("Startup step " + name + " depends on unknown step " + dep);
+        }
+        node.deps.push_back(i);
+    }
+    nodes_.push_back(std::move(node));
+}
+
+StartupReport StartupGraph::run() {
+    using clock = std::chrono::steady_clock;
+    const clock::time_point start = clock::now();
+    auto since_start_ms = [&](clock::time_point t) {
+        return std::chrono::duration<double, std::milli>(t - start).count();
+    };
+
+    StartupReport report;
+    report.steps.resize(nodes_.size());
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<bool> done(nodes_.size(), false);
+
+    std::vector<std::thread> threads;
+    threads.reserve(nodes_.size());
+    for (size_t i = 0; i < nodes_.size(); i++) {
+        threads.emplace_back([&, i]() {
+            Node& node = nodes_[i];
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cv.wait(lock, [&] {
+                    for (size_t dep : node.deps) {
+                        if (!done[dep]) {
+                            return false;
+                        }
+                    }
+                    return true;
+                });
+            }
+
+            clock::time_point step_start = clock::now();
+            bool ok = false;
+            try {
+                ok = node.step();
+            } catch (const std::exception& e) {
+                LOG_ERROR("Startup step " + node.name + " failed: " + e.what());
+            }
+            clock::time_point step_end = clock::now();
+
+            std::lock_guard<std::mutex> lock(mutex);
+            node.ok = ok;
+            report.steps[i] = {node.name, ok, since_start_ms(step_start), since_start_ms(step_end)};
+            done[i] = true;
+            cv.notify_all();
+        });
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
+
+    report.total_ms = since_start_ms(clock::now());
+    return report;
+}
+
+bool StartupGraph::ok(const std::string& name) const {
+    for (const Node& node : nodes_) {
+        if (node.name == name) {
+            return node.ok;
+        }
+    }
+    return false;
+}
+
+void log_startup_report(const StartupReport& report) {
+    char buf[128];
+    for (const StartupStepReport& step : report.steps) {
+        std::snprintf(buf, sizeof(buf), "Startup %-10s %7.1f -> %7.1f ms%s", step.name.c_str(), step.start_ms,
+                      step.end_ms, step.ok ? "" : " (failed)");
+        LOG_INFO(buf);
+    }
+    std::snprintf(buf, sizeof(buf), "Startup graph finished in %.1f ms", report.total_ms);
+    LOG_INFO(buf);
+}
+
+void append_startup_report(StartupReport& report, const StartupReport& later) {
+    for (StartupStepReport step : later.steps) {
+        step.start_ms += report.total_ms;
+        step.end_ms += report.total_ms;
+        report.steps.push_back(step);
+    }
+    report.total_ms += later.total_ms;
+}
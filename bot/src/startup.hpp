@@ -0,0 +1,64 @@
+#ifndef STARTUP_HPP
+#define STARTUP_HPP
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <chrono>
+#include <cstdint>
+
+// Timing of one startup step, relative to the start of the graph
+struct StartupStepReport {
+    std::string name;
+    bool ok = false;
+    double start_ms = 0.0;
+    double end_ms = 0.0;
+};
+
+struct StartupReport {
+    std::vector<StartupStepReport> steps;   // In the order they were added
+    double total_ms = 0.0;                  // Graph start to last step done
+    double first_decision_ms = -1.0;        // Process start to first actionable
+                                            // evaluate(); -1 until it happens
+};
+
+// Startup work as a dependency graph. Each step runs on its own thread as
+// soon as the steps it names have finished, so independent network calls
+// overlap and the slowest chain, not the sum, sets the startup time. A step
+// runs even if a dependency failed; it sees whatever that step left behind
+// and decides for itself.
+class StartupGraph {
+public:
+    using Step = std::function<bool()>;
+
+    // Dependencies must already have been added, which keeps the graph
+    // acyclic; unknown names throw std::invalid_argument
+    void add(const std::string& name, const std::vector<std::string>& after, Step step);
+
+    // Run every step and wait for all of them; steps that throw count as
+    // failed
+    StartupReport run();
+
+    // Whether the named step ran and succeeded (valid after run())
+    bool ok(const std::string& name) const;
+
+private:
+    struct Node {
+        std::string name;
+        std::vector<size_t> deps;
+        Step step;
+        bool ok = false;
+    };
+
+    std::vector<Node> nodes_;
+};
+
+// One line per step plus the total, for the log
+void log_startup_report(const StartupReport& report);
+
+// Append a graph that ran later (a standby's steps after taking the lease);
+// its times continue from the end of report, so any wait between the two
+// is left out
+void append_startup_report(StartupReport& report, const StartupReport& later);
+
+#endif // STARTUP_HPP
@@ -26,10 +26,12 @@ TradingMode string_to_mode(const std::string& str) {
 TradingState TradingState::default_state() {
     TradingState state;
     state.mode = TradingMode::FLAT;
+    state.pair.clear();
     state.entry_price = std::nullopt;
     state.exit_price = std::nullopt;
     state.trailing_stop_price = std::nullopt;
     state.btc_amount = 0.0;
+    state.entry_fee_cad = 0.0;
     state.last_trade_time = std::nullopt;
     state.entry_time = std::nullopt;
     state.trades_today = 0;
@@ -40,34 +42,19 @@ TradingState TradingState::default_state() {
     return state;
 }
 
-TradingState TradingState::load(const std::string& path) {
+TradingState TradingState::from_json(const json& j) {
     TradingState state = default_state();
     
-    if (!util::file_exists(path)) {
-        LOG_INFO("State file not found, initializing defaults: " + path);
-        return state;
-    }
-    
-    std::ifstream file(path);
-    if (!file.is_open()) {
-        LOG_WARNING("Failed to open state file, initializing defaults: " + path);
-        return state;
-    }
-    
-    json j;
-    try {
-        file >> j;
-    } catch (const json::parse_error& e) {
-        LOG_ERROR("Failed to parse state JSON: " + std::string(e.what()));
-        LOG_WARNING("Initializing defaults due to parse error");
-        return state;
-    }
-    
     // Parse mode
     if (j.contains("mode") && j["mode"].is_string()) {
         state.mode = string_to_mode(j["mode"].get<std::string>());
     }
     
+    // Parse pair
+    if (j.contains("pair") && j["pair"].is_string()) {
+        state.pair = j["pair"].get<std::string>();
+    }
+    
     // Parse entry_price
     if (j.contains("entry_price") && !j["entry_price"].is_null()) {
         state.entry_price = j["entry_price"].get<double>();
@@ -88,6 +75,10 @@ TradingState TradingState::load(const std::string& path) {
         state.btc_amount = j["btc_amount"].get<double>();
     }
     
+    if (j.contains("entry_fee_cad") && j["entry_fee_cad"].is_number()) {
+        state.entry_fee_cad = j["entry_fee_cad"].get<double>();
+    }
+    
     // Parse last_trade_time
     if (j.contains("last_trade_time") && !j["last_trade_time"].is_null()) {
         if (j["last_trade_time"].is_number()) {
@@ -128,14 +119,43 @@ TradingState TradingState::load(const std::string& path) {
         state.sim_btc_balance = j["sim_btc_balance"].get<double>();
     }
     
+    return state;
+}
+
+TradingState TradingState::load(const std::string& path) {
+    TradingState state = default_state();
+    
+    if (!util::file_exists(path)) {
+        LOG_INFO("State file not found, initializing defaults: " + path);
+        return state;
+    }
+    
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        LOG_WARNING("Failed to open state file, initializing defaults: " + path);
+        return state;
+    }
+    
+    json j;
+    try {
+        file >> j;
+    } catch (const json::parse_error& e) {
+        LOG_ERROR("Failed to parse state JSON: " + std::string(e.what()));
+        LOG_WARNING("Initializing defaults due to parse error");
+        return state;
+    }
+    
+    state = from_json(j);
+    
     LOG_INFO("Loaded state from: " + path);
     return state;
 }
 
-void TradingState::save(const std::string& path) const {
+json TradingState::to_json() const {
     json j;
     
     j["mode"] = mode_to_string(mode);
+    j["pair"] = pair;
     
     if (entry_price.has_value()) {
         j["entry_price"] = entry_price.value();
@@ -156,6 +176,7 @@ void TradingState::save(const std::string& path) const {
     }
     
     j["btc_amount"] = btc_amount;
+    j["entry_fee_cad"] = entry_fee_cad;
     
     if (last_trade_time.has_value()) {
         j["last_trade_time"] = last_trade_time.value();
@@ -174,6 +195,11 @@ void TradingState::save(const std::string& path) const {
     j["sim_cad_balance"] = sim_cad_balance;
     j["sim_btc_balance"] = sim_btc_balance;
     j["partial_take_profit_done"] = partial_take_profit_done;
+    return j;
+}
+
+void TradingState::save(const std::string& path) const {
+    json j = to_json();
     
     std::ofstream file(path);
     if (!file.is_open()) {
@@ -219,6 +245,7 @@ void TradingState::log_state() const {
     std::ostringstream oss;
     oss << "Current state:"
         << "\n  mode: " << mode_to_string(mode)
+        << "\n  pair: " << (pair.empty() ? "null" : pair)
         << "\n  entry_price: " << (entry_price.has_value() ? std::to_string(entry_price.value()) : "null")
         << "\n  exit_price: " << (exit_price.has_value() ? std::to_string(exit_price.value()) : "null")
         << "\n  trailing_stop_price: " << (trailing_stop_price.has_value() ? std::to_string(trailing_stop_price.value()) : "null")
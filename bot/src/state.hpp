@@ -4,6 +4,7 @@
 #include <string>
 #include <optional>
 #include <cstdint>
+#include <nlohmann/json_fwd.hpp>
 
 enum class TradingMode {
     FLAT,
@@ -15,10 +16,12 @@ TradingMode string_to_mode(const std::string& str);
 
 struct TradingState {
     TradingMode mode = TradingMode::FLAT;
+    std::string pair;                        // Pair of the current or most recent position
     std::optional<double> entry_price;
     std::optional<double> exit_price;
     std::optional<double> trailing_stop_price;
     double btc_amount = 0.0;
+    double entry_fee_cad = 0.0;              // Buy fees not yet charged to a sell
     std::optional<int64_t> last_trade_time;  // Unix epoch seconds
     std::optional<int64_t> entry_time;       // Unix epoch seconds
     int trades_today = 0;
@@ -35,6 +38,10 @@ struct TradingState {
     // Save state to JSON file
     void save(const std::string& path) const;
     
+    // JSON form shared by the state file and the failover journal
+    nlohmann::json to_json() const;
+    static TradingState from_json(const nlohmann::json& j);
+    
     // Initialize default state
     static TradingState default_state();
     
@@ -0,0 +1,111 @@
+#include "state_journal.hpp"
+#include "logger.hpp"
+#include "util.hpp"
+#include <nlohmann/json.hpp>
+#include <sys/stat.h>
+#include <fstream>
+#include <cstdio>
+
+using json = nlohmann::json;
+
+StateJournal::StateJournal(const std::string& path, size_t max_bytes)
+    : path_(path)
+    , max_bytes_(max_bytes) {
+}
+
+bool StateJournal::append(const TradingState& state, const IndicatorWindows& indicators) {
+    json j;
+    j["seq"] = ++seq_;
+    j["written_ns"] = util::now_epoch_ns();
+    j["state"] = state.to_json();
+    j["prices"] = indicators.prices;
+    j["true_ranges"] = indicators.true_ranges;
+    std::string line = j.dump() + "\n";
+
+    struct stat st {};
+    if (stat(path_.c_str(), &st) == 0 && static_cast<size_t>(st.st_size) + line.size() > max_bytes_) {
+        return compact(line);
+    }
+
+    std::ofstream file(path_, std::ios::app);
+    if (!file.is_open()) {
+        LOG_ERROR("Failed to open state journal for writing: " + path_);
+        return false;
+    }
+    // One write per record so a tailer never sees two records interleaved
+    file.write(line.data(), static_cast<std::streamsize>(line.size()));
+    file.flush();
+    return file.good();
+}
+
+bool StateJournal::compact(const std::string& line) {
+    std::string tmp = path_ + ".tmp";
+    {
+        std::ofstream file(tmp, std::ios::trunc);
+        if (!file.is_open()) {
+            LOG_ERROR("Failed to open state journal for compaction: " + tmp);
+            return false;
+        }
+        file << line;
+    }
+    if (std::rename(tmp.c_str(), path_.c_str()) != 0) {
+        LOG_ERROR("Failed to replace state journal: " + path_);
+        return false;
+    }
+    LOG_DEBUG("State journal compacted at seq " + std::to_string(seq_));
+    return true;
+}
+
+bool StateJournal::tail(JournalRecord& latest) {
+    struct stat st {};
+    if (stat(path_.c_str(), &st) != 0) {
+        return false;
+    }
+
+    // Compacted or recreated: start over
+    if (st.st_ino != inode_ || static_cast<size_t>(st.st_size) < offset_) {
+        inode_ = st.st_ino;
+        offset_ = 0;
+        partial_.clear();
+    }
+    if (static_cast<size_t>(st.st_size) == offset_) {
+        return false;
+    }
+
+    std::ifstream file(path_, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    file.seekg(static_cast<std::streamoff>(offset_));
+    std::string chunk(static_cast<size_t>(st.st_size) - offset_, '\0');
+    file.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+    chunk.resize(static_cast<size_t>(file.gcount()));
+    offset_ += chunk.size();
+    partial_ += chunk;
+
+    // Only the newest complete line matters
+    size_t end = partial_.rfind('\n');
+    if (end == std::string::npos) {
+        return false;
+    }
+    size_t begin = end == 0 ? std::string::npos : partial_.rfind('\n', end - 1);
+    begin = begin == std::string::npos ? 0 : begin + 1;
+    std::string line = partial_.substr(begin, end - begin);
+    partial_.erase(0, end + 1);
+
+    try {
+        json j = json::parse(line);
+        latest.seq = j.value("seq", uint64_t{0});
+        latest.written_ns = j.value("written_ns", int64_t{0});
+        latest.state = TradingState::from_json(j.at("state"));
+        latest.indicators.prices = j.value("prices", std::vector<double>{});
+        latest.indicators.true_ranges = j.value("true_ranges", std::vector<double>{});
+    } catch (const json::exception& e) {
+        LOG_WARNING("Skipping unreadable state journal record: " + std::string(e.what()));
+        return false;
+    }
+
+    // A new leader continues the sequence
+    seq_ = latest.seq;
+    return true;
+}
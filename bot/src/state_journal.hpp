@@ -0,0 +1,48 @@
+#ifndef STATE_JOURNAL_HPP
+#define STATE_JOURNAL_HPP
+
+#include "state.hpp"
+#include "strategy.hpp"
+#include <string>
+#include <cstdint>
+#include <sys/types.h>
+
+// One leader tick: full trading state plus the indicator windows
+struct JournalRecord {
+    uint64_t seq = 0;
+    int64_t written_ns = 0;      // Local epoch ns when the leader wrote it
+    TradingState state;
+    IndicatorWindows indicators;
+};
+
+// Append-only JSON-lines journal written by the leader every tick and tailed
+// by a standby. The writer compacts the file down to its last record once it
+// grows past max_bytes (atomic rename); the tailer notices the new inode and
+// starts over from the top.
+class StateJournal {
+public:
+    explicit StateJournal(const std::string& path, size_t max_bytes = 1 << 20);
+
+    // Leader side
+    bool append(const TradingState& state, const IndicatorWindows& indicators);
+
+    // Standby side: newest complete record written since the last call.
+    // False if nothing new arrived.
+    bool tail(JournalRecord& latest);
+
+    uint64_t last_seq() const { return seq_; }
+
+private:
+    bool compact(const std::string& line);
+
+    std::string path_;
+    size_t max_bytes_;
+    uint64_t seq_ = 0;
+
+    // Tailer position
+    ino_t inode_ = 0;
+    size_t offset_ = 0;
+    std::string partial_;
+};
+
+#endif // STATE_JOURNAL_HPP
@@ -1,10 +1,14 @@
 #include "strategy.hpp"
+#include "scanner.hpp"
+#include "paper_exchange.hpp"
+#include "trade_tape.hpp"
 #include "logger.hpp"
 #include "util.hpp"
 #include <sstream>
 #include <iomanip>
 #include <thread>
 #include <cmath>
+#include <algorithm>
 
 std::string decision_to_string(Decision d) {
     switch (d) {
@@ -17,15 +21,26 @@ std::string decision_to_string(Decision d) {
 }
 
 void TradeContext::log() const {
-    std::ostringstream oss;
+    ArenaOStream oss(std::ios_base::out, tick_resource());
     oss << std::fixed << std::setprecision(2);
     
     oss << "TradeContext:"
+        << "\n  pair: " << pair
         << "\n  current_price: " << current_price
+        << "\n  price_age_ms: " << price_age_ms
         << "\n  price_stale: " << (price_stale ? "YES" : "no")
         << "\n  tp_price: " << tp_price
         << "\n  sl_price: " << sl_price
         << "\n  rebuy_price: " << rebuy_price
+        << "\n  book_imbalance: " << (book_valid ? std::to_string(book_imbalance) : "n/a")
+        << "\n  microprice: " << microprice
+        << "\n  weighted_mid: " << weighted_mid
+        << "\n  bid_slope / ask_slope: " << bid_slope << " / " << ask_slope
+        << "\n  vwap: " << vwap
+        << "\n  tape buy / sell volume: " << std::setprecision(8) << tape_buy_volume << " / " << tape_sell_volume
+        << std::setprecision(2)
+        << "\n  vpin / flow_imbalance: "
+        << (flow_valid ? std::to_string(vpin) + " / " + std::to_string(flow_imbalance) : std::string("n/a"))
         << "\n  equity_cad: " << sizing.equity_cad
         << "\n  available_cad: " << sizing.available_cad
         << "\n  risk_cad: " << sizing.risk_cad
@@ -39,13 +54,16 @@ void TradeContext::log() const {
         << "\n  decision: " << decision_to_string(decision)
         << "\n  decision_reason: " << decision_reason;
     
-    LOG_INFO(oss.str());
+    LOG_INFO(oss.view());
 }
 
-Strategy::Strategy(const Config& config, TradingState& state, KrakenClient& client)
+Strategy::Strategy(const Config& config, TradingState& state, KrakenClient& client,
+                   const MarketDataCache& market_data)
     : config_(config)
     , state_(state)
-    , client_(client) {
+    , client_(client)
+    , market_data_(market_data)
+    , ledger_(config.ledger_file) {
 }
 
 void Strategy::init_simulation(double initial_cad) {
@@ -57,27 +75,72 @@ void Strategy::init_simulation(double initial_cad) {
     LOG_INFO("Simulation initialized with CAD: " + std::to_string(initial_cad));
 }
 
+std::string Strategy::active_pair() const {
+    if (state_.mode == TradingMode::LONG && !state_.pair.empty()) {
+        return state_.pair;
+    }
+    return config_.pair;
+}
+
+std::optional<double> Strategy::exit_price_for(const std::string& pair) const {
+    if (!state_.exit_price.has_value()) {
+        return std::nullopt;
+    }
+    // States written before multi-pair support have no pair: they traded config.pair
+    const std::string& exit_pair = state_.pair.empty() ? config_.pair : state_.pair;
+    if (exit_pair != pair) {
+        return std::nullopt;
+    }
+    return state_.exit_price;
+}
+
 bool Strategy::fetch_price(TradeContext& ctx) {
-    TickerResult ticker = client_.get_ticker(config_.pair);
+    ctx.pair = active_pair();
+    std::shared_ptr<const SnapshotTable> table = market_data_.snapshot();
+    const MarketSnapshot* snap = table->find(ctx.pair);
     
-    if (!ticker.success) {
-        LOG_ERROR("Failed to fetch ticker: " + ticker.error);
+    if (snap == nullptr || snap->timestamp == 0) {
+        LOG_ERROR("No market data for " + ctx.pair);
         ctx.decision = Decision::BLOCKED;
-        ctx.decision_reason = "Price fetch failed: " + ticker.error;
+        assign_concat(ctx.decision_reason, "Price fetch failed: no market data for ", ctx.pair);
         return false;
     }
     
-    ctx.current_price = ticker.last_price;
-    ctx.bid_price = ticker.bid_price;
-    ctx.ask_price = ticker.ask_price;
-    ctx.price_timestamp = ticker.timestamp;
+    ctx.current_price = snap->last_price;
+    ctx.bid_price = snap->bid_price;
+    ctx.ask_price = snap->ask_price;
+    ctx.price_timestamp = snap->timestamp;
+    ctx.price_receive_ns = snap->receive_ns;
+    ctx.price_exchange_ns = snap->exchange_ns;
+    
+    const BookSignals& book = snap->book;
+    if (book.valid && util::now_epoch_ns() - book.receive_ns <= config_.stale_price_seconds * 1'000'000'000) {
+        ctx.book_valid = true;
+        ctx.book_imbalance = book.imbalance;
+        ctx.microprice = book.microprice;
+        ctx.weighted_mid = book.weighted_mid;
+        ctx.bid_slope = book.bid_slope;
+        ctx.ask_slope = book.ask_slope;
+    }
     
-    // Check for stale price
-    int64_t age = util::now_epoch_seconds() - ctx.price_timestamp;
-    ctx.price_stale = age > config_.stale_price_seconds;
+    return check_price_age(ctx);
+}
+
+bool Strategy::check_price_age(TradeContext& ctx) {
+    // Age on the exchange clock: includes network delay and any ticks the
+    // quote sat in the snapshot cache after a failed refresh
+    int64_t now_ns = util::now_epoch_ns();
+    int64_t age_ns = 0;
+    if (ctx.price_exchange_ns > 0) {
+        age_ns = client_.clock().to_exchange_ns(now_ns) - ctx.price_exchange_ns;
+    } else {
+        age_ns = now_ns - ctx.price_timestamp * 1'000'000'000;
+    }
+    ctx.price_age_ms = age_ns / 1'000'000;
+    ctx.price_stale = ctx.price_age_ms > config_.stale_price_seconds * 1000;
     
     if (ctx.price_stale) {
-        LOG_WARNING("Price is stale (age: " + std::to_string(age) + "s)");
+        LOG_WARNING("Price is stale (age: " + std::to_string(ctx.price_age_ms) + "ms)");
         ctx.decision = Decision::BLOCKED;
         ctx.decision_reason = "Price data is stale";
         return false;
@@ -86,24 +149,131 @@ bool Strategy::fetch_price(TradeContext& ctx) {
     return true;
 }
 
-void Strategy::update_indicators(TradeContext& ctx) {
-    if (ctx.current_price <= 0) {
-        return;
+bool Strategy::select_scanned_pair(TradeContext& ctx) {
+    if (state_.mode == TradingMode::LONG) {
+        if (!scanner_->fill_context(active_pair(), ctx)) {
+            ctx.pair = active_pair();
+            ctx.decision = Decision::BLOCKED;
+            assign_concat(ctx.decision_reason, "Scanner has no price for position pair ", ctx.pair);
+            return false;
+        }
+        return check_price_age(ctx);
+    }
+    
+    // Ranking is eligible-first, so stop at the first pair that failed the filters
+    for (const ScanCandidate& candidate : scanner_->ranking()) {
+        if (!candidate.eligible) {
+            break;
+        }
+        std::optional<double> exit = exit_price_for(candidate.pair);
+        if (exit.has_value() && candidate.last_price > exit.value() * (1.0 - config_.rebuy_reset_pct)) {
+            continue;
+        }
+        if (scanner_->fill_context(candidate.pair, ctx)) {
+            return check_price_age(ctx);
+        }
+    }
+    
+    ctx.pair = config_.pair;
+    ctx.decision = Decision::NOOP;
+    assign_concat(ctx.decision_reason, "Scanner: no eligible candidate among ",
+                  std::to_string(scanner_->pair_count()), " pairs");
+    return false;
+}
+
+void Strategy::save_state() const {
+    // Backtests run without a state file
+    if (!config_.state_file.empty()) {
+        state_.save(config_.state_file);
+    }
+}
+
+IndicatorWindows Strategy::indicator_windows() const {
+    IndicatorWindows windows;
+    windows.prices.assign(price_history_.begin(), price_history_.end());
+    windows.true_ranges.assign(tr_history_.begin(), tr_history_.end());
+    return windows;
+}
+
+void Strategy::restore_indicators(const IndicatorWindows& windows) {
+    // Keep only what the configured windows would have retained
+    size_t prices = std::min(windows.prices.size(), static_cast<size_t>(std::max(config_.trend_window_long, 0)));
+    size_t trs = std::min(windows.true_ranges.size(), static_cast<size_t>(std::max(config_.atr_window, 0)));
+    price_history_.assign(windows.prices.end() - prices, windows.prices.end());
+    tr_history_.assign(windows.true_ranges.end() - trs, windows.true_ranges.end());
+}
+
+void Strategy::backfill_indicators(const std::vector<double>& closes) {
+    // Same close-to-close true range as update_indicators()
+    IndicatorWindows windows;
+    windows.prices = closes;
+    for (size_t i = 1; i < closes.size(); i++) {
+        windows.true_ranges.push_back(std::abs(closes[i] - closes[i - 1]));
+    }
+    restore_indicators(windows);
+}
+
+bool Strategy::indicators_ready() const {
+    if (config_.require_trend_up && config_.trend_window_short > 0 && config_.trend_window_long > 0 &&
+        static_cast<int>(price_history_.size()) < config_.trend_window_long) {
+        return false;
     }
+    if (config_.min_atr_pct > 0 && config_.atr_window > 0 &&
+        static_cast<int>(tr_history_.size()) < config_.atr_window) {
+        return false;
+    }
+    return true;
+}
 
+void Strategy::add_indicator_sample(double price, double high, double low) {
     if (!price_history_.empty()) {
         double prev_price = price_history_.back();
-        double tr = std::abs(ctx.current_price - prev_price);
+        double tr = std::max({high - low, std::abs(high - prev_price), std::abs(low - prev_price)});
         tr_history_.push_back(tr);
         if (static_cast<int>(tr_history_.size()) > config_.atr_window) {
             tr_history_.pop_front();
         }
     }
 
-    price_history_.push_back(ctx.current_price);
+    price_history_.push_back(price);
     if (static_cast<int>(price_history_.size()) > config_.trend_window_long) {
         price_history_.pop_front();
     }
+}
+
+void Strategy::update_indicators(TradeContext& ctx) {
+    if (ctx.current_price <= 0) {
+        return;
+    }
+
+    const bool tape_pair = tape_ != nullptr && ctx.pair == tape_->pair();
+    const bool from_tape = tape_pair && config_.indicator_source == "tape";
+    if (tape_ != nullptr) {
+        // Drained whenever indicators run, whatever the source; the tape
+        // caps what waits in between
+        for (const TapeBar& bar : tape_->take_closed_bars()) {
+            if (from_tape) {
+                add_indicator_sample(bar.close, bar.high, bar.low);
+            }
+        }
+    }
+    if (tape_pair) {
+        ctx.vwap = tape_->vwap();
+        ctx.tape_volume = tape_->volume();
+        ctx.tape_buy_volume = tape_->buy_volume();
+        ctx.tape_sell_volume = tape_->sell_volume();
+        if (const FlowToxicity* flow = tape_->flow()) {
+            FlowSignals f = flow->signals();
+            ctx.flow_valid = f.valid;
+            ctx.flow_buckets = f.buckets;
+            ctx.vpin = f.vpin;
+            ctx.flow_imbalance = f.imbalance;
+        }
+    }
+    if (!from_tape) {
+        // Poll samples: the true range is the close-to-close move
+        add_indicator_sample(ctx.current_price, ctx.current_price, ctx.current_price);
+    }
 
     if (config_.atr_window > 0 && !tr_history_.empty()) {
         double tr_sum = 0.0;
@@ -154,6 +324,31 @@ bool Strategy::passes_trend_filter(TradeContext& ctx) const {
     return ctx.sma_short >= ctx.sma_long;
 }
 
+bool Strategy::passes_book_filter(TradeContext& ctx) const {
+    if (!config_.book_signals_enabled ||
+        (config_.min_book_imbalance <= -1.0 && !config_.require_microprice_above_mid)) {
+        return true;
+    }
+    if (!ctx.book_valid) {
+        return false;
+    }
+    if (ctx.book_imbalance < config_.min_book_imbalance) {
+        return false;
+    }
+    // Microprice above the mid: more size bid than offered at the touch
+    return !config_.require_microprice_above_mid || ctx.microprice > (ctx.bid_price + ctx.ask_price) / 2.0;
+}
+
+bool Strategy::passes_flow_filter(TradeContext& ctx) const {
+    if (!config_.vpin_enabled || (config_.max_vpin >= 1.0 && config_.min_flow_imbalance <= -1.0)) {
+        return true;
+    }
+    if (!ctx.flow_valid) {
+        return false;
+    }
+    return ctx.vpin <= config_.max_vpin && ctx.flow_imbalance >= config_.min_flow_imbalance;
+}
+
 bool Strategy::passes_volatility_filter(TradeContext& ctx) const {
     if (config_.min_atr_pct <= 0 || ctx.current_price <= 0) {
         return true;
@@ -183,7 +378,7 @@ void Strategy::calculate_sizing(TradeContext& ctx) {
         BalanceResult balance = client_.get_balance();
         if (!balance.success) {
             ctx.sizing.can_trade = false;
-            ctx.sizing.block_reason = "Balance fetch failed: " + balance.error;
+            assign_concat(ctx.sizing.block_reason, "Balance fetch failed: ", balance.error);
             return;
         }
         
@@ -226,13 +421,13 @@ void Strategy::calculate_sizing(TradeContext& ctx) {
     double required_cad = ctx.sizing.position_cad + ctx.sizing.fee_buffer_cad;
     if (ctx.sizing.available_cad < required_cad) {
         ctx.sizing.can_trade = false;
-        ctx.sizing.block_reason = "Insufficient CAD: need " + 
-            std::to_string(required_cad) + ", have " + 
-            std::to_string(ctx.sizing.available_cad);
+        assign_concat(ctx.sizing.block_reason, "Insufficient CAD: need ",
+                      std::to_string(required_cad), ", have ",
+                      std::to_string(ctx.sizing.available_cad));
     } else if (ctx.sizing.position_cad < 1.0) {
         ctx.sizing.can_trade = false;
-        ctx.sizing.block_reason = "Position size too small: " + 
-            std::to_string(ctx.sizing.position_cad) + " CAD";
+        assign_concat(ctx.sizing.block_reason, "Position size too small: ",
+                      std::to_string(ctx.sizing.position_cad), " CAD");
     } else {
         ctx.sizing.can_trade = true;
     }
@@ -242,25 +437,25 @@ bool Strategy::check_blocking_conditions(TradeContext& ctx) {
     // Check cooldown
     if (state_.is_in_cooldown(config_.cooldown_seconds)) {
         ctx.decision = Decision::BLOCKED;
-        ctx.decision_reason = "Cooldown active: " + 
-            std::to_string(state_.cooldown_remaining(config_.cooldown_seconds)) + "s remaining";
+        assign_concat(ctx.decision_reason, "Cooldown active: ",
+                      std::to_string(state_.cooldown_remaining(config_.cooldown_seconds)), "s remaining");
         return true;
     }
     
     // Check max trades per day
     if (state_.trades_today >= config_.max_trades_per_day) {
         ctx.decision = Decision::BLOCKED;
-        ctx.decision_reason = "Max trades per day reached: " + 
-            std::to_string(state_.trades_today) + "/" + 
-            std::to_string(config_.max_trades_per_day);
+        assign_concat(ctx.decision_reason, "Max trades per day reached: ",
+                      std::to_string(state_.trades_today), "/",
+                      std::to_string(config_.max_trades_per_day));
         return true;
     }
     
     // Check consecutive API failures
     if (client_.get_consecutive_failures() >= config_.max_consecutive_failures) {
         ctx.decision = Decision::BLOCKED;
-        ctx.decision_reason = "Too many consecutive API failures: " + 
-            std::to_string(client_.get_consecutive_failures());
+        assign_concat(ctx.decision_reason, "Too many consecutive API failures: ",
+                      std::to_string(client_.get_consecutive_failures()));
         return true;
     }
     
@@ -270,13 +465,13 @@ bool Strategy::check_blocking_conditions(TradeContext& ctx) {
 bool Strategy::check_market_conditions(TradeContext& ctx) {
     if (config_.max_spread_pct > 0 && ctx.spread_pct > config_.max_spread_pct) {
         ctx.decision = Decision::BLOCKED;
-        ctx.decision_reason = "Spread too wide: " + std::to_string(ctx.spread_pct * 100) + "%";
+        assign_concat(ctx.decision_reason, "Spread too wide: ", std::to_string(ctx.spread_pct * 100), "%");
         return true;
     }
 
     if (!passes_volatility_filter(ctx)) {
         ctx.decision = Decision::BLOCKED;
-        ctx.decision_reason = "Volatility too low (ATR): " + std::to_string(ctx.atr);
+        assign_concat(ctx.decision_reason, "Volatility too low (ATR): ", std::to_string(ctx.atr));
         return true;
     }
 
@@ -286,29 +481,53 @@ bool Strategy::check_market_conditions(TradeContext& ctx) {
         return true;
     }
 
+    if (!passes_book_filter(ctx)) {
+        ctx.decision = Decision::BLOCKED;
+        if (!ctx.book_valid) {
+            ctx.decision_reason = "Book filter: no recent order book";
+        } else {
+            assign_concat(ctx.decision_reason, "Book filter: imbalance ", std::to_string(ctx.book_imbalance),
+                          ", microprice ", std::to_string(ctx.microprice));
+        }
+        return true;
+    }
+
+    if (!passes_flow_filter(ctx)) {
+        ctx.decision = Decision::BLOCKED;
+        if (!ctx.flow_valid) {
+            assign_concat(ctx.decision_reason, "Flow filter: ", std::to_string(ctx.flow_buckets), "/",
+                          std::to_string(config_.vpin_buckets), " volume buckets filled");
+        } else {
+            assign_concat(ctx.decision_reason, "Flow filter: toxic flow, VPIN ", std::to_string(ctx.vpin),
+                          ", imbalance ", std::to_string(ctx.flow_imbalance));
+        }
+        return true;
+    }
+
     return false;
 }
 
 bool Strategy::check_entry_condition(TradeContext& ctx) {
-    // First trade ever: enter immediately
-    if (!state_.exit_price.has_value()) {
+    // First trade on this pair: enter immediately
+    std::optional<double> exit_price = exit_price_for(ctx.pair);
+    if (!exit_price.has_value()) {
         ctx.decision_reason = "First trade: entering immediately";
         return true;
     }
     
     // Subsequent trades: require price reset
-    ctx.rebuy_price = state_.exit_price.value() * (1.0 - config_.rebuy_reset_pct);
+    ctx.rebuy_price = exit_price.value() * (1.0 - config_.rebuy_reset_pct);
     
     if (ctx.current_price <= ctx.rebuy_price) {
-        ctx.decision_reason = "Price reset condition met: " + 
-            std::to_string(ctx.current_price) + " <= rebuy_price " + 
-            std::to_string(ctx.rebuy_price);
+        assign_concat(ctx.decision_reason, "Price reset condition met: ",
+                      std::to_string(ctx.current_price), " <= rebuy_price ",
+                      std::to_string(ctx.rebuy_price));
         return true;
     }
     
-    ctx.decision_reason = "Waiting for price reset: current=" + 
-        std::to_string(ctx.current_price) + ", rebuy_price=" + 
-        std::to_string(ctx.rebuy_price);
+    assign_concat(ctx.decision_reason, "Waiting for price reset: current=",
+                  std::to_string(ctx.current_price), ", rebuy_price=",
+                  std::to_string(ctx.rebuy_price));
     return false;
 }
 
@@ -362,25 +581,25 @@ bool Strategy::check_exit_condition(TradeContext& ctx) {
     
     // Check take profit
     if (ctx.current_price >= ctx.tp_price) {
-        ctx.decision_reason = "Take profit triggered: " + 
-            std::to_string(ctx.current_price) + " >= tp_price " + 
-            std::to_string(ctx.tp_price);
+        assign_concat(ctx.decision_reason, "Take profit triggered: ",
+                      std::to_string(ctx.current_price), " >= tp_price ",
+                      std::to_string(ctx.tp_price));
         return true;
     }
     
     // Check stop loss
     if (ctx.current_price <= ctx.sl_price) {
-        ctx.decision_reason = "Stop loss triggered: " + 
-            std::to_string(ctx.current_price) + " <= sl_price " + 
-            std::to_string(ctx.sl_price);
+        assign_concat(ctx.decision_reason, "Stop loss triggered: ",
+                      std::to_string(ctx.current_price), " <= sl_price ",
+                      std::to_string(ctx.sl_price));
         return true;
     }
     
-    ctx.decision_reason = "Holding position: price=" + 
-        std::to_string(ctx.current_price) + 
-        ", entry=" + std::to_string(entry) + 
-        ", tp=" + std::to_string(ctx.tp_price) + 
-        ", sl=" + std::to_string(ctx.sl_price);
+    assign_concat(ctx.decision_reason, "Holding position: price=",
+                  std::to_string(ctx.current_price),
+                  ", entry=", std::to_string(entry),
+                  ", tp=", std::to_string(ctx.tp_price),
+                  ", sl=", std::to_string(ctx.sl_price));
     return false;
 }
 
@@ -390,12 +609,22 @@ TradeContext Strategy::evaluate() {
     // Check date rollover (resets trades_today)
     state_.check_date_rollover();
     
-    // Fetch current price
-    if (!fetch_price(ctx)) {
-        return ctx;
+    // Fills the paper engine matched since the last tick
+    if (paper_ != nullptr) {
+        apply_paper_fills();
+    }
+    
+    // Fetch current price (scanner mode reads the pre-computed per-pair row)
+    if (scanner_ != nullptr) {
+        if (!select_scanned_pair(ctx)) {
+            return ctx;
+        }
+    } else {
+        if (!fetch_price(ctx)) {
+            return ctx;
+        }
+        update_indicators(ctx);
     }
-
-    update_indicators(ctx);
     
     // Check blocking conditions
     if (check_blocking_conditions(ctx)) {
@@ -404,6 +633,12 @@ TradeContext Strategy::evaluate() {
     
     // Mode-specific logic
     if (state_.mode == TradingMode::FLAT) {
+        if (paper_ != nullptr && paper_->find(paper_entry_id_) != nullptr) {
+            ctx.decision = Decision::NOOP;
+            ctx.decision_reason = "Paper limit buy working";
+            return ctx;
+        }
+        
         // Calculate sizing for potential entry
         calculate_sizing(ctx);
         
@@ -477,13 +712,34 @@ bool Strategy::execute_buy(const TradeContext& ctx) {
              std::to_string(ctx.current_price) + " CAD");
     
     if (config_.dry_run) {
+        if (paper_ != nullptr) {
+            // state_.pair moves to ctx.pair when the entry fills: a post-only
+            // entry that times out must leave the last exit's pair in place
+            PaperOrder order;
+            order.pair = ctx.pair;
+            order.buy = true;
+            order.volume = ctx.sizing.btc_to_buy;
+            if (config_.paper_entry_order == "limit") {
+                order.type = PaperOrderType::LIMIT;
+                order.limit_price = ctx.bid_price > 0.0 ? ctx.bid_price : ctx.current_price;
+                order.post_only = true;
+            }
+            paper_entry_id_ = paper_->submit(order, ctx.current_price);
+            if (paper_entry_id_ == 0) {
+                return false;
+            }
+            apply_paper_fills();
+            return true;
+        }
+        
         // Simulate the buy
+        state_.pair = ctx.pair;
         simulate_fill("buy", ctx.sizing.btc_to_buy, ctx.current_price);
         return true;
     }
     
     // Live mode: place actual order
-    OrderResult order = client_.place_market_order(config_.pair, "buy", ctx.sizing.btc_to_buy);
+    OrderResult order = client_.place_market_order(ctx.pair, "buy", ctx.sizing.btc_to_buy);
     
     if (!order.success) {
         LOG_ERROR("Failed to place buy order: " + order.error);
@@ -499,8 +755,10 @@ bool Strategy::execute_buy(const TradeContext& ctx) {
     }
     
     // Update state with confirmed fill details
+    state_.pair = ctx.pair;
     state_.entry_price = fill_result.avg_price;
     state_.btc_amount = fill_result.volume;
+    state_.entry_fee_cad = fill_result.fee;
     state_.mode = TradingMode::LONG;
     state_.trades_today++;
     state_.last_trade_time = util::now_epoch_seconds();
@@ -511,7 +769,7 @@ bool Strategy::execute_buy(const TradeContext& ctx) {
     } else {
         state_.trailing_stop_price = std::nullopt;
     }
-    state_.save(config_.state_file);
+    save_state();
     
     LOG_INFO("BUY FILLED: txid=" + fill_result.txid + 
              ", vol=" + std::to_string(fill_result.volume) + 
@@ -540,13 +798,29 @@ bool Strategy::execute_sell(const TradeContext& ctx) {
              std::to_string(ctx.current_price) + " CAD");
     
     if (config_.dry_run) {
+        if (paper_ != nullptr) {
+            // Pull the resting stop (and any working entry) before selling
+            paper_->cancel_all(ctx.pair);
+            PaperOrder order;
+            order.pair = ctx.pair;
+            order.buy = false;
+            order.volume = btc_to_sell;
+            uint64_t id = paper_->submit(order, ctx.current_price);
+            if (id == 0) {
+                return false;
+            }
+            paper_partial_exit_id_ = ctx.is_partial_exit ? id : 0;
+            apply_paper_fills();
+            return true;
+        }
+        
         // Simulate the sell
-        simulate_fill("sell", btc_to_sell, ctx.current_price);
+        simulate_fill("sell", btc_to_sell, ctx.current_price, std::nullopt, ctx.is_partial_exit);
         return true;
     }
     
     // Live mode: place actual order
-    OrderResult order = client_.place_market_order(config_.pair, "sell", btc_to_sell);
+    OrderResult order = client_.place_market_order(ctx.pair, "sell", btc_to_sell);
     
     if (!order.success) {
         LOG_ERROR("Failed to place sell order: " + order.error);
@@ -561,6 +835,16 @@ bool Strategy::execute_sell(const TradeContext& ctx) {
         return false;
     }
     
+    LedgerEntry entry;
+    entry.pair = ctx.pair;
+    entry.entry_time = state_.entry_time.value_or(0);
+    entry.entry_price = state_.entry_price.value_or(0.0);
+    entry.exit_price = fill_result.avg_price;
+    entry.volume = fill_result.volume;
+    entry.fee_cad = fill_result.fee;
+    double buy_fee = charge_entry_fee(fill_result.volume, state_.btc_amount);
+    entry.pnl_cad = fill_result.volume * (fill_result.avg_price - entry.entry_price) - fill_result.fee - buy_fee;
+    
     // Update state with confirmed fill details
     state_.exit_price = fill_result.avg_price;
     state_.btc_amount = std::max(0.0, state_.btc_amount - fill_result.volume);
@@ -574,7 +858,11 @@ bool Strategy::execute_sell(const TradeContext& ctx) {
     }
     state_.trades_today++;
     state_.last_trade_time = util::now_epoch_seconds();
-    state_.save(config_.state_file);
+    save_state();
+    
+    entry.time = state_.last_trade_time.value();
+    entry.closed = state_.mode == TradingMode::FLAT;
+    ledger_.append(entry);
     
     LOG_INFO("SELL FILLED: txid=" + fill_result.txid + 
              ", vol=" + std::to_string(fill_result.volume) + 
@@ -591,17 +879,35 @@ bool Strategy::execute_sell(const TradeContext& ctx) {
     return true;
 }
 
-void Strategy::simulate_fill(const std::string& side, double btc_amount, double price) {
+void Strategy::simulate_fill(const std::string& side, double btc_amount, double price,
+                             std::optional<double> fee_cad, bool partial_exit) {
     if (side == "buy") {
         double cost_cad = btc_amount * price;
         
-        // Deduct CAD, add BTC
-        state_.sim_cad_balance -= cost_cad;
+        // Another partial fill of a resting paper entry
+        if (state_.mode == TradingMode::LONG && state_.sim_btc_balance > 0.0) {
+            double held = state_.sim_btc_balance;
+            state_.sim_cad_balance -= cost_cad + fee_cad.value_or(0.0);
+            state_.entry_fee_cad += fee_cad.value_or(0.0);
+            state_.sim_btc_balance = held + btc_amount;
+            state_.btc_amount = state_.sim_btc_balance;
+            state_.entry_price = (state_.entry_price.value_or(price) * held + cost_cad) / state_.sim_btc_balance;
+            LOG_INFO("[SIMULATED] BUY FILLED (partial): " + std::to_string(btc_amount) + 
+                     " XBT @ " + std::to_string(price) + 
+                     ", position " + std::to_string(state_.sim_btc_balance) + 
+                     " XBT @ " + std::to_string(state_.entry_price.value()));
+            save_state();
+            return;
+        }
+        
+        // Deduct CAD (and the entry fee when the fill carries one), add BTC
+        state_.sim_cad_balance -= cost_cad + fee_cad.value_or(0.0);
         state_.sim_btc_balance = btc_amount;
         
         // Update state
         state_.entry_price = price;
         state_.btc_amount = btc_amount;
+        state_.entry_fee_cad = fee_cad.value_or(0.0);
         state_.mode = TradingMode::LONG;
         state_.trades_today++;
         state_.last_trade_time = util::now_epoch_seconds();
@@ -622,8 +928,8 @@ void Strategy::simulate_fill(const std::string& side, double btc_amount, double
     } else {  // sell
         double proceeds_cad = btc_amount * price;
         
-        // Apply simulated fee on round-trip
-        double fee = proceeds_cad * config_.sim_fee_pct_roundtrip;
+        // Apply the fill's fee, or the simulated round-trip fee
+        double fee = fee_cad.value_or(proceeds_cad * config_.sim_fee_pct_roundtrip);
         proceeds_cad -= fee;
         
         // Add CAD, clear BTC
@@ -631,22 +937,33 @@ void Strategy::simulate_fill(const std::string& side, double btc_amount, double
         state_.sim_btc_balance = std::max(0.0, state_.sim_btc_balance - btc_amount);
         
         // Log P&L
+        double buy_fee = charge_entry_fee(btc_amount, state_.btc_amount);
         double pnl_cad = 0.0;
         double pnl_pct = 0.0;
         if (state_.entry_price.has_value()) {
             double entry = state_.entry_price.value();
             double gross_proceeds = btc_amount * price;
             double cost = btc_amount * entry;
-            pnl_cad = gross_proceeds - cost - fee;
+            pnl_cad = gross_proceeds - cost - fee - buy_fee;
             pnl_pct = (pnl_cad / cost) * 100.0;
         }
         
+        LedgerEntry entry;
+        entry.pair = state_.pair.empty() ? config_.pair : state_.pair;
+        entry.entry_time = state_.entry_time.value_or(0);
+        entry.entry_price = state_.entry_price.value_or(0.0);
+        entry.exit_price = price;
+        entry.volume = btc_amount;
+        entry.fee_cad = fee;
+        entry.pnl_cad = pnl_cad;
+        entry.simulated = true;
+        
         // Update state
         state_.exit_price = price;
         state_.btc_amount = std::max(0.0, state_.btc_amount - btc_amount);
-        if (state_.btc_amount > 0.0) {
+        if (partial_exit && state_.btc_amount > 0.0) {
             state_.partial_take_profit_done = true;
-        } else {
+        } else if (state_.btc_amount <= 0.0) {
             state_.mode = TradingMode::FLAT;
             state_.entry_time = std::nullopt;
             state_.trailing_stop_price = std::nullopt;
@@ -654,6 +971,10 @@ void Strategy::simulate_fill(const std::string& side, double btc_amount, double
         state_.trades_today++;
         state_.last_trade_time = util::now_epoch_seconds();
         
+        entry.time = state_.last_trade_time.value();
+        entry.closed = state_.mode == TradingMode::FLAT;
+        ledger_.append(entry);
+        
         LOG_INFO("[SIMULATED] SELL FILLED: " + std::to_string(btc_amount) + 
                  " XBT @ " + std::to_string(price) + 
                  " (proceeds: " + std::to_string(proceeds_cad) + 
@@ -664,7 +985,90 @@ void Strategy::simulate_fill(const std::string& side, double btc_amount, double
                  ", XBT=" + std::to_string(state_.sim_btc_balance));
     }
     
-    state_.save(config_.state_file);
+    save_state();
+}
+
+double Strategy::charge_entry_fee(double sold, double held) {
+    if (held <= 0.0 || sold >= held) {
+        double fee = state_.entry_fee_cad;
+        state_.entry_fee_cad = 0.0;
+        return fee;
+    }
+    double fee = state_.entry_fee_cad * sold / held;
+    state_.entry_fee_cad -= fee;
+    return fee;
+}
+
+void Strategy::apply_paper_fills() {
+    auto fills = paper_->take_fills();
+    
+    // A market order walking several levels arrives as several fills but
+    // counts as one trade
+    for (size_t i = 0; i < fills.size();) {
+        PaperFill merged = fills[i];
+        double notional = merged.price * merged.volume;
+        size_t j = i + 1;
+        for (; j < fills.size() && fills[j].order_id == merged.order_id; j++) {
+            notional += fills[j].price * fills[j].volume;
+            merged.volume += fills[j].volume;
+            merged.fee_cad += fills[j].fee_cad;
+        }
+        merged.price = notional / merged.volume;
+        i = j;
+        
+        if (merged.buy) {
+            state_.pair = merged.pair;
+            simulate_fill("buy", merged.volume, merged.price, merged.fee_cad);
+        } else if (state_.mode == TradingMode::LONG) {
+            // A stop or full exit the book only partly filled is not a take-profit
+            simulate_fill("sell", std::min(merged.volume, state_.sim_btc_balance), merged.price, merged.fee_cad,
+                          merged.order_id == paper_partial_exit_id_);
+        }
+    }
+}
+
+void Strategy::manage_paper_orders(const TradeContext& ctx) {
+    if (paper_ == nullptr) {
+        return;
+    }
+    
+    if (const PaperOrder* entry = paper_->find(paper_entry_id_)) {
+        int64_t age_seconds = (util::now_epoch_ns() - entry->created_ns) / 1'000'000'000;
+        if (age_seconds >= config_.paper_limit_timeout_seconds) {
+            LOG_INFO("[SIMULATED] Limit buy unfilled after " + std::to_string(age_seconds) + "s, canceling");
+            paper_->cancel(paper_entry_id_);
+        }
+    }
+    
+    const PaperOrder* stop = paper_->find(paper_stop_id_);
+    if (state_.mode != TradingMode::LONG || !config_.paper_stop_orders) {
+        if (stop != nullptr) {
+            paper_->cancel(paper_stop_id_);
+        }
+        return;
+    }
+    
+    // Levels are only computed when the tick got past the blocking checks
+    if (ctx.sl_price <= 0.0) {
+        return;
+    }
+    double stop_price = std::max(ctx.sl_price, state_.trailing_stop_price.value_or(0.0));
+    double volume = state_.sim_btc_balance;
+    if (stop != nullptr && std::fabs(stop->stop_price - stop_price) <= 1e-9 * stop_price &&
+        std::fabs(stop->remaining() - volume) <= 1e-12) {
+        return;
+    }
+    
+    if (stop != nullptr) {
+        paper_->cancel(paper_stop_id_);
+    }
+    PaperOrder order;
+    order.pair = active_pair();
+    order.buy = false;
+    order.type = PaperOrderType::STOP_LOSS;
+    order.volume = volume;
+    order.stop_price = stop_price;
+    paper_stop_id_ = paper_->submit(order, ctx.current_price);
 }
 
 bool Strategy::execute(const TradeContext& ctx) {
@@ -4,9 +4,17 @@
 #include "config.hpp"
 #include "state.hpp"
 #include "kraken_client.hpp"
+#include "market_data.hpp"
+#include "trade_ledger.hpp"
+#include "tick_arena.hpp"
 #include <string>
 #include <optional>
 #include <deque>
+#include <vector>
+
+class Scanner;
+class PaperExchange;
+class TradeTape;
 
 enum class Decision {
     NOOP,
@@ -18,6 +26,8 @@ enum class Decision {
 std::string decision_to_string(Decision d);
 
 struct PositionSizing {
+    explicit PositionSizing(std::pmr::memory_resource* mr = tick_resource()) : block_reason(mr) {}
+    
     double equity_cad = 0.0;
     double available_cad = 0.0;
     double risk_cad = 0.0;
@@ -27,12 +37,20 @@ struct PositionSizing {
     double fee_buffer_cad = 0.0;
     double btc_to_buy = 0.0;
     bool can_trade = false;
-    std::string block_reason;
+    std::pmr::string block_reason;
 };
 
+// Lives for one tick: the reason strings come from the tick arena when
+// constructed inside a TickArena::Scope
 struct TradeContext {
+    explicit TradeContext(std::pmr::memory_resource* mr = tick_resource()) : sizing(mr), decision_reason(mr) {}
+    
+    std::string pair;
     double current_price = 0.0;
     int64_t price_timestamp = 0;
+    int64_t price_receive_ns = 0;    // Local time the quote arrived
+    int64_t price_exchange_ns = 0;   // Exchange time the quote was served
+    int64_t price_age_ms = 0;        // Exchange-clock age at evaluation
     bool price_stale = false;
     double bid_price = 0.0;
     double ask_price = 0.0;
@@ -41,6 +59,28 @@ struct TradeContext {
     double sma_short = 0.0;
     double sma_long = 0.0;
     
+    // L2 book signals (book_signals_enabled); book_valid is false without
+    // a book at least as fresh as stale_price_seconds
+    bool book_valid = false;
+    double book_imbalance = 0.0;
+    double microprice = 0.0;
+    double weighted_mid = 0.0;
+    double bid_slope = 0.0;
+    double ask_slope = 0.0;
+    
+    // Trade tape over the last tape_vwap_bars bars (tape_enabled)
+    double vwap = 0.0;
+    double tape_volume = 0.0;
+    double tape_buy_volume = 0.0;
+    double tape_sell_volume = 0.0;
+    
+    // Order-flow toxicity (vpin_enabled); flow_valid is false until the
+    // window's vpin_buckets buckets have filled
+    bool flow_valid = false;
+    int flow_buckets = 0;
+    double vpin = 0.0;
+    double flow_imbalance = 0.0;
+    
     double tp_price = 0.0;
     double sl_price = 0.0;
     double rebuy_price = 0.0;
@@ -48,7 +88,7 @@ struct TradeContext {
     PositionSizing sizing;
     
     Decision decision = Decision::NOOP;
-    std::string decision_reason;
+    std::pmr::string decision_reason;
     double sell_volume = 0.0;
     bool is_partial_exit = false;
     
@@ -56,9 +96,16 @@ struct TradeContext {
     void log() const;
 };
 
+// Indicator history handed from a leader to its standby, oldest first
+struct IndicatorWindows {
+    std::vector<double> prices;
+    std::vector<double> true_ranges;
+};
+
 class Strategy {
 public:
-    Strategy(const Config& config, TradingState& state, KrakenClient& client);
+    Strategy(const Config& config, TradingState& state, KrakenClient& client,
+             const MarketDataCache& market_data);
     
     // Main evaluation function - returns decision and context
     TradeContext evaluate();
@@ -68,15 +115,62 @@ public:
     
     // For dry-run mode: initialize simulated balances
     void init_simulation(double initial_cad);
+    
+    // Route entries through the multi-pair scanner instead of config.pair
+    void attach_scanner(const Scanner* scanner) { scanner_ = scanner; }
+    
+    // Dry-run orders go through the paper matching engine instead of
+    // filling instantly at the last price
+    void attach_paper_exchange(PaperExchange* paper) { paper_ = paper; }
+    
+    // Read VWAP and buy/sell volume from the trade tape; with
+    // indicator_source "tape" its closed bars also drive the SMA/ATR
+    // windows instead of per-poll last prices
+    void attach_trade_tape(TradeTape* tape) { tape_ = tape; }
+    
+    // Cancel stale paper entries and keep the resting stop at the current
+    // stop level; call once per tick after execute()
+    void manage_paper_orders(const TradeContext& ctx);
+    
+    // Copy out / restore the SMA and ATR windows so a standby does not
+    // have to warm up again after taking over
+    IndicatorWindows indicator_windows() const;
+    void restore_indicators(const IndicatorWindows& windows);
+    
+    // Seed the windows from historical closes (oldest first), e.g. OHLC
+    // bars fetched at startup, so the first tick does not start cold
+    void backfill_indicators(const std::vector<double>& closes);
+    
+    // Every window the entry filters use is full, so evaluate() decides on
+    // complete indicators rather than a warm-up
+    bool indicators_ready() const;
 
 private:
-    // Fetch current price
+    // Pair of the open position, or config.pair when flat
+    std::string active_pair() const;
+    
+    // Last exit price if it was recorded for this pair
+    std::optional<double> exit_price_for(const std::string& pair) const;
+    
+    // Read current price from the shared market data snapshot
     bool fetch_price(TradeContext& ctx);
+    
+    // Block on quotes older than stale_price_seconds
+    bool check_price_age(TradeContext& ctx);
+    
+    // Pick the best scanned pair (FLAT) or the position pair (LONG)
+    bool select_scanned_pair(TradeContext& ctx);
 
     // Update indicators (SMA, ATR, spread)
     void update_indicators(TradeContext& ctx);
+    
+    // Append one sample to the SMA/ATR windows; true range spans high/low
+    // and the previous sample
+    void add_indicator_sample(double price, double high, double low);
     bool passes_trend_filter(TradeContext& ctx) const;
     bool passes_volatility_filter(TradeContext& ctx) const;
+    bool passes_book_filter(TradeContext& ctx) const;
+    bool passes_flow_filter(TradeContext& ctx) const;
     
     // Calculate position sizing
     void calculate_sizing(TradeContext& ctx);
@@ -99,8 +193,20 @@ private:
     // Execute sell order  
     bool execute_sell(const TradeContext& ctx);
     
-    // Simulate a fill (dry-run mode)
-    void simulate_fill(const std::string& side, double btc_amount, double price);
+    // Persist state after a fill (skipped when state_file is empty)
+    void save_state() const;
+    
+    // Simulate a fill (dry-run mode); without fee_cad the round-trip fee
+    // is charged on the sell. partial_exit marks a partial take-profit sell.
+    void simulate_fill(const std::string& side, double btc_amount, double price,
+                       std::optional<double> fee_cad = std::nullopt, bool partial_exit = false);
+    
+    // Take the share of the position's buy fee that a sell of `sold` out
+    // of `held` realizes, so ledger P&L is net of both fees
+    double charge_entry_fee(double sold, double held);
+    
+    // Book paper engine fills into the simulated balances, one fill per order
+    void apply_paper_fills();
     
     // Wait for order fill confirmation
     bool wait_for_fill(const std::string& txid, OrderResult& out_result, int max_attempts = 10);
@@ -108,6 +214,14 @@ private:
     const Config& config_;
     TradingState& state_;
     KrakenClient& client_;
+    const MarketDataCache& market_data_;
+    const Scanner* scanner_ = nullptr;
+    PaperExchange* paper_ = nullptr;
+    TradeTape* tape_ = nullptr;
+    uint64_t paper_entry_id_ = 0;
+    uint64_t paper_stop_id_ = 0;
+    uint64_t paper_partial_exit_id_ = 0;  // Working partial take-profit sell
+    TradeLedger ledger_;
     std::deque<double> price_history_;
     std::deque<double> tr_history_;
 };
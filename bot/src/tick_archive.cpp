@@ -0,0 +1,631 @@
+#include "tick_archive.hpp"
+#include "logger.hpp"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <cerrno>
+#include <filesystem>
+
+static constexpr char kColdMagic[8] = {'K', 'R', 'K', 'N', 'C', 'L', 'D', '1'};
+static constexpr uint32_t kColdVersion = 1;
+
+struct ColdFileHeader {
+    char magic[8];
+    uint32_t version;
+    int32_t price_decimals;       // -1: XOR encoding
+    uint64_t ticks;
+    int64_t first_ns;
+    int64_t last_ns;
+    uint64_t payload_bytes;
+    uint64_t checksum;            // Of the payload
+    char pair[16];
+    char reserved[24];
+};
+static_assert(sizeof(ColdFileHeader) == 96, "cold segment header must stay 96 bytes");
+
+// Largest encoding of one tick: five 10-byte varints (XOR prices need at
+// most 9 bytes each). While this many bytes remain, a tick decodes without
+// per-byte bounds checks.
+static constexpr size_t kMaxTickBytes = 50;
+
+// Ticks decoded per step when appending to a vector (40 KB)
+static constexpr size_t kDecodeChunk = 1024;
+
+static constexpr int kMaxDecimals = 8;
+static constexpr double kPow10[kMaxDecimals + 1] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8};
+
+static inline uint64_t zigzag(int64_t v) {
+    return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+static inline int64_t unzigzag(uint64_t v) {
+    return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+}
+
+// Two's-complement wrap, so extreme timestamps round-trip instead of
+// overflowing
+static inline int64_t wrap_sub(int64_t a, int64_t b) {
+    return static_cast<int64_t>(static_cast<uint64_t>(a) - static_cast<uint64_t>(b));
+}
+
+static inline int64_t wrap_add(int64_t a, int64_t b) {
+    return static_cast<int64_t>(static_cast<uint64_t>(a) + static_cast<uint64_t>(b));
+}
+
+static inline uint8_t* put_varint(uint8_t* p, uint64_t v) {
+    while (v >= 0x80) {
+        *p++ = static_cast<uint8_t>(v) | 0x80;
+        v >>= 7;
+    }
+    *p++ = static_cast<uint8_t>(v);
+    return p;
+}
+
+// Caller guarantees 10 readable bytes
+static inline uint64_t get_varint_fast(const uint8_t*& p) {
+    uint64_t b = *p++;
+    if (b < 0x80) {
+        return b;
+    }
+    uint64_t v = b & 0x7f;
+    for (int shift = 7; shift < 64; shift += 7) {
+        b = *p++;
+        v |= (b & 0x7f) << shift;
+        if (b < 0x80) {
+            break;
+        }
+    }
+    return v;
+}
+
+static inline bool get_varint_checked(const uint8_t*& p, const uint8_t* end, uint64_t& v) {
+    v = 0;
+    for (int shift = 0; shift < 64 && p < end; shift += 7) {
+        uint64_t b = *p++;
+        v |= (b & 0x7f) << shift;
+        if (b < 0x80) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// XOR with the previous value: 0xFF for no change, else a byte holding the
+// leading and trailing zero-byte counts followed by the bytes between them
+static inline uint8_t* put_xor(uint8_t* p, uint64_t x) {
+    if (x == 0) {
+        *p++ = 0xFF;
+        return p;
+    }
+    int lead = std::countl_zero(x) / 8;
+    int trail = std::countr_zero(x) / 8;
+    *p++ = static_cast<uint8_t>((lead << 4) | trail);
+    x >>= trail * 8;
+    for (int i = 8 - lead - trail; i > 0; i--) {
+        *p++ = static_cast<uint8_t>(x);
+        x >>= 8;
+    }
+    return p;
+}
+
+static inline bool get_xor(const uint8_t*& p, const uint8_t* end, uint64_t& x) {
+    x = 0;
+    if (p >= end) {
+        return false;
+    }
+    uint8_t control = *p++;
+    if (control == 0xFF) {
+        return true;
+    }
+    int lead = control >> 4;
+    int trail = control & 0x0f;
+    int n = 8 - lead - trail;
+    if (n < 1 || end - p < n) {
+        return false;
+    }
+    for (int i = 0; i < n; i++) {
+        x |= static_cast<uint64_t>(p[i]) << (8 * i);
+    }
+    p += n;
+    x <<= trail * 8;
+    return true;
+}
+
+static_assert(std::endian::native == std::endian::little, "XOR fields are loaded as little-endian words");
+
+// get_xor for a caller that guarantees 9 readable bytes: one word load and
+// a mask instead of a byte loop
+static inline bool get_xor_fast(const uint8_t*& p, uint64_t& x) {
+    x = 0;
+    uint8_t control = *p++;
+    if (control == 0xFF) {
+        return true;
+    }
+    int trail = control & 0x0f;
+    int n = 8 - (control >> 4) - trail;
+    if (n < 1) {
+        return false;
+    }
+    std::memcpy(&x, p, 8);
+    if (n < 8) {
+        x &= (1ULL << (8 * n)) - 1;
+    }
+    x <<= 8 * trail;
+    p += n;
+    return true;
+}
+
+// Word-wise hash over four independent lanes, so checking a payload costs
+// little next to decoding it
+static uint64_t payload_checksum(const uint8_t* data, size_t size) {
+    constexpr uint64_t kMul = 0x9e3779b97f4a7c15ULL;
+    uint64_t lane[4] = {size, size ^ 0x5555555555555555ULL, size ^ 0xaaaaaaaaaaaaaaaaULL, ~size};
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        for (int k = 0; k < 4; k++) {
+            uint64_t w;
+            std::memcpy(&w, data + i + 8 * k, 8);
+            lane[k] = (lane[k] ^ w) * kMul;
+            lane[k] ^= lane[k] >> 29;
+        }
+    }
+    uint64_t h = lane[0] ^ std::rotl(lane[1], 16) ^ std::rotl(lane[2], 32) ^ std::rotl(lane[3], 48);
+    for (; i < size; i++) {
+        h = (h ^ data[i]) * kMul;
+    }
+    return h ^ (h >> 32);
+}
+
+// Fewest decimals at which every price is an exact integer count that
+// divides back to the identical double; -1 if none up to kMaxDecimals
+static int choose_decimals(const StoredTick* first, const StoredTick* last) {
+    for (int d = 0; d <= kMaxDecimals; d++) {
+        const double scale = kPow10[d];
+        bool exact = true;
+        for (const StoredTick* t = first; t != last && exact; ++t) {
+            for (double price : {t->last_price, t->bid_price, t->ask_price}) {
+                double scaled = std::nearbyint(price * scale);
+                if (!(std::fabs(scaled) < 9007199254740992.0) ||
+                    std::bit_cast<uint64_t>(scaled / scale) != std::bit_cast<uint64_t>(price)) {
+                    exact = false;
+                    break;
+                }
+            }
+        }
+        if (exact) {
+            return d;
+        }
+    }
+    return -1;
+}
+
+ColdSegmentDecoder::ColdSegmentDecoder(const uint8_t* payload, size_t size, uint64_t count, int price_decimals)
+    : p_(payload)
+    , end_(payload + size)
+    , remaining_(count)
+    , decimals_(price_decimals) {
+    if (decimals_ > kMaxDecimals) {
+        ok_ = false;
+    }
+}
+
+size_t ColdSegmentDecoder::next(StoredTick* out, size_t max) {
+    if (!ok_ || remaining_ == 0) {
+        return 0;
+    }
+    return decimals_ >= 0 ? run<true>(out, max) : run<false>(out, max);
+}
+
+template <bool Fixed>
+size_t ColdSegmentDecoder::run(StoredTick* out, size_t max) {
+    const double scale = Fixed ? kPow10[decimals_] : 1.0;
+    const size_t n = static_cast<size_t>(std::min<uint64_t>(max, remaining_));
+    // Locals so the compiler keeps the running state in registers; as
+    // members they could alias the int64_t fields of out
+    const uint8_t* p = p_;
+    int64_t prev_ns = prev_ns_;
+    int64_t prev_delta = prev_delta_;
+    int64_t prev_fixed[3] = {prev_fixed_[0], prev_fixed_[1], prev_fixed_[2]};
+    uint64_t prev_bits[3] = {prev_bits_[0], prev_bits_[1], prev_bits_[2]};
+    size_t i = 0;
+    for (; i < n; i++) {
+        uint64_t dod;
+        uint64_t offset;
+        double price[3];
+        bool good = true;
+        if (static_cast<size_t>(end_ - p) >= kMaxTickBytes) {
+            dod = get_varint_fast(p);
+            offset = get_varint_fast(p);
+            for (int k = 0; k < 3; k++) {
+                if constexpr (Fixed) {
+                    prev_fixed[k] = wrap_add(prev_fixed[k], unzigzag(get_varint_fast(p)));
+                    price[k] = static_cast<double>(prev_fixed[k]) / scale;
+                } else {
+                    uint64_t x;
+                    good &= get_xor_fast(p, x);
+                    prev_bits[k] ^= x;
+                    price[k] = std::bit_cast<double>(prev_bits[k]);
+                }
+            }
+        } else {
+            good = get_varint_checked(p, end_, dod) && get_varint_checked(p, end_, offset);
+            for (int k = 0; k < 3 && good; k++) {
+                if constexpr (Fixed) {
+                    uint64_t v;
+                    good = get_varint_checked(p, end_, v);
+                    prev_fixed[k] = wrap_add(prev_fixed[k], unzigzag(v));
+                    price[k] = static_cast<double>(prev_fixed[k]) / scale;
+                } else {
+                    uint64_t x;
+                    good = get_xor(p, end_, x);
+                    prev_bits[k] ^= x;
+                    price[k] = std::bit_cast<double>(prev_bits[k]);
+                }
+            }
+        }
+        if (!good) {
+            ok_ = false;
+            break;
+        }
+        prev_delta = wrap_add(prev_delta, unzigzag(dod));
+        prev_ns = wrap_add(prev_ns, prev_delta);
+        StoredTick& tick = out[i];
+        tick.exchange_ns = prev_ns;
+        tick.receive_ns = wrap_add(prev_ns, unzigzag(offset));
+        tick.last_price = price[0];
+        tick.bid_price = price[1];
+        tick.ask_price = price[2];
+    }
+    p_ = p;
+    prev_ns_ = prev_ns;
+    prev_delta_ = prev_delta;
+    std::copy(prev_fixed, prev_fixed + 3, prev_fixed_);
+    std::copy(prev_bits, prev_bits + 3, prev_bits_);
+    remaining_ -= i;
+    return i;
+}
+
+static bool decode_cold_ticks(const uint8_t* data, size_t size, uint64_t count, int price_decimals,
+                              StoredTick* out) {
+    ColdSegmentDecoder decoder(data, size, count, price_decimals);
+    return decoder.next(out, count) == count && decoder.ok();
+}
+
+bool write_cold_segment(const std::string& path, const std::string& pair, const StoredTick* first,
+                        const StoredTick* last, ColdSegmentInfo* info, std::string* error) {
+    auto fail = [&](const std::string& message) {
+        if (error != nullptr) {
+            *error = message;
+        }
+        return false;
+    };
+    if (first == last) {
+        return fail("no ticks");
+    }
+    const size_t count = static_cast<size_t>(last - first);
+    const int decimals = choose_decimals(first, last);
+    const double scale = decimals >= 0 ? kPow10[decimals] : 1.0;
+
+    std::vector<uint8_t> payload(count * kMaxTickBytes);
+    uint8_t* p = payload.data();
+    int64_t prev_ns = 0;
+    int64_t prev_delta = 0;
+    int64_t prev_fixed[3] = {0, 0, 0};
+    uint64_t prev_bits[3] = {0, 0, 0};
+    for (const StoredTick* t = first; t != last; ++t) {
+        int64_t delta = wrap_sub(t->exchange_ns, prev_ns);
+        p = put_varint(p, zigzag(wrap_sub(delta, prev_delta)));
+        prev_delta = delta;
+        prev_ns = t->exchange_ns;
+        p = put_varint(p, zigzag(wrap_sub(t->receive_ns, t->exchange_ns)));
+        const double prices[3] = {t->last_price, t->bid_price, t->ask_price};
+        for (int k = 0; k < 3; k++) {
+            if (decimals >= 0) {
+                int64_t fixed = static_cast<int64_t>(std::nearbyint(prices[k] * scale));
+                p = put_varint(p, zigzag(fixed - prev_fixed[k]));
+                prev_fixed[k] = fixed;
+            } else {
+                uint64_t bits = std::bit_cast<uint64_t>(prices[k]);
+                p = put_xor(p, bits ^ prev_bits[k]);
+                prev_bits[k] = bits;
+            }
+        }
+    }
+    payload.resize(static_cast<size_t>(p - payload.data()));
+
+    // Round-trip in memory before anything reaches the disk
+    std::vector<StoredTick> check(count);
+    if (!decode_cold_ticks(payload.data(), payload.size(), count, decimals, check.data()) ||
+        std::memcmp(check.data(), first, count * sizeof(StoredTick)) != 0) {
+        return fail("encoded segment does not decode to its input");
+    }
+
+    ColdFileHeader header{};
+    std::memcpy(header.magic, kColdMagic, sizeof(kColdMagic));
+    header.version = kColdVersion;
+    header.price_decimals = decimals;
+    header.ticks = count;
+    header.first_ns = first->exchange_ns;
+    header.last_ns = (last - 1)->exchange_ns;
+    header.payload_bytes = payload.size();
+    header.checksum = payload_checksum(payload.data(), payload.size());
+    std::strncpy(header.pair, pair.c_str(), sizeof(header.pair) - 1);
+
+    // Complete or absent: write aside, sync, then rename into place
+    const std::string tmp = path + ".tmp." + std::to_string(getpid());
+    FILE* file = std::fopen(tmp.c_str(), "wb");
+    if (file == nullptr) {
+        return fail("open " + tmp + ": " + std::strerror(errno));
+    }
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+              std::fwrite(payload.data(), 1, payload.size(), file) == payload.size() &&
+              std::fflush(file) == 0 && fsync(fileno(file)) == 0;
+    ok = std::fclose(file) == 0 && ok;
+    if (!ok || std::rename(tmp.c_str(), path.c_str()) != 0) {
+        std::string reason = std::strerror(errno);
+        std::remove(tmp.c_str());
+        return fail("write " + path + ": " + reason);
+    }
+
+    if (info != nullptr) {
+        info->ticks = count;
+        info->first_ns = header.first_ns;
+        info->last_ns = header.last_ns;
+        info->price_decimals = decimals;
+        info->bytes = sizeof(header) + payload.size();
+    }
+    return true;
+}
+
+static bool header_ok(const ColdFileHeader& header) {
+    return std::memcmp(header.magic, kColdMagic, sizeof(kColdMagic)) == 0 && header.version == kColdVersion;
+}
+
+static void fill_info(const ColdFileHeader& header, uint64_t bytes, ColdSegmentInfo& info) {
+    info.ticks = header.ticks;
+    info.first_ns = header.first_ns;
+    info.last_ns = header.last_ns;
+    info.price_decimals = header.price_decimals;
+    info.bytes = bytes;
+}
+
+ColdSegmentReader::~ColdSegmentReader() {
+    close();
+}
+
+void ColdSegmentReader::close() {
+    decoder_.reset();
+    if (map_ != nullptr) {
+        munmap(map_, size_);
+        map_ = nullptr;
+    }
+    size_ = 0;
+    info_ = ColdSegmentInfo{};
+}
+
+bool ColdSegmentReader::open(const std::string& path, std::string* error) {
+    close();
+    auto fail = [&](const std::string& message) {
+        close();
+        if (error != nullptr) {
+            *error = message;
+        }
+        return false;
+    };
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return fail(std::string("open: ") + std::strerror(errno));
+    }
+    struct stat st {};
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(ColdFileHeader)) {
+        ::close(fd);
+        return fail("truncated header");
+    }
+    const size_t size = static_cast<size_t>(st.st_size);
+    int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+    // The checksum reads the whole file front to back: fault it in up front
+    flags |= MAP_POPULATE;
+#endif
+    void* addr = mmap(nullptr, size, PROT_READ, flags, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        return fail(std::string("mmap: ") + std::strerror(errno));
+    }
+    map_ = addr;
+    size_ = size;
+    madvise(addr, size, MADV_SEQUENTIAL);
+
+    ColdFileHeader header;
+    std::memcpy(&header, addr, sizeof(header));
+    const uint8_t* payload = static_cast<const uint8_t*>(addr) + sizeof(header);
+    if (!header_ok(header)) {
+        return fail("incompatible format");
+    }
+    if (header.payload_bytes != size - sizeof(header)) {
+        return fail("payload size mismatch");
+    }
+    if (payload_checksum(payload, header.payload_bytes) != header.checksum) {
+        return fail("checksum mismatch");
+    }
+    fill_info(header, size, info_);
+    decoder_ = std::make_unique<ColdSegmentDecoder>(payload, header.payload_bytes, header.ticks,
+                                                    header.price_decimals);
+    return true;
+}
+
+size_t ColdSegmentReader::next(StoredTick* out, size_t max) {
+    return decoder_ ? decoder_->next(out, max) : 0;
+}
+
+bool ColdSegmentReader::ok() const {
+    return decoder_ && decoder_->ok();
+}
+
+bool read_cold_segment(const std::string& path, std::vector<StoredTick>& out, ColdSegmentInfo* info,
+                       std::string* error) {
+    ColdSegmentReader reader;
+    if (!reader.open(path, error)) {
+        return false;
+    }
+    // Through a small cache-resident chunk, so each output tick is written
+    // to memory once instead of zero-filled and then decoded
+    const size_t old_size = out.size();
+    out.reserve(old_size + reader.info().ticks);
+    StoredTick chunk[kDecodeChunk];
+    while (size_t n = reader.next(chunk, kDecodeChunk)) {
+        out.insert(out.end(), chunk, chunk + n);
+    }
+    if (!reader.ok() || out.size() - old_size != reader.info().ticks) {
+        out.resize(old_size);
+        if (error != nullptr) {
+            *error = "corrupt payload";
+        }
+        return false;
+    }
+    if (info != nullptr) {
+        *info = reader.info();
+    }
+    return true;
+}
+
+bool read_cold_header(const std::string& path, ColdSegmentInfo& info, std::string* error) {
+    auto fail = [&](const std::string& message) {
+        if (error != nullptr) {
+            *error = message;
+        }
+        return false;
+    };
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return fail(std::string("open: ") + std::strerror(errno));
+    }
+    struct stat st {};
+    ColdFileHeader header;
+    bool read = fstat(fd, &st) == 0 &&
+                pread(fd, &header, sizeof(header), 0) == static_cast<ssize_t>(sizeof(header));
+    ::close(fd);
+    if (!read) {
+        return fail("truncated header");
+    }
+    if (!header_ok(header)) {
+        return fail("incompatible format");
+    }
+    if (header.payload_bytes != static_cast<uint64_t>(st.st_size) - sizeof(header)) {
+        return fail("payload size mismatch");
+    }
+    fill_info(header, static_cast<uint64_t>(st.st_size), info);
+    return true;
+}
+
+TickCompactor::TickCompactor(std::string dir)
+    : dir_(std::move(dir)) {
+}
+
+TickCompactor::~TickCompactor() {
+    stop();
+}
+
+CompactionStats TickCompactor::compact_once() {
+    CompactionStats stats;
+    for (const TickSegment& segment : list_tick_segments(dir_)) {
+        if (!segment.cold && !compact_segment(segment, stats)) {
+            stats.failures++;
+        }
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    totals_.segments += stats.segments;
+    totals_.ticks += stats.ticks;
+    totals_.hot_bytes += stats.hot_bytes;
+    totals_.cold_bytes += stats.cold_bytes;
+    totals_.failures += stats.failures;
+    return stats;
+}
+
+bool TickCompactor::compact_segment(const TickSegment& segment, CompactionStats& stats) {
+    namespace fs = std::filesystem;
+    const std::string cold_path = tick_segment_path(dir_, segment.pair, segment.start_seconds, "cold");
+    std::error_code ec;
+    const uint64_t hot_bytes = fs::file_size(segment.path, ec);
+
+    std::vector<StoredTick> hot;
+    if (!read_tick_file(segment.path, hot)) {
+        return false;
+    }
+    if (hot.empty()) {
+        fs::remove(segment.path, ec);
+        return true;
+    }
+
+    // A cold copy already there is left from a pass interrupted before the
+    // hot file was removed; it is checked like a fresh one
+    const bool existed = fs::exists(cold_path, ec);
+    std::string error;
+    if (!existed && !write_cold_segment(cold_path, segment.pair, hot.data(), hot.data() + hot.size(), nullptr,
+                                        &error)) {
+        LOG_ERROR("Failed to compact tick segment " + segment.path + ": " + error);
+        return false;
+    }
+
+    // Read back from disk before the hot copy goes
+    std::vector<StoredTick> back;
+    ColdSegmentInfo info;
+    if (!read_cold_segment(cold_path, back, &info, &error) || back.size() != hot.size() ||
+        std::memcmp(back.data(), hot.data(), hot.size() * sizeof(StoredTick)) != 0) {
+        LOG_ERROR("Cold tick segment " + cold_path + " does not match " + segment.path +
+                  (error.empty() ? std::string() : ": " + error));
+        if (!existed) {
+            fs::remove(cold_path, ec);
+        }
+        return false;
+    }
+
+    if (!fs::remove(segment.path, ec) && ec) {
+        LOG_WARNING("Failed to remove compacted tick segment " + segment.path + ": " + ec.message());
+    }
+    stats.segments++;
+    stats.ticks += info.ticks;
+    stats.hot_bytes += hot_bytes;
+    stats.cold_bytes += info.bytes;
+    LOG_INFO("Compacted tick segment " + segment.path + ": " + std::to_string(info.ticks) + " ticks, " +
+             std::to_string(hot_bytes) + " -> " + std::to_string(info.bytes) + " bytes");
+    return true;
+}
+
+void TickCompactor::start(int interval_seconds) {
+    if (worker_.joinable()) {
+        return;
+    }
+    stopping_ = false;
+    worker_ = std::thread([this, interval_seconds] {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!stopping_) {
+            lock.unlock();
+            compact_once();
+            lock.lock();
+            cv_.wait_for(lock, std::chrono::seconds(interval_seconds), [this] { return stopping_; });
+        }
+    });
+}
+
+void TickCompactor::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+CompactionStats TickCompactor::totals() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return totals_;
+}
@@ -0,0 +1,142 @@
+#ifndef TICK_ARCHIVE_HPP
+#define TICK_ARCHIVE_HPP
+
+#include "tick_store.hpp"
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+
+// Cold-tier tick segments. A .cold file holds one closed hot segment,
+// losslessly compressed and decoded in one sequential pass:
+//   exchange_ns   delta-of-delta, zigzag varint
+//   receive_ns    offset from exchange_ns, zigzag varint
+//   prices        fixed-point deltas (zigzag varint) when every price in
+//                 the segment is exact at 8 or fewer decimals, else the XOR
+//                 with the previous value stored as its non-zero bytes
+// Every field is byte-aligned, so decoding is a few shifts per varint.
+
+struct ColdSegmentInfo {
+    uint64_t ticks = 0;
+    int64_t first_ns = 0;
+    int64_t last_ns = 0;
+    int price_decimals = -1;      // -1: XOR encoding
+    uint64_t bytes = 0;           // File size
+};
+
+// Encode ticks (time ordered) into path via a temporary file and rename
+bool write_cold_segment(const std::string& path, const std::string& pair, const StoredTick* first,
+                        const StoredTick* last, ColdSegmentInfo* info, std::string* error);
+
+// Append the segment's ticks to out; checks the header and payload checksum
+bool read_cold_segment(const std::string& path, std::vector<StoredTick>& out, ColdSegmentInfo* info,
+                       std::string* error);
+
+// Header only (no payload read or checksum), to find the segments a time
+// range needs
+bool read_cold_header(const std::string& path, ColdSegmentInfo& info, std::string* error);
+
+// Streams the ticks of an in-memory cold payload in chunks of the caller's
+// choosing, so a year of segments can be replayed without holding it all
+// decoded
+class ColdSegmentDecoder {
+public:
+    ColdSegmentDecoder(const uint8_t* payload, size_t size, uint64_t count, int price_decimals);
+
+    // Decode up to max ticks into out; returns how many. 0 once every tick
+    // is out or the payload turned out corrupt (see ok()).
+    size_t next(StoredTick* out, size_t max);
+
+    // False after corrupt data; at the end, also false unless the payload
+    // was consumed exactly
+    bool ok() const { return ok_ && (remaining_ > 0 || p_ == end_); }
+    uint64_t remaining() const { return remaining_; }
+
+private:
+    template <bool Fixed>
+    size_t run(StoredTick* out, size_t max);
+
+    const uint8_t* p_;
+    const uint8_t* end_;
+    uint64_t remaining_;
+    int decimals_;
+    bool ok_ = true;
+    int64_t prev_ns_ = 0;
+    int64_t prev_delta_ = 0;
+    int64_t prev_fixed_[3] = {0, 0, 0};
+    uint64_t prev_bits_[3] = {0, 0, 0};
+};
+
+// A cold segment mapped read-only, its header and checksum verified on
+// open, decoded a chunk at a time
+class ColdSegmentReader {
+public:
+    ColdSegmentReader() = default;
+    ~ColdSegmentReader();
+
+    ColdSegmentReader(const ColdSegmentReader&) = delete;
+    ColdSegmentReader& operator=(const ColdSegmentReader&) = delete;
+
+    bool open(const std::string& path, std::string* error);
+    const ColdSegmentInfo& info() const { return info_; }
+
+    // As ColdSegmentDecoder::next; 0 before a successful open()
+    size_t next(StoredTick* out, size_t max);
+    // False after corrupt data, or at the end unless every tick decoded
+    bool ok() const;
+
+private:
+    void close();
+
+    void* map_ = nullptr;
+    size_t size_ = 0;
+    ColdSegmentInfo info_;
+    std::unique_ptr<ColdSegmentDecoder> decoder_;
+};
+
+struct CompactionStats {
+    uint64_t segments = 0;        // Hot segments moved to the cold tier
+    uint64_t ticks = 0;
+    uint64_t hot_bytes = 0;       // Size of the hot segments removed
+    uint64_t cold_bytes = 0;      // Size of the cold segments written
+    uint64_t failures = 0;        // Segments left hot after an error
+};
+
+// Moves closed hot segments (<pair>.<start>.ticks) of a tick store into the
+// cold tier. Each one is encoded, decoded again and compared record by
+// record before the hot file is removed, so a crash or a bad encode never
+// loses data; a leftover hot segment is simply retried.
+class TickCompactor {
+public:
+    explicit TickCompactor(std::string dir);
+    ~TickCompactor();
+
+    TickCompactor(const TickCompactor&) = delete;
+    TickCompactor& operator=(const TickCompactor&) = delete;
+
+    // One pass over the directory on the calling thread
+    CompactionStats compact_once();
+
+    // Run compact_once every interval_seconds on a background thread
+    // until stop() (or destruction)
+    void start(int interval_seconds);
+    void stop();
+
+    CompactionStats totals() const;
+
+private:
+    bool compact_segment(const TickSegment& segment, CompactionStats& stats);
+
+    std::string dir_;
+    std::thread worker_;
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_ = false;
+    CompactionStats totals_;
+};
+
+#endif // TICK_ARCHIVE_HPP
@@ -0,0 +1,51 @@
+#include "tick_arena.hpp"
+#include <algorithm>
+
+static thread_local TickArena* g_current_arena = nullptr;
+
+std::pmr::memory_resource* tick_resource() {
+    if (g_current_arena != nullptr) {
+        return g_current_arena;
+    }
+    return std::pmr::new_delete_resource();
+}
+
+TickArena::TickArena(size_t capacity)
+    : buffer_(std::make_unique<std::byte[]>(capacity))
+    , monotonic_(buffer_.get(), capacity, std::pmr::new_delete_resource()) {
+    stats_.capacity = capacity;
+}
+
+void* TickArena::do_allocate(size_t bytes, size_t alignment) {
+    // Count the padding the monotonic resource will insert, so used()
+    // matches how far into the buffer the tick has got
+    used_ = (used_ + alignment - 1) / alignment * alignment + bytes;
+    allocations_++;
+    return monotonic_.allocate(bytes, alignment);
+}
+
+void TickArena::reset() {
+    stats_.ticks++;
+    stats_.last_tick_bytes = used_;
+    stats_.last_tick_allocations = allocations_;
+    stats_.high_water_bytes = std::max(stats_.high_water_bytes, used_);
+    if (used_ > stats_.capacity) {
+        stats_.overflow_ticks++;
+    }
+    // Rewinds to the initial buffer; only heap blocks from an overflowing
+    // tick are actually freed
+    monotonic_.release();
+    used_ = 0;
+    allocations_ = 0;
+}
+
+TickArena::Scope::Scope(TickArena& arena)
+    : arena_(arena)
+    , previous_(g_current_arena) {
+    g_current_arena = &arena;
+}
+
+TickArena::Scope::~Scope() {
+    g_current_arena = previous_;
+    arena_.reset();
+}
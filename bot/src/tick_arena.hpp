@@ -0,0 +1,113 @@
+#ifndef TICK_ARENA_HPP
+#define TICK_ARENA_HPP
+
+#include <nlohmann/json.hpp>
+#include <memory_resource>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <map>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// Usage of a TickArena, in bytes handed out (including alignment padding)
+struct TickArenaStats {
+    size_t capacity = 0;            // Preallocated buffer
+    uint64_t ticks = 0;             // Resets so far
+    size_t last_tick_bytes = 0;     // Used by the previous tick
+    uint64_t last_tick_allocations = 0;
+    size_t high_water_bytes = 0;    // Largest tick so far
+    uint64_t overflow_ticks = 0;    // Ticks that outgrew the buffer and
+                                    // took extra blocks from the heap
+};
+
+// Per-tick monotonic arena. Everything the loop allocates from it during a
+// tick (decision strings, parsed response trees, status lines, the UI
+// status document) is dead by the end of the tick, so nothing is freed
+// individually; reset() rewinds to the start of the buffer in O(1). A tick
+// that outgrows the buffer continues in heap blocks, which reset() frees
+// and the stats count so the capacity can be raised.
+class TickArena : public std::pmr::memory_resource {
+public:
+    explicit TickArena(size_t capacity);
+
+    // Must only be called once nothing allocated this tick is alive
+    void reset();
+
+    // Bytes handed out since the last reset
+    size_t used() const { return used_; }
+    const TickArenaStats& stats() const { return stats_; }
+
+    // Makes the arena the calling thread's tick resource for the lifetime
+    // of the scope and resets it on exit. Declare it first in the loop body
+    // so every tick-local object is destroyed before the reset.
+    class Scope {
+    public:
+        explicit Scope(TickArena& arena);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        TickArena& arena_;
+        TickArena* previous_;
+    };
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void*, size_t, size_t) override {}
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    std::unique_ptr<std::byte[]> buffer_;
+    std::pmr::monotonic_buffer_resource monotonic_;
+    size_t used_ = 0;
+    uint64_t allocations_ = 0;
+    TickArenaStats stats_;
+};
+
+// The calling thread's tick arena, or the heap outside a TickArena::Scope
+std::pmr::memory_resource* tick_resource();
+
+// Stateless allocator over tick_resource(), for containers that cannot
+// carry an allocator instance. Memory must be freed on the thread and in
+// the tick scope it was allocated in, so keep such objects function-local.
+template <typename T>
+struct TickAllocator {
+    using value_type = T;
+
+    TickAllocator() noexcept = default;
+    template <typename U>
+    TickAllocator(const TickAllocator<U>&) noexcept {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(tick_resource()->allocate(n * sizeof(T), alignof(T)));
+    }
+    void deallocate(T* p, size_t n) noexcept {
+        tick_resource()->deallocate(p, n * sizeof(T), alignof(T));
+    }
+
+    template <typename U>
+    bool operator==(const TickAllocator<U>&) const noexcept { return true; }
+};
+
+// JSON whose object and array nodes live in the tick arena; used for
+// response parsing and the UI status. Strings longer than the SSO buffer
+// still go to the heap.
+using TickJson = nlohmann::basic_json<std::map, std::vector, std::string, bool, std::int64_t, std::uint64_t,
+                                      double, TickAllocator>;
+
+// String stream whose buffer comes from a memory resource; view() reads it
+// without a copy
+using ArenaOStream = std::basic_ostringstream<char, std::char_traits<char>, std::pmr::polymorphic_allocator<char>>;
+
+// Replace out with the concatenation of parts, building it in out's own
+// storage instead of through heap temporaries
+template <typename... Parts>
+void assign_concat(std::pmr::string& out, const Parts&... parts) {
+    out.clear();
+    (out.append(std::string_view(parts)), ...);
+}
+
+#endif // TICK_ARENA_HPP
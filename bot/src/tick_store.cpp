@@ -0,0 +1,427 @@
+#include "tick_store.hpp"
+#include "tick_archive.hpp"
+#include "logger.hpp"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <filesystem>
+#include <cstring>
+#include <cerrno>
+
+static constexpr char kTickMagic[8] = {'K', 'R', 'K', 'N', 'T', 'C', 'K', '1'};
+static constexpr uint32_t kTickVersion = 1;
+
+struct TickFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;
+    char pair[16];
+    char reserved[32];
+};
+static_assert(sizeof(TickFileHeader) == 64, "tick file header must stay 64 bytes");
+
+std::string tick_store_path(const std::string& dir, const std::string& pair) {
+    return (std::filesystem::path(dir) / (pair + ".ticks")).string();
+}
+
+std::string tick_segment_path(const std::string& dir, const std::string& pair, int64_t start_seconds,
+                              const char* ext) {
+    return (std::filesystem::path(dir) / (pair + "." + std::to_string(start_seconds) + "." + ext)).string();
+}
+
+std::vector<TickSegment> list_tick_segments(const std::string& dir, const std::string& pair) {
+    std::vector<TickSegment> segments;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(dir, ec)) {
+        if (!entry.is_regular_file(ec)) {
+            continue;
+        }
+        // <pair>.<start_seconds>.<ticks|cold>
+        const std::string name = entry.path().filename().string();
+        size_t ext_dot = name.rfind('.');
+        if (ext_dot == std::string::npos || ext_dot == 0) {
+            continue;
+        }
+        size_t start_dot = name.rfind('.', ext_dot - 1);
+        if (start_dot == std::string::npos || start_dot == 0 || start_dot + 1 == ext_dot) {
+            continue;
+        }
+        const std::string ext = name.substr(ext_dot + 1);
+        const std::string start = name.substr(start_dot + 1, ext_dot - start_dot - 1);
+        if ((ext != "ticks" && ext != "cold") ||
+            !std::all_of(start.begin(), start.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+            continue;
+        }
+        TickSegment segment;
+        segment.path = entry.path().string();
+        segment.pair = name.substr(0, start_dot);
+        segment.start_seconds = std::stoll(start);
+        segment.cold = ext == "cold";
+        if (pair.empty() || segment.pair == pair) {
+            segments.push_back(std::move(segment));
+        }
+    }
+    // Cold first where a segment is in both tiers
+    std::sort(segments.begin(), segments.end(), [](const TickSegment& a, const TickSegment& b) {
+        if (a.pair != b.pair) {
+            return a.pair < b.pair;
+        }
+        if (a.start_seconds != b.start_seconds) {
+            return a.start_seconds < b.start_seconds;
+        }
+        return a.cold && !b.cold;
+    });
+    return segments;
+}
+
+TickStoreWriter::TickStoreWriter(const std::string& dir, const std::string& pair, int64_t segment_seconds)
+    : dir_(dir)
+    , pair_(pair)
+    , path_(tick_store_path(dir, pair))
+    , segment_ns_(std::max<int64_t>(segment_seconds, 0) * 1'000'000'000) {
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+    open_file();
+}
+
+void TickStoreWriter::open_file() {
+    file_ = std::fopen(path_.c_str(), "ab+");
+    if (file_ == nullptr) {
+        LOG_ERROR("Failed to open tick store " + path_ + ": " + std::string(std::strerror(errno)));
+        return;
+    }
+
+    std::fseek(file_, 0, SEEK_END);
+    long size = std::ftell(file_);
+    if (size < static_cast<long>(sizeof(TickFileHeader))) {
+        TickFileHeader header{};
+        std::memcpy(header.magic, kTickMagic, sizeof(kTickMagic));
+        header.version = kTickVersion;
+        header.record_size = sizeof(StoredTick);
+        std::strncpy(header.pair, pair_.c_str(), sizeof(header.pair) - 1);
+        if (size != 0 && ftruncate(fileno(file_), 0) != 0) {
+            LOG_WARNING("Failed to reset truncated tick store " + path_);
+        }
+        std::fwrite(&header, sizeof(header), 1, file_);
+        std::fflush(file_);
+        return;
+    }
+
+    // Resume after the last whole record so appends stay in time order,
+    // and in the segment the first record opened
+    long records = (size - static_cast<long>(sizeof(TickFileHeader))) / static_cast<long>(sizeof(StoredTick));
+    if (records > 0) {
+        StoredTick tick{};
+        std::fseek(file_, static_cast<long>(sizeof(TickFileHeader)), SEEK_SET);
+        if (segment_ns_ > 0 && std::fread(&tick, sizeof(tick), 1, file_) == 1) {
+            segment_start_ns_ = tick.exchange_ns - tick.exchange_ns % segment_ns_;
+        }
+        std::fseek(file_, static_cast<long>(sizeof(TickFileHeader)) + (records - 1) * static_cast<long>(sizeof(StoredTick)), SEEK_SET);
+        if (std::fread(&tick, sizeof(tick), 1, file_) == 1) {
+            last_exchange_ns_ = tick.exchange_ns;
+        }
+    }
+    std::fseek(file_, 0, SEEK_END);
+}
+
+void TickStoreWriter::roll() {
+    std::fclose(file_);
+    file_ = nullptr;
+    const std::string closed = tick_segment_path(dir_, pair_, segment_start_ns_ / 1'000'000'000, "ticks");
+    std::error_code ec;
+    if (std::filesystem::exists(closed, ec) || std::filesystem::exists(
+            tick_segment_path(dir_, pair_, segment_start_ns_ / 1'000'000'000, "cold"), ec)) {
+        // Never overwrite a closed segment; keep appending to the open file
+        LOG_ERROR("Tick segment " + closed + " already exists; not rolling " + path_);
+    } else if (std::rename(path_.c_str(), closed.c_str()) != 0) {
+        LOG_ERROR("Failed to close tick segment " + path_ + ": " + std::string(std::strerror(errno)));
+    } else {
+        LOG_INFO("Closed tick segment " + closed);
+    }
+    open_file();
+    // After a failed roll the open file spans two segments; try again at
+    // the next boundary rather than on every tick
+    segment_start_ns_ = -1;
+}
+
+TickStoreWriter::~TickStoreWriter() {
+    if (file_ != nullptr) {
+        std::fclose(file_);
+    }
+}
+
+bool TickStoreWriter::append(const StoredTick& tick) {
+    if (file_ == nullptr || tick.exchange_ns < last_exchange_ns_) {
+        return false;
+    }
+    if (segment_ns_ > 0) {
+        if (segment_start_ns_ >= 0 && tick.exchange_ns >= segment_start_ns_ + segment_ns_) {
+            roll();
+            if (file_ == nullptr) {
+                return false;
+            }
+        }
+        if (segment_start_ns_ < 0) {
+            segment_start_ns_ = tick.exchange_ns - tick.exchange_ns % segment_ns_;
+        }
+    }
+    last_exchange_ns_ = tick.exchange_ns;
+    return std::fwrite(&tick, sizeof(tick), 1, file_) == 1;
+}
+
+void TickStoreWriter::flush() {
+    if (file_ != nullptr) {
+        std::fflush(file_);
+    }
+}
+
+// Map a hot tick file read-only; logs and returns false if it is missing
+// or not a tick file
+static bool map_tick_file(const std::string& path, void*& map, size_t& map_size, const StoredTick*& ticks,
+                          size_t& count) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        LOG_ERROR("Failed to open tick store " + path + ": " + std::string(std::strerror(errno)));
+        return false;
+    }
+
+    struct stat st {};
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(TickFileHeader)) {
+        LOG_ERROR("Tick store " + path + " is empty");
+        close(fd);
+        return false;
+    }
+
+    void* addr = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        LOG_ERROR("mmap(" + path + ") failed: " + std::string(std::strerror(errno)));
+        return false;
+    }
+
+    const auto* header = static_cast<const TickFileHeader*>(addr);
+    if (std::memcmp(header->magic, kTickMagic, sizeof(kTickMagic)) != 0 ||
+        header->version != kTickVersion || header->record_size != sizeof(StoredTick)) {
+        LOG_ERROR("Tick store " + path + " has an incompatible format");
+        munmap(addr, static_cast<size_t>(st.st_size));
+        return false;
+    }
+
+    map = addr;
+    map_size = static_cast<size_t>(st.st_size);
+    ticks = reinterpret_cast<const StoredTick*>(static_cast<const char*>(addr) + sizeof(TickFileHeader));
+    // A partially written trailing record is ignored
+    count = (map_size - sizeof(TickFileHeader)) / sizeof(StoredTick);
+    madvise(addr, map_size, MADV_SEQUENTIAL);
+    return true;
+}
+
+bool read_tick_file(const std::string& path, std::vector<StoredTick>& out) {
+    void* map = nullptr;
+    size_t map_size = 0;
+    const StoredTick* ticks = nullptr;
+    size_t count = 0;
+    if (!map_tick_file(path, map, map_size, ticks, count)) {
+        return false;
+    }
+    out.insert(out.end(), ticks, ticks + count);
+    munmap(map, map_size);
+    return true;
+}
+
+// Span of a hot file from its first and last records; only those pages
+// are touched
+static bool hot_part(const std::string& path, TickStoreReader::Part& part) {
+    void* map = nullptr;
+    size_t map_size = 0;
+    const StoredTick* ticks = nullptr;
+    size_t count = 0;
+    if (!map_tick_file(path, map, map_size, ticks, count)) {
+        return false;
+    }
+    part.path = path;
+    part.cold = false;
+    part.ticks = count;
+    if (count > 0) {
+        part.first_ns = ticks[0].exchange_ns;
+        part.last_ns = ticks[count - 1].exchange_ns;
+    }
+    munmap(map, map_size);
+    return true;
+}
+
+TickStoreReader::TickStoreReader(const std::string& dir, const std::string& pair)
+    : pair_(pair) {
+    std::vector<TickSegment> segments = list_tick_segments(dir, pair);
+    for (size_t i = 0; i < segments.size(); i++) {
+        const TickSegment& segment = segments[i];
+        if (!segment.cold && i > 0 && segments[i - 1].cold && segments[i - 1].start_seconds == segment.start_seconds) {
+            continue;   // Compacted but not yet removed
+        }
+        Part part;
+        if (segment.cold) {
+            ColdSegmentInfo info;
+            std::string error;
+            if (!read_cold_header(segment.path, info, &error)) {
+                LOG_ERROR("Cold tick segment " + segment.path + ": " + error);
+                continue;
+            }
+            part.path = segment.path;
+            part.cold = true;
+            part.first_ns = info.first_ns;
+            part.last_ns = info.last_ns;
+            part.ticks = info.ticks;
+        } else if (hot_part(segment.path, part)) {
+            part.cold_path = tick_segment_path(dir, pair, segment.start_seconds, "cold");
+        } else {
+            continue;
+        }
+        parts_.push_back(part);
+    }
+
+    // The open file is optional once there are closed segments
+    const std::string open_path = tick_store_path(dir, pair);
+    std::error_code ec;
+    if (parts_.empty() || std::filesystem::exists(open_path, ec)) {
+        Part part;
+        if (hot_part(open_path, part)) {
+            part.open_file = true;
+            parts_.push_back(part);
+        }
+    }
+
+    // Nothing readable at all: a missing store, not an empty one
+    open_ = !parts_.empty() || !segments.empty();
+    for (const Part& part : parts_) {
+        count_ += part.ticks;
+    }
+}
+
+// Cold ticks decoded per step (40 KB)
+static constexpr size_t kCursorChunk = 1024;
+
+TickCursor::TickCursor(const TickStoreReader& reader, int64_t start_ns, int64_t end_ns)
+    : start_ns_(start_ns)
+    , end_ns_(end_ns) {
+    for (const TickStoreReader::Part& part : reader.parts()) {
+        bool overlaps = part.open_file ? part.ticks == 0 || part.first_ns < end_ns
+                                       : part.ticks > 0 && part.first_ns < end_ns && part.last_ns >= start_ns;
+        if (overlaps) {
+            parts_.push_back(part);
+        }
+    }
+}
+
+TickCursor::~TickCursor() {
+    close_part();
+}
+
+void TickCursor::close_part() {
+    if (map_ != nullptr) {
+        munmap(map_, map_size_);
+        map_ = nullptr;
+        map_size_ = 0;
+        hot_ticks_ = nullptr;
+        hot_count_ = 0;
+    }
+    cold_.reset();
+}
+
+bool TickCursor::open_part(const TickStoreReader::Part& part) {
+    if (part.cold) {
+        return open_cold(part.path);
+    }
+    // The compactor may have replaced a closed segment since it was indexed
+    std::error_code ec;
+    if (part.cold_path.empty() || std::filesystem::exists(part.path, ec)) {
+        if (map_tick_file(part.path, map_, map_size_, hot_ticks_, hot_count_)) {
+            return true;
+        }
+        if (part.cold_path.empty()) {
+            return false;
+        }
+    }
+    LOG_INFO("Tick segment " + part.path + " was compacted, reading " + part.cold_path);
+    return open_cold(part.cold_path);
+}
+
+bool TickCursor::open_cold(const std::string& path) {
+    cold_ = std::make_unique<ColdSegmentReader>();
+    std::string error;
+    if (!cold_->open(path, &error)) {
+        LOG_ERROR("Cold tick segment " + path + ": " + error);
+        cold_.reset();
+        return false;
+    }
+    cold_path_ = path;
+    chunk_.resize(kCursorChunk);
+    return true;
+}
+
+bool TickCursor::next(const StoredTick*& first, const StoredTick*& last) {
+    auto by_time = [](const StoredTick& tick, int64_t ns) { return tick.exchange_ns < ns; };
+    while (!done_) {
+        const StoredTick* begin;
+        size_t count;
+        if (cold_) {
+            count = cold_->next(chunk_.data(), chunk_.size());
+            if (count == 0) {
+                if (!cold_->ok()) {
+                    LOG_ERROR("Cold tick segment " + cold_path_ + " is corrupt, skipping the rest of it");
+                }
+                close_part();
+                continue;
+            }
+            begin = chunk_.data();
+        } else if (map_ != nullptr) {
+            close_part();   // Its run was handed out by the previous call
+            continue;
+        } else {
+            if (index_ == parts_.size()) {
+                break;
+            }
+            if (!open_part(parts_[index_++]) || cold_) {
+                continue;
+            }
+            begin = hot_ticks_;
+            count = hot_count_;
+        }
+
+        const StoredTick* end = begin + count;
+        first = std::lower_bound(begin, end, start_ns_, by_time);
+        last = std::lower_bound(first, end, end_ns_, by_time);
+        // Files are in time order: a tick past the range ends it
+        done_ = last != end;
+        if (first != last) {
+            return true;
+        }
+    }
+    return false;
+}
+
+TickRecorder::TickRecorder(const std::string& dir, int64_t segment_seconds)
+    : dir_(dir)
+    , segment_seconds_(segment_seconds) {
+}
+
+void TickRecorder::record(const SnapshotTable& table) {
+    for (const auto& snap : table.snapshots()) {
+        if (snap.version != table.version() || snap.last_price <= 0.0) {
+            continue;
+        }
+        auto& writer = writers_[snap.pair];
+        if (!writer) {
+            writer = std::make_unique<TickStoreWriter>(dir_, snap.pair, segment_seconds_);
+        }
+        StoredTick tick{};
+        tick.exchange_ns = snap.exchange_ns > 0 ? snap.exchange_ns : snap.receive_ns;
+        tick.receive_ns = snap.receive_ns;
+        tick.last_price = snap.last_price;
+        tick.bid_price = snap.bid_price;
+        tick.ask_price = snap.ask_price;
+        writer->append(tick);
+        writer->flush();
+    }
+}
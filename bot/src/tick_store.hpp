@@ -0,0 +1,156 @@
+#ifndef TICK_STORE_HPP
+#define TICK_STORE_HPP
+
+#include "market_data.hpp"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <cstdio>
+#include <cstdint>
+#include <cstddef>
+
+// One recorded quote. Files are a fixed header followed by packed records
+// in arrival order, so a reader can mmap them and binary-search by time.
+struct StoredTick {
+    int64_t exchange_ns;
+    int64_t receive_ns;
+    double last_price;
+    double bid_price;
+    double ask_price;
+};
+
+// <dir>/<pair>.ticks: the open hot segment
+std::string tick_store_path(const std::string& dir, const std::string& pair);
+
+// <dir>/<pair>.<start_seconds>.<ext>: a closed segment ("ticks", hot) or
+// its compressed copy ("cold")
+std::string tick_segment_path(const std::string& dir, const std::string& pair, int64_t start_seconds,
+                              const char* ext);
+
+struct TickSegment {
+    std::string path;
+    std::string pair;
+    int64_t start_seconds = 0;
+    bool cold = false;
+};
+
+// Closed segments in dir (every pair when pair is empty), by pair and start
+std::vector<TickSegment> list_tick_segments(const std::string& dir, const std::string& pair = "");
+
+// Append the whole records of a hot tick file to out; false (logged) if it
+// cannot be read or is not a tick file
+bool read_tick_file(const std::string& path, std::vector<StoredTick>& out);
+
+// Appends ticks for one pair; creates the file and header on first use.
+// With segment_seconds > 0 the open file is closed (renamed to its
+// segment path) when a tick falls past the end of its aligned interval.
+class TickStoreWriter {
+public:
+    TickStoreWriter(const std::string& dir, const std::string& pair, int64_t segment_seconds = 0);
+    ~TickStoreWriter();
+
+    TickStoreWriter(const TickStoreWriter&) = delete;
+    TickStoreWriter& operator=(const TickStoreWriter&) = delete;
+
+    bool is_open() const { return file_ != nullptr; }
+    bool append(const StoredTick& tick);
+    void flush();
+
+private:
+    void open_file();
+    void roll();
+
+    std::string dir_;
+    std::string pair_;
+    std::string path_;
+    int64_t segment_ns_;
+    FILE* file_ = nullptr;
+    int64_t last_exchange_ns_ = 0;
+    int64_t segment_start_ns_ = -1;   // -1 while the open file has no ticks
+};
+
+// Index of one pair's ticks: its closed hot and cold segments plus the
+// open file, in time order, preferring the cold copy of a segment that
+// exists in both tiers. Only each file's time span is read up front;
+// TickCursor reads the ticks.
+class TickStoreReader {
+public:
+    struct Part {
+        std::string path;
+        bool cold = false;
+        int64_t first_ns = 0;
+        int64_t last_ns = 0;
+        size_t ticks = 0;
+        bool open_file = false;   // Still being written: may grow
+        std::string cold_path;    // Closed hot segment: where compaction moves it
+    };
+
+    TickStoreReader(const std::string& dir, const std::string& pair);
+
+    bool is_open() const { return open_; }
+    const std::string& pair() const { return pair_; }
+    size_t size() const { return count_; }
+    const std::vector<Part>& parts() const { return parts_; }
+
+private:
+    std::string pair_;
+    bool open_ = false;
+    std::vector<Part> parts_;
+    size_t count_ = 0;
+};
+
+class ColdSegmentReader;
+
+// Streams the ticks with start_ns <= exchange_ns < end_ns one file at a
+// time, reading only the files whose span overlaps the range. Hot files are
+// mapped and handed out in place; cold ones are decoded a chunk at a time,
+// so memory stays at one file's mapping plus a chunk however long the range.
+class TickCursor {
+public:
+    TickCursor(const TickStoreReader& reader, int64_t start_ns, int64_t end_ns);
+    ~TickCursor();
+
+    TickCursor(const TickCursor&) = delete;
+    TickCursor& operator=(const TickCursor&) = delete;
+
+    // The next non-empty run of ticks, valid until the following call;
+    // false once the range is exhausted
+    bool next(const StoredTick*& first, const StoredTick*& last);
+
+private:
+    bool open_part(const TickStoreReader::Part& part);
+    bool open_cold(const std::string& path);
+    void close_part();
+
+    std::vector<TickStoreReader::Part> parts_;
+    size_t index_ = 0;
+    int64_t start_ns_;
+    int64_t end_ns_;
+    bool done_ = false;
+
+    // Current hot file, handed out as one run
+    void* map_ = nullptr;
+    size_t map_size_ = 0;
+    const StoredTick* hot_ticks_ = nullptr;
+    size_t hot_count_ = 0;
+    // Current cold file and its decoded chunk
+    std::unique_ptr<ColdSegmentReader> cold_;
+    std::string cold_path_;
+    std::vector<StoredTick> chunk_;
+};
+
+// Records every row refreshed by a snapshot table, one file per pair
+class TickRecorder {
+public:
+    explicit TickRecorder(const std::string& dir, int64_t segment_seconds = 0);
+
+    void record(const SnapshotTable& table);
+
+private:
+    std::string dir_;
+    int64_t segment_seconds_;
+    std::unordered_map<std::string, std::unique_ptr<TickStoreWriter>> writers_;
+};
+
+#endif // TICK_STORE_HPP
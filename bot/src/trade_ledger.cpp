@@ -0,0 +1,71 @@
+#include "trade_ledger.hpp"
+#include "logger.hpp"
+#include <nlohmann/json.hpp>
+#include <fstream>
+
+using json = nlohmann::json;
+
+TradeLedger::TradeLedger(const std::string& path)
+    : path_(path) {
+}
+
+void TradeLedger::append(const LedgerEntry& entry) {
+    if (path_.empty()) {
+        return;
+    }
+
+    json j;
+    j["time"] = entry.time;
+    j["pair"] = entry.pair;
+    j["entry_time"] = entry.entry_time;
+    j["entry_price"] = entry.entry_price;
+    j["exit_price"] = entry.exit_price;
+    j["volume"] = entry.volume;
+    j["fee_cad"] = entry.fee_cad;
+    j["pnl_cad"] = entry.pnl_cad;
+    j["closed"] = entry.closed;
+    j["simulated"] = entry.simulated;
+
+    std::ofstream file(path_, std::ios::app);
+    if (!file.is_open()) {
+        LOG_ERROR("Failed to open trade ledger for writing: " + path_);
+        return;
+    }
+    file << j.dump() << "\n";
+}
+
+std::vector<LedgerEntry> TradeLedger::load(const std::string& path) {
+    std::vector<LedgerEntry> entries;
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        LOG_ERROR("Failed to open trade ledger: " + path);
+        return entries;
+    }
+
+    std::string line;
+    size_t line_no = 0;
+    while (std::getline(file, line)) {
+        line_no++;
+        if (line.empty()) {
+            continue;
+        }
+        try {
+            json j = json::parse(line);
+            LedgerEntry entry;
+            entry.time = j.value("time", int64_t{0});
+            entry.pair = j.value("pair", "");
+            entry.entry_time = j.value("entry_time", int64_t{0});
+            entry.entry_price = j.value("entry_price", 0.0);
+            entry.exit_price = j.value("exit_price", 0.0);
+            entry.volume = j.value("volume", 0.0);
+            entry.fee_cad = j.value("fee_cad", 0.0);
+            entry.pnl_cad = j.value("pnl_cad", 0.0);
+            entry.closed = j.value("closed", false);
+            entry.simulated = j.value("simulated", false);
+            entries.push_back(entry);
+        } catch (const json::exception& e) {
+            LOG_WARNING("Skipping ledger line " + std::to_string(line_no) + ": " + std::string(e.what()));
+        }
+    }
+    return entries;
+}
@@ -0,0 +1,36 @@
+#ifndef TRADE_LEDGER_HPP
+#define TRADE_LEDGER_HPP
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// One sell fill. A round trip is every fill sharing (pair, entry_time).
+struct LedgerEntry {
+    int64_t time = 0;            // Unix epoch seconds of the fill
+    std::string pair;
+    int64_t entry_time = 0;      // Unix epoch seconds of the entry
+    double entry_price = 0.0;
+    double exit_price = 0.0;
+    double volume = 0.0;
+    double fee_cad = 0.0;        // Sell fee
+    double pnl_cad = 0.0;        // Net of the sell fee and this fill's share of the buy fee
+    bool closed = false;         // Position flat after this fill
+    bool simulated = false;
+};
+
+// Append-only JSON-lines record of realized trades
+class TradeLedger {
+public:
+    explicit TradeLedger(const std::string& path);
+
+    // No-op when the path is empty
+    void append(const LedgerEntry& entry);
+
+    static std::vector<LedgerEntry> load(const std::string& path);
+
+private:
+    std::string path_;
+};
+
+#endif // TRADE_LEDGER_HPP
@@ -0,0 +1,189 @@
+#include "trade_tape.hpp"
+#include "market_bus.hpp"
+#include "logger.hpp"
+#include "util.hpp"
+#include <algorithm>
+
+// Kraken returns at most this many prints per Trades request; a full page
+// means more are waiting
+static constexpr size_t kTradesPageSize = 1000;
+
+// Prints reach the Trades endpoint a moment after they happen; a bar stays
+// open this long past its end so they still land in it
+static constexpr int64_t kBarGraceNs = 2'000'000'000;
+
+// Longest run of empty bars filled in after a gap; beyond that the tape
+// restarts at the new interval
+static constexpr int64_t kMaxGapBars = 1440;
+
+TradeTape::TradeTape(std::string pair, int64_t bar_seconds, int vwap_bars, int max_closed_bars)
+    : pair_(std::move(pair))
+    , bar_ns_(std::max<int64_t>(bar_seconds, 1) * 1'000'000'000)
+    , vwap_bars_(static_cast<size_t>(std::max(vwap_bars, 1)))
+    , max_closed_(static_cast<size_t>(std::max(max_closed_bars, 1))) {
+}
+
+bool TradeTape::poll(KrakenClient& client, int max_pages, int64_t now_exchange_ns) {
+    for (int page = 0; page < max_pages; page++) {
+        TradesResult result = client.get_recent_trades(pair_, cursor_);
+        stats_.pages++;
+        if (!result.success) {
+            stats_.failures++;
+            return false;
+        }
+        if (!positioned_) {
+            // Start at the live edge: remember the newest print so the next
+            // page's overlap is recognised, but build nothing from history
+            positioned_ = true;
+            if (flow_ != nullptr) {
+                for (const TradePrint& print : result.trades) {
+                    flow_->add(print.volume, classifier_.classify(print));
+                }
+            }
+            if (!result.trades.empty()) {
+                last_id_ = result.trades.back().trade_id;
+                last_time_ns_ = result.trades.back().time_ns;
+            }
+            cursor_ = result.last;
+            break;
+        }
+        ingest(result.trades);
+        if (!result.last.empty()) {
+            cursor_ = result.last;
+        }
+        if (result.trades.size() < kTradesPageSize) {
+            break;
+        }
+        if (page + 1 == max_pages) {
+            LOG_WARNING("Trade tape for " + pair_ + " still behind after " + std::to_string(max_pages) +
+                        " pages; continuing next poll");
+        }
+    }
+    advance(now_exchange_ns);
+    return true;
+}
+
+size_t TradeTape::ingest(const std::vector<TradePrint>& prints) {
+    // Without trade ids, only prints strictly after the previous batch's
+    // newest print are new; prints sharing a timestamp within one batch
+    // are all kept
+    const int64_t previous_time_ns = last_time_ns_;
+    const int64_t receive_ns = bus_ != nullptr ? util::now_epoch_ns() : 0;
+    size_t accepted = 0;
+    for (const TradePrint& print : prints) {
+        bool fresh = print.trade_id != 0 ? print.trade_id > last_id_ : print.time_ns > previous_time_ns;
+        if (!fresh || print.volume <= 0.0) {
+            stats_.duplicates++;
+            continue;
+        }
+        last_id_ = std::max(last_id_, print.trade_id);
+        last_time_ns_ = std::max(last_time_ns_, print.time_ns);
+        const int sign = classifier_.classify(print);
+        if (flow_ != nullptr) {
+            flow_->add(print.volume, sign);
+        }
+        add(print, sign);
+        if (bus_ != nullptr) {
+            MarketUpdate update;
+            update.pair = pair_;
+            update.price = print.price;
+            update.volume = print.volume;
+            update.receive_ns = receive_ns;
+            update.exchange_ns = print.time_ns;
+            bus_->publish(update);
+        }
+        accepted++;
+    }
+    stats_.prints += accepted;
+    stats_.tick_ruled = classifier_.tick_rule_prints();
+    return accepted;
+}
+
+void TradeTape::add(const TradePrint& print, int sign) {
+    const int64_t start = print.time_ns / bar_ns_ * bar_ns_;
+    if (!has_open_) {
+        has_open_ = true;
+        open_ = TapeBar{};
+        open_.start_ns = start;
+    } else if (start - open_.start_ns > kMaxGapBars * bar_ns_) {
+        close_bar();
+        open_.start_ns = start;
+    } else if (start < open_.start_ns) {
+        stats_.late++;
+    }
+    while (start > open_.start_ns) {
+        close_bar();
+    }
+
+    if (open_.trades == 0) {
+        open_.open = open_.high = open_.low = print.price;
+    }
+    open_.high = std::max(open_.high, print.price);
+    open_.low = std::min(open_.low, print.price);
+    open_.close = print.price;
+    open_.volume += print.volume;
+    open_.notional += print.price * print.volume;
+    if (sign > 0) {
+        open_.buy_volume += print.volume;
+    } else if (sign < 0) {
+        open_.sell_volume += print.volume;
+    } else {
+        open_.buy_volume += print.volume / 2.0;
+        open_.sell_volume += print.volume / 2.0;
+    }
+    open_.trades++;
+}
+
+void TradeTape::advance(int64_t now_exchange_ns) {
+    if (!has_open_) {
+        return;
+    }
+    if (now_exchange_ns - open_.start_ns > kMaxGapBars * bar_ns_) {
+        close_bar();
+        open_.start_ns = (now_exchange_ns - kBarGraceNs) / bar_ns_ * bar_ns_;
+    }
+    while (now_exchange_ns >= open_.start_ns + bar_ns_ + kBarGraceNs) {
+        close_bar();
+    }
+}
+
+void TradeTape::close_bar() {
+    closed_.push_back(open_);
+    if (closed_.size() > max_closed_) {
+        closed_.erase(closed_.begin());
+    }
+    recent_.push_back(open_);
+    if (recent_.size() > vwap_bars_) {
+        recent_.pop_front();
+    }
+    stats_.bars++;
+
+    // Once per bar, so an exact re-sum is cheaper than tracking drift
+    window_ = TapeBar{};
+    for (const TapeBar& bar : recent_) {
+        window_.volume += bar.volume;
+        window_.buy_volume += bar.buy_volume;
+        window_.sell_volume += bar.sell_volume;
+        window_.notional += bar.notional;
+    }
+
+    // Next interval starts flat at this close until a print arrives
+    const double close = open_.close;
+    open_ = TapeBar{};
+    open_.start_ns = closed_.back().start_ns + bar_ns_;
+    open_.open = open_.high = open_.low = open_.close = close;
+}
+
+std::vector<TapeBar> TradeTape::take_closed_bars() {
+    std::vector<TapeBar> out;
+    out.swap(closed_);
+    return out;
+}
+
+double TradeTape::vwap() const {
+    double volume = window_.volume + open_.volume;
+    if (volume <= 0.0) {
+        return has_open_ ? open_.close : 0.0;
+    }
+    return (window_.notional + open_.notional) / volume;
+}
@@ -0,0 +1,114 @@
+#ifndef TRADE_TAPE_HPP
+#define TRADE_TAPE_HPP
+
+#include "kraken_client.hpp"
+#include "flow_toxicity.hpp"
+#include <string>
+#include <vector>
+#include <deque>
+#include <cstdint>
+
+class MarketDataBus;
+
+// One interval of the trade tape
+struct TapeBar {
+    int64_t start_ns = 0;         // Exchange time the interval opens
+    double open = 0.0;
+    double high = 0.0;
+    double low = 0.0;
+    double close = 0.0;
+    double volume = 0.0;
+    double buy_volume = 0.0;      // Taker bought (lifted the ask); tick rule
+                                  // when the side is missing
+    double sell_volume = 0.0;
+    double notional = 0.0;        // Sum of price * volume
+    uint32_t trades = 0;
+
+    // Trade-weighted average price; the close for a bar without trades
+    double vwap() const { return volume > 0.0 ? notional / volume : close; }
+};
+
+struct TapeStats {
+    uint64_t prints = 0;          // Accepted
+    uint64_t duplicates = 0;      // Dropped: at or before the last accepted trade
+    uint64_t late = 0;            // Arrived after their bar closed; counted
+                                  // in the open bar instead
+    uint64_t pages = 0;           // Trades requests
+    uint64_t failures = 0;
+    uint64_t bars = 0;            // Closed bars, including empty ones
+    uint64_t tick_ruled = 0;      // Prints signed by the tick rule
+};
+
+// Incremental consumer of /0/public/Trades for one pair. Each poll asks
+// only for prints after Kraken's since cursor and pages until it has caught
+// up, so every trade between polls is seen exactly once. Prints at or
+// before the last accepted trade id are dropped. Accepted prints build
+// fixed-interval bars (OHLC, volume, buy/sell volume, VWAP) on the exchange
+// clock and a rolling VWAP over the last vwap_bars bars.
+class TradeTape {
+public:
+    // At most max_closed_bars closed bars wait for take_closed_bars(); older
+    // ones are dropped, so a tape nobody drains stays bounded
+    TradeTape(std::string pair, int64_t bar_seconds, int vwap_bars, int max_closed_bars);
+
+    // Fetch up to max_pages pages since the cursor, then close the bars that
+    // ended before now_exchange_ns. The first successful call only positions
+    // the cursor at the live edge; history is never replayed. False if a
+    // request failed (the cursor stays put, so nothing is lost).
+    bool poll(KrakenClient& client, int max_pages, int64_t now_exchange_ns);
+
+    // Add prints, oldest first; returns how many were new
+    size_t ingest(const std::vector<TradePrint>& prints);
+
+    // Close every bar that ended before now, with an empty bar (flat at the
+    // previous close) for each interval without trades
+    void advance(int64_t now_exchange_ns);
+
+    // Bars closed since the last call, oldest first; the newest
+    // max_closed_bars if more closed than that
+    std::vector<TapeBar> take_closed_bars();
+
+    // Over the last vwap_bars closed bars plus the open one; vwap() is 0
+    // until the first print
+    double vwap() const;
+    double volume() const { return window_.volume + open_.volume; }
+    double buy_volume() const { return window_.buy_volume + open_.buy_volume; }
+    double sell_volume() const { return window_.sell_volume + open_.sell_volume; }
+
+    // Feed every signed print into flow (not owned). The page the first
+    // poll positions on primes it, so its buckets fill without waiting
+    void attach_flow(FlowToxicity* flow) { flow_ = flow; }
+    const FlowToxicity* flow() const { return flow_; }
+    
+    // Publish every accepted print to bus as a trade update (not owned)
+    void attach_bus(MarketDataBus* bus) { bus_ = bus; }
+
+    const std::string& pair() const { return pair_; }
+    const TapeStats& stats() const { return stats_; }
+
+private:
+    void add(const TradePrint& print, int sign);
+    void close_bar();
+
+    std::string pair_;
+    int64_t bar_ns_;
+    size_t vwap_bars_;
+    size_t max_closed_;
+
+    std::string cursor_;
+    bool positioned_ = false;
+    uint64_t last_id_ = 0;
+    int64_t last_time_ns_ = 0;
+    TradeSignClassifier classifier_;
+    FlowToxicity* flow_ = nullptr;
+    MarketDataBus* bus_ = nullptr;
+
+    bool has_open_ = false;
+    TapeBar open_;
+    std::deque<TapeBar> recent_;      // Last vwap_bars closed bars
+    TapeBar window_;                  // Volume sums over recent_
+    std::vector<TapeBar> closed_;     // Not yet taken, newest max_closed_
+    TapeStats stats_;
+};
+
+#endif // TRADE_TAPE_HPP
@@ -10,23 +10,50 @@
 #include <fstream>
 #include <cstring>
 #include <stdexcept>
+#include <atomic>
 
 namespace util {
 
+// 0 = wall clock
+static std::atomic<int64_t> g_sim_time_ns{0};
+
+static std::chrono::system_clock::time_point system_now() {
+    int64_t sim_ns = g_sim_time_ns.load(std::memory_order_relaxed);
+    if (sim_ns != 0) {
+        return std::chrono::system_clock::time_point(
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(sim_ns)));
+    }
+    return std::chrono::system_clock::now();
+}
+
+void set_sim_time_ns(int64_t epoch_ns) {
+    g_sim_time_ns.store(epoch_ns, std::memory_order_relaxed);
+}
+
+void clear_sim_time() {
+    g_sim_time_ns.store(0, std::memory_order_relaxed);
+}
+
 int64_t now_epoch_seconds() {
     return std::chrono::duration_cast<std::chrono::seconds>(
-        std::chrono::system_clock::now().time_since_epoch()
+        system_now().time_since_epoch()
     ).count();
 }
 
 int64_t now_epoch_ms() {
     return std::chrono::duration_cast<std::chrono::milliseconds>(
-        std::chrono::system_clock::now().time_since_epoch()
+        system_now().time_since_epoch()
+    ).count();
+}
+
+int64_t now_epoch_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        system_now().time_since_epoch()
     ).count();
 }
 
 std::string now_iso8601() {
-    auto now = std::chrono::system_clock::now();
+    auto now = system_now();
     auto time_t_now = std::chrono::system_clock::to_time_t(now);
     std::tm tm_now;
     localtime_r(&time_t_now, &tm_now);
@@ -57,7 +84,7 @@ int64_t iso8601_to_epoch(const std::string& iso_str) {
 }
 
 std::string today_yyyy_mm_dd() {
-    auto now = std::chrono::system_clock::now();
+    auto now = system_now();
     auto time_t_now = std::chrono::system_clock::to_time_t(now);
     std::tm tm_now;
     localtime_r(&time_t_now, &tm_now);
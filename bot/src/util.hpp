@@ -11,11 +11,17 @@ namespace util {
 // Time utilities
 int64_t now_epoch_seconds();
 int64_t now_epoch_ms();
+int64_t now_epoch_ns();
 std::string now_iso8601();
 std::string epoch_to_iso8601(int64_t epoch_seconds);
 int64_t iso8601_to_epoch(const std::string& iso_str);
 std::string today_yyyy_mm_dd();
 
+// Backtests drive the clock from recorded ticks: while set, every now_*
+// function (and today_yyyy_mm_dd) returns the simulated time
+void set_sim_time_ns(int64_t epoch_ns);
+void clear_sim_time();
+
 // Cryptographic utilities for Kraken API
 std::string base64_encode(const unsigned char* data, size_t len);
 std::string base64_encode(const std::string& data);